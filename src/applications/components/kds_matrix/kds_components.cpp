@@ -352,7 +352,6 @@ void gridpack::kalman_filter::KalmanBus::slabGetValues(
     std::vector<ComplexType*> &values, int *idx)
 {
   int i, k;
-  gridpack::random::Random random;
   if (p_mode == EnsembleX) {
     if (p_ngen > 0) {
       for (i=0; i<p_ngen; i++) {
@@ -384,11 +383,19 @@ void gridpack::kalman_filter::KalmanBus::slabGetValues(
     idx[1] = p_HX_idx[1];
     double d1 = p_ang_series[p_currentStep];
     double d2 = p_mag_series[p_currentStep];
+    // Measurement noise streams are keyed by bus and time step. Stream ids
+    // 2 and 3 keep them separate from the generator ensembles
+    gridpack::random::CounterRandom nrandom;
+    std::vector<double> noise(p_nEnsemble);
+    nrandom.setStream(getOriginalIndex(),p_currentStep,2);
+    if (p_nEnsemble > 0) nrandom.fillGaussian(&noise[0],p_nEnsemble);
     for (k=0; k<p_nEnsemble; k++) {
-      (values[0])[k] = d1+p_noise*random.grand();
+      (values[0])[k] = d1+p_noise*noise[k];
     }
+    nrandom.setStream(getOriginalIndex(),p_currentStep,3);
+    if (p_nEnsemble > 0) nrandom.fillGaussian(&noise[0],p_nEnsemble);
     for (k=0; k<p_nEnsemble; k++) {
-      (values[1])[k] = d2+p_noise*random.grand();
+      (values[1])[k] = d2+p_noise*noise[k];
     }
   } else if (p_mode == E_Ensemble1) {
     if (p_ngen > 0) {
@@ -832,7 +839,7 @@ void gridpack::kalman_filter::KalmanBus::setCurrentTimeStep(int istep)
 void gridpack::kalman_filter::KalmanBus::createEnsemble()
 {
   int i, k;
-  gridpack::random::Random random;
+  gridpack::random::CounterRandom random;
   if (p_V3 == NULL) {
     p_V3 = new gridpack::ComplexType[p_nEnsemble];
   }
@@ -873,14 +880,20 @@ void gridpack::kalman_filter::KalmanBus::createEnsemble()
         p_V2[i] = new gridpack::ComplexType[p_nEnsemble];
       }
     }
+    // Each generator draws its ensemble from its own stream, keyed by the
+    // original bus index, so the ensemble does not depend on how buses are
+    // distributed over processors
+    int bus_id = getOriginalIndex();
     for (i=0; i<p_ngen; i++) {
-      double angT = 0.0;
-      double magT = 0.0;
+      random.setStream(bus_id,i,0);
+      random.fillGaussian(p_delta1[i],p_nEnsemble);
       for (k=0; k<p_nEnsemble; k++) {
-        (p_delta1[i])[k] = p_delta_0[i]*(1.0+p_sigma*random.grand());
+        (p_delta1[i])[k] = p_delta_0[i]*(1.0+p_sigma*(p_delta1[i])[k]);
       }
+      random.setStream(bus_id,i,1);
+      random.fillGaussian(p_omega1[i],p_nEnsemble);
       for (k=0; k<p_nEnsemble; k++) {
-        (p_omega1[i])[k] = p_omega_0[i]*(1.0+p_sigma*random.grand());
+        (p_omega1[i])[k] = p_omega_0[i]*(1.0+p_sigma*(p_omega1[i])[k]);
       }
     }
   }
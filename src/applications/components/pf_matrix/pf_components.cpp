@@ -56,6 +56,9 @@ gridpack::powerflow::PFBus::PFBus(void)
   p_vMag_ptr = NULL;
   p_vAng_ptr = NULL;
   p_PV_ptr = NULL;
+  p_branchP = 0.0;
+  p_branchQ = 0.0;
+  p_branchSet = false;
 }
 
 /**
@@ -313,6 +316,36 @@ bool gridpack::powerflow::PFBus::chkQlim(void)
   return false;
 }
 
+/**
+ * Amount by which reactive power on a PV bus lies outside the combined
+ * generator limits. Unlike chkQlim, this does not modify the bus
+ * @return distance (in MVAR) from required reactive power to nearest
+ * limit, zero if there is no violation or bus is not a PV bus
+ */
+double gridpack::powerflow::PFBus::getQlimViolation(void)
+{
+  if (!p_isPV) return 0.0;
+  double qmax = 0.0;
+  double qmin = 0.0;
+  int i;
+  for (i=0; i<p_gstatus.size(); i++) {
+    if (p_gstatus[i] == 1) {
+      qmax += p_qmax[i];
+      qmin += p_qmin[i];
+    }
+  }
+  double ql = 0.0;
+  for (i=0; i<p_lstatus.size(); i++) {
+    if (p_lstatus[i] == 1) {
+      ql += p_ql[i];
+    }
+  }
+  double qval = p_Qinj*p_sbase+ql;
+  if (qval > qmax) return qval-qmax;
+  if (qval < qmin) return qmin-qval;
+  return 0.0;
+}
+
 /**
  * Clear changes that were made for Q limit violations and reset
  * bus to its original state
@@ -615,6 +648,18 @@ bool gridpack::powerflow::PFBus::checkVoltageViolation()
   return ret;
 }
 
+/**
+ * Amount by which voltage lies outside its limits
+ * @return distance from voltage magnitude to nearest limit, zero if
+ * there is no violation
+ */
+double gridpack::powerflow::PFBus::getVoltageViolation(void)
+{
+  if (*p_vMag_ptr > p_vmax) return *p_vMag_ptr - p_vmax;
+  if (*p_vMag_ptr < p_vmin) return p_vmin - *p_vMag_ptr;
+  return 0.0;
+}
+
 /**
  * Return the value of the voltage magnitude on this bus
  * @return: voltage magnitude
@@ -1290,19 +1335,27 @@ int gridpack::powerflow::PFBus::rhsValues(double *rvals)
   if (!isIsolated()) {
     if (!getReferenceBus()) {
       int nvals;
-      std::vector<boost::shared_ptr<BaseComponent> > branches;
-      getNeighborBranches(branches);
-      int size = branches.size();
-      int i;
-      double P, Q, p, q;
-      P = 0.0;
-      Q = 0.0;
-      for (i=0; i<size; i++) {
-        gridpack::powerflow::PFBranch *branch
-          = dynamic_cast<gridpack::powerflow::PFBranch*>(branches[i].get());
-        branch->getPQ(this, &p, &q);
-        P += p;
-        Q += q;
+      double P, Q;
+      if (p_branchSet) {
+        // Branch sums were evaluated for the whole network at once
+        P = p_branchP;
+        Q = p_branchQ;
+        p_branchSet = false;
+      } else {
+        std::vector<boost::shared_ptr<BaseComponent> > branches;
+        getNeighborBranches(branches);
+        int size = branches.size();
+        int i;
+        double p, q;
+        P = 0.0;
+        Q = 0.0;
+        for (i=0; i<size; i++) {
+          gridpack::powerflow::PFBranch *branch
+            = dynamic_cast<gridpack::powerflow::PFBranch*>(branches[i].get());
+          branch->getPQ(this, &p, &q);
+          P += p;
+          Q += q;
+        }
       }
       // Also add bus i's own Pi, Qi
       P += p_v*p_v*p_ybusr;
@@ -1329,19 +1382,27 @@ int gridpack::powerflow::PFBus::rhsValues(double *rvals)
       return nvals;
     } else {
 #ifdef LARGE_MATRIX
-      std::vector<boost::shared_ptr<BaseComponent> > branches;
-      getNeighborBranches(branches);
-      int size = branches.size();
-      int i;
-      double P, Q, p, q;
-      P = 0.0;
-      Q = 0.0;
-      for (i=0; i<size; i++) {
-        gridpack::powerflow::PFBranch *branch
-          = dynamic_cast<gridpack::powerflow::PFBranch*>(branches[i].get());
-        branch->getPQ(this, &p, &q);
-        P += p;
-        Q += q;
+      double P, Q;
+      if (p_branchSet) {
+        // Branch sums were evaluated for the whole network at once
+        P = p_branchP;
+        Q = p_branchQ;
+        p_branchSet = false;
+      } else {
+        std::vector<boost::shared_ptr<BaseComponent> > branches;
+        getNeighborBranches(branches);
+        int size = branches.size();
+        int i;
+        double p, q;
+        P = 0.0;
+        Q = 0.0;
+        for (i=0; i<size; i++) {
+          gridpack::powerflow::PFBranch *branch
+            = dynamic_cast<gridpack::powerflow::PFBranch*>(branches[i].get());
+          branch->getPQ(this, &p, &q);
+          P += p;
+          Q += q;
+        }
       }
       // Also add bus i's own Pi, Qi
       P += p_v*p_v*p_ybusr;
@@ -1360,6 +1421,35 @@ int gridpack::powerflow::PFBus::rhsValues(double *rvals)
   }
 }
 
+/**
+ * Set the power flowing out of the bus through attached branches. This
+ * is used when the branch sums are evaluated for the whole network at
+ * once. The next call to rhsValues uses these values instead of calling
+ * getPQ on each attached branch
+ * @param P real power flowing out through branches
+ * @param Q reactive power flowing out through branches
+ */
+void gridpack::powerflow::PFBus::setBranchInjection(double P, double Q)
+{
+  p_branchP = P;
+  p_branchQ = Q;
+  p_branchSet = true;
+}
+
+/**
+ * Get the power flowing out of the bus through attached branches, if it
+ * has been set with setBranchInjection and not yet used by rhsValues
+ * @param P real power flowing out through branches
+ * @param Q reactive power flowing out through branches
+ * @return false if no values are pending
+ */
+bool gridpack::powerflow::PFBus::getBranchInjection(double *P, double *Q) const
+{
+  *P = p_branchP;
+  *Q = p_branchQ;
+  return p_branchSet;
+}
+
 /**
  * Get vector containing generator participation
  * @return vector of generator participation factors
@@ -1439,6 +1529,8 @@ gridpack::powerflow::PFBranch::PFBranch(void)
   p_shunt.clear();
   p_elems = 0;
   p_theta = 0.0;
+  p_cs = 1.0;
+  p_sn = 0.0;
   p_sbase = 0.0;
   p_mode = YBus;
 }
@@ -1634,6 +1726,8 @@ void gridpack::powerflow::PFBranch::setYBus(void)
     dynamic_cast<gridpack::powerflow::PFBus*>(getBus2().get());
   double pi = 4.0*atan(1.0);
   p_theta = (bus1->getPhase() - bus2->getPhase());
+  p_cs = cos(p_theta);
+  p_sn = sin(p_theta);
 }
 
 /**
@@ -1751,16 +1845,16 @@ void gridpack::powerflow::PFBranch::getJacobian(gridpack::powerflow::PFBus *bus,
     gridpack::powerflow::PFBus *bus2 =
       dynamic_cast<gridpack::powerflow::PFBus*>(getBus2().get());
     v = bus2->getVoltage();
-    cs = cos(p_theta);
-    sn = sin(p_theta);
+    cs = p_cs;
+    sn = p_sn;
     ybusr = p_ybusr_frwd;
     ybusi = p_ybusi_frwd;
   } else if (bus == getBus2().get()) {
     gridpack::powerflow::PFBus *bus1 =
       dynamic_cast<gridpack::powerflow::PFBus*>(getBus1().get());
     v = bus1->getVoltage();
-    cs = cos(-p_theta);
-    sn = sin(-p_theta);
+    cs = p_cs;
+    sn = -p_sn;
     ybusr = p_ybusr_rvrs;
     ybusi = p_ybusi_rvrs;
   } else {
@@ -1789,14 +1883,16 @@ void gridpack::powerflow::PFBranch::getPQ(gridpack::powerflow::PFBus *bus, doubl
   double cs, sn;
   double ybusr, ybusi;
   p_theta = bus1->getPhase() - bus2->getPhase();
+  p_cs = cos(p_theta);
+  p_sn = sin(p_theta);
   if (bus == bus1) {
-    cs = cos(p_theta);
-    sn = sin(p_theta);
+    cs = p_cs;
+    sn = p_sn;
     ybusr = p_ybusr_frwd;
     ybusi = p_ybusi_frwd;
   } else if (bus == bus2) {
-    cs = cos(-p_theta);
-    sn = sin(-p_theta);
+    cs = p_cs;
+    sn = -p_sn;
     ybusr = p_ybusr_rvrs;
     ybusi = p_ybusi_rvrs;
   } else {
@@ -1807,6 +1903,34 @@ void gridpack::powerflow::PFBranch::getPQ(gridpack::powerflow::PFBus *bus, doubl
   *q = v1*v2*(ybusr*sn-ybusi*cs);
 }
 
+/**
+ * Return the off-diagonal admittances used by getPQ and the Jacobian
+ * @param yr_frwd, yi_frwd: real and imaginary parts of forward admittance
+ * @param yr_rvrs, yi_rvrs: real and imaginary parts of reverse admittance
+ */
+void gridpack::powerflow::PFBranch::getPQAdmittance(double *yr_frwd,
+    double *yi_frwd, double *yr_rvrs, double *yi_rvrs) const
+{
+  *yr_frwd = p_ybusr_frwd;
+  *yi_frwd = p_ybusi_frwd;
+  *yr_rvrs = p_ybusr_rvrs;
+  *yi_rvrs = p_ybusi_rvrs;
+}
+
+/**
+ * Set the phase angle difference across the branch, together with its
+ * cosine and sine, if these have been evaluated outside the component
+ * @param theta: phase angle of bus 1 minus phase angle of bus 2
+ * @param cs, sn: cosine and sine of theta
+ */
+void gridpack::powerflow::PFBranch::setPhaseDifference(double theta,
+    double cs, double sn)
+{
+  p_theta = theta;
+  p_cs = cs;
+  p_sn = sn;
+}
+
 /**
  * Return complex power for line element
  * @param tag describing line element on branch
@@ -2109,8 +2233,8 @@ int gridpack::powerflow::PFBranch::forwardJacobianValues(double *rvals)
   int nvals;
   if (ok) {
     double t11, t12, t21, t22;
-    double cs = cos(p_theta);
-    double sn = sin(p_theta);
+    double cs = p_cs;
+    double sn = p_sn;
     bool bus1PV = bus1->isPV();
     bool bus2PV = bus2->isPV();
 #ifdef LARGE_MATRIX
@@ -2184,8 +2308,8 @@ int gridpack::powerflow::PFBranch::reverseJacobianValues(double *rvals)
   int nvals;
   if (ok) {
     double t11, t12, t21, t22;
-    double cs = cos(-p_theta);
-    double sn = sin(-p_theta);
+    double cs = p_cs;
+    double sn = -p_sn;
     bool bus1PV = bus1->isPV();
     bool bus2PV = bus2->isPV();
 #ifdef LARGE_MATRIX
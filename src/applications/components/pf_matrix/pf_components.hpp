@@ -145,6 +145,13 @@ class PFBus
      */
     bool checkVoltageViolation(void);
 
+    /**
+     * Amount by which voltage lies outside its limits
+     * @return distance from voltage magnitude to nearest limit, zero if
+     * there is no violation
+     */
+    double getVoltageViolation(void);
+
     /**
      * Return the value of the voltage magnitude on this bus
      * @return voltage magnitude
@@ -241,6 +248,14 @@ class PFBus
     */
     bool chkQlim(void);
 
+    /**
+     * Amount by which reactive power on a PV bus lies outside the combined
+     * generator limits. Unlike chkQlim, this does not modify the bus
+     * @return distance (in MVAR) from required reactive power to nearest
+     * limit, zero if there is no violation or bus is not a PV bus
+     */
+    double getQlimViolation(void);
+
     /**
      * Clear changes that were made for Q limit violations and reset
      * bus to its original state
@@ -317,6 +332,26 @@ class PFBus
      */
     int rhsValues(double *rvals);
 
+    /**
+     * Set the power flowing out of the bus through attached branches. This
+     * is used when the branch sums are evaluated for the whole network at
+     * once (see PFFactoryModule::evaluateInjections). The next call to
+     * rhsValues uses these values instead of calling getPQ on each attached
+     * branch
+     * @param P real power flowing out through branches
+     * @param Q reactive power flowing out through branches
+     */
+    void setBranchInjection(double P, double Q);
+
+    /**
+     * Get the power flowing out of the bus through attached branches, if it
+     * has been set with setBranchInjection and not yet used by rhsValues
+     * @param P real power flowing out through branches
+     * @param Q reactive power flowing out through branches
+     * @return false if no values are pending
+     */
+    bool getBranchInjection(double *P, double *Q) const;
+
     /**
      * Push p_isPV values from exchange buffer to p_isPV variable
      */
@@ -377,6 +412,9 @@ class PFBus
     std::vector<std::string> p_lid;
     double p_sbase;
     double p_Pinj, p_Qinj;
+    // branch sums set by setBranchInjection, used once by rhsValues
+    double p_branchP, p_branchQ;
+    bool p_branchSet;
     double p_vmin, p_vmax;
     bool p_isPV, p_saveisPV, p_save2isPV;
     bool *p_PV_ptr;
@@ -504,6 +542,24 @@ class PFBranch
      */
     void getPQ(PFBus *bus, double *p, double *q);
 
+    /**
+     * Return the off-diagonal admittances used by getPQ and the Jacobian
+     * @param yr_frwd, yi_frwd: real and imaginary parts of forward admittance
+     * @param yr_rvrs, yi_rvrs: real and imaginary parts of reverse admittance
+     */
+    void getPQAdmittance(double *yr_frwd, double *yi_frwd,
+        double *yr_rvrs, double *yi_rvrs) const;
+
+    /**
+     * Set the phase angle difference across the branch, together with its
+     * cosine and sine, if these have been evaluated outside the component.
+     * The off-diagonal Jacobian blocks use these values until the next call
+     * to getPQ
+     * @param theta: phase angle of bus 1 minus phase angle of bus 2
+     * @param cs, sn: cosine and sine of theta
+     */
+    void setPhaseDifference(double theta, double cs, double sn);
+
     /**
      * Set the mode to control what matrices and vectors are built when using
      * the mapper
@@ -607,6 +663,8 @@ class PFBranch
     double p_ybusr_frwd, p_ybusi_frwd;
     double p_ybusr_rvrs, p_ybusi_rvrs;
     double p_theta;
+    // cosine and sine of p_theta
+    double p_cs, p_sn;
     double p_sbase;
     int p_elems;
     bool p_active;
@@ -637,7 +695,7 @@ private:
       & p_mode
       & p_ybusr_frwd & p_ybusi_frwd
       & p_ybusr_rvrs & p_ybusi_rvrs
-      & p_theta
+      & p_theta & p_cs & p_sn
       & p_sbase
       & p_elems
       & p_active;
@@ -141,6 +141,113 @@ std::vector<gridpack::powerflow::Contingency>
   return ret;
 }
 
+/**
+ * Append an int to a packed buffer
+ */
+static void packInt(std::vector<char> &buf, int ival)
+{
+  const char *ptr = reinterpret_cast<const char*>(&ival);
+  buf.insert(buf.end(), ptr, ptr+sizeof(int));
+}
+
+/**
+ * Append a string to a packed buffer
+ */
+static void packString(std::vector<char> &buf, const std::string &str)
+{
+  packInt(buf, static_cast<int>(str.size()));
+  buf.insert(buf.end(), str.begin(), str.end());
+}
+
+/**
+ * Read an int from a packed buffer and advance the position
+ */
+static int unpackInt(const char *buf, int len, int &pos)
+{
+  int ival;
+  if (pos+static_cast<int>(sizeof(int)) > len) {
+    char sbuf[256];
+    sprintf(sbuf,"CADriver::unpackContingency: corrupt contingency buffer\n");
+    throw gridpack::Exception(sbuf);
+  }
+  memcpy(&ival, buf+pos, sizeof(int));
+  pos += sizeof(int);
+  return ival;
+}
+
+/**
+ * Read a string from a packed buffer and advance the position
+ */
+static std::string unpackString(const char *buf, int len, int &pos)
+{
+  int slen = unpackInt(buf, len, pos);
+  if (slen < 0 || pos+slen > len) {
+    char sbuf[256];
+    sprintf(sbuf,"CADriver::unpackContingency: corrupt contingency buffer\n");
+    throw gridpack::Exception(sbuf);
+  }
+  std::string ret(buf+pos, slen);
+  pos += slen;
+  return ret;
+}
+
+/**
+ * Pack a contingency into a contiguous buffer so that it can be kept
+ * in a NodeStore
+ * @param event contingency
+ * @param buf buffer containing packed contingency
+ */
+void gridpack::contingency_analysis::CADriver::packContingency(
+    const gridpack::powerflow::Contingency &event, std::vector<char> &buf)
+{
+  buf.clear();
+  packInt(buf, event.p_type);
+  packString(buf, event.p_name);
+  int i;
+  int nlines = event.p_from.size();
+  packInt(buf, nlines);
+  for (i=0; i<nlines; i++) {
+    packInt(buf, event.p_from[i]);
+    packInt(buf, event.p_to[i]);
+    packString(buf, event.p_ckt[i]);
+  }
+  int ngen = event.p_busid.size();
+  packInt(buf, ngen);
+  for (i=0; i<ngen; i++) {
+    packInt(buf, event.p_busid[i]);
+    packString(buf, event.p_genid[i]);
+  }
+}
+
+/**
+ * Unpack a contingency from a buffer created by packContingency
+ * @param buf pointer to packed contingency
+ * @param len length of buffer
+ * @param event contingency
+ */
+void gridpack::contingency_analysis::CADriver::unpackContingency(
+    const char *buf, int len, gridpack::powerflow::Contingency &event)
+{
+  event = gridpack::powerflow::Contingency();
+  int pos = 0;
+  event.p_type = unpackInt(buf, len, pos);
+  event.p_name = unpackString(buf, len, pos);
+  int i;
+  int nlines = unpackInt(buf, len, pos);
+  for (i=0; i<nlines; i++) {
+    event.p_from.push_back(unpackInt(buf, len, pos));
+    event.p_to.push_back(unpackInt(buf, len, pos));
+    event.p_ckt.push_back(unpackString(buf, len, pos));
+    event.p_saveLineStatus.push_back(true);
+  }
+  int ngen = unpackInt(buf, len, pos);
+  for (i=0; i<ngen; i++) {
+    event.p_busid.push_back(unpackInt(buf, len, pos));
+    event.p_genid.push_back(unpackString(buf, len, pos));
+    event.p_saveGenStatus.push_back(true);
+  }
+}
+
 /**
  * Execute application. argc and argv are standard runtime parameters
  */
@@ -221,8 +328,10 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   gridpack::powerflow::PFAppModule pf_app;
   // Read in the network from an external file and partition it over the
   // processors in the task communicator. This will read in power flow
-  // parameters from the Powerflow block in the input
-  pf_app.readNetwork(pf_network,config);
+  // parameters from the Powerflow block in the input. The network is only
+  // read and partitioned by one task communicator and then copied to the
+  // others
+  pf_app.readNetwork(pf_network,config,world);
   // Finish initializing the network
   pf_app.initialize();
   //  Set minimum and maximum voltage limits on all buses
@@ -253,10 +362,23 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
       "ContingencyList.Contingency_analysis.Contingencies");
   gridpack::utility::Configuration::ChildCursors contingencies;
   if (cursor) cursor->children(contingencies);
-  std::vector<gridpack::powerflow::Contingency>
-    events = getContingencies(contingencies);
+  // The contingency list is only built on process 0. It is then copied into
+  // a NodeStore so that there is only one copy of the list on each node,
+  // instead of one on every process
+  std::vector<gridpack::powerflow::Contingency> events;
+  if (world.rank() == 0) events = getContingencies(contingencies);
+  gridpack::parallel::NodeStore<char> event_store(world);
+  if (world.rank() == 0) {
+    std::vector<char> buf;
+    int idx;
+    for (idx = 0; idx < events.size(); idx++) {
+      packContingency(events[idx], buf);
+      event_store.addVector(idx, buf);
+    }
+  }
+  event_store.upload();
   // Contingencies are now available. Print out a list of contingencies from
-  // process 0 (the list is replicated on all processors)
+  // process 0
   if (world.rank() == 0) {
     int idx;
     for (idx = 0; idx < events.size(); idx++) {
@@ -279,12 +401,13 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
       }
     }
   }
+  events.clear();
 
 
   // Set up task manager on the world communicator. The number of tasks is
   // equal to the number of contingencies
   gridpack::parallel::TaskManager taskmgr(world);
-  int ntasks = events.size();
+  int ntasks = event_store.numVectors();
   taskmgr.set(ntasks);
 
   int nbus = pf_network->totalBuses();
@@ -456,9 +579,13 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   char sbuf[128];
   // nextTask returns the same task_id on all processors in task_comm. When the
   // calculation runs out of task, nextTask will return false.
+  gridpack::powerflow::Contingency event;
   while (taskmgr.nextTask(task_comm, &task_id)) {
     printf("Executing task %d on process %d\n",task_id,world.rank());
-    sprintf(sbuf,"%s.out",events[task_id].p_name.c_str());
+    // Get a private copy of the contingency from the shared list
+    unpackContingency(event_store.getData(task_id),
+        event_store.getSize(task_id), event);
+    sprintf(sbuf,"%s.out",event.p_name.c_str());
     // Open a new file, based on the contingency name, to store results from
     // this particular contingency calculation
     if (print_calcs) pf_app.open(sbuf);
@@ -466,34 +593,34 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
     // information on the contingency
     sprintf(sbuf,"\nRunning task on %d processes\n",task_comm.size());
     if (print_calcs) pf_app.writeHeader(sbuf);
-    if (events[task_id].p_type == Branch) {
-      int nlines = events[task_id].p_from.size();
+    if (event.p_type == Branch) {
+      int nlines = event.p_from.size();
       int j;
       for (j=0; j<nlines; j++) {
         sprintf(sbuf," Line: (from) %d (to) %d (line) \'%s\'\n",
-            events[task_id].p_from[j],events[task_id].p_to[j],
-            events[task_id].p_ckt[j].c_str());
+            event.p_from[j],event.p_to[j],
+            event.p_ckt[j].c_str());
         printf("p[%d] Line: (from) %d (to) %d (line) \'%s\'\n",
             pf_network->communicator().rank(),
-            events[task_id].p_from[j],events[task_id].p_to[j],
-            events[task_id].p_ckt[j].c_str());
+            event.p_from[j],event.p_to[j],
+            event.p_ckt[j].c_str());
       }
-    } else if (events[task_id].p_type == Generator) {
-      int nbus = events[task_id].p_busid.size();
+    } else if (event.p_type == Generator) {
+      int nbus = event.p_busid.size();
       int j;
       for (j=0; j<nbus; j++) {
         sprintf(sbuf," Generator: (bus) %d (generator ID) \'%s\'\n",
-            events[task_id].p_busid[j],events[task_id].p_genid[j].c_str());
+            event.p_busid[j],event.p_genid[j].c_str());
         printf("p[%d] Generator: (bus) %d (generator ID) \'%s\'\n",
             pf_network->communicator().rank(),
-            events[task_id].p_busid[j],events[task_id].p_genid[j].c_str());
+            event.p_busid[j],event.p_genid[j].c_str());
       }
     }
     if (print_calcs) pf_app.writeHeader(sbuf);
     // Reset all voltages back to their original values
     pf_app.resetVoltages();
     // Set contingency
-    pf_app.setContingency(events[task_id]);
+    pf_app.setContingency(event);
     // Solve power flow equations for this system
 #ifdef USE_SUCCESS
     contingency_idx.push_back(task_id);
@@ -505,29 +632,34 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
       if (check_Qlim && !pf_app.checkQlimViolations()) {
         pf_app.solve();
       }
+      // Check for violations. The audit is started before writing out
+      // voltages and currents so that its reduction overlaps the output
+      pf_app.startViolationAudit(gridpack::powerflow::AUDIT_VOLTAGE |
+          gridpack::powerflow::AUDIT_LINE_OVERLOAD);
       // If power flow solution is successful, write out voltages and currents
       if (print_calcs) pf_app.write();
-      // Check for violations
-      bool ok1 = pf_app.checkVoltageViolations();
-      bool ok2 = pf_app.checkLineOverloadViolations();
+      gridpack::powerflow::PFViolationAudit audit =
+        pf_app.finishViolationAudit();
+      bool ok1 = audit.voltageOK;
+      bool ok2 = audit.lineOK;
       bool ok = ok1 && ok2;
       // Include results of violation checks in output
       if (ok) {
         sprintf(sbuf,"\nNo violation for contingency %s\n",
-            events[task_id].p_name.c_str());
+            event.p_name.c_str());
 #ifdef USE_SUCCESS
         contingency_violation.push_back(1);
 #endif
       } 
       if (!ok1) {
         sprintf(sbuf,"\nBus Violation for contingency %s\n",
-            events[task_id].p_name.c_str());
+            event.p_name.c_str());
       }
       if (print_calcs) pf_app.print(sbuf);
       if (print_calcs) pf_app.writeCABus();
       if (!ok2) {
         sprintf(sbuf,"\nBranch Violation for contingency %s\n",
-            events[task_id].p_name.c_str());
+            event.p_name.c_str());
       }
 
 #ifdef USE_SUCCESS
@@ -644,7 +776,7 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
       contingency_violation.push_back(0);
 #endif
       sprintf(sbuf,"\nDivergent for contingency %s\n",
-          events[task_id].p_name.c_str());
+          event.p_name.c_str());
       if (print_calcs) pf_app.print(sbuf);
       // Add dummy values to StatBlock object. Mask value is set to 0 for all
       // network elements to indicate calculation failure
@@ -734,7 +866,7 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
 #endif
     } 
     // Return network to its original base case state
-    pf_app.unSetContingency(events[task_id]);
+    pf_app.unSetContingency(event);
     // Close output file for this contingency
     if (print_calcs) pf_app.close();
   }
@@ -75,6 +75,24 @@ class CADriver
     void execute(int argc, char** argv);
 
     private:
+
+    /**
+     * Pack a contingency into a contiguous buffer so that it can be kept
+     * in a NodeStore
+     * @param event contingency
+     * @param buf buffer containing packed contingency
+     */
+    void packContingency(const gridpack::powerflow::Contingency &event,
+        std::vector<char> &buf);
+
+    /**
+     * Unpack a contingency from a buffer created by packContingency
+     * @param buf pointer to packed contingency
+     * @param len length of buffer
+     * @param event contingency
+     */
+    void unpackContingency(const char *buf, int len,
+        gridpack::powerflow::Contingency &event);
 };
 
 } // contingency analysis 
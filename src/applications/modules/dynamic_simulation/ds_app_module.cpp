@@ -30,6 +30,7 @@
 gridpack::dynamic_simulation_r::DSAppModule::DSAppModule(void)
 {
   p_generatorWatch = false;
+  p_kronBlockSize = 0;
 }
 
 /**
@@ -76,6 +77,7 @@ void gridpack::dynamic_simulation_r::DSAppModule::readNetwork(
   if (p_time_step == 0.0) {
     // TODO: some kind of error
   }
+  p_kronBlockSize = cursor->get("kronBlockSize",0);
 
   // load input file
   gridpack::parser::PTI23_parser<DSNetwork> parser(network);
@@ -187,6 +189,7 @@ void gridpack::dynamic_simulation_r::DSAppModule::setNetwork(
   if (p_time_step == 0.0) {
     // TODO: some kind of error
   }
+  p_kronBlockSize = cursor->get("kronBlockSize",0);
 
   // Create serial IO object to export data from buses or branches
   p_busIO.reset(new gridpack::serial_io::SerialBusIO<DSNetwork>(2048, network));
@@ -811,7 +814,6 @@ void gridpack::dynamic_simulation_r::DSAppModule::solve(
   boost::shared_ptr<gridpack::math::Matrix> Y_a(gridpack::math::storageType(*diagY_a, denseType));
   timer->stop(t_matset);
 
-  int t_matmul = timer->createCategory("Matrix Multiply");
   // Construct Y_c as a dense matrix
   timer->start(t_matset);
   p_factory->setMode(YC);
@@ -829,51 +831,35 @@ void gridpack::dynamic_simulation_r::DSAppModule::solve(
   boost::shared_ptr<gridpack::math::Matrix> prefy11ybus = ybusMap.mapToMatrix();
   timer->stop(t_matset);
 
-  // Solve linear equations ybus * X = Y_c
+  // Reduce the network onto the generator internal buses. The ordering
+  // and symbolic factorization of prefy11ybus are reused for the fault-on
+  // and post-fault networks, which have the same nonzero pattern
   int t_solve = timer->createCategory("Solve Linear Equation");
-  timer->start(t_solve);
-  gridpack::math::LinearMatrixSolver solver1(*prefy11ybus);
-  boost::shared_ptr<gridpack::math::Matrix> prefy11X(solver1.solve(*Y_cDense));
-  timer->stop(t_solve);
-  
+  gridpack::math::KronReduction kron(*Y_a, *Y_b, *Y_cDense, p_kronBlockSize);
+
   //-----------------------------------------------------------------------
   // Compute prefy11
   //-----------------------------------------------------------------------
-  // Form reduced admittance matrix prefy11: prefy11 = Y_b * X
-  timer->start(t_matmul);
-  boost::shared_ptr<gridpack::math::Matrix> prefy11(multiply(*Y_b, *prefy11X)); 
-  timer->stop(t_matmul);
-  // Update prefy11: prefy11 = Y_a + prefy11
-  prefy11->add(*Y_a);
+  // prefy11 = Y_a + Y_b * prefy11ybus^-1 * Y_c
+  timer->start(t_solve);
+  boost::shared_ptr<gridpack::math::Matrix> prefy11(kron.reduce(*prefy11ybus));
+  timer->stop(t_solve);
 
   //-----------------------------------------------------------------------
   // Compute fy11
   // Update ybus values at beginning of fault
   //-----------------------------------------------------------------------
-  // Read the switch info from fault. Event from input.xml
-  int sw2_2 = fault.from_idx - 1;
-  int sw3_2 = fault.to_idx - 1;
-
   boost::shared_ptr<gridpack::math::Matrix> fy11ybus(prefy11ybus->clone());
-  gridpack::ComplexType x(0.0, -1e7);
   timer->start(t_matset);
   p_factory->setEvent(fault);
   p_factory->setMode(onFY);
   ybusMap.overwriteMatrix(fy11ybus);
   timer->stop(t_matset);
 
-  // Solve linear equations of fy11ybus * X = Y_c
+  // fy11 = Y_a + Y_b * fy11ybus^-1 * Y_c
   timer->start(t_solve);
-  gridpack::math::LinearMatrixSolver solver2(*fy11ybus);
-  boost::shared_ptr<gridpack::math::Matrix> fy11X(solver2.solve(*Y_cDense)); 
+  boost::shared_ptr<gridpack::math::Matrix> fy11(kron.reduce(*fy11ybus));
   timer->stop(t_solve);
-  
-  // Form reduced admittance matrix fy11: fy11 = Y_b * X
-  timer->start(t_matmul);
-  boost::shared_ptr<gridpack::math::Matrix> fy11(multiply(*Y_b, *fy11X)); 
-  timer->stop(t_matmul);
-  // Update fy11: fy11 = Y_a + fy11
-  fy11->add(*Y_a);
 
   //-----------------------------------------------------------------------
   // Compute posfy11
@@ -882,24 +868,14 @@ void gridpack::dynamic_simulation_r::DSAppModule::solve(
   // Get the updating factor for posfy11 stage ybus
   timer->start(t_matset);
   boost::shared_ptr<gridpack::math::Matrix> posfy11ybus(prefy11ybus->clone());
-  timer->stop(t_matset);
-  timer->start(t_matset);
   p_factory->setMode(posFY);
   ybusMap.incrementMatrix(posfy11ybus);
   timer->stop(t_matset);
-    
-  // Solve linear equations of posfy11ybus * X = Y_c
+
+  // posfy11 = Y_a + Y_b * posfy11ybus^-1 * Y_c
   timer->start(t_solve);
-  gridpack::math::LinearMatrixSolver solver3(*posfy11ybus);
-  boost::shared_ptr<gridpack::math::Matrix> posfy11X(solver3.solve(*Y_cDense)); 
+  boost::shared_ptr<gridpack::math::Matrix> posfy11(kron.reduce(*posfy11ybus));
   timer->stop(t_solve);
-  
-  // Form reduced admittance matrix posfy11: posfy11 = Y_b * X
-  timer->start(t_matmul);
-  boost::shared_ptr<gridpack::math::Matrix> posfy11(multiply(*Y_b, *posfy11X)); 
-  timer->stop(t_matmul);
-  // Update posfy11: posfy11 = Y_a + posfy11
-  posfy11->add(*Y_a);
 
   //-----------------------------------------------------------------------
   // Integration implementation (Modified Euler Method)
@@ -133,6 +133,10 @@ class DSAppModule
     // Time step
     double p_time_step;
 
+    // Number of generator columns solved at once in the Kron reduction
+    // (0 solves all columns at once)
+    int p_kronBlockSize;
+
     // Current step count?
     int p_S_Steps;
 
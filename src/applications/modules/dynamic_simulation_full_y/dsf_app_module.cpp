@@ -37,6 +37,7 @@ gridpack::dynamic_simulation::DSFullApp::DSFullApp(void)
   p_generatorWatch = false;
   p_loadWatch = false;
   p_generators_read_in = false;
+  p_save_time_series = false;
 }
 
 /**
@@ -49,6 +50,7 @@ gridpack::dynamic_simulation::DSFullApp::DSFullApp(gridpack::parallel::Communica
   p_generatorWatch = false;
   p_loadWatch = false;
   p_generators_read_in = false;
+  p_save_time_series = false;
 }
 
 /**
@@ -177,6 +179,72 @@ void gridpack::dynamic_simulation::DSFullApp::readGenerators(void)
   printf("p[%d] generatorParameters: %s\n",p_comm.rank(),filename.c_str());
   if (filename.size() > 0) parser.externalParse(filename.c_str());
   printf("p[%d] finished Generator parameters\n",p_comm.rank());
+  bool balance = cursor->get("balanceDynamicLoad",false);
+  if (balance) balanceLoad();
+}
+
+/**
+ * Estimate the cost of integrating the devices on each bus and
+ * repartition the network so that this cost is evenly distributed
+ * across processors. Buses with many or detailed generators, exciters,
+ * governors and dynamic loads are much more expensive than plain
+ * network buses, so a partition based on bus count alone can be badly
+ * unbalanced for dynamic simulation. This must be called after
+ * readGenerators and before initialize. The imbalance before and after
+ * repartitioning is printed if reportLoadImbalance is set in the input
+ * file
+ */
+void gridpack::dynamic_simulation::DSFullApp::balanceLoad()
+{
+  int nbus = p_network->numBuses();
+  int i, j;
+  for (i=0; i<nbus; i++) {
+    gridpack::component::DataCollection *data
+      = p_network->getBusData(i).get();
+    int weight = 1;
+    int ngen = 0;
+    if (data->getValue(GENERATOR_NUMBER, &ngen)) {
+      for (j=0; j<ngen; j++) {
+        std::string model;
+        if (!data->getValue(GENERATOR_MODEL, &model, j)) continue;
+        // Classical machine model has only two states, all other
+        // machine models are considerably more expensive
+        if (model == "GENCLS") {
+          weight += 1;
+        } else {
+          weight += 4;
+        }
+        bool flag = false;
+        if (data->getValue(HAS_EXCITER, &flag, j) && flag) weight += 3;
+        flag = false;
+        if (data->getValue(HAS_GOVERNOR, &flag, j) && flag) weight += 3;
+      }
+    }
+    int nload = 0;
+    if (data->getValue(LOAD_NUMBER, &nload)) {
+      for (j=0; j<nload; j++) {
+        std::string model;
+        if (data->getValue(LOAD_MODEL, &model, j)) weight += 2;
+      }
+    }
+    p_network->setBusWeight(i,weight);
+  }
+  // Only report the imbalance if it was asked for in the input file
+  gridpack::utility::Configuration::CursorPtr cursor;
+  cursor = p_config->getCursor("Configuration.Dynamic_simulation");
+  bool report = cursor->get("reportLoadImbalance",false);
+  double imbalance = 0.0;
+  if (report) imbalance = p_network->loadImbalance();
+  if (report && p_comm.rank() == 0) {
+    printf("Dynamic simulation load imbalance before repartitioning: %f\n",
+        imbalance);
+  }
+  int moved = p_network->repartition();
+  if (report) imbalance = p_network->loadImbalance();
+  if (report && p_comm.rank() == 0) {
+    printf("Dynamic simulation load imbalance after repartitioning: %f"
+        " (%d buses moved)\n", imbalance, moved);
+  }
 }
 
 /**
@@ -1136,14 +1204,20 @@ void gridpack::dynamic_simulation::DSFullApp::setGeneratorWatch()
   // If storing time series data, set up vector to hold results
   openGeneratorWatchFile();
   if (p_save_time_series) {
-    p_time_series.clear();
     printf("p_gen_buses: %d\n",(int)p_gen_buses.size());
-    for (i=0; i<p_gen_buses.size(); i++) {
-      std::vector<double> vec0;
-      p_time_series.push_back(vec0);
-      std::vector<double> vec1;
-      p_time_series.push_back(vec1);
+    // Size store from simulation length. The fault-on interval may use a
+    // smaller time step, in which case the store grows automatically.
+    int nsteps = 1;
+    if (p_time_step > 0.0) {
+      nsteps = static_cast<int>(p_sim_time/p_time_step) + 2;
     }
+    int decimation;
+    cursor = p_config->getCursor("Configuration.Dynamic_simulation");
+    if (!cursor->get("timeSeriesDecimation",&decimation)) {
+      decimation = 1;
+    }
+    p_time_series.allocate(2*p_gen_buses.size(),nsteps,decimation);
+    p_time_step_buf.reserve(2*p_gen_buses.size());
   }
 }
 
@@ -1212,9 +1286,13 @@ void gridpack::dynamic_simulation::DSFullApp::saveTimeSeries(bool flag)
 void gridpack::dynamic_simulation::DSFullApp::saveTimeStep()
 {
   if (!p_save_time_series) return;
+  if (!p_time_series.nextStepStored()) {
+    p_time_series.saveStep(NULL,0);
+    return;
+  }
   int nbus = p_gen_buses.size();
   int i, j;
-  int icnt = 0;
+  p_time_step_buf.clear();
   gridpack::dynamic_simulation::DSFullBus *bus;
   for (i=0; i<nbus; i++) {
     if (p_network->getActiveBus(p_gen_buses[i])) {
@@ -1222,11 +1300,15 @@ void gridpack::dynamic_simulation::DSFullApp::saveTimeStep()
         (p_network->getBus(p_gen_buses[i]).get());
       std::vector<double> vals = bus->getWatchedValues();
       for (j=0; j<vals.size(); j++) {
-        p_time_series[icnt].push_back(vals[j]);
-        icnt++;
+        p_time_step_buf.push_back(vals[j]);
       }
     }
   }
+  if (p_time_step_buf.size() > 0) {
+    p_time_series.saveStep(&p_time_step_buf[0],p_time_step_buf.size());
+  } else {
+    p_time_series.saveStep(NULL,0);
+  }
 }
 
 /**
@@ -1296,20 +1378,39 @@ std::vector<std::vector<double> > gridpack::dynamic_simulation::DSFullApp::getGe
 {
   std::vector<std::vector<double> > ret;
   if (p_save_time_series) {
-    int ngen = p_time_series.size();
-    int i, j;
+    int ngen = p_time_series.numSeries();
+    int i;
+    ret.resize(ngen);
     for (i=0; i<ngen; i++) {
-      std::vector<double> series;
-      int nsteps = (p_time_series[i]).size();
-      for (j=0; j<nsteps; j++) {
-        series.push_back((p_time_series[i])[j]);
-      }
-      ret.push_back(series);
+      p_time_series.copySeries(i,ret[i]);
     }
   }
   return ret;
 }
 
+/**
+ * Return a view of a single time series for watched generators. The
+ * view points directly into internal storage so no data is copied.
+ * @param idx local index of time series
+ * @return view of time series
+ */
+gridpack::dynamic_simulation::TimeSeriesView
+gridpack::dynamic_simulation::DSFullApp::getGeneratorTimeSeriesView(int idx) const
+{
+  return p_time_series.series(idx);
+}
+
+/**
+ * Return store holding all time series for watched generators on this
+ * processor
+ * @return reference to internal time series store
+ */
+const gridpack::dynamic_simulation::TimeSeriesStore&
+gridpack::dynamic_simulation::DSFullApp::getGeneratorTimeSeriesStore() const
+{
+  return p_time_series;
+}
+
 /**
  * Redirect output from standard out
  * @param filename name of file to write results to
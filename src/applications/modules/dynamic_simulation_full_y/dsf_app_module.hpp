@@ -22,6 +22,7 @@
 #include "gridpack/configuration/configuration.hpp"
 #include "gridpack/serial_io/serial_io.hpp"
 #include "dsf_factory.hpp"
+#include "time_series_store.hpp"
 
 
 namespace gridpack {
@@ -78,6 +79,15 @@ class DSFullApp
      */
     void readGenerators(void);
 
+    /**
+     * Estimate the cost of the devices on each bus and repartition the
+     * network to balance this cost across processors. This is called
+     * from readGenerators if balanceDynamicLoad is set in the input file.
+     * The load imbalance before and after is only printed if
+     * reportLoadImbalance is also set
+     */
+    void balanceLoad(void);
+
     /**
      * Set up exchange buffers and other internal parameters and initialize
      * network components using data from data collection
@@ -157,6 +167,22 @@ class DSFullApp
      */
     std::vector<std::vector<double> > getGeneratorTimeSeries();
 
+    /**
+     * Return a view of a single time series for watched generators. The
+     * view points directly into internal storage so no data is copied. It
+     * remains valid until the generator watch list is reset.
+     * @param idx local index of time series
+     * @return view of time series
+     */
+    TimeSeriesView getGeneratorTimeSeriesView(int idx) const;
+
+    /**
+     * Return store holding all time series for watched generators on this
+     * processor
+     * @return reference to internal time series store
+     */
+    const TimeSeriesStore& getGeneratorTimeSeriesStore() const;
+
     /**
      * Return a list of original bus IDs and tags for all monitored
      * generators
@@ -288,8 +314,11 @@ class DSFullApp
    // Flag to save time series
    bool p_save_time_series;
 
-   // Vector of times series from watched generators
-   std::vector<std::vector<double> > p_time_series;
+   // Time series from watched generators
+   TimeSeriesStore p_time_series;
+
+   // Buffer used to collect watched values for a single time step
+   std::vector<double> p_time_step_buf;
 };
 
 } // dynamic simulation
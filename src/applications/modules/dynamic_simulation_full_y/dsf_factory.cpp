@@ -375,7 +375,7 @@ void gridpack::dynamic_simulation::DSFullFactory::setExtendedCmplBusVoltage()
 
   // Invoke updateDSVect method on all bus objects
   for (i=0; i<p_numBus; i++) {
-    dynamic_cast<gridpack::dynamic_simulation::DSFullBus*>(p_buses[i])->setExtendedCmplBusVoltage(p_network->getBusData(i));
+    buses()[i]->setExtendedCmplBusVoltage(p_network->getBusData(i));
   }
 	
 }
@@ -389,7 +389,7 @@ void gridpack::dynamic_simulation::DSFullFactory::LoadExtendedCmplBus()
 
   // Invoke updateDSVect method on all bus objects
   for (i=0; i<p_numBus; i++) {
-    dynamic_cast<gridpack::dynamic_simulation::DSFullBus*>(p_buses[i])->LoadExtendedCmplBus(p_network->getBusData(i));
+    buses()[i]->LoadExtendedCmplBus(p_network->getBusData(i));
   }
 	
 }
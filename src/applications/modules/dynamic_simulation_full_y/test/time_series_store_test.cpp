@@ -0,0 +1,204 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   time_series_store_test.cpp
+ * @date   2026-10-19
+ *
+ * @brief  Check decimation, growth and compression in TimeSeriesStore
+ */
+// -------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+#include "time_series_store.hpp"
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+using gridpack::dynamic_simulation::TimeSeriesStore;
+using gridpack::dynamic_simulation::TimeSeriesView;
+
+/**
+ * Value of series s at call number step
+ */
+static double stepValue(int s, int step)
+{
+  return 100.0*static_cast<double>(s+1)+static_cast<double>(step)/8.0;
+}
+
+/**
+ * Check that series s holds the values saved on calls 0, decimation,
+ * 2*decimation, ...
+ */
+static bool checkSeries(const TimeSeriesStore &store, int s, int nsteps)
+{
+  TimeSeriesView view = store.series(s);
+  if (view.size() != nsteps) return false;
+  if (view.end()-view.begin() != nsteps) return false;
+  int i;
+  for (i=0; i<nsteps; i++) {
+    if (view[i] != stepValue(s, i*store.decimation())) return false;
+  }
+  return true;
+}
+
+/**
+ * Check that compressing series s and decompressing it gives back exactly
+ * the same bits
+ */
+static bool roundTrip(const TimeSeriesStore &store, int s)
+{
+  std::vector<unsigned char> buf;
+  store.compressSeries(s, buf);
+  std::vector<double> vec;
+  TimeSeriesStore::decompressSeries(buf, vec);
+  TimeSeriesView view = store.series(s);
+  if (static_cast<int>(vec.size()) != view.size()) return false;
+  if (vec.size() == 0) return true;
+  return memcmp(&vec[0], view.begin(), vec.size()*sizeof(double)) == 0;
+}
+
+BOOST_AUTO_TEST_SUITE(TimeSeriesStoreTest)
+
+BOOST_AUTO_TEST_CASE(Decimation)
+{
+  // 10 calls with decimation 3 keep calls 0, 3, 6 and 9
+  TimeSeriesStore store;
+  store.allocate(3, 10, 3);
+  BOOST_CHECK_EQUAL(store.numSeries(), 3);
+  BOOST_CHECK_EQUAL(store.decimation(), 3);
+  int step;
+  for (step=0; step<10; step++) {
+    double vals[3];
+    int s;
+    for (s=0; s<3; s++) vals[s] = stepValue(s, step);
+    BOOST_CHECK_EQUAL(store.nextStepStored(), step%3 == 0);
+    BOOST_CHECK_EQUAL(store.saveStep(vals, 3), step%3 == 0);
+  }
+  BOOST_CHECK_EQUAL(store.numSteps(), 4);
+  int s;
+  for (s=0; s<3; s++) BOOST_CHECK(checkSeries(store, s, 4));
+
+  // Missing values are set to zero and extra values are ignored
+  store.allocate(2, 2);
+  double vals[3] = {1.0, 2.0, 3.0};
+  store.saveStep(vals, 1);
+  store.saveStep(vals, 3);
+  std::vector<double> vec;
+  store.copySeries(1, vec);
+  BOOST_REQUIRE_EQUAL(vec.size(), 2);
+  BOOST_CHECK_EQUAL(vec[0], 0.0);
+  BOOST_CHECK_EQUAL(vec[1], 2.0);
+
+  BOOST_CHECK_THROW(store.series(2), gridpack::Exception);
+  BOOST_CHECK_THROW(store.series(-1), gridpack::Exception);
+  BOOST_CHECK_THROW(store.allocate(-1, 2), gridpack::Exception);
+}
+
+BOOST_AUTO_TEST_CASE(Growth)
+{
+  // Preallocate 4 steps and save well past that
+  TimeSeriesStore store;
+  store.allocate(3, 4);
+  double vals[3];
+  int step, s;
+  for (step=0; step<4; step++) {
+    for (s=0; s<3; s++) vals[s] = stepValue(s, step);
+    store.saveStep(vals, 3);
+  }
+  TimeSeriesView before = store.series(1);
+  BOOST_CHECK(checkSeries(store, 1, 4));
+
+  for (step=4; step<37; step++) {
+    for (s=0; s<3; s++) vals[s] = stepValue(s, step);
+    store.saveStep(vals, 3);
+  }
+  BOOST_CHECK_EQUAL(store.numSteps(), 37);
+  for (s=0; s<3; s++) BOOST_CHECK(checkSeries(store, s, 37));
+
+  // Views taken before the store grew point at the released block and
+  // must be fetched again
+  TimeSeriesView after = store.series(1);
+  BOOST_CHECK(before.begin() != after.begin());
+  BOOST_CHECK_EQUAL(before.size(), 4);
+  BOOST_CHECK_EQUAL(after.size(), 37);
+
+  // Clearing releases everything
+  store.clear();
+  BOOST_CHECK_EQUAL(store.numSeries(), 0);
+  BOOST_CHECK_EQUAL(store.numSteps(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Compression)
+{
+  // A smooth series, a series of special values and a series that changes
+  // in every bit, plus an empty store
+  static const int nsteps = 200;
+  TimeSeriesStore store;
+  store.allocate(3, nsteps);
+  double special[] = {0.0, -0.0, 1.0, 1.0,
+    std::numeric_limits<double>::infinity(),
+    -std::numeric_limits<double>::infinity(),
+    std::numeric_limits<double>::quiet_NaN(),
+    std::numeric_limits<double>::denorm_min(),
+    std::numeric_limits<double>::max(),
+    -std::numeric_limits<double>::min()};
+  int nspecial = sizeof(special)/sizeof(double);
+  unsigned long long bits = 0x0123456789abcdefULL;
+  int step;
+  for (step=0; step<nsteps; step++) {
+    double vals[3];
+    vals[0] = 1.0+1.0e-4*sin(0.01*static_cast<double>(step));
+    vals[1] = special[step%nspecial];
+    bits = ~(bits*6364136223846793005ULL+1442695040888963407ULL);
+    memcpy(&vals[2], &bits, sizeof(double));
+    store.saveStep(vals, 3);
+  }
+  int s;
+  for (s=0; s<3; s++) BOOST_CHECK(roundTrip(store, s));
+
+  // The smooth series is stored in less space than the raw values
+  std::vector<unsigned char> buf;
+  store.compressSeries(0, buf);
+  BOOST_CHECK(buf.size() < nsteps*sizeof(double));
+
+  TimeSeriesStore empty;
+  empty.allocate(1, 10);
+  BOOST_CHECK(roundTrip(empty, 0));
+
+  // Truncated buffers are rejected
+  store.compressSeries(2, buf);
+  buf.resize(buf.size()-1);
+  std::vector<double> vec;
+  BOOST_CHECK_THROW(TimeSeriesStore::decompressSeries(buf, vec),
+      gridpack::Exception);
+  buf.assign(1, 9);
+  BOOST_CHECK_THROW(TimeSeriesStore::decompressSeries(buf, vec),
+      gridpack::Exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_function()
+{
+  return true;
+}
+
+// -------------------------------------------------------------
+//  Main Program
+// -------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+  int result = ::boost::unit_test::unit_test_main( &init_function, argc, argv );
+  return result;
+}
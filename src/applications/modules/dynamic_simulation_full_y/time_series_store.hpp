@@ -0,0 +1,346 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   time_series_store.hpp
+ * @date   2026-10-19
+ *
+ * @brief
+ * Compact columnar storage for time series data collected from watched
+ * generators. All series are held in a single preallocated block, one
+ * contiguous column per series, so that consumers can read a series in
+ * place without copying it. Watched loads are still only written to the
+ * load watch file.
+ */
+// -------------------------------------------------------------
+
+#ifndef _time_series_store_hpp_
+#define _time_series_store_hpp_
+
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include "gridpack/utilities/exception.hpp"
+
+namespace gridpack {
+namespace dynamic_simulation {
+
+// -------------------------------------------------------------
+//  class TimeSeriesView
+// -------------------------------------------------------------
+/**
+ * Read-only view of a single series in a TimeSeriesStore. The view points
+ * directly into the store and is invalidated if the store is reallocated
+ * or cleared.
+ */
+class TimeSeriesView {
+public:
+  TimeSeriesView(void)
+    : p_data(NULL), p_size(0)
+  { }
+
+  TimeSeriesView(const double *data, int size)
+    : p_data(data), p_size(size)
+  { }
+
+  /**
+   * Number of values in series
+   * @return number of saved time steps
+   */
+  int size(void) const
+  {
+    return p_size;
+  }
+
+  /**
+   * Access value in series
+   * @param i index of saved time step
+   * @return value at time step
+   */
+  const double& operator[](int i) const
+  {
+    return p_data[i];
+  }
+
+  /**
+   * Pointer to the beginning of the series
+   */
+  const double* begin(void) const
+  {
+    return p_data;
+  }
+
+  /**
+   * Pointer to one past the end of the series
+   */
+  const double* end(void) const
+  {
+    return p_data + p_size;
+  }
+
+private:
+  const double *p_data;
+  int p_size;
+};
+
+// -------------------------------------------------------------
+//  class TimeSeriesStore
+// -------------------------------------------------------------
+class TimeSeriesStore {
+public:
+
+  /**
+   * Default constructor
+   */
+  TimeSeriesStore(void)
+    : p_nseries(0), p_capacity(0), p_nsaved(0), p_ncalls(0),
+      p_decimation(1)
+  { }
+
+  /**
+   * Default destructor
+   */
+  ~TimeSeriesStore(void)
+  { }
+
+  /**
+   * Allocate storage for a set of time series. Any previously stored data
+   * is discarded.
+   * @param nseries number of series to store
+   * @param nsteps expected number of calls to saveStep. This is used to
+   *        size the store and does not need to be exact
+   * @param decimation only save every decimation'th step
+   */
+  void allocate(int nseries, int nsteps, int decimation = 1)
+  {
+    if (nseries < 0 || nsteps < 0) {
+      char buf[256];
+      sprintf(buf,"Illegal dimensions (%d,%d) in TimeSeriesStore::allocate\n",
+          nseries,nsteps);
+      throw gridpack::Exception(buf);
+    }
+    if (decimation < 1) decimation = 1;
+    p_nseries = nseries;
+    p_decimation = decimation;
+    p_capacity = (nsteps + decimation - 1)/decimation;
+    if (p_capacity < 1) p_capacity = 1;
+    p_nsaved = 0;
+    p_ncalls = 0;
+    p_data.clear();
+    p_data.resize(static_cast<size_t>(p_nseries)*p_capacity, 0.0);
+  }
+
+  /**
+   * Clear all stored data and release memory
+   */
+  void clear(void)
+  {
+    p_nseries = 0;
+    p_capacity = 0;
+    p_nsaved = 0;
+    p_ncalls = 0;
+    std::vector<double>().swap(p_data);
+  }
+
+  /**
+   * Check if the next call to saveStep will actually store data. This can be
+   * used to skip evaluating values for steps that are decimated away.
+   * @return true if the next step will be stored
+   */
+  bool nextStepStored(void) const
+  {
+    return (p_ncalls%p_decimation == 0);
+  }
+
+  /**
+   * Save values for one time step. Values beyond the number of series are
+   * ignored and missing values are set to zero.
+   * @param vals array of values, one for each series
+   * @param nvals number of values in array
+   * @return true if values were stored, false if step was decimated
+   */
+  bool saveStep(const double *vals, int nvals)
+  {
+    bool stored = nextStepStored();
+    p_ncalls++;
+    if (!stored) return false;
+    if (p_nsaved == p_capacity) grow();
+    int n = nvals < p_nseries ? nvals : p_nseries;
+    int i;
+    for (i=0; i<n; i++) {
+      p_data[static_cast<size_t>(i)*p_capacity+p_nsaved] = vals[i];
+    }
+    for (i=n; i<p_nseries; i++) {
+      p_data[static_cast<size_t>(i)*p_capacity+p_nsaved] = 0.0;
+    }
+    p_nsaved++;
+    return true;
+  }
+
+  /**
+   * Number of series in store
+   */
+  int numSeries(void) const
+  {
+    return p_nseries;
+  }
+
+  /**
+   * Number of time steps currently held for each series
+   */
+  int numSteps(void) const
+  {
+    return p_nsaved;
+  }
+
+  /**
+   * Decimation factor used when saving steps
+   */
+  int decimation(void) const
+  {
+    return p_decimation;
+  }
+
+  /**
+   * Return a view of a single series. No data is copied.
+   * @param idx index of series
+   * @return view of series
+   */
+  TimeSeriesView series(int idx) const
+  {
+    if (idx < 0 || idx >= p_nseries) {
+      char buf[256];
+      sprintf(buf,"Series index %d out of range [0,%d) in TimeSeriesStore::series\n",
+          idx,p_nseries);
+      throw gridpack::Exception(buf);
+    }
+    return TimeSeriesView(&p_data[static_cast<size_t>(idx)*p_capacity],
+        p_nsaved);
+  }
+
+  /**
+   * Copy a single series into a standard vector
+   * @param idx index of series
+   * @param vec vector that receives the series
+   */
+  void copySeries(int idx, std::vector<double> &vec) const
+  {
+    TimeSeriesView view = series(idx);
+    vec.assign(view.begin(), view.end());
+  }
+
+  /**
+   * Losslessly compress a single series. Each value is XOR'ed with the
+   * previous value in the series and only the significant bytes of the
+   * result are written, preceded by a byte count. The saving depends on
+   * how many low order mantissa bits change from one step to the next, so
+   * even slowly varying series such as rotor speeds may shrink very little.
+   * @param idx index of series
+   * @param buf buffer that receives the compressed series
+   */
+  void compressSeries(int idx, std::vector<unsigned char> &buf) const
+  {
+    TimeSeriesView view = series(idx);
+    buf.clear();
+    buf.reserve(view.size()*sizeof(double)/2+1);
+    unsigned long long prev = 0;
+    int i, j;
+    for (i=0; i<view.size(); i++) {
+      unsigned long long bits;
+      memcpy(&bits, &view[i], sizeof(double));
+      unsigned long long delta = bits^prev;
+      prev = bits;
+      // Count significant bytes, starting from the most significant end.
+      // Sign, exponent and leading mantissa bits of consecutive values are
+      // usually identical, so the top bytes of delta are usually zero
+      int nbytes = 0;
+      unsigned long long tmp = delta;
+      while (tmp != 0) {
+        nbytes++;
+        tmp >>= 8;
+      }
+      buf.push_back(static_cast<unsigned char>(nbytes));
+      for (j=0; j<nbytes; j++) {
+        buf.push_back(static_cast<unsigned char>((delta>>(8*j))&0xff));
+      }
+    }
+  }
+
+  /**
+   * Reconstruct a series that was compressed using compressSeries
+   * @param buf buffer containing compressed series
+   * @param vec vector that receives the decompressed series
+   */
+  static void decompressSeries(const std::vector<unsigned char> &buf,
+      std::vector<double> &vec)
+  {
+    vec.clear();
+    unsigned long long prev = 0;
+    size_t pos = 0;
+    while (pos < buf.size()) {
+      int nbytes = buf[pos++];
+      if (nbytes > 8 || pos+nbytes > buf.size()) {
+        throw gridpack::Exception(
+            "Corrupt buffer in TimeSeriesStore::decompressSeries\n");
+      }
+      unsigned long long delta = 0;
+      int j;
+      for (j=0; j<nbytes; j++) {
+        delta |= static_cast<unsigned long long>(buf[pos++])<<(8*j);
+      }
+      prev ^= delta;
+      double val;
+      memcpy(&val, &prev, sizeof(double));
+      vec.push_back(val);
+    }
+  }
+
+private:
+
+  /**
+   * Increase capacity if more steps are saved than were originally
+   * requested. Each column is moved to its new location in a single pass.
+   */
+  void grow(void)
+  {
+    int newcap = 2*p_capacity;
+    if (newcap < 1) newcap = 1;
+    std::vector<double> data(static_cast<size_t>(p_nseries)*newcap, 0.0);
+    int i;
+    for (i=0; i<p_nseries; i++) {
+      if (p_nsaved > 0) {
+        memcpy(&data[static_cast<size_t>(i)*newcap],
+            &p_data[static_cast<size_t>(i)*p_capacity],
+            p_nsaved*sizeof(double));
+      }
+    }
+    p_data.swap(data);
+    p_capacity = newcap;
+  }
+
+  // number of series
+  int p_nseries;
+
+  // number of steps that can be held for each series before reallocating
+  int p_capacity;
+
+  // number of steps currently stored
+  int p_nsaved;
+
+  // number of calls to saveStep
+  int p_ncalls;
+
+  // only every p_decimation'th step is stored
+  int p_decimation;
+
+  // column-major data, one column of length p_capacity per series
+  std::vector<double> p_data;
+};
+
+} // dynamic_simulation
+} // gridpack
+#endif
@@ -0,0 +1,292 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   ensemble_kernels.hpp
+ * @date   2026-10-19
+ *
+ * @brief
+ * Kernels for the ensemble Kalman filter analysis step. All the matrices
+ * that enter the analysis are tall and skinny (rows distributed over
+ * processes, one column per ensemble member), so the analysis is carried
+ * out in ensemble space: the local rows are copied into reusable buffers,
+ * the small ensemble-space matrices are formed with local products and a
+ * single global sum, and the ensemble-space system is solved redundantly
+ * on every process.
+ */
+// -------------------------------------------------------------
+
+#ifndef _ensemble_kernels_hpp_
+#define _ensemble_kernels_hpp_
+
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+#include "gridpack/parallel/communicator.hpp"
+#include "gridpack/math/matrix.hpp"
+#include "gridpack/utilities/exception.hpp"
+
+namespace gridpack {
+namespace kalman_filter {
+
+// -------------------------------------------------------------
+//  class EnsembleKernels
+// -------------------------------------------------------------
+/**
+ * Evaluate the state increment
+ *
+ *   X_inc = N_inv*A*Z2
+ *
+ * with
+ *
+ *   Q  = I + Rm1n*HA^T*HA
+ *   Z1 = Rm1*HA^T*(D-HX)
+ *   W  = Q^-1*Z1
+ *   Z2 = Z1 - Rm1n*HA^T*HA*W
+ *
+ * where A is the (states x ensemble) perturbation matrix and HA, D and HX
+ * are (measurements x ensemble). Since Z1 = Q*W, Z2 = Z1 - (Q-I)*W = W,
+ * so only W has to be computed. The cost of an analysis step is
+ * O(n*m^2) for n rows and m ensemble members, plus O(m^3) for the
+ * ensemble-space solve. Buffers are kept between calls, so the analysis
+ * does not allocate memory once the first step has been done.
+ */
+class EnsembleKernels {
+public:
+
+  /**
+   * Constructor
+   * @param comm communicator used by the ensemble matrices
+   */
+  EnsembleKernels(const gridpack::parallel::Communicator &comm)
+    : p_comm(comm), p_nEnsemble(0)
+  { }
+
+  /**
+   * Destructor
+   */
+  ~EnsembleKernels(void)
+  { }
+
+  /**
+   * Evaluate the state increment. All matrices must have the same number
+   * of columns.
+   * @param A perturbation matrix of states
+   * @param HA perturbation matrix of measured quantities
+   * @param D measurement matrix
+   * @param HX ensemble of measured quantities
+   * @param Rm1n scale factor for HA^T*HA
+   * @param Rm1 scale factor for HA^T*(D-HX)
+   * @param N_inv scale factor for increment
+   * @param X_inc matrix that receives the increment. Must have the same
+   *        size and distribution as A
+   */
+  void increment(const gridpack::math::Matrix &A,
+      const gridpack::math::Matrix &HA, const gridpack::math::Matrix &D,
+      const gridpack::math::Matrix &HX, double Rm1n, double Rm1,
+      double N_inv, gridpack::math::Matrix &X_inc)
+  {
+    int m = A.cols();
+    if (HA.cols() != m || D.cols() != m || HX.cols() != m ||
+        X_inc.cols() != m) {
+      char buf[256];
+      sprintf(buf,"EnsembleKernels::increment: inconsistent ensemble sizes"
+          " A: %d HA: %d D: %d HX: %d X_inc: %d\n",m,HA.cols(),D.cols(),
+          HX.cols(),X_inc.cols());
+      throw gridpack::Exception(buf);
+    }
+    setEnsembleSize(m);
+    int i, j, k;
+
+    // Copy local rows. Y = D - HX
+    int nh = getLocalRows(HA, p_HA);
+    getLocalRows(D, p_Y);
+    getLocalRows(HX, p_work);
+    for (i=0; i<nh*m; i++) p_Y[i] -= p_work[i];
+
+    // Form HA^T*HA and HA^T*Y from local rows and sum both in a single
+    // reduction. HA^T*HA is symmetric, so only the upper triangle is
+    // evaluated
+    int mm = m*m;
+    for (i=0; i<2*mm; i++) p_gram[i] = 0.0;
+    ComplexType *G = &p_gram[0];
+    ComplexType *Z = &p_gram[mm];
+    int r;
+    for (r=0; r<nh; r++) {
+      const ComplexType *ha = &p_HA[r*m];
+      const ComplexType *y = &p_Y[r*m];
+      for (i=0; i<m; i++) {
+        ComplexType hai = ha[i];
+        for (j=i; j<m; j++) G[i*m+j] += hai*ha[j];
+        for (j=0; j<m; j++) Z[i*m+j] += hai*y[j];
+      }
+    }
+    p_comm.sum(&p_gram[0], 2*mm);
+    for (i=0; i<m; i++) {
+      for (j=0; j<i; j++) G[i*m+j] = G[j*m+i];
+    }
+
+    // Q = I + Rm1n*G, W = Rm1*Z, solve Q*W = Rm1*Z in place
+    for (i=0; i<mm; i++) {
+      p_Q[i] = Rm1n*G[i];
+      p_W[i] = Rm1*Z[i];
+    }
+    for (i=0; i<m; i++) p_Q[i*m+i] += 1.0;
+    solve(p_Q, p_W, m);
+
+    // X_inc = N_inv*A*W, one local row at a time
+    int na = getLocalRows(A, p_A);
+    p_work.resize(na*m);
+    for (r=0; r<na; r++) {
+      const ComplexType *a = &p_A[r*m];
+      ComplexType *x = &p_work[r*m];
+      for (j=0; j<m; j++) x[j] = 0.0;
+      for (k=0; k<m; k++) {
+        ComplexType ak = N_inv*a[k];
+        const ComplexType *w = &p_W[k*m];
+        for (j=0; j<m; j++) x[j] += ak*w[j];
+      }
+    }
+    setLocalRows(X_inc, p_work);
+  }
+
+private:
+
+  /**
+   * Resize ensemble-space buffers
+   * @param m number of ensemble members
+   */
+  void setEnsembleSize(int m)
+  {
+    if (m == p_nEnsemble) return;
+    p_nEnsemble = m;
+    p_gram.resize(2*m*m);
+    p_Q.resize(m*m);
+    p_W.resize(m*m);
+    p_jdx.resize(m);
+    p_idx.resize(m);
+    int j;
+    for (j=0; j<m; j++) p_jdx[j] = j;
+  }
+
+  /**
+   * Copy the locally held rows of a matrix into a buffer, row by row
+   * @param M matrix
+   * @param buf buffer that receives rows
+   * @return number of local rows
+   */
+  int getLocalRows(const gridpack::math::Matrix &M,
+      std::vector<ComplexType> &buf)
+  {
+    int lo, hi, i, j;
+    int m = p_nEnsemble;
+    M.localRowRange(lo, hi);
+    buf.resize((hi-lo)*m);
+    for (i=lo; i<hi; i++) {
+      for (j=0; j<m; j++) p_idx[j] = i;
+      M.getElements(m, &p_idx[0], &p_jdx[0], &buf[(i-lo)*m]);
+    }
+    return hi-lo;
+  }
+
+  /**
+   * Copy a buffer into the locally held rows of a matrix
+   * @param M matrix
+   * @param buf buffer with one row after another
+   */
+  void setLocalRows(gridpack::math::Matrix &M,
+      const std::vector<ComplexType> &buf)
+  {
+    int lo, hi, i, j;
+    int m = p_nEnsemble;
+    M.localRowRange(lo, hi);
+    for (i=lo; i<hi; i++) {
+      for (j=0; j<m; j++) p_idx[j] = i;
+      M.setElements(m, &p_idx[0], &p_jdx[0], &buf[(i-lo)*m]);
+    }
+    M.ready();
+  }
+
+  /**
+   * Solve Q*X = B in place using LU factorization with partial pivoting.
+   * On exit, B contains X and Q is overwritten
+   * @param Q m x m matrix, row major
+   * @param B m x m right hand sides, row major
+   * @param m size of system
+   */
+  void solve(std::vector<ComplexType> &Q, std::vector<ComplexType> &B,
+      int m)
+  {
+    int i, j, k;
+    for (k=0; k<m; k++) {
+      int p = k;
+      double amax = std::abs(Q[k*m+k]);
+      for (i=k+1; i<m; i++) {
+        if (std::abs(Q[i*m+k]) > amax) {
+          amax = std::abs(Q[i*m+k]);
+          p = i;
+        }
+      }
+      if (amax == 0.0) {
+        char buf[256];
+        sprintf(buf,"EnsembleKernels::solve: singular ensemble matrix at"
+            " column %d\n",k);
+        throw gridpack::Exception(buf);
+      }
+      if (p != k) {
+        for (j=0; j<m; j++) {
+          std::swap(Q[k*m+j],Q[p*m+j]);
+          std::swap(B[k*m+j],B[p*m+j]);
+        }
+      }
+      ComplexType pivot = Q[k*m+k];
+      for (i=k+1; i<m; i++) {
+        ComplexType f = Q[i*m+k]/pivot;
+        if (f == 0.0) continue;
+        for (j=k+1; j<m; j++) Q[i*m+j] -= f*Q[k*m+j];
+        for (j=0; j<m; j++) B[i*m+j] -= f*B[k*m+j];
+      }
+    }
+    for (k=m-1; k>=0; k--) {
+      ComplexType pivot = Q[k*m+k];
+      for (j=0; j<m; j++) {
+        ComplexType sum = B[k*m+j];
+        for (i=k+1; i<m; i++) sum -= Q[k*m+i]*B[i*m+j];
+        B[k*m+j] = sum/pivot;
+      }
+    }
+  }
+
+  gridpack::parallel::Communicator p_comm;
+
+  // number of ensemble members
+  int p_nEnsemble;
+
+  // local rows of A, HA and D-HX, one row after another
+  std::vector<ComplexType> p_A;
+  std::vector<ComplexType> p_HA;
+  std::vector<ComplexType> p_Y;
+
+  // scratch space for local rows
+  std::vector<ComplexType> p_work;
+
+  // HA^T*HA followed by HA^T*(D-HX)
+  std::vector<ComplexType> p_gram;
+
+  // ensemble-space system and solution
+  std::vector<ComplexType> p_Q;
+  std::vector<ComplexType> p_W;
+
+  // index buffers for getElements/setElements
+  std::vector<int> p_idx;
+  std::vector<int> p_jdx;
+};
+
+} // kalman_filter
+} // gridpack
+#endif
@@ -22,6 +22,7 @@
 #include "gridpack/mapper/full_map.hpp"
 #include "gridpack/mapper/gen_slab_map.hpp"
 #include "kds_app_module.hpp"
+#include "ensemble_kernels.hpp"
 
 // Calling program for state estimation application
 
@@ -569,6 +570,11 @@ void gridpack::kalman_filter::KalmanApp::solve()
   sprintf(ioBuf,"End Time Step of Fault: %d\n",steps2); p_busIO->header(ioBuf);
    
 
+  // Matrices and buffers for the ensemble analysis are reused at every
+  // step
+  boost::shared_ptr<gridpack::math::Matrix> A, HAm, HXm, X_inc;
+  gridpack::kalman_filter::EnsembleKernels ensemble(p_network->communicator());
+
   for (I_Steps = 2; I_Steps < simu_k; I_Steps++) { // Simulation Steps
 
     int t_onlyDAE= timer->createCategory("KF: In-Loop Only DAE");
@@ -660,7 +666,11 @@ void gridpack::kalman_filter::KalmanApp::solve()
     timer->start(t_A);    
     // Create perturbation matrix for X3
     p_factory->setMode(Perturbation);
-    boost::shared_ptr<gridpack::math::Matrix> A = xSlab.mapToMatrix();
+    if (!A) {
+      A = xSlab.mapToMatrix();
+    } else {
+      xSlab.mapToMatrix(A);
+    }
     timer->stop(t_A);
 
     int t_ensmb3 = timer->createCategory("KF: In-Loop EnKF E_ensmb3");
@@ -687,80 +697,32 @@ void gridpack::kalman_filter::KalmanApp::solve()
     int t_HX = timer->createCategory("KF: In-Loop EnKF HX");
     timer->start(t_HX);
     p_factory->setMode(HX);
-    boost::shared_ptr<gridpack::math::Matrix> HX = hxSlab.mapToMatrix();
+    if (!HXm) {
+      HXm = hxSlab.mapToMatrix();
+    } else {
+      hxSlab.mapToMatrix(HXm);
+    }
     timer->stop(t_HX);
 
-    // Create Y = D-HX
-    int t_Y = timer->createCategory("KF: In-Loop EnKF Y");
-    timer->start(t_Y);
-    boost::shared_ptr<gridpack::math::Matrix> Y(D->clone());
-    HX->scale(-1.0);
-    Y->add(*HX);
-    HX->scale(-1.0);
-    timer->stop(t_Y);
-
-    int t_Q = timer->createCategory("KF: In-Loop EnKF Q");
-    timer->start(t_Q);
     // Create HA matrix
-    int t_setHA = timer->createCategory("KF: In-Loop EnKF setHA");
-    timer->start(t_setHA);
-    p_factory->setMode(HA);
-    timer->stop(t_setHA);
     int t_HA = timer->createCategory("KF: In-Loop EnKF HA");
     timer->start(t_HA);
-    boost::shared_ptr<gridpack::math::Matrix> HA = hxSlab.mapToMatrix();
+    p_factory->setMode(HA);
+    if (!HAm) {
+      HAm = hxSlab.mapToMatrix();
+    } else {
+      hxSlab.mapToMatrix(HAm);
+    }
     timer->stop(t_HA);
-    int t_HAt = timer->createCategory("KF: In-Loop EnKF HAt");
-    timer->start(t_HAt);
-    boost::shared_ptr<gridpack::math::Matrix> HA_t(transpose(*HA));
-    timer->stop(t_HAt);
-    int t_HAtHA = timer->createCategory("KF: In-Loop EnKF HAtHA");
-    timer->start(t_HAtHA);
-    boost::shared_ptr<gridpack::math::Matrix> Q(multiply(*HA_t,*HA));
-    timer->stop(t_HAtHA);
-    int t_ScaleQ = timer->createCategory("KF: In-Loop EnKF ScaleQ");
-    timer->start(t_ScaleQ);
-    Q->scale(p_Rm1n);
-    boost::shared_ptr<gridpack::math::Matrix> H1(Q->clone());
-    gridpack::ComplexType z_one(1.0,0.0);
-    Q->addDiagonal(z_one);
-    timer->stop(t_ScaleQ);
-    timer->stop(t_Q);
-
-    int t_Z1 = timer->createCategory("KF: In-Loop EnKF Z1");
-    timer->start(t_Z1);
-    // Create Z1 matrix
-    boost::shared_ptr<gridpack::math::Matrix> Z1(multiply(*HA_t,*Y));
-    Z1->scale(p_Rm1);
-    timer->stop(t_Z1);
-
-    int t_W = timer->createCategory("KF: In-Loop EnKF Solve W"); 
-    timer->start(t_W);
-    // Create W by solving Q*W = Z1
-    boost::shared_ptr<gridpack::math::Matrix>
-      Q_sparse(gridpack::math::storageType(*Q,
-            gridpack::math::Sparse));
-    gridpack::math::LinearMatrixSolver solver2(*Q_sparse);
-    cursor = p_config->getCursor("Configuration.Kalman_filter");
-    solver2.configure(cursor);
-    boost::shared_ptr<gridpack::math::Matrix> W(solver2.solve(*Z1));
-    timer->stop(t_W);
-
-    int t_Z2 = timer->createCategory("KF: In-Loop EnKF Z2");
-    timer->start(t_Z2);
-    // Evaluate Z2 = Z1 - H1*W
-    boost::shared_ptr<gridpack::math::Matrix> Z2(multiply(*H1,*W));
-    Z2->scale(-1);
-    Z2->add(*Z1);
-    timer->stop(t_Z2);
 
+    // Evaluate X_inc in ensemble space from the local rows of A, HA, D
+    // and HX
     int t_Update = timer->createCategory("KF: In-Loop EnKF X Update");
     timer->start(t_Update);
     int t_X_inc = timer->createCategory("KF: In-Loop EnKF X_inc");
     timer->start(t_X_inc);
-    // Evaluate X_inc
-    boost::shared_ptr<gridpack::math::Matrix> X_inc(multiply(*A,*Z2));
-    X_inc->scale(p_N_inv);
+    if (!X_inc) X_inc.reset(A->clone());
+    ensemble.increment(*A, *HAm, *D, *HXm, p_Rm1n, p_Rm1, p_N_inv, *X_inc);
     timer->stop(t_X_inc);
 
     // Push results back onto buses and update values of rotor angle and speed
@@ -0,0 +1,231 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   ensemble_kernels_test.cpp
+ * @date   2026-10-19
+ *
+ * @brief  Check EnsembleKernels::increment against the dense evaluation of
+ *         HA^T*HA, Q, W and Z2 with distributed matrices that it replaced
+ */
+// -------------------------------------------------------------
+
+#include <iostream>
+#include <cmath>
+#include <boost/shared_ptr.hpp>
+#include "mpi.h"
+#include <ga.h>
+#include <macdecls.h>
+#include "gridpack/parallel/parallel.hpp"
+#include "gridpack/math/math.hpp"
+#include "ensemble_kernels.hpp"
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+static const double delta(1.0e-10);
+
+/**
+ * Pseudo-random value in [-1,1] x [-1,1] that only depends on the seed
+ * and the global position, so it does not depend on the distribution
+ * @param seed identifies the matrix
+ * @param i global row index
+ * @param j column index
+ */
+static gridpack::ComplexType entry(int seed, int i, int j)
+{
+  unsigned int h = static_cast<unsigned int>(seed)*2654435761u;
+  h ^= static_cast<unsigned int>(i)*40503u+static_cast<unsigned int>(j)*9973u;
+  h = h*1103515245u+12345u;
+  h ^= h>>13;
+  h = h*1103515245u+12345u;
+  double re = static_cast<double>((h>>8)%2001)/1000.0-1.0;
+  h = h*1103515245u+12345u;
+  double im = static_cast<double>((h>>8)%2001)/1000.0-1.0;
+  return gridpack::ComplexType(re,im);
+}
+
+/**
+ * Create a dense matrix with m columns and fill it with entry()
+ * @param comm communicator
+ * @param nrows number of rows on this process
+ * @param m number of columns (ensemble members)
+ * @param seed identifies the matrix
+ */
+static boost::shared_ptr<gridpack::math::Matrix> randomMatrix(
+    const gridpack::parallel::Communicator &comm, int nrows, int m, int seed)
+{
+  int lcols = m/comm.size()+(comm.rank() < m%comm.size() ? 1 : 0);
+  boost::shared_ptr<gridpack::math::Matrix>
+    M(new gridpack::math::Matrix(comm, nrows, lcols,
+          gridpack::math::Dense));
+  int lo, hi, i, j;
+  M->localRowRange(lo, hi);
+  for (i=lo; i<hi; i++) {
+    for (j=0; j<m; j++) M->setElement(i, j, entry(seed, i, j));
+  }
+  M->ready();
+  return M;
+}
+
+/**
+ * Evaluate X_inc the way the Kalman filter did before EnsembleKernels:
+ * Q = I + Rm1n*HA^T*HA, Z1 = Rm1*HA^T*(D-HX), solve Q*W = Z1,
+ * Z2 = Z1 - Rm1n*HA^T*HA*W and X_inc = N_inv*A*Z2
+ */
+static boost::shared_ptr<gridpack::math::Matrix> denseIncrement(
+    const gridpack::math::Matrix &A, const gridpack::math::Matrix &HA,
+    const gridpack::math::Matrix &D, const gridpack::math::Matrix &HX,
+    double Rm1n, double Rm1, double N_inv)
+{
+  boost::shared_ptr<gridpack::math::Matrix> Y(D.clone());
+  boost::shared_ptr<gridpack::math::Matrix> negHX(HX.clone());
+  negHX->scale(-1.0);
+  Y->add(*negHX);
+
+  boost::shared_ptr<gridpack::math::Matrix> HA_t(transpose(HA));
+  boost::shared_ptr<gridpack::math::Matrix> Q(multiply(*HA_t,HA));
+  Q->scale(Rm1n);
+  boost::shared_ptr<gridpack::math::Matrix> H1(Q->clone());
+  gridpack::ComplexType z_one(1.0,0.0);
+  Q->addDiagonal(z_one);
+
+  boost::shared_ptr<gridpack::math::Matrix> Z1(multiply(*HA_t,*Y));
+  Z1->scale(Rm1);
+
+  boost::shared_ptr<gridpack::math::Matrix>
+    Q_sparse(gridpack::math::storageType(*Q, gridpack::math::Sparse));
+  gridpack::math::LinearMatrixSolver solver(*Q_sparse);
+  solver.configure(gridpack::utility::Configuration::CursorPtr());
+  boost::shared_ptr<gridpack::math::Matrix> W(solver.solve(*Z1));
+
+  boost::shared_ptr<gridpack::math::Matrix> Z2(multiply(*H1,*W));
+  Z2->scale(-1.0);
+  Z2->add(*Z1);
+
+  boost::shared_ptr<gridpack::math::Matrix> X_inc(multiply(A,*Z2));
+  X_inc->scale(N_inv);
+  return X_inc;
+}
+
+/**
+ * Compare the local rows of two matrices with m columns
+ * @return true if all entries agree on all processes
+ */
+static bool sameMatrix(const gridpack::parallel::Communicator &comm,
+    const gridpack::math::Matrix &X, const gridpack::math::Matrix &Xref,
+    int m)
+{
+  int lo, hi, rlo, rhi, i, j;
+  X.localRowRange(lo, hi);
+  Xref.localRowRange(rlo, rhi);
+  int bad = 0;
+  if (lo != rlo || hi != rhi || X.rows() != Xref.rows()) bad = 1;
+  for (i=lo; i<hi && !bad; i++) {
+    for (j=0; j<m; j++) {
+      gridpack::ComplexType x, xref;
+      X.getElement(i, j, x);
+      Xref.getElement(i, j, xref);
+      if (std::abs(x-xref) > delta*(1.0+std::abs(xref))) {
+        std::cout << "p[" << comm.rank() << "] X_inc(" << i << "," << j
+          << "): " << x << " expected: " << xref << std::endl;
+        bad = 1;
+      }
+    }
+  }
+  comm.sum(&bad, 1);
+  return bad == 0;
+}
+
+/**
+ * Compare EnsembleKernels::increment with denseIncrement() for random
+ * matrices distributed over comm. The same kernels are used for two
+ * ensemble sizes and then the first one again, so reused buffers are
+ * covered
+ */
+static void checkIncrement(const gridpack::parallel::Communicator &comm)
+{
+  gridpack::kalman_filter::EnsembleKernels kernels(comm);
+  // uneven numbers of states and measurements on each process
+  int nstates = 4+comm.rank();
+  int nmeas = 3+comm.rank()%2;
+  int sizes[3] = {5, 3, 5};
+  int k;
+  for (k=0; k<3; k++) {
+    int m = sizes[k];
+    boost::shared_ptr<gridpack::math::Matrix>
+      A(randomMatrix(comm, nstates, m, 4*k+1)),
+      HA(randomMatrix(comm, nmeas, m, 4*k+2)),
+      D(randomMatrix(comm, nmeas, m, 4*k+3)),
+      HX(randomMatrix(comm, nmeas, m, 4*k+4));
+    double Rm1n = 0.5/static_cast<double>(k+1);
+    double Rm1 = 2.0;
+    double N_inv = 1.0/static_cast<double>(m-1);
+
+    boost::shared_ptr<gridpack::math::Matrix> X_inc(A->clone());
+    kernels.increment(*A, *HA, *D, *HX, Rm1n, Rm1, N_inv, *X_inc);
+    boost::shared_ptr<gridpack::math::Matrix>
+      X_ref(denseIncrement(*A, *HA, *D, *HX, Rm1n, Rm1, N_inv));
+    BOOST_CHECK(sameMatrix(comm, *X_inc, *X_ref, m));
+  }
+
+  // Matrices with different ensemble sizes are rejected
+  boost::shared_ptr<gridpack::math::Matrix>
+    A(randomMatrix(comm, nstates, 4, 1)),
+    HA(randomMatrix(comm, nmeas, 4, 2)),
+    D(randomMatrix(comm, nmeas, 3, 3));
+  boost::shared_ptr<gridpack::math::Matrix> X_inc(A->clone());
+  BOOST_CHECK_THROW(kernels.increment(*A, *HA, *D, *HA, 1.0, 1.0, 1.0,
+        *X_inc), gridpack::Exception);
+}
+
+BOOST_AUTO_TEST_SUITE(EnsembleKernelsTest)
+
+BOOST_AUTO_TEST_CASE(OneProcess)
+{
+  gridpack::parallel::Communicator world;
+  checkIncrement(world.self());
+}
+
+BOOST_AUTO_TEST_CASE(AllProcesses)
+{
+  gridpack::parallel::Communicator world;
+  checkIncrement(world);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_function()
+{
+  return true;
+}
+
+// -------------------------------------------------------------
+//  Main Program
+// -------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+  gridpack::parallel::Environment env(argc, argv);
+  gridpack::parallel::Communicator world;
+  gridpack::math::Initialize(&argc,&argv);
+
+  // Report the result once so that parallel output cannot garble it
+  int lresult = ::boost::unit_test::unit_test_main( &init_function, argc, argv );
+  lresult = (lresult == boost::exit_success ? 0 : 1);
+  int gresult = lresult;
+  world.sum(&gresult,1);
+  gridpack::math::Finalize();
+  if (world.rank() == 0) {
+    if (gresult == 0) {
+      std::cout << "No errors detected" << std::endl;
+    } else {
+      std::cout << "failure detected" << std::endl;
+    }
+  }
+  return gresult;
+}
@@ -24,6 +24,7 @@
 #include "gridpack/parser/GOSS_parser.hpp"
 #include "gridpack/math/math.hpp"
 #include "pf_helper.hpp"
+#include <boost/filesystem.hpp>
 
 #define USE_REAL_VALUES
 
@@ -32,6 +33,7 @@
  */
 gridpack::powerflow::PFAppModule::PFAppModule(void)
 {
+  p_yBusSet = false;
 }
 
 /**
@@ -43,6 +45,30 @@ gridpack::powerflow::PFAppModule::~PFAppModule(void)
 
 enum Parser{PTI23, PTI33, GOSS};
 
+/**
+ * Describe the input that a network snapshot is created from, so that an
+ * old snapshot is not used after the network file or the options applied
+ * by the parser have changed
+ * @param filename name of network file
+ * @param filetype format of network file
+ * @param phaseShiftSign sign applied to phase shifts by the parser
+ * @return description that is stored in the snapshot
+ */
+static std::string snapshotSource(const std::string &filename,
+    int filetype, double phaseShiftSign)
+{
+  boost::system::error_code ec;
+  boost::uintmax_t size = boost::filesystem::file_size(filename, ec);
+  if (ec) size = 0;
+  std::time_t mtime = boost::filesystem::last_write_time(filename, ec);
+  if (ec) mtime = 0;
+  char buf[128];
+  sprintf(buf," format: %d size: %llu modified: %lld phaseShiftSign: %g",
+      filetype, static_cast<unsigned long long>(size),
+      static_cast<long long>(mtime), phaseShiftSign);
+  return filename+buf;
+}
+
 /**
  * Read in and partition the powerflow network. The input file is read
  * directly from the Powerflow block in the configuration file so no
@@ -54,6 +80,60 @@ enum Parser{PTI23, PTI33, GOSS};
 void gridpack::powerflow::PFAppModule::readNetwork(
     boost::shared_ptr<PFNetwork> &network,
     gridpack::utility::Configuration *config)
+{
+  p_readNetwork(network, config, NULL, 0);
+}
+
+/**
+ * Read in the powerflow network when the calculation is divided into
+ * several groups of processes that each have their own copy of the
+ * network. Only the group containing process 0 of world reads and
+ * partitions the network. The partitioned network is then copied to
+ * the other groups, so the setup cost does not grow with the number of
+ * groups. If the groups are not all the same size, each group reads
+ * the network separately
+ * @param network pointer to a PFNetwork object. This should not have any
+ * buses or branches defined on it.
+ * @param config point to open configuration file
+ * @param world communicator containing all groups
+ */
+void gridpack::powerflow::PFAppModule::readNetwork(
+    boost::shared_ptr<PFNetwork> &network,
+    gridpack::utility::Configuration *config,
+    const gridpack::parallel::Communicator &world)
+{
+  gridpack::parallel::Communicator comm = network->communicator();
+  int nmin = comm.size();
+  int nmax = comm.size();
+  world.min(&nmin,1);
+  world.max(&nmax,1);
+  if (nmin != nmax || comm.size() == world.size()) {
+    p_readNetwork(network, config, NULL, 0);
+    return;
+  }
+  // Find the group that contains process 0 of world. Processes with the
+  // same rank in each group form the peers communicator
+  int leader = (world.rank() == 0 ? 1 : 0);
+  comm.max(&leader,1);
+  gridpack::parallel::Communicator peers = world.split(comm.rank());
+  int root = (leader ? peers.rank() : -1);
+  peers.max(&root,1);
+  p_readNetwork(network, config, &peers, root);
+}
+
+/**
+ * Read in and partition the powerflow network, or receive it from
+ * another group of processes
+ * @param network pointer to a PFNetwork object
+ * @param config point to open configuration file
+ * @param peers communicator connecting processes with the same rank in
+ * each group. If NULL, the network is read by this group
+ * @param root rank in peers of the process that reads the network
+ */
+void gridpack::powerflow::PFAppModule::p_readNetwork(
+    boost::shared_ptr<PFNetwork> &network,
+    gridpack::utility::Configuration *config,
+    const gridpack::parallel::Communicator *peers, int root)
 {
   p_network = network;
   p_comm = network->communicator();
@@ -92,10 +172,40 @@ void gridpack::powerflow::PFAppModule::readNetwork(
   ComplexType tol;
   // Phase shift sign
   double phaseShiftSign = cursor->get("phaseShiftSign",1.0);
+  // Solver options that are checked on every call to solve
+  p_injectionKernel = cursor->getHandle<bool>("injectionKernel");
+  p_blockMatrix = cursor->getHandle<bool>("blockMatrix");
+  // Only recompute admittances of branches changed by contingencies
+  p_incrementalYBus = cursor->getHandle<bool>("incrementalContingency");
+
+  // Optionally restore the partitioned network from a snapshot instead of
+  // parsing and partitioning it. The snapshot is created after partitioning
+  // if it does not exist yet, and created again if it was made from a
+  // different network file or with a different phase shift sign
+  std::string snapshot;
+  bool useSnapshot = cursor->get("networkSnapshot",&snapshot);
+  std::string source;
+  if (useSnapshot) {
+    source = snapshotSource(filename, filetype, phaseShiftSign);
+  }
+  network->setLocalReordering(cursor->get("localReordering",false));
+  network->setArenaAllocation(cursor->get("arenaAllocation",false));
+  // Processes that receive the network from another group skip reading
+  // and partitioning
+  bool replica = (peers != NULL && peers->rank() != root);
+  bool restored = false;
+  if (useSnapshot && !replica) {
+    int t_snap = timer->createCategory("Powerflow: Load Snapshot");
+    timer->start(t_snap);
+    restored = network->loadSnapshot(snapshot, source);
+    timer->stop(t_snap);
+  }
 
   int t_pti = timer->createCategory("Powerflow: Network Parser");
   timer->start(t_pti);
-  if (filetype == PTI23) {
+  if (restored || replica) {
+    // network is already set up or will be copied from another group
+  } else if (filetype == PTI23) {
     gridpack::parser::PTI23_parser<PFNetwork> parser(network);
     parser.parse(filename.c_str());
     if (phaseShiftSign == -1.0) {
@@ -113,6 +223,25 @@ void gridpack::powerflow::PFAppModule::readNetwork(
   }
   timer->stop(t_pti);
 
+  // partition network. Optionally reorder local buses and branches for
+  // locality and place them in contiguous blocks of memory after
+  // partitioning
+  if (!restored && !replica) {
+    int t_part = timer->createCategory("Powerflow: Partition");
+    timer->start(t_part);
+    network->partition();
+    timer->stop(t_part);
+    if (useSnapshot) network->saveSnapshot(snapshot, false, source);
+  }
+
+  // Copy the partitioned network to the other groups
+  if (peers != NULL) {
+    int t_rep = timer->createCategory("Powerflow: Replicate Network");
+    timer->start(t_rep);
+    network->replicate(*peers, root);
+    timer->stop(t_rep);
+  }
+
   // Create serial IO object to export data from buses
   p_busIO.reset(new gridpack::serial_io::SerialBusIO<PFNetwork>(512,network));
 
@@ -124,12 +253,6 @@ void gridpack::powerflow::PFAppModule::readNetwork(
   p_busIO->header(ioBuf);
   sprintf(ioBuf,"\nConvergence tolerance: %f\n",p_tolerance);
   p_busIO->header(ioBuf);
-
-  // partition network
-  int t_part = timer->createCategory("Powerflow: Partition");
-  timer->start(t_part);
-  network->partition();
-  timer->stop(t_part);
   timer->stop(t_total);
 }
 
@@ -157,6 +280,8 @@ void gridpack::powerflow::PFAppModule::initialize()
   timer->start(t_setc);
   p_factory->setComponents();
   timer->stop(t_setc);
+  p_yBusSet = false;
+  p_yBusChanged.clear();
 
   // Set up bus data exchange buffers. Need to decide what data needs to be
   // exchanged
@@ -184,6 +309,10 @@ void gridpack::powerflow::PFAppModule::reload()
   timer->start(t_load);
   p_factory->load();
   timer->stop(t_load);
+  // The next solve calls setYBus, which also refreshes the admittances
+  // held by the injection kernel
+  p_yBusSet = false;
+  p_yBusChanged.clear();
 }
 
 /**
@@ -211,7 +340,20 @@ bool gridpack::powerflow::PFAppModule::solve()
   // set YBus components so that you can create Y matrix
   int t_fact = timer->createCategory("Powerflow: Factory Operations");
   timer->start(t_fact);
-  p_factory->setYBus();
+  // If incremental updates are enabled, only the branches that were
+  // changed by contingencies since the last solve, and the buses attached
+  // to them, need new admittances
+  if (p_incrementalYBus.get(false) && p_yBusSet) {
+    p_factory->updateYBus(p_yBusChanged);
+  } else {
+    p_factory->setYBus();
+  }
+  p_yBusSet = true;
+  p_yBusChanged.clear();
+  // Optionally evaluate branch flows for the whole network at once instead
+  // of branch by branch in the components. The kernel arrays are only set
+  // up again if the option has changed since the last solve
+  p_factory->setInjectionKernel(p_injectionKernel.get(false));
   timer->stop(t_fact);
 
   int t_cmap = timer->createCategory("Powerflow: Create Mappers");
@@ -253,6 +395,7 @@ bool gridpack::powerflow::PFAppModule::solve()
   gridpack::mapper::BusVectorMap<PFNetwork> vMap(p_network);
   timer->stop(t_cmap);
   timer->start(t_vmap);
+  p_factory->evaluateInjections();
 #ifdef USE_REAL_VALUES
   boost::shared_ptr<gridpack::math::RealVector> PQ = vMap.mapToRealVector();
 #else
@@ -268,7 +411,14 @@ bool gridpack::powerflow::PFAppModule::solve()
 #ifdef USE_REAL_VALUES
   boost::shared_ptr<gridpack::math::RealMatrix> J = jMap.mapToRealMatrix();
 #else
-  boost::shared_ptr<gridpack::math::Matrix> J = jMap.mapToMatrix();
+  // Optionally store the Jacobian in block sparse format, with one block
+  // for each bus
+  boost::shared_ptr<gridpack::math::Matrix> J;
+  if (p_blockMatrix.get(false)) {
+    J = jMap.mapToBlockMatrix();
+  } else {
+    J = jMap.mapToMatrix();
+  }
 #endif
   timer->stop(t_mmap);
 //  p_busIO->header("\nJacobian values\n");
@@ -342,6 +492,7 @@ bool gridpack::powerflow::PFAppModule::solve()
 
     // Create new versions of Jacobian and PQ vector
     timer->start(t_vmap);
+    p_factory->evaluateInjections();
 #ifdef USE_REAL_VALUES
     vMap.mapToRealVector(PQ);
 #else
@@ -427,6 +578,8 @@ bool gridpack::powerflow::PFAppModule::nl_solve()
   int t_fact = timer->createCategory("Powerflow: Factory Operations");
   timer->start(t_fact);
   p_factory->setYBus();
+  p_yBusSet = true;
+  p_yBusChanged.clear();
   p_factory->setSBus();
   timer->stop(t_fact);
 
@@ -671,6 +824,7 @@ bool gridpack::powerflow::PFAppModule::setContingency(
             p_network->getBranch(jdx).get());
         event.p_saveLineStatus[i] = branch->getBranchStatus(tag);
         branch->setBranchStatus(tag, false);
+        p_yBusChanged.push_back(jdx);
       }
     }
   } else {
@@ -722,6 +876,7 @@ bool gridpack::powerflow::PFAppModule::unSetContingency(
         branch = dynamic_cast<gridpack::powerflow::PFBranch*>(
             p_network->getBranch(jdx).get());
         branch->setBranchStatus(tag,event.p_saveLineStatus[i]);
+        p_yBusChanged.push_back(jdx);
       }
     }
   } else {
@@ -804,6 +959,38 @@ bool gridpack::powerflow::PFAppModule::checkQlimViolations(int area)
   return p_factory->checkQlimViolations(area);
 }
 
+/**
+ * Evaluate voltage, line overload and Q limit checks in a single pass
+ * and a single reduction over all processors. Q limits are only
+ * checked, buses are not converted from PV to PQ
+ * @param checks bitwise or of PFAuditCheck values
+ * @return worst violations over the network and in each area
+ */
+gridpack::powerflow::PFViolationAudit
+gridpack::powerflow::PFAppModule::auditViolations(int checks)
+{
+  return p_factory->auditViolations(checks);
+}
+
+/**
+ * Start a violation audit without waiting for the reduction to complete
+ * @param checks bitwise or of PFAuditCheck values
+ */
+void gridpack::powerflow::PFAppModule::startViolationAudit(int checks)
+{
+  p_factory->startViolationAudit(checks);
+}
+
+/**
+ * Complete a violation audit started with startViolationAudit
+ * @return worst violations over the network and in each area
+ */
+gridpack::powerflow::PFViolationAudit
+gridpack::powerflow::PFAppModule::finishViolationAudit()
+{
+  return p_factory->finishViolationAudit();
+}
+
 /**
  * Clear changes that were made for Q limit violations and reset
  * system to its original state
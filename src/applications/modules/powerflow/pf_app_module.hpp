@@ -95,6 +95,23 @@ class PFAppModule
     void readNetwork(boost::shared_ptr<PFNetwork> &network,
                      gridpack::utility::Configuration *config);
 
+    /**
+     * Read in the powerflow network when the calculation is divided into
+     * several groups of processes that each have their own copy of the
+     * network. Only the group containing process 0 of world reads and
+     * partitions the network. The partitioned network is then copied to
+     * the other groups, so the setup cost does not grow with the number of
+     * groups. If the groups are not all the same size, each group reads
+     * the network separately
+     * @param network pointer to a PFNetwork object. This should not have any
+     * buses or branches defined on it.
+     * @param config point to open configuration file
+     * @param world communicator containing all groups
+     */
+    void readNetwork(boost::shared_ptr<PFNetwork> &network,
+                     gridpack::utility::Configuration *config,
+                     const gridpack::parallel::Communicator &world);
+
     /**
      * Set up exchange buffers and other internal parameters and initialize
      * network components using data from data collection
@@ -227,12 +244,48 @@ class PFAppModule
      */
     void clearQlimViolations();
 
+    /**
+     * Evaluate voltage, line overload and Q limit checks in a single pass
+     * and a single reduction over all processors. Q limits are only
+     * checked, buses are not converted from PV to PQ
+     * @param checks bitwise or of PFAuditCheck values
+     * @return worst violations over the network and in each area
+     */
+    PFViolationAudit auditViolations(int checks = AUDIT_ALL);
+
+    /**
+     * Start a violation audit without waiting for the reduction to complete
+     * @param checks bitwise or of PFAuditCheck values
+     */
+    void startViolationAudit(int checks = AUDIT_ALL);
+
+    /**
+     * Complete a violation audit started with startViolationAudit. This
+     * must be called on all processes before the module is destroyed
+     * @return worst violations over the network and in each area
+     */
+    PFViolationAudit finishViolationAudit();
+
     /**
      * Reset voltages to values in network configuration file
      */
     void resetVoltages();
   private:
 
+    /**
+     * Read in and partition the powerflow network, or receive it from
+     * another group of processes
+     * @param network pointer to a PFNetwork object
+     * @param config point to open configuration file
+     * @param peers communicator connecting processes with the same rank in
+     * each group. If NULL, the network is read by this group
+     * @param root rank in peers of the process that reads the network
+     */
+    void p_readNetwork(boost::shared_ptr<PFNetwork> &network,
+                       gridpack::utility::Configuration *config,
+                       const gridpack::parallel::Communicator *peers,
+                       int root);
+
     // pointer to network
     boost::shared_ptr<PFNetwork> p_network;
 
@@ -259,6 +312,19 @@ class PFAppModule
 
     // pointer to configuration module
     gridpack::utility::Configuration *p_config;
+
+    // options that are read on every call to solve
+    gridpack::utility::Configuration::Handle<bool> p_injectionKernel;
+    gridpack::utility::Configuration::Handle<bool> p_blockMatrix;
+    gridpack::utility::Configuration::Handle<bool> p_incrementalYBus;
+
+    // true if the admittance contributions of all components have been
+    // evaluated since the network was loaded
+    bool p_yBusSet;
+
+    // local indices of branches changed by setContingency or
+    // unSetContingency since admittances were last evaluated
+    std::vector<int> p_yBusChanged;
 };
 
 } // powerflow
@@ -16,14 +16,96 @@
 // -------------------------------------------------------------
 
 #include <vector>
+#include <set>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include "boost/smart_ptr/shared_ptr.hpp"
 #include "gridpack/parser/dictionary.hpp"
+#include "gridpack/utilities/exception.hpp"
+#include "gridpack/math/complex_kernels.hpp"
 #include "pf_factory_module.hpp"
 
 
 namespace gridpack {
 namespace powerflow {
 
+// Layout of the record for each area in the violation audit buffer. Counts
+// are summed and the largest violation, together with its location, is kept
+// for each type of violation
+enum {
+  AUDIT_NUM_V = 0, AUDIT_MAX_V, AUDIT_BUS_V,
+  AUDIT_NUM_L, AUDIT_MAX_L, AUDIT_FROM_L, AUDIT_TO_L,
+  AUDIT_NUM_Q, AUDIT_MAX_Q, AUDIT_BUS_Q,
+  AUDIT_RECORD
+};
+
+/**
+ * Check if one violation is worse than another. Ties are broken using the
+ * location so that the result does not depend on the order of reduction
+ */
+static bool auditWorse(double mag1, double id1a, double id1b,
+    double mag2, double id2a, double id2b)
+{
+  if (mag1 != mag2) return mag1 > mag2;
+  if (id1a < 0.0) return false;
+  if (id2a < 0.0) return true;
+  if (id1a != id2a) return id1a < id2a;
+  return id1b < id2b;
+}
+
+/**
+ * Reduction operator for violation audit records
+ */
+static void auditReduce(void *invec, void *inoutvec, int *len,
+    MPI_Datatype *datatype)
+{
+  double *in = static_cast<double*>(invec);
+  double *io = static_cast<double*>(inoutvec);
+  int nrec = *len/AUDIT_RECORD;
+  int i;
+  for (i=0; i<nrec; i++) {
+    io[AUDIT_NUM_V] += in[AUDIT_NUM_V];
+    if (auditWorse(in[AUDIT_MAX_V],in[AUDIT_BUS_V],0.0,
+          io[AUDIT_MAX_V],io[AUDIT_BUS_V],0.0)) {
+      io[AUDIT_MAX_V] = in[AUDIT_MAX_V];
+      io[AUDIT_BUS_V] = in[AUDIT_BUS_V];
+    }
+    io[AUDIT_NUM_L] += in[AUDIT_NUM_L];
+    if (auditWorse(in[AUDIT_MAX_L],in[AUDIT_FROM_L],in[AUDIT_TO_L],
+          io[AUDIT_MAX_L],io[AUDIT_FROM_L],io[AUDIT_TO_L])) {
+      io[AUDIT_MAX_L] = in[AUDIT_MAX_L];
+      io[AUDIT_FROM_L] = in[AUDIT_FROM_L];
+      io[AUDIT_TO_L] = in[AUDIT_TO_L];
+    }
+    io[AUDIT_NUM_Q] += in[AUDIT_NUM_Q];
+    if (auditWorse(in[AUDIT_MAX_Q],in[AUDIT_BUS_Q],0.0,
+          io[AUDIT_MAX_Q],io[AUDIT_BUS_Q],0.0)) {
+      io[AUDIT_MAX_Q] = in[AUDIT_MAX_Q];
+      io[AUDIT_BUS_Q] = in[AUDIT_BUS_Q];
+    }
+    in += AUDIT_RECORD;
+    io += AUDIT_RECORD;
+  }
+}
+
+/**
+ * Add violations at one location to an audit record
+ * @param count number of violations at the location
+ * @param mag size of the worst violation at the location
+ */
+static void auditAdd(double *rec, int num, int max, int id1, int id2,
+    int count, double mag, double loc1, double loc2)
+{
+  rec[num] += static_cast<double>(count);
+  if (auditWorse(mag,loc1,loc2,rec[max],rec[id1],
+        (id2 >= 0 ? rec[id2] : 0.0))) {
+    rec[max] = mag;
+    rec[id1] = loc1;
+    if (id2 >= 0) rec[id2] = loc2;
+  }
+}
+
 // Powerflow factory class implementations
 
 /**
@@ -34,6 +116,12 @@ PFFactoryModule::PFFactoryModule(PFFactoryModule::NetworkPtr network)
   : gridpack::factory::BaseFactory<PFNetwork>(network)
 {
   p_network = network;
+  p_auditAreasSet = false;
+  p_auditChecks = 0;
+  p_auditPending = false;
+  p_auditRequest = MPI_REQUEST_NULL;
+  p_auditOp = MPI_OP_NULL;
+  p_kernel = false;
 }
 
 /**
@@ -41,6 +129,13 @@ PFFactoryModule::PFFactoryModule(PFFactoryModule::NetworkPtr network)
  */
 gridpack::powerflow::PFFactoryModule::~PFFactoryModule()
 {
+  // Audits must be completed by calling finishViolationAudit on all
+  // processes. Completing the reduction here could call MPI after
+  // MPI_Finalize, or on only some processes while an exception unwinds
+  if (p_auditPending) {
+    printf("PFFactoryModule: violation audit was started but never"
+        " finished\n");
+  }
 }
 
 /**
@@ -51,17 +146,64 @@ void gridpack::powerflow::PFFactoryModule::setYBus(void)
   int numBus = p_network->numBuses();
   int numBranch = p_network->numBranches();
   int i;
+  gridpack::factory::ComponentRange<PFBus> bus_list = buses();
+  gridpack::factory::ComponentRange<PFBranch> branch_list = branches();
 
   // Invoke setYBus method on all branch objects
   for (i=0; i<numBranch; i++) {
-    dynamic_cast<PFBranch*>(p_network->getBranch(i).get())->setYBus();
+    branch_list[i]->setYBus();
   }
 
   // Invoke setYBus method on all bus objects
   for (i=0; i<numBus; i++) {
-    dynamic_cast<PFBus*>(p_network->getBus(i).get())->setYBus();
+    bus_list[i]->setYBus();
   }
 
+  if (p_kernel) loadKernelAdmittances();
+}
+
+/**
+ * Recompute the admittance contributions of a set of branches and of
+ * the buses at either end of them. All other buses and branches must
+ * still hold the values from a previous call to setYBus
+ * @param branchIDs local indices of branches whose parameters or
+ * status have changed
+ */
+void gridpack::powerflow::PFFactoryModule::updateYBus(
+    const std::vector<int> &branchIDs)
+{
+  int numBranch = p_network->numBranches();
+  std::vector<int> ids(branchIDs);
+  std::sort(ids.begin(),ids.end());
+  ids.erase(std::unique(ids.begin(),ids.end()),ids.end());
+  gridpack::factory::ComponentRange<PFBranch> branch_list = branches();
+  std::set<PFBus*> changed;
+  int i;
+  int nids = ids.size();
+  for (i=0; i<nids; i++) {
+    int idx = ids[i];
+    if (idx < 0 || idx >= numBranch) {
+      char buf[256];
+      sprintf(buf,"PFFactoryModule::updateYBus: illegal branch index: %d"
+          " size: %d\n",idx,numBranch);
+      throw gridpack::Exception(buf);
+    }
+    PFBranch *branch = branch_list[idx];
+    branch->setYBus();
+    changed.insert(dynamic_cast<PFBus*>(branch->getBus1().get()));
+    changed.insert(dynamic_cast<PFBus*>(branch->getBus2().get()));
+    if (p_kernel) {
+      branch->getPQAdmittance(&p_kYrFrwd[idx],&p_kYiFrwd[idx],
+          &p_kYrRvrs[idx],&p_kYiRvrs[idx]);
+    }
+  }
+
+  // Bus diagonals are sums over all attached branches, so they are
+  // recomputed after the branches
+  std::set<PFBus*>::iterator it;
+  for (it = changed.begin(); it != changed.end(); it++) {
+    (*it)->setYBus();
+  }
 }
 
 /**
@@ -71,10 +213,11 @@ void gridpack::powerflow::PFFactoryModule::setSBus(void)
 {
   int numBus = p_network->numBuses();
   int i;
+  gridpack::factory::ComponentRange<PFBus> bus_list = buses();
 
   // Invoke setSBus method on all bus objects
   for (i=0; i<numBus; i++) {
-    dynamic_cast<PFBus*>(p_network->getBus(i).get())->setSBus();
+    bus_list[i]->setSBus();
   }
 }
 
@@ -85,10 +228,11 @@ void gridpack::powerflow::PFFactoryModule::setPQ(void)
 {
   int numBus = p_network->numBuses();
   int i;
+  gridpack::factory::ComponentRange<PFBus> bus_list = buses();
   ComplexType values[2];
 
   for (i=0; i<numBus; i++) {
-    dynamic_cast<PFBus*>(p_network->getBus(i).get())->vectorValues(values);
+    bus_list[i]->vectorValues(values);
   }
 }
 
@@ -104,10 +248,11 @@ void gridpack::powerflow::PFFactoryModule::updatePg(int busID, std::string genID
 {
   int numBus = p_network->numBuses();
   int i;
+  gridpack::factory::ComponentRange<PFBus> bus_list = buses();
   int genIndex=0;
   for (i=0; i<numBus; i++) {
 //    dynamic_cast<PFBus*>(p_network->getBus(i).get())->setParam(name,busID, genID, value);
-    dynamic_cast<PFBus*>(p_network->getBus(i).get())->setParam(GENERATOR_PG,
+    bus_list[i]->setParam(GENERATOR_PG,
         busID, genID, value);
   }
 }
@@ -116,10 +261,11 @@ void gridpack::powerflow::PFFactoryModule::updateQg(int busID, std::string genID
 {
   int numBus = p_network->numBuses();
   int i;
+  gridpack::factory::ComponentRange<PFBus> bus_list = buses();
   int genIndex=0;
   for (i=0; i<numBus; i++) {
 //    dynamic_cast<PFBus*>(p_network->getBus(i).get())->setParam(name,busID, genID, value);
-    dynamic_cast<PFBus*>(p_network->getBus(i).get())->setParam(GENERATOR_QG,
+    bus_list[i]->setParam(GENERATOR_QG,
         busID, genID, value);
   }
 }
@@ -136,16 +282,14 @@ void gridpack::powerflow::PFFactoryModule::updateQg(int busID, std::string genID
  */
 bool gridpack::powerflow::PFFactoryModule::checkLoneBus(std::ofstream *stream)
 {
-  int numBus = p_network->numBuses();
   int i, j, k;
   bool bus_ok = true;
   char buf[128];
   p_saveIsolatedStatus.clear();
-  for (i=0; i<numBus; i++) {
-    if (!p_network->getActiveBus(i)) continue;
-    gridpack::powerflow::PFBus *bus =
-      dynamic_cast<gridpack::powerflow::PFBus*>
-      (p_network->getBus(i).get());
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
     std::vector<boost::shared_ptr<gridpack::component::BaseComponent> > branches;
     bus->getNeighborBranches(branches);
     int size = branches.size();
@@ -186,14 +330,12 @@ bool gridpack::powerflow::PFFactoryModule::checkLoneBus(std::ofstream *stream)
 void gridpack::powerflow::PFFactoryModule::clearLoneBus()
 {
   if (p_saveIsolatedStatus.size() == 0) return;
-  int numBus = p_network->numBuses();
   int i, j, k;
   int ncount = 0;
-  for (i=0; i<numBus; i++) {
-    if (!p_network->getActiveBus(i)) continue;
-    gridpack::powerflow::PFBus *bus =
-      dynamic_cast<gridpack::powerflow::PFBus*>
-      (p_network->getBus(i).get());
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
     std::vector<boost::shared_ptr<gridpack::component::BaseComponent> > branches;
     bus->getNeighborBranches(branches);
     int size = branches.size();
@@ -234,10 +376,9 @@ void gridpack::powerflow::PFFactoryModule::setVoltageLimits(double Vmin,
   int numBus = p_network->numBuses();
   int i;
   bool bus_ok = true;
+  gridpack::factory::ComponentRange<PFBus> bus_list = buses();
   for (i=0; i<numBus; i++) {
-    gridpack::powerflow::PFBus *bus =
-      dynamic_cast<gridpack::powerflow::PFBus*>(p_network->getBus(i).get());
-    bus->setVoltageLimits(Vmin,Vmax);
+    bus_list[i]->setVoltageLimits(Vmin,Vmax);
   }
 }
 
@@ -250,18 +391,15 @@ void gridpack::powerflow::PFFactoryModule::setVoltageLimits(double Vmin,
  */
 bool gridpack::powerflow::PFFactoryModule::checkVoltageViolations()
 {
-  int numBus = p_network->numBuses();
   int i;
   bool bus_ok = true;
   char buf[128];
-  for (i=0; i<numBus; i++) {
-    if (p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      if (!bus->getIgnore()) {
-        if (!bus->checkVoltageViolation()) bus_ok = false;
-      }
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
+    if (!bus->getIgnore()) {
+      if (!bus->checkVoltageViolation()) bus_ok = false;
     }
   }
   return checkTrue(bus_ok);
@@ -275,17 +413,14 @@ bool gridpack::powerflow::PFFactoryModule::checkVoltageViolations()
 bool gridpack::powerflow::PFFactoryModule::checkVoltageViolations(
     int area)
 {
-  int numBus = p_network->numBuses();
   int i;
   bool bus_ok = true;
-  for (i=0; i<numBus; i++) {
-    if (p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      if (!bus->getIgnore() && bus->getArea() == area) {
-        if (!bus->checkVoltageViolation()) bus_ok = false;
-      }
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
+    if (!bus->getIgnore() && bus->getArea() == area) {
+      if (!bus->checkVoltageViolation()) bus_ok = false;
     }
   }
   return checkTrue(bus_ok);
@@ -297,15 +432,12 @@ bool gridpack::powerflow::PFFactoryModule::checkVoltageViolations(
  */
 void gridpack::powerflow::PFFactoryModule::ignoreVoltageViolations()
 {
-  int numBus = p_network->numBuses();
   int i;
-  for (i=0; i<numBus; i++) {
-    if (p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      if (bus->checkVoltageViolation()) bus->setIgnore(true);
-    }
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
+    if (bus->checkVoltageViolation()) bus->setIgnore(true);
   }
 }
 
@@ -315,15 +447,12 @@ void gridpack::powerflow::PFFactoryModule::ignoreVoltageViolations()
  */
 void gridpack::powerflow::PFFactoryModule::clearVoltageViolations()
 {
-  int numBus = p_network->numBuses();
   int i;
-  for (i=0; i<numBus; i++) {
-    if (p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      bus->setIgnore(false);
-    }
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
+    bus->setIgnore(false);
   }
 }
 
@@ -334,27 +463,26 @@ void gridpack::powerflow::PFFactoryModule::clearVoltageViolations()
  */
 bool gridpack::powerflow::PFFactoryModule::checkLineOverloadViolations()
 {
-  int numBranch = p_network->numBranches();
-  int i;
+  int i, n;
   bool branch_ok = true;
-  for (i=0; i<numBranch; i++) {
-    if (p_network->getActiveBranch(i)) {
-      gridpack::powerflow::PFBranch *branch =
-        dynamic_cast<gridpack::powerflow::PFBranch*>
-        (p_network->getBranch(i).get());
-      // Loop over all lines in the branch and choose the smallest rating value
-      int nlines;
-      p_network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
-      std::vector<std::string> tags = branch->getLineTags();
-      double rateA;
-      for (int k = 0; k<nlines; k++) {
-        if (!branch->getIgnore(tags[k])) {
-          if (p_network->getBranchData(i)->getValue(BRANCH_RATING_A,&rateA,k)) {
-            if (rateA > 0.0) {
-              gridpack::ComplexType s = branch->getComplexPower(tags[k]);
-              double pq = abs(s);
-              if (pq > rateA) branch_ok = false;
-            }
+  gridpack::factory::ComponentRange<PFBranch> branch_list = branches();
+  const std::vector<int> &active = activeBranchIndices();
+  int nactive = active.size();
+  for (n=0; n<nactive; n++) {
+    i = active[n];
+    PFBranch *branch = branch_list[i];
+    // Loop over all lines in the branch and choose the smallest rating value
+    int nlines;
+    p_network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
+    std::vector<std::string> tags = branch->getLineTags();
+    double rateA;
+    for (int k = 0; k<nlines; k++) {
+      if (!branch->getIgnore(tags[k])) {
+        if (p_network->getBranchData(i)->getValue(BRANCH_RATING_A,&rateA,k)) {
+          if (rateA > 0.0) {
+            gridpack::ComplexType s = branch->getComplexPower(tags[k]);
+            double pq = abs(s);
+            if (pq > rateA) branch_ok = false;
           }
         }
       }
@@ -371,35 +499,34 @@ bool gridpack::powerflow::PFFactoryModule::checkLineOverloadViolations()
  */
 bool gridpack::powerflow::PFFactoryModule::checkLineOverloadViolations(int area)
 {
-  int numBranch = p_network->numBranches();
-  int i;
+  int i, n;
   bool branch_ok = true;
-  for (i=0; i<numBranch; i++) {
-    if (p_network->getActiveBranch(i)) {
-      gridpack::powerflow::PFBranch *branch =
-        dynamic_cast<gridpack::powerflow::PFBranch*>
-        (p_network->getBranch(i).get());
-      // get buses at either end
-      gridpack::powerflow::PFBus *bus1 =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (branch->getBus1().get());
-      gridpack::powerflow::PFBus *bus2 =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (branch->getBus2().get());
-      // Loop over all lines in the branch and choose the smallest rating value
-      if (bus1->getArea() == area || bus2->getArea() == area) {
-        int nlines;
-        p_network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
-        std::vector<std::string> tags = branch->getLineTags();
-        double rateA;
-        for (int k = 0; k<nlines; k++) {
-          if (!branch->getIgnore(tags[k])) {
-            if (p_network->getBranchData(i)->getValue(BRANCH_RATING_A,&rateA,k)) {
-              if (rateA > 0.0) {
-                gridpack::ComplexType s = branch->getComplexPower(tags[k]);
-                double pq = abs(s);
-                if (pq > rateA) branch_ok = false;
-              }
+  gridpack::factory::ComponentRange<PFBranch> branch_list = branches();
+  const std::vector<int> &active = activeBranchIndices();
+  int nactive = active.size();
+  for (n=0; n<nactive; n++) {
+    i = active[n];
+    PFBranch *branch = branch_list[i];
+    // get buses at either end
+    gridpack::powerflow::PFBus *bus1 =
+      dynamic_cast<gridpack::powerflow::PFBus*>
+      (branch->getBus1().get());
+    gridpack::powerflow::PFBus *bus2 =
+      dynamic_cast<gridpack::powerflow::PFBus*>
+      (branch->getBus2().get());
+    // Loop over all lines in the branch and choose the smallest rating value
+    if (bus1->getArea() == area || bus2->getArea() == area) {
+      int nlines;
+      p_network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
+      std::vector<std::string> tags = branch->getLineTags();
+      double rateA;
+      for (int k = 0; k<nlines; k++) {
+        if (!branch->getIgnore(tags[k])) {
+          if (p_network->getBranchData(i)->getValue(BRANCH_RATING_A,&rateA,k)) {
+            if (rateA > 0.0) {
+              gridpack::ComplexType s = branch->getComplexPower(tags[k]);
+              double pq = abs(s);
+              if (pq > rateA) branch_ok = false;
             }
           }
         }
@@ -415,25 +542,24 @@ bool gridpack::powerflow::PFFactoryModule::checkLineOverloadViolations(int area)
  */
 void gridpack::powerflow::PFFactoryModule::ignoreLineOverloadViolations()
 {
-  int numBranch = p_network->numBranches();
-  int i;
-  for (i=0; i<numBranch; i++) {
-    if (p_network->getActiveBranch(i)) {
-      gridpack::powerflow::PFBranch *branch =
-        dynamic_cast<gridpack::powerflow::PFBranch*>
-        (p_network->getBranch(i).get());
-      // Loop over all lines in the branch and choose the smallest rating value
-      int nlines;
-      p_network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
-      std::vector<std::string> tags = branch->getLineTags();
-      double rateA;
-      for (int k = 0; k<nlines; k++) {
-        if (p_network->getBranchData(i)->getValue(BRANCH_RATING_A,&rateA,k)) {
-          if (rateA > 0.0) {
-            gridpack::ComplexType s = branch->getComplexPower(tags[k]);
-            double pq = abs(s);
-            if (pq > rateA) branch->setIgnore(tags[k],true);
-          }
+  int i, n;
+  gridpack::factory::ComponentRange<PFBranch> branch_list = branches();
+  const std::vector<int> &active = activeBranchIndices();
+  int nactive = active.size();
+  for (n=0; n<nactive; n++) {
+    i = active[n];
+    PFBranch *branch = branch_list[i];
+    // Loop over all lines in the branch and choose the smallest rating value
+    int nlines;
+    p_network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
+    std::vector<std::string> tags = branch->getLineTags();
+    double rateA;
+    for (int k = 0; k<nlines; k++) {
+      if (p_network->getBranchData(i)->getValue(BRANCH_RATING_A,&rateA,k)) {
+        if (rateA > 0.0) {
+          gridpack::ComplexType s = branch->getComplexPower(tags[k]);
+          double pq = abs(s);
+          if (pq > rateA) branch->setIgnore(tags[k],true);
         }
       }
     }
@@ -445,21 +571,20 @@ void gridpack::powerflow::PFFactoryModule::ignoreLineOverloadViolations()
  */
 void gridpack::powerflow::PFFactoryModule::clearLineOverloadViolations()
 {
-  int numBranch = p_network->numBranches();
-  int i;
-  for (i=0; i<numBranch; i++) {
-    if (p_network->getActiveBranch(i)) {
-      gridpack::powerflow::PFBranch *branch =
-        dynamic_cast<gridpack::powerflow::PFBranch*>
-        (p_network->getBranch(i).get());
-      // Loop over all lines in the branch and choose the smallest rating value
-      int nlines;
-      p_network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
-      std::vector<std::string> tags = branch->getLineTags();
-      double rateA;
-      for (int k = 0; k<nlines; k++) {
-        branch->setIgnore(tags[k],false);
-      }
+  int i, n;
+  gridpack::factory::ComponentRange<PFBranch> branch_list = branches();
+  const std::vector<int> &active = activeBranchIndices();
+  int nactive = active.size();
+  for (n=0; n<nactive; n++) {
+    i = active[n];
+    PFBranch *branch = branch_list[i];
+    // Loop over all lines in the branch and choose the smallest rating value
+    int nlines;
+    p_network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
+    std::vector<std::string> tags = branch->getLineTags();
+    double rateA;
+    for (int k = 0; k<nlines; k++) {
+      branch->setIgnore(tags[k],false);
     }
   }
 }
@@ -473,21 +598,17 @@ bool gridpack::powerflow::PFFactoryModule::checkQlimViolations()
   int numBus = p_network->numBuses();
   int i;
   bool bus_ok = true;
-  for (i=0; i<numBus; i++) {
-    if (p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      if (bus->chkQlim()) bus_ok = false;
-    }
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
+    if (bus->chkQlim()) bus_ok = false;
   }
   p_network->updateBuses();
+  gridpack::factory::ComponentRange<PFBus> bus_list = buses();
   for (i=0; i<numBus; i++) {
     if (!p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      bus->pushIsPV();
+      bus_list[i]->pushIsPV();
     }
   }
   return checkTrue(bus_ok);
@@ -503,23 +624,19 @@ bool gridpack::powerflow::PFFactoryModule::checkQlimViolations(int area)
   int numBus = p_network->numBuses();
   int i;
   bool bus_ok = true;
-  for (i=0; i<numBus; i++) {
-    if (p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      if (bus->getArea() == area) {
-        if (!bus->chkQlim()) bus_ok = false;
-      }
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
+    if (bus->getArea() == area) {
+      if (!bus->chkQlim()) bus_ok = false;
     }
   }
   p_network->updateBuses();
+  gridpack::factory::ComponentRange<PFBus> bus_list = buses();
   for (i=0; i<numBus; i++) {
     if (!p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      bus->pushIsPV();
+      bus_list[i]->pushIsPV();
     }
   }
   return checkTrue(bus_ok);
@@ -534,21 +651,17 @@ void gridpack::powerflow::PFFactoryModule::clearQlimViolations()
   int numBus = p_network->numBuses();
   int i;
   bool bus_ok = true;
-  for (i=0; i<numBus; i++) {
-    if (p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      bus->clearQlim();
-    }
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
+    bus->clearQlim();
   }
   p_network->updateBuses();
+  gridpack::factory::ComponentRange<PFBus> bus_list = buses();
   for (i=0; i<numBus; i++) {
     if (!p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
-        dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      bus->pushIsPV();
+      bus_list[i]->pushIsPV();
     }
   }
 }
@@ -557,17 +670,374 @@ void gridpack::powerflow::PFFactoryModule::clearQlimViolations()
  * Reinitialize voltages
  */
 void gridpack::powerflow::PFFactoryModule::resetVoltages()
+{
+  int i;
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
+    bus->resetVoltage();
+  }
+}
+
+/**
+ * Evaluate branch power flows for the whole network in flat arrays
+ * instead of through the components
+ * @param flag true if network-level kernel is used
+ */
+void gridpack::powerflow::PFFactoryModule::setInjectionKernel(bool flag)
 {
   int numBus = p_network->numBuses();
+  int numBranch = p_network->numBranches();
+  // Nothing to do if the kernel is already set up for this network. The
+  // admittances are kept current by setYBus and updateYBus
+  if (flag == p_kernel && (!flag ||
+        (static_cast<int>(p_kBus1.size()) == numBranch &&
+         static_cast<int>(p_kV.size()) == numBus))) return;
+  p_kernel = flag;
+  if (!p_kernel) {
+    p_kBus1.clear();
+    p_kBus2.clear();
+    p_kV.clear();
+    return;
+  }
   int i;
+  p_kBus1.resize(numBranch);
+  p_kBus2.resize(numBranch);
+  for (i=0; i<numBranch; i++) {
+    p_network->getBranchEndpoints(i,&p_kBus1[i],&p_kBus2[i]);
+  }
+  p_kTheta.resize(numBranch);
+  p_kCos.resize(numBranch);
+  p_kSin.resize(numBranch);
+  p_kVV.resize(numBranch);
+  p_kS1r.resize(numBranch);
+  p_kS1i.resize(numBranch);
+  p_kS2r.resize(numBranch);
+  p_kS2i.resize(numBranch);
+  p_kV.resize(numBus);
+  p_kA.resize(numBus);
+  p_kP.resize(numBus);
+  p_kQ.resize(numBus);
+  loadKernelAdmittances();
+}
+
+/**
+ * Evaluate branch power flows with the network-level kernel and push the
+ * results into the buses and branches
+ */
+void gridpack::powerflow::PFFactoryModule::evaluateInjections(void)
+{
+  if (!p_kernel) return;
+  int numBus = p_network->numBuses();
+  int numBranch = p_network->numBranches();
+  if (static_cast<int>(p_kBus1.size()) != numBranch ||
+      static_cast<int>(p_kV.size()) != numBus) {
+    char buf[256];
+    sprintf(buf,"PFFactoryModule::evaluateInjections: network has changed"
+        " size, buses: %d branches: %d\n",numBus,numBranch);
+    throw gridpack::Exception(buf);
+  }
+  int i;
+  gridpack::factory::ComponentRange<PFBus> bus_list = buses();
+  gridpack::factory::ComponentRange<PFBranch> branch_list = branches();
+
+  // Gather bus state (ghost buses must be up to date)
   for (i=0; i<numBus; i++) {
-    if (p_network->getActiveBus(i)) {
-      gridpack::powerflow::PFBus *bus =
+    PFBus *bus = bus_list[i];
+    p_kV[i] = bus->getVoltage();
+    p_kA[i] = bus->getPhase();
+    p_kP[i] = 0.0;
+    p_kQ[i] = 0.0;
+  }
+
+  // Phase angle differences and trigonometric functions, once per branch.
+  // These loops contain no branches or indirect stores and can be
+  // vectorized by the compiler
+  const int *b1 = numBranch > 0 ? &p_kBus1[0] : NULL;
+  const int *b2 = numBranch > 0 ? &p_kBus2[0] : NULL;
+  double *theta = numBranch > 0 ? &p_kTheta[0] : NULL;
+  double *cs = numBranch > 0 ? &p_kCos[0] : NULL;
+  double *sn = numBranch > 0 ? &p_kSin[0] : NULL;
+  double *vv = numBranch > 0 ? &p_kVV[0] : NULL;
+  const double *a = numBus > 0 ? &p_kA[0] : NULL;
+  const double *v = numBus > 0 ? &p_kV[0] : NULL;
+  for (i=0; i<numBranch; i++) {
+    theta[i] = a[b1[i]] - a[b2[i]];
+    vv[i] = v[b1[i]]*v[b2[i]];
+  }
+  gridpack::math::complexCis(numBranch,theta,cs,sn);
+
+  // Flows at both ends of each branch in split complex arrays. This is
+  // equivalent to calling PFBranch::getPQ from each end. The from end is
+  // vv*cis(theta)*conj(Yfrwd) and the to end is the conjugate of
+  // vv*cis(theta)*Yrvrs
+  double *s1r = numBranch > 0 ? &p_kS1r[0] : NULL;
+  double *s1i = numBranch > 0 ? &p_kS1i[0] : NULL;
+  double *s2r = numBranch > 0 ? &p_kS2r[0] : NULL;
+  double *s2i = numBranch > 0 ? &p_kS2i[0] : NULL;
+  if (numBranch > 0) {
+    gridpack::math::complexMultiplyConj(numBranch,cs,sn,&p_kYrFrwd[0],
+        &p_kYiFrwd[0],s1r,s1i);
+    gridpack::math::complexMultiply(numBranch,cs,sn,&p_kYrRvrs[0],
+        &p_kYiRvrs[0],s2r,s2i);
+    gridpack::math::complexScale(numBranch,vv,s1r,s1i,s1r,s1i);
+    gridpack::math::complexScale(numBranch,vv,s2r,s2i,s2r,s2i);
+  }
+
+  // Accumulate flows at the buses
+  double *P = numBus > 0 ? &p_kP[0] : NULL;
+  double *Q = numBus > 0 ? &p_kQ[0] : NULL;
+  for (i=0; i<numBranch; i++) {
+    int i1 = b1[i];
+    int i2 = b2[i];
+    P[i1] += s1r[i];
+    Q[i1] += s1i[i];
+    P[i2] += s2r[i];
+    Q[i2] -= s2i[i];
+  }
+
+  // Push results back into components. Sums on ghost buses are incomplete
+  // but are never used
+  for (i=0; i<numBranch; i++) {
+    branch_list[i]->setPhaseDifference(theta[i],cs[i],sn[i]);
+  }
+  for (i=0; i<numBus; i++) {
+    bus_list[i]->setBranchInjection(P[i],Q[i]);
+  }
+}
+
+/**
+ * Copy branch admittances into the arrays used by evaluateInjections
+ */
+void gridpack::powerflow::PFFactoryModule::loadKernelAdmittances(void)
+{
+  int numBranch = p_network->numBranches();
+  int i;
+  gridpack::factory::ComponentRange<PFBranch> branch_list = branches();
+  p_kYrFrwd.resize(numBranch);
+  p_kYiFrwd.resize(numBranch);
+  p_kYrRvrs.resize(numBranch);
+  p_kYiRvrs.resize(numBranch);
+  for (i=0; i<numBranch; i++) {
+    branch_list[i]->getPQAdmittance(&p_kYrFrwd[i],&p_kYiFrwd[i],
+        &p_kYrRvrs[i],&p_kYiRvrs[i]);
+  }
+}
+
+/**
+ * Build sorted list of all areas in the network. This is only done
+ * the first time an audit is run
+ */
+void gridpack::powerflow::PFFactoryModule::setupAuditAreas()
+{
+  if (p_auditAreasSet) return;
+  int i;
+  std::set<int> local;
+  gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+  int nactive = active.size();
+  for (i=0; i<nactive; i++) {
+    PFBus *bus = active[i];
+    local.insert(bus->getArea());
+  }
+  std::vector<int> areas(local.begin(), local.end());
+  MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
+  int nprocs = p_network->communicator().size();
+  int nlocal = areas.size();
+  std::vector<int> counts(nprocs);
+  MPI_Allgather(&nlocal,1,MPI_INT,&counts[0],1,MPI_INT,comm);
+  std::vector<int> offsets(nprocs,0);
+  for (i=1; i<nprocs; i++) offsets[i] = offsets[i-1]+counts[i-1];
+  std::vector<int> all(offsets[nprocs-1]+counts[nprocs-1]+1);
+  MPI_Allgatherv((nlocal > 0 ? &areas[0] : &all[0]),nlocal,MPI_INT,
+      &all[0],&counts[0],&offsets[0],MPI_INT,comm);
+  all.pop_back();
+  std::sort(all.begin(),all.end());
+  all.erase(std::unique(all.begin(),all.end()),all.end());
+  p_auditAreas.swap(all);
+  p_auditAreasSet = true;
+}
+
+/**
+ * Start a violation audit. This does the local evaluation and posts a
+ * non-blocking reduction, so that other work can be done before calling
+ * finishViolationAudit. Only one audit can be outstanding at a time.
+ * This is collective.
+ * @param checks bitwise or of PFAuditCheck values
+ */
+void gridpack::powerflow::PFFactoryModule::startViolationAudit(int checks)
+{
+  if (p_auditPending) {
+    char buf[256];
+    sprintf(buf,"PFFactoryModule::startViolationAudit: previous audit"
+        " has not been finished\n");
+    throw gridpack::Exception(buf);
+  }
+  setupAuditAreas();
+  int nareas = p_auditAreas.size();
+  p_auditChecks = checks;
+  // Record 0 is the whole network, followed by one record for each area
+  p_auditBuf.assign((nareas+1)*AUDIT_RECORD,0.0);
+  int i, k;
+  for (i=0; i<=nareas; i++) {
+    double *rec = &p_auditBuf[i*AUDIT_RECORD];
+    rec[AUDIT_BUS_V] = -1.0;
+    rec[AUDIT_FROM_L] = -1.0;
+    rec[AUDIT_TO_L] = -1.0;
+    rec[AUDIT_BUS_Q] = -1.0;
+  }
+
+  if (checks & (AUDIT_VOLTAGE | AUDIT_QLIM)) {
+    gridpack::factory::ComponentRange<PFBus> active = activeBuses();
+    int nactive = active.size();
+    for (i=0; i<nactive; i++) {
+      PFBus *bus = active[i];
+      int idx = std::lower_bound(p_auditAreas.begin(),p_auditAreas.end(),
+          bus->getArea()) - p_auditAreas.begin();
+      double *tot = &p_auditBuf[0];
+      double *rec = &p_auditBuf[(idx+1)*AUDIT_RECORD];
+      double loc = static_cast<double>(bus->getOriginalIndex());
+      if ((checks & AUDIT_VOLTAGE) && !bus->getIgnore()) {
+        double dv = bus->getVoltageViolation();
+        if (dv > 0.0) {
+          auditAdd(tot,AUDIT_NUM_V,AUDIT_MAX_V,AUDIT_BUS_V,-1,1,dv,loc,0.0);
+          auditAdd(rec,AUDIT_NUM_V,AUDIT_MAX_V,AUDIT_BUS_V,-1,1,dv,loc,0.0);
+        }
+      }
+      if (checks & AUDIT_QLIM) {
+        double dq = bus->getQlimViolation();
+        if (dq > 0.0) {
+          auditAdd(tot,AUDIT_NUM_Q,AUDIT_MAX_Q,AUDIT_BUS_Q,-1,1,dq,loc,0.0);
+          auditAdd(rec,AUDIT_NUM_Q,AUDIT_MAX_Q,AUDIT_BUS_Q,-1,1,dq,loc,0.0);
+        }
+      }
+    }
+  }
+
+  if (checks & AUDIT_LINE_OVERLOAD) {
+    int n;
+    gridpack::factory::ComponentRange<PFBranch> branch_list = branches();
+    const std::vector<int> &active = activeBranchIndices();
+    int nactive = active.size();
+    for (n=0; n<nactive; n++) {
+      i = active[n];
+      PFBranch *branch = branch_list[i];
+      // Find the worst overloaded line in the branch
+      int nlines;
+      p_network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
+      std::vector<std::string> tags = branch->getLineTags();
+      double rateA;
+      double worst = 0.0;
+      int nover = 0;
+      for (k = 0; k<nlines; k++) {
+        if (!branch->getIgnore(tags[k])) {
+          if (p_network->getBranchData(i)->getValue(BRANCH_RATING_A,&rateA,k)) {
+            if (rateA > 0.0) {
+              gridpack::ComplexType s = branch->getComplexPower(tags[k]);
+              double pq = abs(s);
+              if (pq > rateA) {
+                nover++;
+                if (pq-rateA > worst) worst = pq-rateA;
+              }
+            }
+          }
+        }
+      }
+      if (nover == 0) continue;
+      gridpack::powerflow::PFBus *bus1 =
+        dynamic_cast<gridpack::powerflow::PFBus*>
+        (branch->getBus1().get());
+      gridpack::powerflow::PFBus *bus2 =
         dynamic_cast<gridpack::powerflow::PFBus*>
-        (p_network->getBus(i).get());
-      bus->resetVoltage();
+        (branch->getBus2().get());
+      double loc1 = static_cast<double>(bus1->getOriginalIndex());
+      double loc2 = static_cast<double>(bus2->getOriginalIndex());
+      // A branch between two areas is reported in both areas
+      int idx1 = std::lower_bound(p_auditAreas.begin(),p_auditAreas.end(),
+          bus1->getArea()) - p_auditAreas.begin();
+      int idx2 = std::lower_bound(p_auditAreas.begin(),p_auditAreas.end(),
+          bus2->getArea()) - p_auditAreas.begin();
+      // Every overloaded line is counted, but the branch only appears
+      // once with its worst line
+      auditAdd(&p_auditBuf[0],AUDIT_NUM_L,AUDIT_MAX_L,AUDIT_FROM_L,
+          AUDIT_TO_L,nover,worst,loc1,loc2);
+      auditAdd(&p_auditBuf[(idx1+1)*AUDIT_RECORD],AUDIT_NUM_L,AUDIT_MAX_L,
+          AUDIT_FROM_L,AUDIT_TO_L,nover,worst,loc1,loc2);
+      if (idx2 != idx1) {
+        auditAdd(&p_auditBuf[(idx2+1)*AUDIT_RECORD],AUDIT_NUM_L,
+            AUDIT_MAX_L,AUDIT_FROM_L,AUDIT_TO_L,nover,worst,loc1,loc2);
+      }
     }
   }
+
+  MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
+  MPI_Op_create(&auditReduce,1,&p_auditOp);
+#if MPI_VERSION >= 3
+  MPI_Iallreduce(MPI_IN_PLACE,&p_auditBuf[0],p_auditBuf.size(),MPI_DOUBLE,
+      p_auditOp,comm,&p_auditRequest);
+#else
+  MPI_Allreduce(MPI_IN_PLACE,&p_auditBuf[0],p_auditBuf.size(),MPI_DOUBLE,
+      p_auditOp,comm);
+  p_auditRequest = MPI_REQUEST_NULL;
+#endif
+  p_auditPending = true;
+}
+
+/**
+ * Complete a violation audit started with startViolationAudit
+ * @return worst violations over the network and in each area
+ */
+gridpack::powerflow::PFViolationAudit
+gridpack::powerflow::PFFactoryModule::finishViolationAudit()
+{
+  if (!p_auditPending) {
+    char buf[256];
+    sprintf(buf,"PFFactoryModule::finishViolationAudit: no audit"
+        " has been started\n");
+    throw gridpack::Exception(buf);
+  }
+  MPI_Wait(&p_auditRequest,MPI_STATUS_IGNORE);
+  MPI_Op_free(&p_auditOp);
+  p_auditPending = false;
+
+  PFViolationAudit audit;
+  int nareas = p_auditAreas.size();
+  int i;
+  audit.areas.resize(nareas);
+  for (i=0; i<=nareas; i++) {
+    const double *rec = &p_auditBuf[i*AUDIT_RECORD];
+    PFAreaViolations &v = (i == 0 ? audit.total : audit.areas[i-1]);
+    v.area = (i == 0 ? -1 : p_auditAreas[i-1]);
+    v.numVoltage = static_cast<int>(rec[AUDIT_NUM_V]);
+    v.maxVoltage = rec[AUDIT_MAX_V];
+    v.voltageBus = static_cast<int>(rec[AUDIT_BUS_V]);
+    v.numLine = static_cast<int>(rec[AUDIT_NUM_L]);
+    v.maxLine = rec[AUDIT_MAX_L];
+    v.lineFromBus = static_cast<int>(rec[AUDIT_FROM_L]);
+    v.lineToBus = static_cast<int>(rec[AUDIT_TO_L]);
+    v.numQlim = static_cast<int>(rec[AUDIT_NUM_Q]);
+    v.maxQlim = rec[AUDIT_MAX_Q];
+    v.qlimBus = static_cast<int>(rec[AUDIT_BUS_Q]);
+  }
+  audit.checks = p_auditChecks;
+  audit.voltageOK = (audit.total.numVoltage == 0);
+  audit.lineOK = (audit.total.numLine == 0);
+  audit.qlimOK = (audit.total.numQlim == 0);
+  return audit;
+}
+
+/**
+ * Evaluate voltage, line overload and Q limit checks in a single pass
+ * over the local buses and branches and combine the results from all
+ * processors in a single reduction.
+ * @param checks bitwise or of PFAuditCheck values
+ * @return worst violations over the network and in each area
+ */
+gridpack::powerflow::PFViolationAudit
+gridpack::powerflow::PFFactoryModule::auditViolations(int checks)
+{
+  startViolationAudit(checks);
+  return finishViolationAudit();
 }
 
 } // namespace powerflow
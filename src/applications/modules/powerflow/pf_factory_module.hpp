@@ -18,6 +18,8 @@
 #ifndef _pf_factory_module_h_
 #define _pf_factory_module_h_
 
+#include <vector>
+#include <mpi.h>
 #include "boost/smart_ptr/shared_ptr.hpp"
 #include "gridpack/network/base_network.hpp"
 #include "gridpack/factory/base_factory.hpp"
@@ -29,6 +31,56 @@ namespace powerflow {
 /// The type of network used in the powerflow application
 typedef gridpack::network::BaseNetwork<PFBus, PFBranch > PFNetwork;
 
+/// Checks that can be included in a violation audit
+enum PFAuditCheck {
+  AUDIT_VOLTAGE = 1,
+  AUDIT_LINE_OVERLOAD = 2,
+  AUDIT_QLIM = 4,
+  AUDIT_ALL = 7
+};
+
+/**
+ * Number and size of violations found in an area (or the whole network)
+ * by PFFactoryModule::auditViolations. Bus indices are original indices.
+ * Indices of the worst violation are -1 if there are no violations
+ */
+struct PFAreaViolations {
+  int area;
+  // voltage violations, size is distance outside voltage limits
+  int numVoltage;
+  double maxVoltage;
+  int voltageBus;
+  // line overloads, size is MVA in excess of RATE A. Every overloaded
+  // line is counted and the worst one is reported by its branch
+  int numLine;
+  double maxLine;
+  int lineFromBus;
+  int lineToBus;
+  // Q limit violations on PV buses, size is MVAR outside generator limits
+  int numQlim;
+  double maxQlim;
+  int qlimBus;
+};
+
+/**
+ * Result of a violation audit
+ */
+struct PFViolationAudit {
+  // bitwise or of the PFAuditCheck values that were evaluated. Checks that
+  // were not evaluated report no violations
+  int checks;
+  // true if no voltage violations were found
+  bool voltageOK;
+  // true if no line overloads were found
+  bool lineOK;
+  // true if no Q limit violations were found
+  bool qlimOK;
+  // violations over the whole network (area is -1)
+  PFAreaViolations total;
+  // violations in each area, sorted by area
+  std::vector<PFAreaViolations> areas;
+};
+
 class PFFactoryModule
   : public gridpack::factory::BaseFactory<PFNetwork> {
   public:
@@ -48,6 +100,15 @@ class PFFactoryModule
      */
     void setYBus(void);
 
+    /**
+     * Recompute the admittance contributions of a set of branches and of
+     * the buses at either end of them. All other buses and branches must
+     * still hold the values from a previous call to setYBus
+     * @param branchIDs local indices of branches whose parameters or
+     * status have changed
+     */
+    void updateYBus(const std::vector<int> &branchIDs);
+
     /**
      * Make SBus vector 
      */
@@ -145,14 +206,98 @@ class PFFactoryModule
      */
     void clearLineOverloadViolations();
 
+    /**
+     * Evaluate voltage, line overload and Q limit checks in a single pass
+     * over the local buses and branches and combine the results from all
+     * processors in a single reduction. Buses and lines flagged to be
+     * ignored are skipped. Q limits are only checked, the buses are not
+     * modified (use checkQlimViolations to convert buses from PV to PQ).
+     * This is collective.
+     * @param checks bitwise or of PFAuditCheck values
+     * @return worst violations over the network and in each area
+     */
+    PFViolationAudit auditViolations(int checks = AUDIT_ALL);
+
+    /**
+     * Start a violation audit. This does the local evaluation and posts a
+     * non-blocking reduction, so that other work can be done before calling
+     * finishViolationAudit. Only one audit can be outstanding at a time.
+     * This is collective.
+     * @param checks bitwise or of PFAuditCheck values
+     */
+    void startViolationAudit(int checks = AUDIT_ALL);
+
+    /**
+     * Complete a violation audit started with startViolationAudit. This
+     * must be called on all processes before the factory is destroyed and
+     * before MPI is finalized. This is collective.
+     * @return worst violations over the network and in each area
+     */
+    PFViolationAudit finishViolationAudit();
+
     /**
      * Reinitialize voltages
      */
     void resetVoltages();
+
+    /**
+     * Evaluate branch power flows for the whole network in flat arrays
+     * instead of through the components. When this is enabled, the branch
+     * admittances and endpoints are copied into contiguous arrays (and the
+     * admittances are refreshed by setYBus) so that evaluateInjections can
+     * compute the phase angle differences and their sine and cosine once per
+     * branch, evaluate the flows at both ends with the batched complex
+     * kernels and accumulate the power injections in a single pass. The
+     * arrays are only rebuilt if the flag changes or the network has changed
+     * size, so this can be called before every solve
+     * @param flag true if network-level kernel is used
+     */
+    void setInjectionKernel(bool flag);
+
+    /**
+     * Evaluate branch power flows with the network-level kernel and push the
+     * results into the buses and branches. This must be called after ghost
+     * buses have been updated and before the RHS vector is mapped. The
+     * following RHS and Jacobian evaluations use the results instead of
+     * calculating them branch by branch. Does nothing if the kernel has not
+     * been enabled with setInjectionKernel
+     */
+    void evaluateInjections(void);
   private:
 
+    /**
+     * Build sorted list of all areas in the network. This is only done
+     * the first time an audit is run
+     */
+    void setupAuditAreas();
+
     NetworkPtr p_network;
     std::vector<bool> p_saveIsolatedStatus;
+
+    // sorted list of areas in network, used by audits
+    std::vector<int> p_auditAreas;
+    bool p_auditAreasSet;
+
+    // checks and buffer for outstanding audit
+    int p_auditChecks;
+    std::vector<double> p_auditBuf;
+    bool p_auditPending;
+    MPI_Request p_auditRequest;
+    MPI_Op p_auditOp;
+
+    /**
+     * Copy branch admittances into the arrays used by evaluateInjections
+     */
+    void loadKernelAdmittances(void);
+
+    // network-level injection kernel. Branch arrays are indexed by local
+    // branch index and bus arrays by local bus index
+    bool p_kernel;
+    std::vector<int> p_kBus1, p_kBus2;
+    std::vector<double> p_kYrFrwd, p_kYiFrwd, p_kYrRvrs, p_kYiRvrs;
+    std::vector<double> p_kTheta, p_kCos, p_kSin, p_kVV;
+    std::vector<double> p_kS1r, p_kS1i, p_kS2r, p_kS2i;
+    std::vector<double> p_kV, p_kA, p_kP, p_kQ;
 };
 
 } // powerflow
@@ -0,0 +1,557 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   pf_factory_test.cpp
+ * @date   2026-10-19
+ *
+ * @brief  Check that the shortcuts in PFFactoryModule give the same
+ *         results as the component path on the IEEE 14 bus network, that
+ *         violation audits agree with the existing checks, and that groups
+ *         of processes sharing one network read get the whole network
+ */
+// -------------------------------------------------------------
+
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "mpi.h"
+#include <ga.h>
+#include <macdecls.h>
+#include "gridpack/parallel/parallel.hpp"
+#include "gridpack/math/math.hpp"
+#include "gridpack/mapper/full_map.hpp"
+#include "gridpack/mapper/bus_vector_map.hpp"
+#include "gridpack/parser/PTI23_parser.hpp"
+#include "pf_factory_module.hpp"
+#include "pf_app_module.hpp"
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+using gridpack::powerflow::PFNetwork;
+
+static const double delta(1.0e-10);
+
+/**
+ * Read and partition the IEEE 14 bus network and set up the factory up to
+ * the point where the power flow iterations start
+ * @param nareas if greater than zero, replace the areas in the .raw file
+ * by 1 + (bus index)%nareas
+ */
+static boost::shared_ptr<PFNetwork> setupNetwork(
+    boost::shared_ptr<gridpack::powerflow::PFFactoryModule> &factory,
+    int nareas = 0)
+{
+  gridpack::parallel::Communicator world;
+  boost::shared_ptr<PFNetwork> network(new PFNetwork(world));
+  gridpack::parser::PTI23_parser<PFNetwork> parser(network);
+  parser.parse("IEEE14.raw");
+  network->partition();
+  if (nareas > 0) {
+    int i;
+    for (i=0; i<network->numBuses(); i++) {
+      int area = 1+network->getOriginalBusIndex(i)%nareas;
+      network->getBusData(i)->setValue(BUS_AREA,area);
+    }
+  }
+  factory.reset(new gridpack::powerflow::PFFactoryModule(network));
+  factory->load();
+  factory->setComponents();
+  factory->setExchange();
+  network->initBusUpdate();
+  factory->setYBus();
+  factory->setSBus();
+  return network;
+}
+
+/**
+ * Sum of the power flowing out of a bus, evaluated branch by branch in the
+ * components
+ */
+static void componentInjection(gridpack::powerflow::PFBus *bus, double *P,
+    double *Q)
+{
+  std::vector<boost::shared_ptr<gridpack::component::BaseComponent> >
+    branches;
+  bus->getNeighborBranches(branches);
+  *P = 0.0;
+  *Q = 0.0;
+  size_t i;
+  for (i=0; i<branches.size(); i++) {
+    double p, q;
+    dynamic_cast<gridpack::powerflow::PFBranch*>(branches[i].get())
+      ->getPQ(bus, &p, &q);
+    *P += p;
+    *Q += q;
+  }
+}
+
+/**
+ * Evaluate the injections with the network-level kernel and check them
+ * against the sums over the branches on all local buses. The sums on
+ * ghost buses are incomplete and never used
+ */
+static bool kernelMatchesComponents(boost::shared_ptr<PFNetwork> &network,
+    boost::shared_ptr<gridpack::powerflow::PFFactoryModule> &factory)
+{
+  factory->evaluateInjections();
+  int nbus = network->numBuses();
+  int i;
+  bool ok = true;
+  for (i=0; i<nbus; i++) {
+    double Pk, Qk;
+    if (!network->getBus(i)->getBranchInjection(&Pk,&Qk)) ok = false;
+    if (!network->getActiveBus(i)) continue;
+    double P, Q;
+    componentInjection(network->getBus(i).get(), &P, &Q);
+    if (std::abs(P-Pk) > delta*(1.0+std::abs(P)) ||
+        std::abs(Q-Qk) > delta*(1.0+std::abs(Q))) {
+      std::cout << "Bus " << network->getOriginalBusIndex(i)
+        << " component P, Q: " << P << ", " << Q
+        << " kernel P, Q: " << Pk << ", " << Qk << std::endl;
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+/**
+ * Check that two vectors agree to within a relative tolerance
+ */
+static bool sameVector(const gridpack::math::Vector &A,
+    const gridpack::math::Vector &B)
+{
+  boost::scoped_ptr<gridpack::math::Vector> D(A.clone());
+  D->add(B, -1.0);
+  double scale = A.normInfinity();
+  if (scale < 1.0) scale = 1.0;
+  return D->normInfinity() <= delta*scale;
+}
+
+/**
+ * Check that two matrices with the same layout agree to within a relative
+ * tolerance
+ */
+static bool sameMatrix(const gridpack::math::Matrix &A,
+    const gridpack::math::Matrix &B)
+{
+  boost::scoped_ptr<gridpack::math::Matrix> D(A.clone());
+  D->scale(-1.0);
+  D->add(B);
+  double scale = A.norm2();
+  if (scale < 1.0) scale = 1.0;
+  return D->norm2() <= delta*scale;
+}
+
+/**
+ * Map the admittance matrix from the values currently held by the
+ * components
+ */
+static boost::shared_ptr<gridpack::math::Matrix> mapYBus(
+    boost::shared_ptr<PFNetwork> &network,
+    boost::shared_ptr<gridpack::powerflow::PFFactoryModule> &factory)
+{
+  factory->setMode(gridpack::powerflow::YBus);
+  gridpack::mapper::FullMatrixMap<PFNetwork> yMap(network);
+  return yMap.mapToMatrix();
+}
+
+/**
+ * Set the status of all elements of the branches between two buses, the
+ * same way PFAppModule::setContingency does
+ * @param from original index of first bus
+ * @param to original index of second bus
+ * @param status new status of the branch elements
+ * @return local indices of the branches that were changed
+ */
+static std::vector<int> setLineStatus(boost::shared_ptr<PFNetwork> &network,
+    int from, int to, bool status)
+{
+  std::vector<int> lids = network->getLocalBranchIndices(from,to);
+  size_t i;
+  for (i=0; i<lids.size(); i++) {
+    std::string tag;
+    network->getBranchData(lids[i])->getValue(BRANCH_CKT,&tag,0);
+    network->getBranch(lids[i])->setBranchStatus(tag,status);
+  }
+  return lids;
+}
+
+/**
+ * Number of neighbors and base voltage of each bus, indexed by the original
+ * bus index and summed over the processes in the network communicator
+ * @param nmax largest original bus index
+ */
+static void busTable(boost::shared_ptr<PFNetwork> &network, int nmax,
+    std::vector<int> &nbr, std::vector<double> &kv)
+{
+  nbr.assign(nmax+1, 0);
+  kv.assign(nmax+1, 0.0);
+  int i;
+  for (i=0; i<network->numBuses(); i++) {
+    if (!network->getActiveBus(i)) continue;
+    int idx = network->getOriginalBusIndex(i);
+    nbr[idx] += network->getConnectedBuses(i).size();
+    double rval;
+    if (network->getBusData(i)->getValue(BUS_BASEKV,&rval)) kv[idx] += rval;
+  }
+  network->communicator().sum(&nbr[0], nmax+1);
+  network->communicator().sum(&kv[0], nmax+1);
+}
+
+/**
+ * Number of violations and the worst violation found by searching the
+ * buses or branches directly. Ties go to the smallest location, as in the
+ * violation audit
+ */
+struct Violations {
+  int num;
+  double mag;
+  int loc1, loc2;
+  Violations(void) : num(0), mag(0.0), loc1(-1), loc2(-1) { }
+  void add(int count, double m, int l1, int l2)
+  {
+    num += count;
+    if (m > mag || (m == mag && (loc1 < 0 || l1 < loc1 ||
+            (l1 == loc1 && l2 < loc2)))) {
+      mag = m;
+      loc1 = l1;
+      loc2 = l2;
+    }
+  }
+  // combine the results from all processes
+  void reduce(const gridpack::parallel::Communicator &comm)
+  {
+    static const int big = 1000000000;
+    comm.sum(&num,1);
+    double gmag = mag;
+    comm.max(&gmag,1);
+    int l1 = (loc1 >= 0 && mag == gmag ? loc1 : big);
+    comm.min(&l1,1);
+    int l2 = (loc1 >= 0 && mag == gmag && loc1 == l1 ? loc2 : big);
+    comm.min(&l2,1);
+    mag = gmag;
+    loc1 = (l1 == big ? -1 : l1);
+    loc2 = (l2 == big ? -1 : l2);
+  }
+};
+
+/**
+ * Find the voltage, line overload and Q limit violations in one area (or in
+ * the whole network if area is -1) by looping over the buses and branches
+ * in the same way as the check*Violations functions
+ */
+static void findViolations(boost::shared_ptr<PFNetwork> &network, int area,
+    Violations &volt, Violations &line, Violations &qlim)
+{
+  int i, k;
+  for (i=0; i<network->numBuses(); i++) {
+    if (!network->getActiveBus(i)) continue;
+    gridpack::powerflow::PFBus *bus = network->getBus(i).get();
+    if (area >= 0 && bus->getArea() != area) continue;
+    int idx = bus->getOriginalIndex();
+    if (!bus->getIgnore() && bus->getVoltageViolation() > 0.0) {
+      volt.add(1, bus->getVoltageViolation(), idx, -1);
+    }
+    if (bus->getQlimViolation() > 0.0) {
+      qlim.add(1, bus->getQlimViolation(), idx, -1);
+    }
+  }
+  for (i=0; i<network->numBranches(); i++) {
+    if (!network->getActiveBranch(i)) continue;
+    gridpack::powerflow::PFBranch *branch = network->getBranch(i).get();
+    gridpack::powerflow::PFBus *bus1 =
+      dynamic_cast<gridpack::powerflow::PFBus*>(branch->getBus1().get());
+    gridpack::powerflow::PFBus *bus2 =
+      dynamic_cast<gridpack::powerflow::PFBus*>(branch->getBus2().get());
+    if (area >= 0 && bus1->getArea() != area && bus2->getArea() != area) {
+      continue;
+    }
+    int nlines;
+    network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
+    std::vector<std::string> tags = branch->getLineTags();
+    int nover = 0;
+    double worst = 0.0;
+    for (k=0; k<nlines; k++) {
+      double rateA;
+      if (branch->getIgnore(tags[k])) continue;
+      if (!network->getBranchData(i)->getValue(BRANCH_RATING_A,&rateA,k) ||
+          rateA <= 0.0) continue;
+      double pq = abs(branch->getComplexPower(tags[k]));
+      if (pq > rateA) {
+        nover++;
+        if (pq-rateA > worst) worst = pq-rateA;
+      }
+    }
+    if (nover > 0) {
+      line.add(nover, worst, bus1->getOriginalIndex(),
+          bus2->getOriginalIndex());
+    }
+  }
+  volt.reduce(network->communicator());
+  line.reduce(network->communicator());
+  qlim.reduce(network->communicator());
+}
+
+/**
+ * Check the results of a violation audit for one area against a direct
+ * search
+ */
+static bool sameViolations(const gridpack::powerflow::PFAreaViolations &v,
+    const Violations &volt, const Violations &line, const Violations &qlim)
+{
+  bool ok = (v.numVoltage == volt.num && v.maxVoltage == volt.mag &&
+      v.voltageBus == volt.loc1 &&
+      v.numLine == line.num && v.maxLine == line.mag &&
+      v.lineFromBus == line.loc1 && v.lineToBus == line.loc2 &&
+      v.numQlim == qlim.num && v.maxQlim == qlim.mag &&
+      v.qlimBus == qlim.loc1);
+  if (!ok) {
+    std::cout << "Area " << v.area << " audit: " << v.numVoltage << " "
+      << v.maxVoltage << " " << v.voltageBus << ", " << v.numLine << " "
+      << v.maxLine << " " << v.lineFromBus << "-" << v.lineToBus << ", "
+      << v.numQlim << " " << v.maxQlim << " " << v.qlimBus
+      << " expected: " << volt.num << " " << volt.mag << " " << volt.loc1
+      << ", " << line.num << " " << line.mag << " " << line.loc1 << "-"
+      << line.loc2 << ", " << qlim.num << " " << qlim.mag << " "
+      << qlim.loc1 << std::endl;
+  }
+  return ok;
+}
+
+BOOST_AUTO_TEST_SUITE(PFFactoryTest)
+
+BOOST_AUTO_TEST_CASE(InjectionKernel)
+{
+  boost::shared_ptr<gridpack::powerflow::PFFactoryModule> factory;
+  boost::shared_ptr<PFNetwork> network = setupNetwork(factory);
+
+  // Move away from the solution in the .raw file so that the mismatches
+  // are not small
+  factory->setMode(gridpack::powerflow::RHS);
+  gridpack::mapper::BusVectorMap<PFNetwork> vMap(network);
+  boost::shared_ptr<gridpack::math::Vector> X = vMap.mapToVector();
+  X->scale(0.05);
+  vMap.mapToBus(X);
+  network->updateBuses();
+
+  // Right hand side and Jacobian evaluated branch by branch
+  factory->setInjectionKernel(false);
+  factory->setMode(gridpack::powerflow::RHS);
+  boost::shared_ptr<gridpack::math::Vector> PQc = vMap.mapToVector();
+  factory->setMode(gridpack::powerflow::Jacobian);
+  gridpack::mapper::FullMatrixMap<PFNetwork> jMap(network);
+  boost::shared_ptr<gridpack::math::Matrix> Jc = jMap.mapToMatrix();
+
+  // Same quantities with the network-level kernel. Bus sums agree with
+  // the sums over the branches
+  factory->setInjectionKernel(true);
+  BOOST_CHECK(kernelMatchesComponents(network, factory));
+  factory->setMode(gridpack::powerflow::RHS);
+  boost::shared_ptr<gridpack::math::Vector> PQk = vMap.mapToVector();
+  factory->setMode(gridpack::powerflow::Jacobian);
+  boost::shared_ptr<gridpack::math::Matrix> Jk = jMap.mapToMatrix();
+  BOOST_CHECK(sameVector(*PQc, *PQk));
+  BOOST_CHECK(sameMatrix(*Jc, *Jk));
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalYBus)
+{
+  boost::shared_ptr<gridpack::powerflow::PFFactoryModule> factory;
+  boost::shared_ptr<PFNetwork> network = setupNetwork(factory);
+  boost::shared_ptr<gridpack::math::Matrix> Y0 = mapYBus(network, factory);
+  factory->setInjectionKernel(true);
+
+  // Take line 2-4 out of service and only update the admittances that
+  // depend on it. The result must match a full evaluation and must
+  // differ from the original matrix. Enabling the kernel again, as every
+  // solve does, keeps the admittances refreshed by updateYBus
+  std::vector<int> lids = setLineStatus(network, 2, 4, false);
+  factory->updateYBus(lids);
+  factory->setInjectionKernel(true);
+  BOOST_CHECK(kernelMatchesComponents(network, factory));
+  boost::shared_ptr<gridpack::math::Matrix> Yinc = mapYBus(network, factory);
+  factory->setYBus();
+  boost::shared_ptr<gridpack::math::Matrix> Yfull = mapYBus(network, factory);
+  BOOST_CHECK(sameMatrix(*Yfull, *Yinc));
+  BOOST_CHECK(!sameMatrix(*Y0, *Yfull));
+
+  // Restore the line. Both paths must give back the original matrix
+  lids = setLineStatus(network, 2, 4, true);
+  factory->updateYBus(lids);
+  Yinc = mapYBus(network, factory);
+  factory->setYBus();
+  Yfull = mapYBus(network, factory);
+  BOOST_CHECK(sameMatrix(*Yfull, *Yinc));
+  BOOST_CHECK(sameMatrix(*Y0, *Yfull));
+
+  // Indices outside the local branches are rejected
+  std::vector<int> bad(1, network->numBranches());
+  BOOST_CHECK_THROW(factory->updateYBus(bad), gridpack::Exception);
+}
+
+BOOST_AUTO_TEST_CASE(ViolationAudit)
+{
+  // Spread the buses over three areas and use tight voltage limits and
+  // line ratings, so that the solution in the .raw file has violations in
+  // some places but not everywhere
+  boost::shared_ptr<gridpack::powerflow::PFFactoryModule> factory;
+  boost::shared_ptr<PFNetwork> network = setupNetwork(factory, 3);
+  factory->setVoltageLimits(0.99, 1.05);
+  int i, k;
+  for (i=0; i<network->numBranches(); i++) {
+    int nlines;
+    network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&nlines);
+    for (k=0; k<nlines; k++) {
+      if (!network->getBranchData(i)->setValue(BRANCH_RATING_A,40.0,k)) {
+        network->getBranchData(i)->addValue(BRANCH_RATING_A,40.0,k);
+      }
+    }
+  }
+
+  // Totals and worst violations agree with a direct search and the pass
+  // or fail results agree with the existing checks
+  gridpack::powerflow::PFViolationAudit audit = factory->auditViolations();
+  BOOST_CHECK_EQUAL(audit.checks, gridpack::powerflow::AUDIT_ALL);
+  Violations volt, line, qlim;
+  findViolations(network, -1, volt, line, qlim);
+  BOOST_CHECK(volt.num > 0 && line.num > 0);
+  BOOST_CHECK(sameViolations(audit.total, volt, line, qlim));
+  BOOST_CHECK_EQUAL(audit.voltageOK, factory->checkVoltageViolations());
+  BOOST_CHECK_EQUAL(audit.lineOK, factory->checkLineOverloadViolations());
+  BOOST_CHECK_EQUAL(audit.qlimOK, qlim.num == 0);
+
+  // Same for each area. A line between two areas is counted in both
+  BOOST_CHECK_EQUAL(static_cast<int>(audit.areas.size()), 3);
+  int nvolt = 0;
+  for (i=0; i<static_cast<int>(audit.areas.size()); i++) {
+    int area = audit.areas[i].area;
+    BOOST_CHECK_EQUAL(area, i+1);
+    Violations avolt, aline, aqlim;
+    findViolations(network, area, avolt, aline, aqlim);
+    BOOST_CHECK(sameViolations(audit.areas[i], avolt, aline, aqlim));
+    BOOST_CHECK_EQUAL(audit.areas[i].numVoltage == 0,
+        factory->checkVoltageViolations(area));
+    BOOST_CHECK_EQUAL(audit.areas[i].numLine == 0,
+        factory->checkLineOverloadViolations(area));
+    nvolt += audit.areas[i].numVoltage;
+  }
+  BOOST_CHECK_EQUAL(nvolt, audit.total.numVoltage);
+
+  // Checks that are not requested report no violations
+  audit = factory->auditViolations(gridpack::powerflow::AUDIT_VOLTAGE);
+  BOOST_CHECK_EQUAL(audit.checks, gridpack::powerflow::AUDIT_VOLTAGE);
+  BOOST_CHECK_EQUAL(audit.total.numVoltage, volt.num);
+  BOOST_CHECK_EQUAL(audit.total.numLine, 0);
+  BOOST_CHECK(audit.lineOK && audit.qlimOK);
+
+  // Ignored buses are skipped
+  for (i=0; i<network->numBuses(); i++) network->getBus(i)->setIgnore(true);
+  audit = factory->auditViolations(gridpack::powerflow::AUDIT_VOLTAGE);
+  BOOST_CHECK(audit.voltageOK);
+  BOOST_CHECK(factory->checkVoltageViolations());
+  factory->clearVoltageViolations();
+
+  // Only one audit can be outstanding and it must be started first
+  factory->startViolationAudit(gridpack::powerflow::AUDIT_LINE_OVERLOAD);
+  BOOST_CHECK_THROW(factory->startViolationAudit(), gridpack::Exception);
+  audit = factory->finishViolationAudit();
+  BOOST_CHECK_EQUAL(audit.total.numLine, line.num);
+  BOOST_CHECK_THROW(factory->finishViolationAudit(), gridpack::Exception);
+}
+
+BOOST_AUTO_TEST_CASE(ReadNetworkGroups)
+{
+  gridpack::parallel::Communicator world;
+  int me = world.rank();
+  int nprocs = world.size();
+  gridpack::utility::Configuration *config =
+    gridpack::utility::Configuration::configuration();
+  config->open("input.xml",world);
+
+  // Reference network read and partitioned by all processes
+  boost::shared_ptr<PFNetwork> ref(new PFNetwork(world));
+  gridpack::parser::PTI23_parser<PFNetwork> parser(ref);
+  parser.parse("IEEE14.raw");
+  ref->partition();
+  int nmax = 0;
+  int i;
+  for (i=0; i<ref->numBuses(); i++) {
+    if (ref->getOriginalBusIndex(i) > nmax) nmax = ref->getOriginalBusIndex(i);
+  }
+  world.max(&nmax,1);
+  std::vector<int> rnbr;
+  std::vector<double> rkv;
+  busTable(ref, nmax, rnbr, rkv);
+
+  // Split the processes into two halves, which are the same size if the
+  // number of processes is even and the network is copied from the first
+  // half to the second. Then put the first process in a group by itself,
+  // so that the groups have different sizes and each group reads the
+  // network itself. On a single process there is only one group
+  int split;
+  for (split=0; split<2; split++) {
+    int color;
+    if (split == 0) {
+      color = (me < nprocs/2 ? 0 : 1);
+    } else {
+      color = (me == 0 ? 0 : 1);
+    }
+    gridpack::parallel::Communicator group = world.split(color);
+    boost::shared_ptr<PFNetwork> network(new PFNetwork(group));
+    gridpack::powerflow::PFAppModule pf_app;
+    pf_app.readNetwork(network, config, world);
+
+    // Every group ends up with the complete network
+    BOOST_CHECK_EQUAL(network->totalBuses(), ref->totalBuses());
+    BOOST_CHECK_EQUAL(network->totalBranches(), ref->totalBranches());
+    std::vector<int> nbr;
+    std::vector<double> kv;
+    busTable(network, nmax, nbr, kv);
+    BOOST_CHECK(nbr == rnbr);
+    bool ok = true;
+    for (i=0; i<=nmax; i++) {
+      if (std::abs(kv[i]-rkv[i]) > delta*(1.0+std::abs(rkv[i]))) ok = false;
+    }
+    BOOST_CHECK(ok);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_function()
+{
+  return true;
+}
+
+// -------------------------------------------------------------
+//  Main Program
+// -------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+  gridpack::parallel::Environment env(argc, argv);
+  gridpack::parallel::Communicator world;
+  gridpack::math::Initialize(&argc,&argv);
+
+  // Report the result once so that parallel output cannot garble it
+  int lresult = ::boost::unit_test::unit_test_main( &init_function, argc, argv );
+  lresult = (lresult == boost::exit_success ? 0 : 1);
+  int gresult = lresult;
+  world.sum(&gresult,1);
+  gridpack::math::Finalize();
+  if (world.rank() == 0) {
+    if (gresult == 0) {
+      std::cout << "No errors detected" << std::endl;
+    } else {
+      std::cout << "failure detected" << std::endl;
+    }
+  }
+  return gresult;
+}
@@ -53,12 +53,12 @@ void gridpack::state_estimation::SEFactoryModule::setYBus(void)
 
   // Invoke setYBus method on all bus objects
   for (i=0; i<numBus; i++) {
-    (dynamic_cast<SEBus*>(p_network->getBus(i).get()))->setYBus();
+    buses()[i]->setYBus();
   }
 
   // Invoke setYBus method on all branch objects
   for (i=0; i<numBranch; i++) {
-    (dynamic_cast<SEBranch*>(p_network->getBranch(i).get()))->setYBus();
+    branches()[i]->setYBus();
   }
 }
 
@@ -135,12 +135,12 @@ void gridpack::state_estimation::SEFactoryModule::configureSE(void)
 
   // Invoke setYBus method on all bus objects
   for (i=0; i<numBus; i++) {
-    (dynamic_cast<SEBus*>(p_network->getBus(i).get()))->configureSE();
+    buses()[i]->configureSE();
   }
 
   // Invoke setYBus method on all branch objects
   for (i=0; i<numBranch; i++) {
-    (dynamic_cast<SEBranch*>(p_network->getBranch(i).get()))->configureSE();
+    branches()[i]->configureSE();
   }
 }
 
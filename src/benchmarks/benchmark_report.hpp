@@ -0,0 +1,259 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   benchmark_report.hpp
+ * @date   2026-10-19
+ *
+ * @brief
+ * Timing and reporting for the GridPACK benchmark suite. Each benchmark
+ * is timed over several repetitions and the slowest process determines
+ * the time of a repetition. Results are written as a JSON document so
+ * that they can be compared between commits by scripts.
+ */
+// -------------------------------------------------------------
+
+#ifndef _benchmark_report_hpp_
+#define _benchmark_report_hpp_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <mpi.h>
+#include "gridpack/parallel/communicator.hpp"
+#include "gridpack/utilities/exception.hpp"
+
+namespace gridpack {
+namespace benchmark {
+
+// -------------------------------------------------------------
+//  class BenchmarkTimer
+// -------------------------------------------------------------
+/**
+ * Time a single repetition of a benchmark. All processes are synchronized
+ * before the clock is started and the elapsed time of the slowest process
+ * is returned
+ */
+class BenchmarkTimer {
+public:
+
+  /**
+   * Constructor
+   * @param comm communicator over which benchmark runs
+   */
+  BenchmarkTimer(const gridpack::parallel::Communicator &comm)
+    : p_comm(comm), p_start(0.0)
+  { }
+
+  /**
+   * Synchronize processes and start clock
+   */
+  void start(void)
+  {
+    p_comm.barrier();
+    p_start = MPI_Wtime();
+  }
+
+  /**
+   * Stop clock
+   * @return elapsed time in seconds on the slowest process
+   */
+  double stop(void)
+  {
+    double elapsed = MPI_Wtime() - p_start;
+    p_comm.max(&elapsed, 1);
+    return elapsed;
+  }
+
+private:
+
+  gridpack::parallel::Communicator p_comm;
+
+  double p_start;
+};
+
+// -------------------------------------------------------------
+//  class BenchmarkReport
+// -------------------------------------------------------------
+/**
+ * Collect the results of all benchmarks in a run and write them out as
+ * JSON. A result consists of the timings of the individual repetitions,
+ * the number of work items processed in each repetition (buses,
+ * contingencies, time steps, etc.) and a short description of the unit of
+ * work.
+ */
+class BenchmarkReport {
+public:
+
+  /**
+   * Constructor
+   * @param comm communicator over which benchmarks run
+   */
+  BenchmarkReport(const gridpack::parallel::Communicator &comm)
+    : p_comm(comm)
+  { }
+
+  /**
+   * Destructor
+   */
+  ~BenchmarkReport(void)
+  { }
+
+  /**
+   * Add a parameter describing the run (network size, repetitions, etc.)
+   * @param name parameter name
+   * @param value parameter value
+   */
+  void addParameter(const std::string &name, int value)
+  {
+    char buf[32];
+    sprintf(buf,"%d",value);
+    p_params.push_back(std::pair<std::string,std::string>(name,buf));
+  }
+
+  /**
+   * Add a string parameter describing the run
+   * @param name parameter name
+   * @param value parameter value
+   */
+  void addParameter(const std::string &name, const std::string &value)
+  {
+    p_params.push_back(std::pair<std::string,std::string>(name,
+          "\""+escape(value)+"\""));
+  }
+
+  /**
+   * Add the result of a benchmark
+   * @param family benchmark family (e.g. "mapper")
+   * @param name name of benchmark within family
+   * @param times time of each repetition in seconds
+   * @param items number of work items processed in each repetition
+   * @param unit name of a work item
+   */
+  void addResult(const std::string &family, const std::string &name,
+      const std::vector<double> &times, double items,
+      const std::string &unit)
+  {
+    if (times.empty()) {
+      char buf[256];
+      sprintf(buf,"BenchmarkReport::addResult: no timings for %s/%s\n",
+          family.c_str(),name.c_str());
+      throw gridpack::Exception(buf);
+    }
+    Result result;
+    result.family = family;
+    result.name = name;
+    result.times = times;
+    result.items = items;
+    result.unit = unit;
+    p_results.push_back(result);
+    if (p_comm.rank() == 0) {
+      std::vector<double> sorted(times);
+      std::sort(sorted.begin(),sorted.end());
+      printf("benchmark %s/%s: median %12.6e s min %12.6e s (%d samples)\n",
+          family.c_str(),name.c_str(),median(sorted),sorted[0],
+          static_cast<int>(sorted.size()));
+    }
+  }
+
+  /**
+   * Write all results as a JSON document. Only process 0 writes
+   * @param filename name of output file. If empty, the document is
+   *        written to standard output
+   */
+  void write(const std::string &filename) const
+  {
+    if (p_comm.rank() != 0) return;
+    FILE *fp = stdout;
+    if (!filename.empty()) {
+      fp = fopen(filename.c_str(),"w");
+      if (fp == NULL) {
+        char buf[256];
+        sprintf(buf,"BenchmarkReport::write: unable to open file %s\n",
+            filename.c_str());
+        throw gridpack::Exception(buf);
+      }
+    }
+    int i, j;
+    fprintf(fp,"{\n  \"schema\": \"gridpack-benchmarks-1\",\n");
+    fprintf(fp,"  \"processes\": %d,\n",p_comm.size());
+    fprintf(fp,"  \"parameters\": {");
+    for (i=0; i<static_cast<int>(p_params.size()); i++) {
+      fprintf(fp,"%s\n    \"%s\": %s",(i>0?",":""),
+          escape(p_params[i].first).c_str(),p_params[i].second.c_str());
+    }
+    fprintf(fp,"\n  },\n  \"results\": [");
+    for (i=0; i<static_cast<int>(p_results.size()); i++) {
+      const Result &r = p_results[i];
+      std::vector<double> sorted(r.times);
+      std::sort(sorted.begin(),sorted.end());
+      double med = median(sorted);
+      fprintf(fp,"%s\n    {\n",(i>0?",":""));
+      fprintf(fp,"      \"family\": \"%s\",\n",escape(r.family).c_str());
+      fprintf(fp,"      \"name\": \"%s\",\n",escape(r.name).c_str());
+      fprintf(fp,"      \"unit\": \"%s\",\n",escape(r.unit).c_str());
+      fprintf(fp,"      \"items\": %.17g,\n",r.items);
+      fprintf(fp,"      \"min_s\": %.9e,\n",sorted[0]);
+      fprintf(fp,"      \"median_s\": %.9e,\n",med);
+      fprintf(fp,"      \"max_s\": %.9e,\n",sorted[sorted.size()-1]);
+      fprintf(fp,"      \"items_per_s\": %.9e,\n",
+          (med > 0.0 ? r.items/med : 0.0));
+      fprintf(fp,"      \"samples_s\": [");
+      for (j=0; j<static_cast<int>(r.times.size()); j++) {
+        fprintf(fp,"%s%.9e",(j>0?", ":""),r.times[j]);
+      }
+      fprintf(fp,"]\n    }");
+    }
+    fprintf(fp,"\n  ]\n}\n");
+    if (fp != stdout) fclose(fp);
+  }
+
+private:
+
+  struct Result {
+    std::string family;
+    std::string name;
+    std::vector<double> times;
+    double items;
+    std::string unit;
+  };
+
+  /**
+   * Median of a sorted list of values
+   */
+  static double median(const std::vector<double> &sorted)
+  {
+    int n = sorted.size();
+    if (n%2 == 1) return sorted[n/2];
+    return 0.5*(sorted[n/2-1]+sorted[n/2]);
+  }
+
+  /**
+   * Escape quotes and backslashes in a JSON string
+   */
+  static std::string escape(const std::string &str)
+  {
+    std::string ret;
+    int i;
+    for (i=0; i<static_cast<int>(str.size()); i++) {
+      if (str[i] == '"' || str[i] == '\\') ret.push_back('\\');
+      ret.push_back(str[i]);
+    }
+    return ret;
+  }
+
+  gridpack::parallel::Communicator p_comm;
+
+  std::vector<std::pair<std::string,std::string> > p_params;
+
+  std::vector<Result> p_results;
+};
+
+} // benchmark
+} // gridpack
+#endif
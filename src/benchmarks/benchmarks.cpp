@@ -0,0 +1,544 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   benchmarks.cpp
+ * @date   2026-10-19
+ *
+ * @brief
+ * Benchmark suite for GridPACK. The benchmarks run on a synthetic network
+ * of configurable size, created by gridpack::parser::SyntheticNetwork, and
+ * cover the main framework operations (parsing and partitioning, matrix
+ * assembly through the mappers, ghost exchanges, linear solves and loops
+ * over components allocated individually or in arenas) as well as
+ * complete application kernels (a power flow Newton iteration, a dynamic
+ * simulation time step and contingency analysis throughput). Results are
+ * written as JSON.
+ *
+ * Usage: gridpack_benchmarks.x [input.xml] [-buses n] [-areas n]
+ *        [-reps n] [-output file] [-only family]
+ */
+// -------------------------------------------------------------
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include "mpi.h"
+#include <ga.h>
+#include <macdecls.h>
+#include "gridpack/include/gridpack.hpp"
+#include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+#include "gridpack/applications/modules/dynamic_simulation_full_y/dsf_app_module.hpp"
+#include "gridpack/parser/synthetic_network.hpp"
+#include "benchmark_report.hpp"
+
+using gridpack::benchmark::BenchmarkTimer;
+using gridpack::benchmark::BenchmarkReport;
+using gridpack::parser::SyntheticNetwork;
+using gridpack::powerflow::PFNetwork;
+
+/**
+ * Run time parameters of the benchmark suite
+ */
+struct BenchmarkOptions {
+  int buses;
+  int areas;
+  int seed;
+  int reps;
+  int ncont;
+  std::string output;
+  std::string only;
+};
+
+/**
+ * Check if a benchmark family should be run
+ * @param opts run time parameters
+ * @param family name of family
+ */
+static bool runFamily(const BenchmarkOptions &opts, const char *family)
+{
+  return opts.only.empty() || opts.only == family;
+}
+
+/**
+ * List all branch circuits of the synthetic network. Parallel circuits
+ * between the same buses are listed separately
+ * @param synth synthetic network
+ * @param circuits list of circuits
+ */
+static void listCircuits(const SyntheticNetwork &synth,
+    std::vector<SyntheticNetwork::BranchRecord> &circuits)
+{
+  circuits.clear();
+  std::vector<SyntheticNetwork::BranchRecord> brs;
+  int id;
+  for (id=1; id<=synth.numBuses(); id++) {
+    synth.branches(id,brs);
+    circuits.insert(circuits.end(),brs.begin(),brs.end());
+  }
+}
+
+/**
+ * Number of branches in a list of circuits, counting parallel circuits
+ * only once
+ */
+static int countBranches(
+    const std::vector<SyntheticNetwork::BranchRecord> &circuits)
+{
+  int nbranch = 0;
+  size_t i;
+  for (i=0; i<circuits.size(); i++) {
+    if (i == 0 || circuits[i].from != circuits[i-1].from ||
+        circuits[i].to != circuits[i-1].to) nbranch++;
+  }
+  return nbranch;
+}
+
+/**
+ * Parse and partition the network
+ * @param network empty network
+ * @param filename name of .raw file
+ */
+static void readNetwork(boost::shared_ptr<PFNetwork> &network,
+    const std::string &filename)
+{
+  gridpack::parser::PTI23_parser<PFNetwork> parser(network);
+  parser.parse(filename.c_str());
+  network->partition();
+}
+
+/**
+ * Benchmark the parser and the partitioner
+ * @return the network created by the last repetition
+ */
+static boost::shared_ptr<PFNetwork> benchmarkParser(
+    const gridpack::parallel::Communicator &world,
+    const BenchmarkOptions &opts, const SyntheticNetwork &synth,
+    const std::string &rawFile, BenchmarkReport &report)
+{
+  BenchmarkTimer timer(world);
+  std::vector<double> tparse, tpart, tsynth;
+  boost::shared_ptr<PFNetwork> network;
+  int rep;
+  for (rep=0; rep<opts.reps; rep++) {
+    network.reset(new PFNetwork(world));
+    gridpack::parser::PTI23_parser<PFNetwork> parser(network);
+    timer.start();
+    parser.parse(rawFile.c_str());
+    tparse.push_back(timer.stop());
+    timer.start();
+    network->partition();
+    tpart.push_back(timer.stop());
+  }
+  // Same network generated in place on all processes, without the file
+  for (rep=0; rep<opts.reps; rep++) {
+    boost::shared_ptr<PFNetwork> synthNetwork(new PFNetwork(world));
+    gridpack::parser::SyntheticParser<PFNetwork> parser(synthNetwork,synth);
+    timer.start();
+    parser.parse();
+    tsynth.push_back(timer.stop());
+  }
+  double nbus = synth.numBuses();
+  report.addResult("parser","pti23_parse",tparse,nbus,"buses");
+  report.addResult("parser","synthetic_parse",tsynth,nbus,"buses");
+  report.addResult("parser","partition",tpart,nbus,"buses");
+  return network;
+}
+
+/**
+ * Benchmark the loops that mappers and factories make over all components,
+ * with components allocated individually and in arenas
+ */
+static void benchmarkComponents(const gridpack::parallel::Communicator &world,
+    const BenchmarkOptions &opts, const std::string &rawFile,
+    BenchmarkReport &report)
+{
+  static const int passes(100);
+  BenchmarkTimer timer(world);
+  double nbus = opts.buses;
+  int rep, r, b;
+  int arena;
+  for (arena=0; arena<2; arena++) {
+    boost::shared_ptr<PFNetwork> network(new PFNetwork(world));
+    gridpack::parser::PTI23_parser<PFNetwork> parser(network);
+    parser.parse(rawFile.c_str());
+    network->setArenaAllocation(arena == 1);
+    network->partition();
+    int numBus = network->numBuses();
+    int numBranch = network->numBranches();
+
+    // factories keep arrays of base class pointers
+    std::vector<gridpack::component::BaseBusComponent*> buses(numBus);
+    std::vector<gridpack::component::BaseBranchComponent*> branches(numBranch);
+    for (b=0; b<numBus; b++) buses[b] = network->getBus(b).get();
+    for (b=0; b<numBranch; b++) branches[b] = network->getBranch(b).get();
+
+    // mapper: size and index queries on every component
+    std::vector<double> tmapper, tfactory;
+    int isize, jsize, total = 0;
+    for (rep=0; rep<opts.reps; rep++) {
+      timer.start();
+      for (r=0; r<passes; r++) {
+        for (b=0; b<numBus; b++) {
+          if (network->getActiveBus(b) &&
+              buses[b]->matrixDiagSize(&isize,&jsize)) {
+            total += isize*jsize;
+          }
+        }
+        for (b=0; b<numBranch; b++) {
+          if (branches[b]->matrixForwardSize(&isize,&jsize)) {
+            total += isize*jsize;
+          }
+        }
+      }
+      tmapper.push_back(timer.stop());
+    }
+
+    // factory: set a mode on every component
+    for (rep=0; rep<opts.reps; rep++) {
+      timer.start();
+      for (r=0; r<passes; r++) {
+        for (b=0; b<numBus; b++) buses[b]->setMode(r);
+        for (b=0; b<numBranch; b++) branches[b]->setMode(r);
+      }
+      tfactory.push_back(timer.stop());
+    }
+    if (total < 0) {
+      throw gridpack::Exception("benchmarkComponents: illegal matrix size");
+    }
+    std::string suffix(arena == 1 ? "_arena" : "_individual");
+    report.addResult("component","mapper_loop"+suffix,tmapper,
+        nbus*passes,"bus visits");
+    report.addResult("component","factory_loop"+suffix,tfactory,
+        nbus*passes,"bus visits");
+  }
+}
+
+/**
+ * Benchmark the kernels of the power flow calculation: matrix assembly,
+ * ghost exchanges, linear solves and complete Newton iterations
+ */
+static void benchmarkPowerflow(const gridpack::parallel::Communicator &world,
+    const BenchmarkOptions &opts, boost::shared_ptr<PFNetwork> network,
+    gridpack::utility::Configuration::CursorPtr cursor,
+    BenchmarkReport &report)
+{
+  BenchmarkTimer timer(world);
+  double nbus = opts.buses;
+  int rep;
+
+  gridpack::powerflow::PFFactoryModule factory(network);
+  factory.load();
+  factory.setComponents();
+  factory.setExchange();
+  network->initBusUpdate();
+  factory.setYBus();
+  factory.setSBus();
+
+  if (runFamily(opts,"mapper")) {
+    // Create a new Y-matrix, including the mapper setup, and refill an
+    // existing one
+    std::vector<double> tcreate, tfill;
+    factory.setMode(gridpack::powerflow::YBus);
+    boost::shared_ptr<gridpack::math::Matrix> Y;
+    for (rep=0; rep<opts.reps; rep++) {
+      timer.start();
+      gridpack::mapper::FullMatrixMap<PFNetwork> yMap(network);
+      Y = yMap.mapToMatrix();
+      tcreate.push_back(timer.stop());
+      timer.start();
+      yMap.mapToMatrix(Y);
+      tfill.push_back(timer.stop());
+    }
+    report.addResult("mapper","ybus_create",tcreate,nbus,"buses");
+    report.addResult("mapper","ybus_refill",tfill,nbus,"buses");
+  }
+
+  if (runFamily(opts,"exchange")) {
+    std::vector<double> texch;
+    for (rep=0; rep<opts.reps; rep++) {
+      timer.start();
+      network->updateBuses();
+      texch.push_back(timer.stop());
+    }
+    report.addResult("exchange","update_buses",texch,nbus,"buses");
+  }
+
+  if (!runFamily(opts,"solver") && !runFamily(opts,"newton")) return;
+
+  factory.setMode(gridpack::powerflow::RHS);
+  gridpack::mapper::BusVectorMap<PFNetwork> vMap(network);
+  boost::shared_ptr<gridpack::math::Vector> PQ = vMap.mapToVector();
+  factory.setMode(gridpack::powerflow::Jacobian);
+  gridpack::mapper::FullMatrixMap<PFNetwork> jMap(network);
+  boost::shared_ptr<gridpack::math::Matrix> J = jMap.mapToMatrix();
+  boost::shared_ptr<gridpack::math::Vector> X(PQ->clone());
+  gridpack::math::LinearSolver solver(*J);
+  solver.configure(cursor);
+
+  if (runFamily(opts,"solver")) {
+    std::vector<double> tsolve;
+    for (rep=0; rep<opts.reps; rep++) {
+      X->zero();
+      timer.start();
+      solver.solve(*PQ, *X);
+      tsolve.push_back(timer.stop());
+    }
+    report.addResult("solver","jacobian_solve",tsolve,J->rows(),"rows");
+  }
+
+  if (runFamily(opts,"newton")) {
+    // Each repetition is one complete iteration of the hand-coded
+    // Newton-Raphson loop in PFAppModule::solve
+    std::vector<double> titer;
+    for (rep=0; rep<opts.reps; rep++) {
+      X->zero();
+      solver.solve(*PQ, *X);
+      timer.start();
+      factory.setMode(gridpack::powerflow::RHS);
+      vMap.mapToBus(X);
+      network->updateBuses();
+      factory.evaluateInjections();
+      vMap.mapToVector(PQ);
+      factory.setMode(gridpack::powerflow::Jacobian);
+      jMap.mapToMatrix(J);
+      X->zero();
+      solver.solve(*PQ, *X);
+      titer.push_back(timer.stop());
+    }
+    report.addResult("newton","powerflow_iteration",titer,nbus,"buses");
+  }
+}
+
+/**
+ * Transfer the power flow solution to the dynamic simulation network
+ */
+static void transferPFtoDS(boost::shared_ptr<PFNetwork> pf_network,
+    boost::shared_ptr<gridpack::dynamic_simulation::DSFullNetwork>
+    ds_network)
+{
+  int numBus = pf_network->numBuses();
+  int i, j;
+  gridpack::component::DataCollection *pfData;
+  gridpack::component::DataCollection *dsData;
+  double rval;
+  for (i=0; i<numBus; i++) {
+    pfData = pf_network->getBusData(i).get();
+    dsData = ds_network->getBusData(i).get();
+    pfData->getValue("BUS_PF_VMAG",&rval);
+    dsData->setValue(BUS_VOLTAGE_MAG,rval);
+    pfData->getValue("BUS_PF_VANG",&rval);
+    dsData->setValue(BUS_VOLTAGE_ANG,rval);
+    int ngen = 0;
+    if (pfData->getValue(GENERATOR_NUMBER, &ngen)) {
+      for (j=0; j<ngen; j++) {
+        pfData->getValue("GENERATOR_PF_PGEN",&rval,j);
+        dsData->setValue(GENERATOR_PG,rval,j);
+        pfData->getValue("GENERATOR_PF_QGEN",&rval,j);
+        dsData->setValue(GENERATOR_QG,rval,j);
+      }
+    }
+  }
+}
+
+/**
+ * Benchmark the complete applications: power flow contingency throughput
+ * and dynamic simulation time steps
+ */
+static void benchmarkApplications(
+    const gridpack::parallel::Communicator &world,
+    const BenchmarkOptions &opts,
+    const std::vector<SyntheticNetwork::BranchRecord> &circuits,
+    gridpack::utility::Configuration *config, BenchmarkReport &report)
+{
+  BenchmarkTimer timer(world);
+  int rep, i;
+
+  boost::shared_ptr<PFNetwork> pf_network(new PFNetwork(world));
+  gridpack::powerflow::PFAppModule pf_app;
+  pf_app.readNetwork(pf_network,config);
+  pf_app.initialize();
+  pf_app.solve();
+  pf_app.saveData();
+
+  if (runFamily(opts,"contingency") && opts.ncont > 0) {
+    // Single circuit outages spread evenly over the network. Each
+    // repetition solves all contingencies, as in the contingency analysis
+    // driver
+    int ncircuit = circuits.size();
+    int ncont = (opts.ncont < ncircuit ? opts.ncont : ncircuit);
+    std::vector<gridpack::powerflow::Contingency> events;
+    gridpack::utility::StringUtils util;
+    for (i=0; i<ncont; i++) {
+      gridpack::powerflow::Contingency event;
+      SyntheticNetwork::BranchRecord circuit = circuits[static_cast<int>(
+          (static_cast<long>(i)*ncircuit)/ncont)];
+      char buf[32];
+      sprintf(buf,"CTG%d",i+1);
+      event.p_name = buf;
+      event.p_type = gridpack::powerflow::Branch;
+      event.p_from.push_back(circuit.from);
+      event.p_to.push_back(circuit.to);
+      // Circuit IDs are stored the way the parser cleans them up
+      event.p_ckt.push_back(util.clean2Char(circuit.ckt));
+      event.p_saveLineStatus.push_back(true);
+      events.push_back(event);
+    }
+    std::vector<double> tcont;
+    for (rep=0; rep<opts.reps; rep++) {
+      timer.start();
+      for (i=0; i<ncont; i++) {
+        pf_app.setContingency(events[i]);
+        pf_app.solve();
+        pf_app.unSetContingency(events[i]);
+        pf_app.resetVoltages();
+      }
+      tcont.push_back(timer.stop());
+    }
+    report.addResult("contingency","line_outage_powerflow",tcont,ncont,
+        "contingencies");
+    pf_app.solve();
+    pf_app.saveData();
+  }
+
+  if (runFamily(opts,"dynamic")) {
+    gridpack::utility::Configuration::CursorPtr cursor;
+    cursor = config->getCursor("Configuration.Dynamic_simulation");
+    double simTime = cursor->get("simulationTime",0.2);
+    double step = cursor->get("timeStep",0.01);
+    int nsteps = static_cast<int>(simTime/step+0.5);
+    // Fault on the first branch of the network for the middle third of
+    // the simulation, so that the steps include the network switching
+    gridpack::dynamic_simulation::DSFullBranch::Event fault;
+    fault.from_idx = circuits[0].from;
+    fault.to_idx = circuits[0].to;
+    fault.start = step*static_cast<double>(nsteps/3);
+    fault.end = step*static_cast<double>((2*nsteps)/3);
+    fault.step = step;
+    std::vector<double> tstep;
+    for (rep=0; rep<opts.reps; rep++) {
+      boost::shared_ptr<gridpack::dynamic_simulation::DSFullNetwork>
+        ds_network(new gridpack::dynamic_simulation::DSFullNetwork(world));
+      pf_network->clone<gridpack::dynamic_simulation::DSFullBus,
+        gridpack::dynamic_simulation::DSFullBranch>(ds_network);
+      transferPFtoDS(pf_network,ds_network);
+      gridpack::dynamic_simulation::DSFullApp ds_app;
+      ds_app.setNetwork(ds_network,config);
+      ds_app.readGenerators();
+      ds_app.initialize();
+      timer.start();
+      ds_app.solve(fault);
+      tstep.push_back(timer.stop()/static_cast<double>(nsteps));
+    }
+    report.addResult("dynamic","full_y_time_step",tstep,opts.buses,
+        "buses");
+  }
+}
+
+int
+main(int argc, char **argv)
+{
+  gridpack::parallel::Environment env(argc,argv);
+  gridpack::math::Initialize(&argc,&argv);
+
+  if (1) {
+    gridpack::parallel::Communicator world;
+
+    // Input deck is the first argument if it does not start with '-'
+    int iarg = 1;
+    std::string inputfile("input.xml");
+    if (argc > 1 && argv[1][0] != '-') {
+      inputfile = argv[1];
+      iarg = 2;
+    }
+    gridpack::utility::Configuration *config =
+      gridpack::utility::Configuration::configuration();
+    config->open(inputfile,world);
+    gridpack::utility::Configuration::CursorPtr cursor;
+    cursor = config->getCursor("Configuration.Benchmarks");
+
+    BenchmarkOptions opts;
+    opts.buses = cursor->get("numBuses",1024);
+    opts.areas = cursor->get("numAreas",1);
+    opts.seed = cursor->get("seed",12345);
+    opts.reps = cursor->get("repetitions",5);
+    opts.ncont = cursor->get("contingencies",16);
+    opts.output = cursor->get("outputFile","benchmarks.json");
+    for (; iarg<argc-1; iarg += 2) {
+      if (!strcmp(argv[iarg],"-buses")) {
+        opts.buses = atoi(argv[iarg+1]);
+      } else if (!strcmp(argv[iarg],"-areas")) {
+        opts.areas = atoi(argv[iarg+1]);
+      } else if (!strcmp(argv[iarg],"-reps")) {
+        opts.reps = atoi(argv[iarg+1]);
+      } else if (!strcmp(argv[iarg],"-output")) {
+        opts.output = argv[iarg+1];
+      } else if (!strcmp(argv[iarg],"-only")) {
+        opts.only = argv[iarg+1];
+      } else {
+        char buf[256];
+        sprintf(buf,"gridpack_benchmarks: unknown option %s\n",argv[iarg]);
+        throw gridpack::Exception(buf);
+      }
+    }
+    if (opts.reps < 1) opts.reps = 1;
+
+    // Create the synthetic network and write it out. The file names come
+    // from the input deck so that the applications find them
+    std::string rawFile, dyrFile;
+    config->getCursor("Configuration.Powerflow")->get(
+        "networkConfiguration",&rawFile);
+    config->getCursor("Configuration.Dynamic_simulation")->get(
+        "generatorParameters",&dyrFile);
+    gridpack::parser::SyntheticNetworkParams params;
+    params.numBuses = opts.buses;
+    params.numAreas = opts.areas;
+    params.seed = static_cast<unsigned int>(opts.seed);
+    SyntheticNetwork synth(params);
+    synth.write(world,rawFile,dyrFile);
+    std::vector<SyntheticNetwork::BranchRecord> circuits;
+    listCircuits(synth,circuits);
+
+    BenchmarkReport report(world);
+    report.addParameter("input",inputfile);
+    report.addParameter("areas",opts.areas);
+    report.addParameter("seed",opts.seed);
+    report.addParameter("buses",synth.numBuses());
+    report.addParameter("branches",countBranches(circuits));
+    report.addParameter("repetitions",opts.reps);
+#ifdef GRIDPACK_BENCHMARK_REVISION
+    report.addParameter("revision",GRIDPACK_BENCHMARK_REVISION);
+#endif
+
+    boost::shared_ptr<PFNetwork> network;
+    if (runFamily(opts,"parser")) {
+      network = benchmarkParser(world,opts,synth,rawFile,report);
+    }
+    if (runFamily(opts,"component")) {
+      benchmarkComponents(world,opts,rawFile,report);
+    }
+    if (runFamily(opts,"mapper") || runFamily(opts,"exchange") ||
+        runFamily(opts,"solver") || runFamily(opts,"newton")) {
+      if (!network) {
+        network.reset(new PFNetwork(world));
+        readNetwork(network,rawFile);
+      }
+      benchmarkPowerflow(world,opts,network,
+          config->getCursor("Configuration.Powerflow"),report);
+    }
+    if (runFamily(opts,"contingency") || runFamily(opts,"dynamic")) {
+      benchmarkApplications(world,opts,circuits,config,report);
+    }
+    report.write(opts.output);
+  }
+
+  // Terminate Math libraries
+  gridpack::math::Finalize();
+  return 0;
+}
@@ -10,7 +10,10 @@
 // #include <boost/property_tree/json_parser.hpp>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <streambuf>
+#include <cstring>
+#include <stdexcept>
 
 using boost::property_tree::ptree;
 using std::string;
@@ -19,13 +22,22 @@ using std::ostream;
 namespace gridpack {
 namespace utility {
 
+// The tree is shared between a Configuration and all cursors created from
+// it, so creating a cursor does not copy any part of the tree. Nodes in a
+// ptree are not moved when other nodes are added, so cursors remain valid
+// if more files are merged into the configuration later
 class ConfigInternals {
 public:
-	ConfigInternals() : logging(NULL), path("") { } 
+	ConfigInternals() : logging(NULL), root(new ptree), pt(root.get()), path("") { } 
 	std::ostream * logging ;
-	boost::property_tree::ptree pt;
+	boost::shared_ptr<boost::property_tree::ptree> root;
+	boost::property_tree::ptree * pt;
 	string path;
-	bool initialize(const std::string &);
+	void share(const ConfigInternals & parent, ptree & node) {
+		logging = parent.logging;
+		root = parent.root;
+		pt = &node;
+	}
 } ;
 
 static void merge_trees(boost::property_tree::ptree &parent, 
@@ -40,6 +52,53 @@ static void merge_trees(boost::property_tree::ptree &parent,
 }
 
 
+// Trees are sent to other processes in a compact binary form so that only
+// one process parses the XML. Each node is stored as the length of its key,
+// the key, the length of its data, the data and the number of children,
+// followed by the children
+static void pack_int(std::string & buf, int n) {
+	buf.append(reinterpret_cast<const char*>(&n), sizeof(int));
+}
+
+static void pack_tree(const ptree & pt, std::string & buf) {
+	pack_int(buf, static_cast<int>(pt.data().size()));
+	buf.append(pt.data());
+	pack_int(buf, static_cast<int>(pt.size()));
+	for(ptree::const_iterator it=pt.begin();it!=pt.end();++it) {
+		pack_int(buf, static_cast<int>(it->first.size()));
+		buf.append(it->first);
+		pack_tree(it->second, buf);
+	}
+}
+
+static int unpack_int(const char * buf, int len, int & pos) {
+	int n;
+	if(pos + static_cast<int>(sizeof(int)) > len)
+		throw std::runtime_error("corrupt configuration buffer");
+	memcpy(&n, buf+pos, sizeof(int));
+	pos += sizeof(int);
+	return n;
+}
+
+static std::string unpack_string(const char * buf, int len, int & pos) {
+	int n = unpack_int(buf, len, pos);
+	if(n < 0 || pos + n > len)
+		throw std::runtime_error("corrupt configuration buffer");
+	std::string ret(buf+pos, n);
+	pos += n;
+	return ret;
+}
+
+static void unpack_tree(const char * buf, int len, int & pos, ptree & pt) {
+	pt.data() = unpack_string(buf, len, pos);
+	int nchild = unpack_int(buf, len, pos);
+	for(int i=0; i<nchild; i++) {
+		std::string key = unpack_string(buf, len, pos);
+		ptree & child = pt.push_back(std::make_pair(key, ptree()))->second;
+		unpack_tree(buf, len, pos, child);
+	}
+}
+
 
 Configuration::Configuration(void)
 {
@@ -112,43 +171,55 @@ bool Configuration::open(const std::string & file) {
 #endif 
 	std::string str;
 	std::ifstream input(file.c_str());
-   int n = -1;
-	if(!input.bad()) {
+	int n = -1;
+	if(input.is_open()) {
 		input.seekg(0, std::ios::end);   
 		str.reserve((unsigned) input.tellg());
 		input.seekg(0, std::ios::beg);
 
 		str.assign((std::istreambuf_iterator<char>(input)),
 					std::istreambuf_iterator<char>());
-      n = 0;
-   }
+		n = 0;
+	}
+	// Load the XML file into a property tree. If reading fails (parse
+	// error), an exception is thrown. The XML is only parsed on this
+	// process, the other processes receive the tree in packed form
+	ptree pt0;
+	if (n >= 0) {
+		try {
+			std::istringstream ss(str);
+			read_xml(ss, pt0);
+		}
+		catch(...) {
+			if(pimpl->logging != NULL)
+			 (*pimpl->logging) << "Error reading XML file " << file << std::endl;
+			n = -2;
+		}
+	}
 #ifdef CONFIGURATION_USE_MPI
-   if (n >= 0) {
-	  n = str.size();
-   }
-	MPI_Bcast(&n, 1, MPI_INT, rank, comm);
-   if (n > 0) {
-	  MPI_Bcast((void*) str.c_str(), n, MPI_CHAR, rank, comm);
-   } else {
-     std::cout<<"Configure: Unable to open file "<<file<<std::endl;
-     return false;
-   }
-#endif
-    // Load the XML file into the property tree. If reading fails
-    // (cannot open file, parse error), an exception is thrown.
-	try {
-		pimpl->initialize(str);
+	std::string buf;
+	if (n >= 0) {
+		pack_tree(pt0, buf);
+		n = buf.size();
 	}
-	catch(...) {
-		if(pimpl->logging != NULL)
-		 (*pimpl->logging) << "Error reading XML file " << file << std::endl;
+	MPI_Bcast(&n, 1, MPI_INT, rank, comm);
+	if (n > 0) {
+		MPI_Bcast((void*) buf.data(), n, MPI_CHAR, rank, comm);
+	} else if (n == -1) {
+		std::cout<<"Configure: Unable to open file "<<file<<std::endl;
+		return false;
+	} else {
 		return false;
 	}
-	if(!pimpl->logging && pimpl->pt.get<bool>("Configuration.enableLogging",false))
+#else
+	if (n < 0) return false;
+#endif
+	merge_trees(*pimpl->pt,"",pt0);
+	if(!pimpl->logging && pimpl->pt->get<bool>("Configuration.enableLogging",false))
 		pimpl->logging = & std::cout;
 	if(pimpl->logging != NULL && rank== 0) {
 		try {
-			dump_xml(pimpl->pt, *pimpl->logging);
+			dump_xml(*pimpl->pt, *pimpl->logging);
 		}
 		catch(...) {
 			 (*pimpl->logging) << "Error writing XML file " << file << std::endl;
@@ -157,14 +228,6 @@ bool Configuration::open(const std::string & file) {
 	return true;
 }
 
-bool ConfigInternals::initialize(const std::string & input) {
-	std::istringstream ss(input);
-	boost::property_tree::ptree pt0;	
-    read_xml(ss, pt0);
-	merge_trees(pt,"",pt0);
-	return true;
-}
-
 #ifdef CONFIGURATION_USE_MPI
 bool Configuration::initialize(gridpack::parallel::Communicator tcomm) {
 	std::cout << "warning: Configuration::initialize is deprecated" << std::endl;
@@ -179,19 +242,22 @@ bool Configuration::initialize_internal(MPI_Comm comm) {
 	MPI_Comm_rank(comm,&rank);
 	int n ;
 	MPI_Bcast(&n, 1, MPI_INT, 0, comm);
-   if (n == 0) return false;
-	assert(n > 0 && n < (1<<30)); // sanity check that n is not too large (1<<n = 2^n)
-	char * buffer = new char[n+1];
-	MPI_Bcast(buffer, n, MPI_CHAR, 0, comm);
-	std::string input(buffer,buffer+n);
+	// A non-positive size means that process 0 could not read or parse the
+	// file
+	if (n <= 0) return false;
+	std::vector<char> buffer(n);
+	MPI_Bcast(&buffer[0], n, MPI_CHAR, 0, comm);
+	ptree pt0;
 	try {
-		pimpl->initialize(input);
+		int pos = 0;
+		unpack_tree(&buffer[0], n, pos, pt0);
 	}
 	catch(...) {
 		std::cout << "Configuration::initialize fails for rank " << rank
-        << ". Make sure that there are no XML formatting errors in file." << std::endl;
+        << ". Unable to unpack configuration from process 0." << std::endl;
 		return false;
 	}
+	merge_trees(*pimpl->pt,"",pt0);
 	return true;
 }
 #endif
@@ -211,14 +277,14 @@ bool get0_bool(ptree & pt, Configuration::KeyType key, T * output) {
 	return false;
 }
 
-bool Configuration::get(Configuration::KeyType key, bool default_value) { return get0(pimpl->pt, key, default_value) ; }
-bool Configuration::get(Configuration::KeyType key, bool * output) { return get0_bool(pimpl->pt,key, output); }
-int Configuration::get(Configuration::KeyType key, int default_value) { return get0(pimpl->pt, key, default_value) ; }
-bool Configuration::get(Configuration::KeyType key, int * output) { return get0_bool(pimpl->pt,key, output); }
-double Configuration::get(Configuration::KeyType key, double default_value) { return get0(pimpl->pt, key, default_value) ; }
-bool Configuration::get(Configuration::KeyType key, double * output) { return get0_bool(pimpl->pt,key, output); }
+bool Configuration::get(Configuration::KeyType key, bool default_value) { return get0(*pimpl->pt, key, default_value) ; }
+bool Configuration::get(Configuration::KeyType key, bool * output) { return get0_bool(*pimpl->pt,key, output); }
+int Configuration::get(Configuration::KeyType key, int default_value) { return get0(*pimpl->pt, key, default_value) ; }
+bool Configuration::get(Configuration::KeyType key, int * output) { return get0_bool(*pimpl->pt,key, output); }
+double Configuration::get(Configuration::KeyType key, double default_value) { return get0(*pimpl->pt, key, default_value) ; }
+bool Configuration::get(Configuration::KeyType key, double * output) { return get0_bool(*pimpl->pt,key, output); }
 std::string Configuration::get(Configuration::KeyType key, const std::string & default_value) {
-  std::string ret = get0(pimpl->pt, key, default_value) ;
+  std::string ret = get0(*pimpl->pt, key, default_value) ;
 
   // remove leading and trailing white space from string
   ret.replace(0,ret.find_first_not_of(" "), "");
@@ -226,7 +292,7 @@ std::string Configuration::get(Configuration::KeyType key, const std::string & d
   return ret;
 }
 bool Configuration::get(Configuration::KeyType key, std::string * output) {
-  bool ret = get0_bool(pimpl->pt,key, output);
+  bool ret = get0_bool(*pimpl->pt,key, output);
 
   // remove leading and trailing white space from string
   output->replace(0,output->find_first_not_of(" "), "");
@@ -254,31 +320,28 @@ bool Configuration::get(Configuration::KeyType key, std::vector<double> * output
 
 
 Configuration::CursorPtr Configuration::getCursor(Configuration::KeyType key) {
-	boost::optional<ptree&> cpt = pimpl->pt.get_child_optional(key);
+	boost::optional<ptree&> cpt = pimpl->pt->get_child_optional(key);
 	if(!cpt) return CursorPtr((Configuration*)NULL);
 	Configuration * c = new Configuration;
-	c->pimpl->logging = pimpl->logging;
-	c->pimpl->pt = *cpt;
+	c->pimpl->share(*pimpl, *cpt);
 	return CursorPtr (c);
 }
 
 void Configuration::children(ChildCursors & cs) {
 	cs.clear();
-	BOOST_FOREACH(ptree::value_type & v, pimpl->pt) {
+	BOOST_FOREACH(ptree::value_type & v, *pimpl->pt) {
 		boost::shared_ptr<Cursor> c(new Configuration);
-		c->pimpl->logging = pimpl->logging;
-		c->pimpl->pt = v.second;
+		c->pimpl->share(*pimpl, v.second);
 		cs.push_back(c);
 	}
 }
 
 void Configuration::children(ChildElements & cs) {
 	cs.clear();
-	BOOST_FOREACH(ptree::value_type & v, pimpl->pt) {
+	BOOST_FOREACH(ptree::value_type & v, *pimpl->pt) {
 //		boost::shared_ptr<Cursor> c(new Configuration);
 		CursorPtr c(new Configuration);
-		c->pimpl->logging = pimpl->logging;
-		c->pimpl->pt = v.second;
+		c->pimpl->share(*pimpl, v.second);
 		cs.push_back(ChildElement());
 		ChildElement & last = cs.back();
 		last.cursor = c;
@@ -170,6 +170,57 @@ public:
 	std::vector<double> get(KeyType, const std::vector<double> & default_value);
 	bool get(KeyType, std::vector<double>*);
 
+	/**
+	 * A key that has been looked up once and converted to type T. Reading
+	 * the value from a handle does not search the tree, so handles can be
+	 * used for parameters that are read repeatedly, e.g. inside solver
+	 * loops. A handle does not see changes made to the configuration after
+	 * it was created.
+	 */
+	template <typename T>
+	class Handle {
+	public:
+		Handle(void) : p_found(false), p_value() { }
+
+		/**
+		 * @return true if key was present in the configuration
+		 */
+		bool found(void) const { return p_found; }
+
+		/**
+		 * @param output location that is set if key was found
+		 * @return true if key was present in the configuration
+		 */
+		bool get(T * output) const {
+			if (p_found) *output = p_value;
+			return p_found;
+		}
+
+		/**
+		 * @param default_value value returned if key was not found
+		 * @return value of key
+		 */
+		const T & get(const T & default_value) const {
+			return p_found ? p_value : default_value;
+		}
+	private:
+		friend class Configuration;
+		bool p_found;
+		T p_value;
+	};
+
+	/**
+	 * Resolve a key into a typed handle. T can be any type supported by get
+	 * @param KeyType data key in key-value pair
+	 * @return handle holding the value of the key
+	 */
+	template <typename T>
+	Handle<T> getHandle(KeyType key) {
+		Handle<T> ret;
+		ret.p_found = get(key, &ret.p_value);
+		return ret;
+	}
+
 	/**
 	 * This class represents a prefix of a set of key names.
 	 * Conveniently this implementation allows it to be the same class
@@ -71,6 +71,39 @@ protected:
 };
 
 
+BOOST_AUTO_TEST_CASE( Handles )
+{
+  gridpack::utility::Configuration *config =
+    gridpack::utility::Configuration::configuration();
+
+  gridpack::utility::Configuration::Handle<int> integer =
+    config->getHandle<int>("GridPACK.Thing.Integer");
+  BOOST_CHECK(integer.found());
+  BOOST_CHECK_EQUAL(integer.get(0), 123);
+
+  gridpack::utility::Configuration::Handle<std::string> string1 =
+    config->getHandle<std::string>("GridPACK.Thing.String1");
+  std::string sval;
+  BOOST_CHECK(string1.get(&sval));
+  BOOST_CHECK_EQUAL(sval, "A simple string.");
+
+  gridpack::utility::Configuration::Handle<double> missing =
+    config->getHandle<double>("GridPACK.Thing.Missing");
+  BOOST_CHECK(!missing.found());
+  BOOST_CHECK_EQUAL(missing.get(2.5), 2.5);
+
+  // Handles obtained through a cursor refer to the same tree
+  gridpack::utility::Configuration::CursorPtr cursor =
+       config->getCursor("GridPACK.Thing");
+  BOOST_REQUIRE(cursor != NULL);
+  gridpack::utility::Configuration::Handle<bool> flag =
+    cursor->getHandle<bool>("Flag");
+  BOOST_CHECK(flag.found());
+  BOOST_CHECK(!flag.get(true));
+  BOOST_CHECK_CLOSE(cursor->getHandle<double>("Float").get(0.0), 1.23e04,
+      1.0e-10);
+}
+
 BOOST_AUTO_TEST_CASE( Configurable )
 {
   std::auto_ptr<gridpack::utility::Configuration> 
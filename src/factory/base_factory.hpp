@@ -30,11 +30,71 @@
 namespace gridpack{
 namespace factory{
 
+/**
+ * View of a contiguous array of component pointers. This is returned by the
+ * component accessors in BaseFactory and can be used either with an index
+ * or with begin() and end(). The view is invalidated if the factory
+ * rebuilds its component arrays
+ */
+template <class _component>
+class ComponentRange {
+  public:
+    typedef _component* const* iterator;
+
+    ComponentRange(void)
+      : p_begin(NULL), p_end(NULL)
+    { }
+
+    ComponentRange(iterator begin, iterator end)
+      : p_begin(begin), p_end(end)
+    { }
+
+    /**
+     * Pointer to first component in range
+     */
+    iterator begin(void) const
+    {
+      return p_begin;
+    }
+
+    /**
+     * Pointer to one past the last component in range
+     */
+    iterator end(void) const
+    {
+      return p_end;
+    }
+
+    /**
+     * Number of components in range
+     */
+    int size(void) const
+    {
+      return static_cast<int>(p_end - p_begin);
+    }
+
+    /**
+     * Access component in range
+     * @param i index of component in range
+     * @return pointer to component
+     */
+    _component* operator[](int i) const
+    {
+      return p_begin[i];
+    }
+
+  private:
+    iterator p_begin;
+    iterator p_end;
+};
+
 template <class _network>
 class BaseFactory {
   public:
     typedef _network NetworkType;
     typedef boost::shared_ptr<NetworkType> NetworkPtr;
+    typedef typename NetworkType::BusType BusType;
+    typedef typename NetworkType::BranchType BranchType;
 
     /**
      * Constructor
@@ -55,6 +115,7 @@ class BaseFactory {
       for (i=0; i<p_numBranches; i++) {
         p_branches[i] = p_network->getBranch(i).get();
       }
+      setComponentArrays();
     }
 
     /**
@@ -236,6 +297,7 @@ class BaseFactory {
       
       // Set internal maps
       p_network->setMap();
+      setComponentArrays();
       timer->stop(t_setc);
       timer->configTimer(true);
     }
@@ -492,6 +554,64 @@ class BaseFactory {
       *nbranch = p_numBranches;
     }
 
+    /**
+     * Return all buses on this processor as their full type. The position of a
+     * bus in the range is its local index in the network
+     * @return range of bus pointers
+     */
+    ComponentRange<BusType> buses(void) const
+    {
+      return p_componentRange(p_busArray);
+    }
+
+    /**
+     * Return all branches on this processor as their full type. The position of
+     * a branch in the range is its local index in the network
+     * @return range of branch pointers
+     */
+    ComponentRange<BranchType> branches(void) const
+    {
+      return p_componentRange(p_branchArray);
+    }
+
+    /**
+     * Return only the buses owned by this processor, in order of increasing
+     * local index
+     * @return range of bus pointers
+     */
+    ComponentRange<BusType> activeBuses(void) const
+    {
+      return p_componentRange(p_activeBusArray);
+    }
+
+    /**
+     * Return only the branches owned by this processor, in order of increasing
+     * local index
+     * @return range of branch pointers
+     */
+    ComponentRange<BranchType> activeBranches(void) const
+    {
+      return p_componentRange(p_activeBranchArray);
+    }
+
+    /**
+     * Local network indices of the buses returned by activeBuses
+     * @return list of local bus indices
+     */
+    const std::vector<int>& activeBusIndices(void) const
+    {
+      return p_activeBusIndex;
+    }
+
+    /**
+     * Local network indices of the branches returned by activeBranches
+     * @return list of local branch indices
+     */
+    const std::vector<int>& activeBranchIndices(void) const
+    {
+      return p_activeBranchIndex;
+    }
+
     /**
      * Debugging call that will dump contents of DataCollection objects on each
      * bus and branch. This call will attempt to guarantee that output is
@@ -537,6 +657,56 @@ class BaseFactory {
     gridpack::component::BaseBusComponent **p_buses;
 
     gridpack::component::BaseBranchComponent **p_branches;
+
+    /**
+     * Rebuild the typed component arrays and the lists of active components.
+     * This is called by the constructor and by setComponents and should be
+     * called again if the network changes which components are active
+     */
+    void setComponentArrays(void)
+    {
+      int i;
+      p_busArray.resize(p_numBuses);
+      p_activeBusArray.clear();
+      p_activeBusIndex.clear();
+      for (i=0; i<p_numBuses; i++) {
+        p_busArray[i] = p_network->getBus(i).get();
+        if (p_network->getActiveBus(i)) {
+          p_activeBusArray.push_back(p_busArray[i]);
+          p_activeBusIndex.push_back(i);
+        }
+      }
+      p_branchArray.resize(p_numBranches);
+      p_activeBranchArray.clear();
+      p_activeBranchIndex.clear();
+      for (i=0; i<p_numBranches; i++) {
+        p_branchArray[i] = p_network->getBranch(i).get();
+        if (p_network->getActiveBranch(i)) {
+          p_activeBranchArray.push_back(p_branchArray[i]);
+          p_activeBranchIndex.push_back(i);
+        }
+      }
+    }
+
+  private:
+
+    template <class _component>
+    static ComponentRange<_component>
+      p_componentRange(const std::vector<_component*> &array)
+    {
+      if (array.empty()) return ComponentRange<_component>();
+      return ComponentRange<_component>(&array[0], &array[0]+array.size());
+    }
+
+    // Buses and branches cast to their full type, indexed by local index
+    std::vector<BusType*> p_busArray;
+    std::vector<BranchType*> p_branchArray;
+
+    // Active buses and branches and their local indices
+    std::vector<BusType*> p_activeBusArray;
+    std::vector<int> p_activeBusIndex;
+    std::vector<BranchType*> p_activeBranchArray;
+    std::vector<int> p_activeBranchIndex;
 };
 
 }    // factory
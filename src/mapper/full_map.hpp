@@ -138,6 +138,50 @@ boost::shared_ptr<gridpack::math::Matrix> mapToMatrix(bool isDense = false)
   return Ret;
 }
 
+/**
+ * Generate matrix in block sparse format from current component state on
+ * network. If the diagonal blocks of the buses are not all square and the
+ * same size, this reverts to a block size of 1
+ * @param symmetric set to true if only the upper triangular part of the
+ *        matrix needs to be stored
+ * @return return a pointer to new matrix
+ */
+boost::shared_ptr<gridpack::math::Matrix> mapToBlockMatrix(bool symmetric = false)
+{
+  gridpack::parallel::Communicator comm = p_network->communicator();
+  int t_new, t_bus, t_branch, t_set;
+  if (p_timer) t_new = p_timer->createCategory("Mapper: New Matrix");
+  if (p_timer) p_timer->start(t_new);
+  GA_Pgroup_sync(p_GAgrp);
+  boost::shared_ptr<gridpack::math::Matrix> Ret;
+  Ret.reset(gridpack::math::Matrix::createBlockSparse(comm, p_rowBlockSize,
+        p_colBlockSize, p_blockSize, p_maxcol, symmetric));
+  if (p_timer) p_timer->stop(t_new);
+  if (p_timer) t_bus = p_timer->createCategory("Mapper: Load Bus Data");
+  if (p_timer) p_timer->start(t_bus);
+  loadBusData(*Ret,false);
+  if (p_timer) p_timer->stop(t_bus);
+  if (p_timer) t_branch = p_timer->createCategory("Mapper: Load Branch Data");
+  if (p_timer) p_timer->start(t_branch);
+  loadBranchData(*Ret,false);
+  if (p_timer) p_timer->stop(t_branch);
+  if (p_timer) t_set = p_timer->createCategory("Mapper: Set Matrix");
+  if (p_timer) p_timer->start(t_set);
+  GA_Pgroup_sync(p_GAgrp);
+  Ret->ready();
+  if (p_timer) p_timer->stop(t_set);
+  return Ret;
+}
+
+/**
+ * Size of the uniform component blocks in the matrix
+ * @return block size used by mapToBlockMatrix
+ */
+int blockSize(void) const
+{
+  return p_blockSize;
+}
+
 /**
  * Generate real matrix from current component state on network
  * @param isDense set to true if creating a dense matrix
@@ -786,6 +830,22 @@ void setupOffsetArrays()
   GA_Pgroup_igop(p_GAgrp,&p_maxIBlock,one,cmax);
   GA_Pgroup_igop(p_GAgrp,&p_maxJBlock,one,cmax);
 
+  // Find out if all non-zero blocks are square and have the same size. If
+  // they do, the matrix can be stored in block sparse format
+  int minBlock = p_maxIBlock > p_maxJBlock ? p_maxIBlock : p_maxJBlock;
+  for (i=0; i<nRows; i++) {
+    if (iSizes[i] > 0 && iSizes[i] < minBlock) minBlock = iSizes[i];
+    if (jSizes[i] > 0 && jSizes[i] < minBlock) minBlock = jSizes[i];
+  }
+  char cmin[4];
+  strcpy(cmin,"min");
+  GA_Pgroup_igop(p_GAgrp,&minBlock,one,cmin);
+  if (minBlock > 0 && minBlock == p_maxIBlock && minBlock == p_maxJBlock) {
+    p_blockSize = minBlock;
+  } else {
+    p_blockSize = 1;
+  }
+
   for (i = 0; i<p_nNodes; i++) {
     itmp[i] = 0;
     jtmp[i] = 0;
@@ -945,18 +1005,12 @@ void loadBusData(gridpack::math::Matrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (bus->matrixDiagValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_busOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_busOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
+          idx = p_i_busOffsets[jcnt];
+          jdx = p_j_busOffsets[jcnt];
+          if (flag) {
+            matrix.addBlock(idx, jdx, isize, jsize, values);
+          } else {
+            matrix.setBlock(idx, jdx, isize, jsize, values);
           }
         }
         jcnt++;
@@ -990,18 +1044,12 @@ void loadRealBusData(gridpack::math::RealMatrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (bus->matrixDiagValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_busOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_busOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
+          idx = p_i_busOffsets[jcnt];
+          jdx = p_j_busOffsets[jcnt];
+          if (flag) {
+            matrix.addBlock(idx, jdx, isize, jsize, values);
+          } else {
+            matrix.setBlock(idx, jdx, isize, jsize, values);
           }
         }
         jcnt++;
@@ -1132,18 +1180,12 @@ void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixForwardValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
+          idx = p_i_branchOffsets[jcnt];
+          jdx = p_j_branchOffsets[jcnt];
+          if (flag) {
+            matrix.addBlock(idx, jdx, isize, jsize, values);
+          } else {
+            matrix.setBlock(idx, jdx, isize, jsize, values);
           }
         }
         jcnt++;
@@ -1157,20 +1199,14 @@ void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixReverseValues(values)) {
-          icnt = 0;
-          // Note that because the indices have been reversed, we need to switch
-          // the ordering of the offsets as well
-          for (k=0; k<jsize; k++) {
-            idx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              jdx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(jdx, idx, values[icnt]);
-              } else {
-                matrix.setElement(jdx, idx, values[icnt]);
-              }
-              icnt++;
-            }
+          // Because the indices have been reversed, the offsets were
+          // switched when they were gathered
+          idx = p_i_branchOffsets[jcnt];
+          jdx = p_j_branchOffsets[jcnt];
+          if (flag) {
+            matrix.addBlock(idx, jdx, isize, jsize, values);
+          } else {
+            matrix.setBlock(idx, jdx, isize, jsize, values);
           }
         }
         jcnt++;
@@ -1209,18 +1245,12 @@ void loadRealBranchData(gridpack::math::RealMatrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixForwardValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
+          idx = p_i_branchOffsets[jcnt];
+          jdx = p_j_branchOffsets[jcnt];
+          if (flag) {
+            matrix.addBlock(idx, jdx, isize, jsize, values);
+          } else {
+            matrix.setBlock(idx, jdx, isize, jsize, values);
           }
         }
         jcnt++;
@@ -1234,20 +1264,14 @@ void loadRealBranchData(gridpack::math::RealMatrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixReverseValues(values)) {
-          icnt = 0;
-          // Note that because the indices have been reversed, we need to switch
-          // the ordering of the offsets as well
-          for (k=0; k<jsize; k++) {
-            idx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              jdx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(jdx, idx, values[icnt]);
-              } else {
-                matrix.setElement(jdx, idx, values[icnt]);
-              }
-              icnt++;
-            }
+          // Because the indices have been reversed, the offsets were
+          // switched when they were gathered
+          idx = p_i_branchOffsets[jcnt];
+          jdx = p_j_branchOffsets[jcnt];
+          if (flag) {
+            matrix.addBlock(idx, jdx, isize, jsize, values);
+          } else {
+            matrix.setBlock(idx, jdx, isize, jsize, values);
           }
         }
         jcnt++;
@@ -1335,6 +1359,7 @@ int                         p_branchContribution;
 int                         p_maxIBlock;
 int                         p_maxJBlock;
 int                         p_maxcol;
+int                         p_blockSize;
 #ifdef NZ_PER_ROW
 int*                        p_nz_per_row;
 #endif
@@ -41,7 +41,7 @@ public:
   /// Default constructor.
   BasicLinearMatrixSolverImplementation(MatrixType& A)
     : LinearMatrixSolverImplementation<T, I>(A),
-      p_solver(A)
+      p_solver(*(this->p_A))
   {
   }
 
@@ -52,7 +52,8 @@ public:
 
 protected:
 
-  /// The linear solver instance used for this
+  /// The linear solver instance used for this (uses the local copy
+  /// of the coefficient matrix so updateMatrix() is seen by it)
   LinearSolverT<T, I> p_solver;
 
   /// Solve w/ the specified RHS Matrix (specialized)
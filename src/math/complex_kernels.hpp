@@ -0,0 +1,265 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+// -------------------------------------------------------------
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   complex_kernels.hpp
+ * @date   2026-10-19
+ *
+ * @brief
+ * Batched complex arithmetic on arrays stored in split layout, with the
+ * real and imaginary parts of n complex numbers in two separate arrays of
+ * doubles. The split layout lets each operation be carried out on several
+ * numbers at once with SIMD instructions. AVX-512 or AVX2 versions are
+ * used if the compiler targets them (e.g. -mavx2 -mfma or -march=native),
+ * otherwise plain loops are used that the compiler is free to vectorize.
+ * Output arrays may be the same as input arrays, but must not otherwise
+ * overlap them.
+ *
+ * Multiplication and division use the textbook formulas, without the
+ * rescaling that std::complex does to avoid overflow and underflow, so
+ * they should only be used on values of moderate magnitude, such as
+ * admittances, voltages and currents in per unit.
+ */
+// -------------------------------------------------------------
+
+#ifndef _complex_kernels_hpp_
+#define _complex_kernels_hpp_
+
+#include <cmath>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define GRIDPACK_COMPLEX_SIMD_WIDTH 8
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define GRIDPACK_COMPLEX_SIMD_WIDTH 4
+#else
+#define GRIDPACK_COMPLEX_SIMD_WIDTH 1
+#endif
+
+namespace gridpack {
+namespace math {
+
+// -------------------------------------------------------------
+// SIMD helpers. Each wraps a packed double type and the handful of
+// operations the kernels need
+// -------------------------------------------------------------
+namespace complex_simd {
+
+#if defined(__AVX512F__)
+typedef __m512d pack;
+inline pack load(const double *p) { return _mm512_loadu_pd(p); }
+inline void store(double *p, pack a) { _mm512_storeu_pd(p, a); }
+inline pack set1(double a) { return _mm512_set1_pd(a); }
+inline pack add(pack a, pack b) { return _mm512_add_pd(a, b); }
+inline pack sub(pack a, pack b) { return _mm512_sub_pd(a, b); }
+inline pack mul(pack a, pack b) { return _mm512_mul_pd(a, b); }
+inline pack div(pack a, pack b) { return _mm512_div_pd(a, b); }
+inline pack fmadd(pack a, pack b, pack c) { return _mm512_fmadd_pd(a, b, c); }
+inline pack fmsub(pack a, pack b, pack c) { return _mm512_fmsub_pd(a, b, c); }
+#elif defined(__AVX2__)
+typedef __m256d pack;
+inline pack load(const double *p) { return _mm256_loadu_pd(p); }
+inline void store(double *p, pack a) { _mm256_storeu_pd(p, a); }
+inline pack set1(double a) { return _mm256_set1_pd(a); }
+inline pack add(pack a, pack b) { return _mm256_add_pd(a, b); }
+inline pack sub(pack a, pack b) { return _mm256_sub_pd(a, b); }
+inline pack mul(pack a, pack b) { return _mm256_mul_pd(a, b); }
+inline pack div(pack a, pack b) { return _mm256_div_pd(a, b); }
+#if defined(__FMA__)
+inline pack fmadd(pack a, pack b, pack c) { return _mm256_fmadd_pd(a, b, c); }
+inline pack fmsub(pack a, pack b, pack c) { return _mm256_fmsub_pd(a, b, c); }
+#else
+inline pack fmadd(pack a, pack b, pack c) { return add(mul(a, b), c); }
+inline pack fmsub(pack a, pack b, pack c) { return sub(mul(a, b), c); }
+#endif
+#endif
+
+} // namespace complex_simd
+
+/**
+ * Reciprocal of n complex numbers, y = 1/x
+ * @param n number of values
+ * @param xr,xi real and imaginary parts of x
+ * @param yr,yi real and imaginary parts of y
+ */
+inline void complexReciprocal(int n, const double *xr, const double *xi,
+    double *yr, double *yi)
+{
+  int i = 0;
+#if GRIDPACK_COMPLEX_SIMD_WIDTH > 1
+  using namespace complex_simd;
+  const pack one = set1(1.0);
+  for (; i+GRIDPACK_COMPLEX_SIMD_WIDTH <= n; i += GRIDPACK_COMPLEX_SIMD_WIDTH) {
+    pack a = load(xr+i);
+    pack b = load(xi+i);
+    pack rden = div(one, fmadd(a, a, mul(b, b)));
+    store(yr+i, mul(a, rden));
+    store(yi+i, sub(set1(0.0), mul(b, rden)));
+  }
+#endif
+  for (; i<n; i++) {
+    double a = xr[i];
+    double b = xi[i];
+    double rden = 1.0/(a*a+b*b);
+    yr[i] = a*rden;
+    yi[i] = -b*rden;
+  }
+}
+
+/**
+ * Product of n pairs of complex numbers, c = a*b
+ * @param n number of values
+ * @param ar,ai real and imaginary parts of a
+ * @param br,bi real and imaginary parts of b
+ * @param cr,ci real and imaginary parts of c
+ */
+inline void complexMultiply(int n, const double *ar, const double *ai,
+    const double *br, const double *bi, double *cr, double *ci)
+{
+  int i = 0;
+#if GRIDPACK_COMPLEX_SIMD_WIDTH > 1
+  using namespace complex_simd;
+  for (; i+GRIDPACK_COMPLEX_SIMD_WIDTH <= n; i += GRIDPACK_COMPLEX_SIMD_WIDTH) {
+    pack xr = load(ar+i);
+    pack xi = load(ai+i);
+    pack yr = load(br+i);
+    pack yi = load(bi+i);
+    store(cr+i, fmsub(xr, yr, mul(xi, yi)));
+    store(ci+i, fmadd(xr, yi, mul(xi, yr)));
+  }
+#endif
+  for (; i<n; i++) {
+    double xr = ar[i];
+    double xi = ai[i];
+    double yr = br[i];
+    double yi = bi[i];
+    cr[i] = xr*yr-xi*yi;
+    ci[i] = xr*yi+xi*yr;
+  }
+}
+
+/**
+ * Product of n complex numbers with the conjugates of n others,
+ * c = a*conj(b)
+ * @param n number of values
+ * @param ar,ai real and imaginary parts of a
+ * @param br,bi real and imaginary parts of b
+ * @param cr,ci real and imaginary parts of c
+ */
+inline void complexMultiplyConj(int n, const double *ar, const double *ai,
+    const double *br, const double *bi, double *cr, double *ci)
+{
+  int i = 0;
+#if GRIDPACK_COMPLEX_SIMD_WIDTH > 1
+  using namespace complex_simd;
+  for (; i+GRIDPACK_COMPLEX_SIMD_WIDTH <= n; i += GRIDPACK_COMPLEX_SIMD_WIDTH) {
+    pack xr = load(ar+i);
+    pack xi = load(ai+i);
+    pack yr = load(br+i);
+    pack yi = load(bi+i);
+    store(cr+i, fmadd(xr, yr, mul(xi, yi)));
+    store(ci+i, fmsub(xi, yr, mul(xr, yi)));
+  }
+#endif
+  for (; i<n; i++) {
+    double xr = ar[i];
+    double xi = ai[i];
+    double yr = br[i];
+    double yi = bi[i];
+    cr[i] = xr*yr+xi*yi;
+    ci[i] = xi*yr-xr*yi;
+  }
+}
+
+/**
+ * Quotient of n pairs of complex numbers, c = a/b
+ * @param n number of values
+ * @param ar,ai real and imaginary parts of a
+ * @param br,bi real and imaginary parts of b
+ * @param cr,ci real and imaginary parts of c
+ */
+inline void complexDivide(int n, const double *ar, const double *ai,
+    const double *br, const double *bi, double *cr, double *ci)
+{
+  int i = 0;
+#if GRIDPACK_COMPLEX_SIMD_WIDTH > 1
+  using namespace complex_simd;
+  const pack one = set1(1.0);
+  for (; i+GRIDPACK_COMPLEX_SIMD_WIDTH <= n; i += GRIDPACK_COMPLEX_SIMD_WIDTH) {
+    pack xr = load(ar+i);
+    pack xi = load(ai+i);
+    pack yr = load(br+i);
+    pack yi = load(bi+i);
+    pack rden = div(one, fmadd(yr, yr, mul(yi, yi)));
+    store(cr+i, mul(fmadd(xr, yr, mul(xi, yi)), rden));
+    store(ci+i, mul(fmsub(xi, yr, mul(xr, yi)), rden));
+  }
+#endif
+  for (; i<n; i++) {
+    double xr = ar[i];
+    double xi = ai[i];
+    double yr = br[i];
+    double yi = bi[i];
+    double rden = 1.0/(yr*yr+yi*yi);
+    cr[i] = (xr*yr+xi*yi)*rden;
+    ci[i] = (xi*yr-xr*yi)*rden;
+  }
+}
+
+/**
+ * Scale n complex numbers by n real numbers, c = s*a
+ * @param n number of values
+ * @param s real scale factors
+ * @param ar,ai real and imaginary parts of a
+ * @param cr,ci real and imaginary parts of c
+ */
+inline void complexScale(int n, const double *s, const double *ar,
+    const double *ai, double *cr, double *ci)
+{
+  int i = 0;
+#if GRIDPACK_COMPLEX_SIMD_WIDTH > 1
+  using namespace complex_simd;
+  for (; i+GRIDPACK_COMPLEX_SIMD_WIDTH <= n; i += GRIDPACK_COMPLEX_SIMD_WIDTH) {
+    pack f = load(s+i);
+    store(cr+i, mul(f, load(ar+i)));
+    store(ci+i, mul(f, load(ai+i)));
+  }
+#endif
+  for (; i<n; i++) {
+    double f = s[i];
+    double xr = ar[i];
+    double xi = ai[i];
+    cr[i] = f*xr;
+    ci[i] = f*xi;
+  }
+}
+
+/**
+ * Unit complex numbers with given phase angles, c = cos(theta) +
+ * i*sin(theta). There are no SIMD instructions for trigonometric
+ * functions, so this is a plain loop that the compiler can vectorize if it
+ * has a vector math library
+ * @param n number of values
+ * @param theta phase angles in radians
+ * @param cr,ci real and imaginary parts of c
+ */
+inline void complexCis(int n, const double *theta, double *cr, double *ci)
+{
+  int i;
+  for (i=0; i<n; i++) {
+    double t = theta[i];
+    cr[i] = cos(t);
+    ci[i] = sin(t);
+  }
+}
+
+} // namespace math
+} // namespace gridpack
+
+#endif
@@ -0,0 +1,236 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+// -------------------------------------------------------------
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+// -------------------------------------------------------------
+/**
+ * @file   kron_reduction.hpp
+ * @date   2026-10-19
+ *
+ * @brief  Declaration of the KronReduction class
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#ifndef _kron_reduction_hpp_
+#define _kron_reduction_hpp_
+
+#include <cstdio>
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include "gridpack/utilities/uncopyable.hpp"
+#include "gridpack/utilities/exception.hpp"
+#include "gridpack/math/matrix.hpp"
+#include "gridpack/math/linear_matrix_solver.hpp"
+
+namespace gridpack {
+namespace math {
+
+// -------------------------------------------------------------
+//  class KronReductionT
+// -------------------------------------------------------------
+/// Reduce a network admittance matrix onto a small set of nodes
+/**
+ * This class computes the Schur complement (Kron reduction)
+ *
+ *   Y_red = Y_a + Y_b * Y^{-1} * Y_c
+ *
+ * where @c Y is a (large, sparse) network admittance matrix and @c
+ * Y_a, @c Y_b, and @c Y_c couple the retained nodes (e.g. generator
+ * internal buses) to the network. Only the reduced matrix is
+ * returned; intermediate solutions are discarded as soon as they
+ * have been multiplied by @c Y_b.
+ *
+ * A KronReduction is typically used for several network states
+ * (e.g. pre-fault, fault-on, and post-fault) that differ only in
+ * the values of @c Y. The ordering and symbolic factorization of the
+ * first @c Y passed to reduce() are kept and reused for subsequent
+ * calls, so each additional state only costs a numeric
+ * factorization and the solves. Subsequent matrices must have the
+ * same nonzero pattern as the first.
+ *
+ * The columns of @c Y_c can be solved in blocks to limit the size of
+ * the dense intermediate solution.
+ */
+template <typename T, typename I = int>
+class KronReductionT
+  : private utility::Uncopyable
+{
+public:
+
+  typedef MatrixT<T, I> MatrixType;
+  typedef LinearMatrixSolverT<T, I> SolverType;
+
+  /// Default constructor.
+  /**
+   * @e Collective on the communicator of @c Y_c.
+   *
+   * The coupling matrices must exist for the life of this instance.
+   *
+   * @param Y_a retained node block (n_r x n_r)
+   * @param Y_b retained to network coupling (n_r x n)
+   * @param Y_c network to retained coupling (n x n_r), must be \ref
+   * Matrix::Dense "dense"
+   * @param blockSize number of columns of @c Y_c to solve at once;
+   * zero or less means all columns at once
+   */
+  KronReductionT(const MatrixType& Y_a, const MatrixType& Y_b,
+                 const MatrixType& Y_c, const int& blockSize = 0)
+    : utility::Uncopyable(),
+      p_Ya(Y_a), p_Yb(Y_b), p_Yc(Y_c)
+  {
+    if (p_Yb.rows() != p_Ya.rows() || p_Yc.cols() != p_Ya.cols() ||
+        p_Yb.cols() != p_Yc.rows()) {
+      char buf[256];
+      sprintf(buf,"KronReduction: inconsistent block sizes Y_a(%d,%d)"
+          " Y_b(%d,%d) Y_c(%d,%d)\n",
+          static_cast<int>(p_Ya.rows()), static_cast<int>(p_Ya.cols()),
+          static_cast<int>(p_Yb.rows()), static_cast<int>(p_Yb.cols()),
+          static_cast<int>(p_Yc.rows()), static_cast<int>(p_Yc.cols()));
+      throw gridpack::Exception(buf);
+    }
+    int ncols = p_Yc.cols();
+    if (blockSize > 0 && blockSize < ncols) {
+      p_buildBlocks(blockSize);
+    }
+  }
+
+  /// Destructor
+  ~KronReductionT(void)
+  {}
+
+  /// Compute the reduced matrix for the specified network matrix
+  /**
+   * @e Collective.
+   *
+   * The first call factors @c Y completely. Later calls reuse the
+   * symbolic factorization and only refactor numerically.
+   *
+   * @param Y network admittance matrix (n x n)
+   *
+   * @return (dense) reduced matrix (n_r x n_r), caller is responsible
+   * for deleting it
+   */
+  MatrixType *reduce(MatrixType& Y)
+  {
+    if (Y.rows() != p_Yc.rows() || Y.cols() != p_Yc.rows()) {
+      char buf[256];
+      sprintf(buf,"KronReduction::reduce: network matrix is (%d,%d), expected (%d,%d)\n",
+          static_cast<int>(Y.rows()), static_cast<int>(Y.cols()),
+          static_cast<int>(p_Yc.rows()), static_cast<int>(p_Yc.rows()));
+      throw gridpack::Exception(buf);
+    }
+    if (!p_solver) {
+      p_solver.reset(new SolverType(Y));
+    } else {
+      p_solver->updateMatrix(Y);
+    }
+
+    MatrixType *result;
+    if (p_rhs.empty()) {
+      boost::scoped_ptr<MatrixType> X(p_solver->solve(p_Yc));
+      result = multiply(p_Yb, *X);
+      result->add(p_Ya);
+    } else {
+      result = p_Ya.clone();
+      I lo, hi;
+      for (size_t k = 0; k < p_rhs.size(); ++k) {
+        boost::scoped_ptr<MatrixType> X(p_solver->solve(*p_rhs[k]));
+        boost::scoped_ptr<MatrixType> R(multiply(p_Yb, *X));
+        R->localRowRange(lo, hi);
+        int nc = R->cols();
+        std::vector<I> jdx(nc);
+        std::vector<I> rdx(nc);
+        std::vector<T> vals(nc);
+        for (int j = 0; j < nc; ++j) {
+          jdx[j] = j;
+          rdx[j] = p_offset[k] + j;
+        }
+        for (I i = lo; i < hi; ++i) {
+          std::vector<I> idx(nc, i);
+          R->getElements(nc, &idx[0], &jdx[0], &vals[0]);
+          result->addElements(nc, &idx[0], &rdx[0], &vals[0]);
+        }
+      }
+      result->ready();
+    }
+    return result;
+  }
+
+  /// Get the number of blocks used to solve for the columns of @c Y_c
+  int blocks(void) const
+  {
+    return (p_rhs.empty() ? 1 : static_cast<int>(p_rhs.size()));
+  }
+
+protected:
+
+  /// The retained node block
+  const MatrixType& p_Ya;
+
+  /// The retained to network coupling
+  const MatrixType& p_Yb;
+
+  /// The network to retained coupling
+  const MatrixType& p_Yc;
+
+  /// The factored network matrix, created by the first reduce()
+  boost::scoped_ptr<SolverType> p_solver;
+
+  /// Column blocks of @c Y_c, empty if all columns are solved at once
+  std::vector< boost::shared_ptr<MatrixType> > p_rhs;
+
+  /// First column of @c Y_c in each block
+  std::vector<int> p_offset;
+
+  /// Copy @c Y_c into dense column blocks
+  void p_buildBlocks(const int& blockSize)
+  {
+    const parallel::Communicator& comm(p_Yc.communicator());
+    int nprocs = comm.size();
+    int me = comm.rank();
+    int ncols = p_Yc.cols();
+    I lo, hi;
+    p_Yc.localRowRange(lo, hi);
+    int nrows = hi - lo;
+
+    for (int c0 = 0; c0 < ncols; c0 += blockSize) {
+      int nb = (c0 + blockSize < ncols ? blockSize : ncols - c0);
+      int lcols = nb/nprocs + (me < nb%nprocs ? 1 : 0);
+      boost::shared_ptr<MatrixType>
+        B(new MatrixType(comm, nrows, lcols, Dense));
+      std::vector<I> jdx(nb);
+      std::vector<I> bdx(nb);
+      std::vector<T> vals(nb);
+      for (int j = 0; j < nb; ++j) {
+        jdx[j] = c0 + j;
+        bdx[j] = j;
+      }
+      for (I i = lo; i < hi; ++i) {
+        std::vector<I> idx(nb, i);
+        p_Yc.getElements(nb, &idx[0], &jdx[0], &vals[0]);
+        B->setElements(nb, &idx[0], &bdx[0], &vals[0]);
+      }
+      B->ready();
+      p_rhs.push_back(B);
+      p_offset.push_back(c0);
+    }
+  }
+
+};
+
+typedef KronReductionT<ComplexType> ComplexKronReduction;
+typedef KronReductionT<RealType> RealKronReduction;
+typedef ComplexKronReduction KronReduction;
+
+} // namespace math
+} // namespace gridpack
+
+
+#endif
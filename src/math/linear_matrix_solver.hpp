@@ -87,6 +87,26 @@ protected:
     return p_impl->solve(B);
   }
 
+  /// Replace the coefficient Matrix (specialized)
+  void p_updateMatrix(const MatrixType& A)
+  {
+    p_impl->updateMatrix(A);
+  }
+
+  /// Solve, keeping only selected rows of the solution (specialized)
+  MatrixType *p_solveRows(const MatrixType& B, 
+                          const std::vector<I>& rows) const
+  {
+    return p_impl->solveRows(B, rows);
+  }
+
+  /// Get selected entries of the inverse (specialized)
+  MatrixType *p_inverseEntries(const std::vector<I>& rows, 
+                               const std::vector<I>& cols) const
+  {
+    return p_impl->inverseEntries(rows, cols);
+  }
+
 };
 
 typedef LinearMatrixSolverT<ComplexType> ComplexLinearMatrixSolver;
@@ -20,6 +20,8 @@
 #ifndef _linear_matrix_solver_implementation_hpp_
 #define _linear_matrix_solver_implementation_hpp_
 
+#include <vector>
+#include <boost/scoped_ptr.hpp>
 #include "gridpack/parallel/distributed.hpp"
 #include "gridpack/configuration/configurable.hpp"
 #include "gridpack/utilities/uncopyable.hpp"
@@ -49,7 +51,8 @@ public:
       parallel::Distributed(A.communicator()),
       utility::Configurable(),
       utility::Uncopyable(),
-      p_A(A.clone())
+      p_A(A.clone()),
+      p_columnBlock(32)
   {
     configurationKey("LinearMatrixSolver");
   }
@@ -69,10 +72,103 @@ protected:
 
   /// The coefficient matrix (may not need to remember)
   boost::scoped_ptr<MatrixType> p_A;
+
+  /// Number of RHS columns solved at once by p_solveRows()
+  int p_columnBlock;
+
+  /// Number of @c n items owned by this process when spread evenly
+  int p_localShare(const int& n) const
+  {
+    int nprocs(this->processor_size());
+    int me(this->processor_rank());
+    return n/nprocs + (me < n%nprocs ? 1 : 0);
+  }
   
   /// Solve w/ the specified RHS Matrix (specialized)
   virtual MatrixType *p_solve(const MatrixType& B) const = 0;
 
+  /// Replace the coefficient Matrix (specialized)
+  virtual void p_updateMatrix(const MatrixType& A)
+  {
+    p_A->equate(A);
+  }
+
+  /// Solve, keeping only selected rows of the solution (specialized)
+  /**
+   * The columns of @c B are copied into dense blocks of
+   * ::p_columnBlock columns and solved one block at a time. Only the
+   * selected rows of each block solution are kept.
+   */
+  virtual MatrixType *p_solveRows(const MatrixType& B, 
+                                  const std::vector<I>& rows) const
+  {
+    const parallel::Communicator& comm(B.communicator());
+    int ncols(B.cols());
+    int nsel(rows.size());
+    I lo, hi;
+    B.localRowRange(lo, hi);
+    int nrows(hi - lo);
+
+    MatrixType *result = 
+      new MatrixType(comm, p_localShare(nsel), p_localShare(ncols), Dense);
+
+    for (int c0 = 0; c0 < ncols; c0 += p_columnBlock) {
+      int nb = (c0 + p_columnBlock < ncols ? p_columnBlock : ncols - c0);
+      std::vector<I> jdx(nb);
+      std::vector<I> bdx(nb);
+      std::vector<I> rdx(nb);
+      std::vector<typename MatrixType::TheType> vals(nb);
+      for (int j = 0; j < nb; ++j) {
+        jdx[j] = c0 + j;
+        bdx[j] = j;
+      }
+
+      MatrixType Bk(comm, nrows, p_localShare(nb), Dense);
+      for (I i = lo; i < hi; ++i) {
+        std::vector<I> idx(nb, i);
+        B.getElements(nb, &idx[0], &jdx[0], &vals[0]);
+        Bk.setElements(nb, &idx[0], &bdx[0], &vals[0]);
+      }
+      Bk.ready();
+
+      boost::scoped_ptr<MatrixType> X(this->p_solve(Bk));
+      I xlo, xhi;
+      X->localRowRange(xlo, xhi);
+      for (int k = 0; k < nsel; ++k) {
+        if (xlo <= rows[k] && rows[k] < xhi) {
+          std::vector<I> idx(nb, rows[k]);
+          std::vector<I> kdx(nb, k);
+          X->getElements(nb, &idx[0], &bdx[0], &vals[0]);
+          result->setElements(nb, &kdx[0], &jdx[0], &vals[0]);
+        }
+      }
+    }
+    result->ready();
+    return result;
+  }
+
+  /// Get selected entries of the inverse (specialized)
+  /**
+   * The selected columns of the identity are used as a sparse RHS
+   * for p_solveRows().
+   */
+  virtual MatrixType *p_inverseEntries(const std::vector<I>& rows, 
+                                       const std::vector<I>& cols) const
+  {
+    const parallel::Communicator& comm(p_A->communicator());
+    int ncsel(cols.size());
+    I lo, hi;
+    p_A->localRowRange(lo, hi);
+    MatrixType E(comm, hi - lo, p_localShare(ncsel), Sparse);
+    for (int l = 0; l < ncsel; ++l) {
+      if (lo <= cols[l] && cols[l] < hi) {
+        E.setElement(cols[l], l, 1.0);
+      }
+    }
+    E.ready();
+    return p_solveRows(E, rows);
+  }
+
 };
 
 
@@ -21,6 +21,7 @@
 #ifndef _linear_matrix_solver_interface_hpp_
 #define _linear_matrix_solver_interface_hpp_
 
+#include <vector>
 #include "gridpack/parallel/distributed.hpp"
 #include "gridpack/configuration/configurable.hpp"
 #include "gridpack/utilities/uncopyable.hpp"
@@ -55,11 +56,77 @@ public:
     return this->p_solve(B);
   }
 
+  /// Solve w/ the specified RHS Matrix, keeping only selected rows of the solution
+  /** 
+   * @e Collective. The result has one row for each entry in @c rows
+   * and the same number of columns as @c B. Only the selected rows
+   * are stored, so memory scales with the number of rows and
+   * columns selected instead of the size of the coefficient Matrix.
+   * @c B may be sparse.
+   * 
+   * @param B RHS matrix
+   * @param rows global rows of the solution that are wanted, must be
+   * the same on all processes
+   * 
+   * @return (dense) Matrix with the selected rows of the solution
+   */
+  MatrixType *solveRows(const MatrixType& B, const std::vector<I>& rows) const
+  {
+    return this->p_solveRows(B, rows);
+  }
+
+  /// Get selected entries of the inverse of the coefficient Matrix
+  /** 
+   * @e Collective. Entry (k, l) of the result is entry (@c rows[k],
+   * @c cols[l]) of the inverse of the coefficient Matrix. If the
+   * underlying direct solver can compute selected entries of the
+   * inverse, that is used. Otherwise, the inverse is computed a few
+   * columns at a time and only the selected rows are kept.
+   * 
+   * @param rows global rows of the inverse, must be the same on all
+   * processes
+   * @param cols global columns of the inverse, must be the same on
+   * all processes
+   * 
+   * @return (dense) Matrix with the selected entries of the inverse
+   */
+  MatrixType *inverseEntries(const std::vector<I>& rows, 
+                             const std::vector<I>& cols) const
+  {
+    return this->p_inverseEntries(rows, cols);
+  }
+
+  /// Replace the coefficient Matrix w/ one having the same nonzero pattern
+  /** 
+   * The values in @c A are copied into the coefficient Matrix. If
+   * the underlying library supports it, the symbolic factorization
+   * computed for the original coefficient Matrix is kept and only
+   * the numeric factorization is redone on the next solve().
+   * 
+   * @param A new coefficient Matrix, same size and nonzero pattern
+   * as the original
+   */
+  void updateMatrix(const MatrixType& A)
+  {
+    this->p_updateMatrix(A);
+  }
+
 protected:
 
   /// Solve w/ the specified RHS Matrix (specialized)
   virtual MatrixType *p_solve(const MatrixType& B) const = 0;
 
+  /// Replace the coefficient Matrix (specialized)
+  virtual void p_updateMatrix(const MatrixType& A) = 0;
+
+  /// Solve, keeping only selected rows of the solution (specialized)
+  virtual MatrixType *p_solveRows(const MatrixType& B, 
+                                  const std::vector<I>& rows) const = 0;
+
+  /// Get selected entries of the inverse (specialized)
+  virtual MatrixType *p_inverseEntries(const std::vector<I>& rows, 
+                                       const std::vector<I>& cols) const = 0;
+
 };
 
 
@@ -23,6 +23,7 @@
 #include <gridpack/math/newton_raphson_solver.hpp>
 #include <gridpack/math/linear_solver.hpp>
 #include <gridpack/math/linear_matrix_solver.hpp>
+#include <gridpack/math/kron_reduction.hpp>
 
 namespace gridpack {
 namespace math {
@@ -155,6 +155,38 @@ public:
               const int& global_cols,
               const int& local_rows,
               const int& local_cols);
+
+  /// Create a ::BlockSparse Matrix instance
+  /** 
+   * @e Collective.
+   *
+   * Nonzeros are stored as dense @c block_size by @c block_size
+   * blocks, which reduces index storage and speeds up
+   * matrix-vector products and triangular solves when all nonzeros
+   * come in blocks of that size. Values can be set one at a time,
+   * but setBlock() and addBlock() are much faster.
+   * 
+   * @param comm parallel environment
+   * @param local_rows matrix rows to be owned by the local process,
+   * must be a multiple of @c block_size
+   * @param local_cols matrix columns to be owned by the local
+   * process, must be a multiple of @c block_size
+   * @param block_size number of rows and columns in each block
+   * @param max_nz_per_row estimate of the maximum number of nonzero
+   * elements (not blocks) in a row
+   * @param symmetric if true, only the upper triangle is stored and
+   * values set in the lower triangle are ignored; only use this for
+   * matrices that are symmetric in the underlying library
+   * 
+   * @return new MatrixT
+   */
+  static MatrixT *
+  createBlockSparse(const parallel::Communicator& comm,
+                    const int& local_rows,
+                    const int& local_cols,
+                    const int& block_size,
+                    const int& max_nz_per_row,
+                    const bool& symmetric = false);
   
   /// Get the storage type of this matrix
   MatrixStorageType storageType(void) const;
@@ -328,6 +360,22 @@ protected:
     p_matrix_impl->addElements(n, i, j, x); 
   }
 
+  /// Set a dense block of elements
+  void p_setBlock(const IdxType& i, const IdxType& j, 
+                  const IdxType& m, const IdxType& n, 
+                  const TheType *x)
+  {
+    p_matrix_impl->setBlock(i, j, m, n, x);
+  }
+
+  /// Add to a dense block of elements
+  void p_addBlock(const IdxType& i, const IdxType& j, 
+                  const IdxType& m, const IdxType& n, 
+                  const TheType *x)
+  {
+    p_matrix_impl->addBlock(i, j, m, n, x);
+  }
+
   /// Get an individual element
   void p_getElement(const IdxType& i, const IdxType& j, TheType& x) const
   { 
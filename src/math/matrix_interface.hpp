@@ -171,6 +171,47 @@ public:
     this->p_addElements(n, i, j, x);
   }
 
+  /// Set a dense block of elements
+  /** 
+   * @e Local.
+   *
+   * This overwrites the values in the @c m by @c n block of the
+   * matrix whose upper left element is at row @c i and column @c
+   * j. Inserting a whole block at once is much cheaper than
+   * inserting its elements one at a time, especially if the matrix
+   * uses ::BlockSparse storage. ready() must be called after all
+   * setBlock() calls and before using the matrix.
+   * 
+   * @param i global (0-based) index of first row of block
+   * @param j global (0-based) index of first column of block
+   * @param m number of rows in block
+   * @param n number of columns in block
+   * @param x array of @c m*n values, ordered by column (element
+   * (r,c) of the block is x[c*m+r]), the same ordering used by
+   * network components
+   */
+  void setBlock(const IdxType& i, const IdxType& j, 
+                const IdxType& m, const IdxType& n, const TheType *x)
+  {
+    this->p_setBlock(i, j, m, n, x);
+  }
+
+  /// Add to a dense block of elements
+  /** 
+   * @e Local.
+   *
+   * @param i global (0-based) index of first row of block
+   * @param j global (0-based) index of first column of block
+   * @param m number of rows in block
+   * @param n number of columns in block
+   * @param x array of @c m*n values, ordered by column
+   */
+  void addBlock(const IdxType& i, const IdxType& j, 
+                const IdxType& m, const IdxType& n, const TheType *x)
+  {
+    this->p_addBlock(i, j, m, n, x);
+  }
+
   /// Get an individual element
   /** 
    * @c Local.
@@ -409,6 +450,30 @@ protected:
   virtual void p_addElements(const IdxType& n, const IdxType *i, const IdxType *j, 
                              const TheType *x) = 0;
 
+  /// Set a dense block of elements (specialized)
+  virtual void p_setBlock(const IdxType& i, const IdxType& j, 
+                          const IdxType& m, const IdxType& n, 
+                          const TheType *x)
+  {
+    for (IdxType c = 0; c < n; ++c) {
+      for (IdxType r = 0; r < m; ++r) {
+        this->p_setElement(i+r, j+c, x[c*m+r]);
+      }
+    }
+  }
+
+  /// Add to a dense block of elements (specialized)
+  virtual void p_addBlock(const IdxType& i, const IdxType& j, 
+                          const IdxType& m, const IdxType& n, 
+                          const TheType *x)
+  {
+    for (IdxType c = 0; c < n; ++c) {
+      for (IdxType r = 0; r < m; ++r) {
+        this->p_addElement(i+r, j+c, x[c*m+r]);
+      }
+    }
+  }
+
   /// Get an individual element (specialized)
   virtual void p_getElement(const IdxType& i, const IdxType& j, TheType& x) const = 0;
 
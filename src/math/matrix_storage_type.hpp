@@ -20,9 +20,12 @@ namespace math {
 
 /// The types of matrices that can be created
 /**
- * The gridpack::math library provides two storage schemes for
+ * The gridpack::math library provides three storage schemes for
  * matrices. This is used by Matrix and MatrixImplementation
- * subclasses.
+ * subclasses. ::BlockSparse is a sparse scheme that stores small
+ * dense blocks of a fixed size rather than individual elements; it
+ * only pays off when all nonzeros come in blocks of that size, such
+ * as the per-bus blocks generated by a mapper.
  *
  * The actual storage scheme and memory used is dependent upon the
  * underlying math library implementation.
@@ -30,7 +33,8 @@ namespace math {
  */
 enum MatrixStorageType { 
   Dense,                      /**< dense matrix storage scheme */
-  Sparse                      /**< sparse matrix storage scheme */
+  Sparse,                     /**< sparse matrix storage scheme */
+  BlockSparse                 /**< sparse storage of fixed size dense blocks */
 };
 
 } // namespace math
@@ -23,6 +23,8 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
+#include <cfloat>
+#include <iostream>
 #include <petscconf.h>
 #include <petscmat.h>
 #include "linear_matrix_solver_implementation.hpp"
@@ -30,6 +32,8 @@
 #include "petsc_matrix_implementation.hpp"
 #include "petsc_matrix_extractor.hpp"
 #include "petsc_exception.hpp"
+#include "petsc_misc.hpp"
+#include "value_transfer.hpp"
 
 namespace gridpack {
 namespace math {
@@ -51,6 +55,7 @@ public:
     : LinearMatrixSolverImplementation<T, I>(A),
       PETScConfigurable(this->communicator()),
       p_factored(false),
+      p_refactor(false), p_factorNonzeros(0.0),
       p_orderingType(MATORDERINGND),
 #if defined(PETSC_HAVE_SUPERLU_DIST)
       p_solverPackage(MATSOLVERSUPERLU_DIST),
@@ -60,7 +65,10 @@ public:
       p_solverPackage(MATSOLVERPETSC),
 #endif    
       p_factorType(MAT_FACTOR_LU),
-      p_fill(5), p_pivot(false)
+      p_fill(5), p_pivot(false),
+      p_mixedPrecision(false), p_factorPrecision(FLT_EPSILON),
+      p_refineTolerance(1.0e-12), p_refineMaxIterations(10),
+      p_lowPrecision(false), p_refineIterations(0)
   {
     // FIXME: maybe enforce the following: A is square, A uses sparse storage
   }
@@ -88,6 +96,12 @@ protected:
   /// Is p_Fmat ready?
   mutable bool p_factored;
 
+  /// Has the coefficient matrix changed since p_Fmat was computed?
+  mutable bool p_refactor;
+
+  /// Number of nonzeros in the coefficient matrix when it was factored
+  mutable PetscLogDouble p_factorNonzeros;
+
   /// List of supported matrix ordering
   static MatOrderingType p_supportedOrderingType[];
 
@@ -115,6 +129,24 @@ protected:
   /// Flag to enable pivoting
   bool p_pivot;
 
+  /// Use a reduced precision factorization with iterative refinement
+  bool p_mixedPrecision;
+
+  /// Precision of the reduced precision factorization
+  double p_factorPrecision;
+
+  /// Relative residual norm at which iterative refinement stops
+  double p_refineTolerance;
+
+  /// Maximum number of refinement iterations before falling back
+  int p_refineMaxIterations;
+
+  /// Is p_Fmat a reduced precision factorization?
+  mutable bool p_lowPrecision;
+
+  /// Number of refinement iterations used in the last solve
+  mutable int p_refineIterations;
+
   /// Do what is necessary to build this instance
   void p_build(const std::string& option_prefix)
   {
@@ -182,7 +214,14 @@ protected:
       }
       p_fill = props->get("Fill", p_fill);
       p_pivot = props->get("Pivot", p_pivot);
+
+      p_mixedPrecision = props->get("MixedPrecision", p_mixedPrecision);
+      p_factorPrecision = props->get("FactorPrecision", p_factorPrecision);
+      p_refineTolerance = props->get("RefinementTolerance", p_refineTolerance);
+      p_refineMaxIterations = 
+        props->get("RefinementMaxIterations", p_refineMaxIterations);
     }
+    p_lowPrecision = p_mixedPrecision;
 
     // FIXME: I cannot make this test work. Not sure why. It would be
     // nice to be able to find out if the package works before we
@@ -225,6 +264,19 @@ protected:
 
       ierr = MatGetOrdering(*A, p_orderingType, &perm, &iperm); CHKERRXX(ierr);
       ierr = MatGetFactor(*A, p_solverPackage, p_factorType, &p_Fmat);CHKERRXX(ierr);
+      if (p_lowPrecision) {
+        PetscBool available;
+        ierr = lowPrecisionFactor(p_Fmat, p_factorPrecision, &available); CHKERRXX(ierr);
+        if (!available) {
+          if (this->processor_rank() == 0) {
+            std::cerr << this->configurationKey() 
+                      << ": reduced precision factorization not available with \""
+                      << p_solverPackage << "\", using full precision" 
+                      << std::endl;
+          }
+          p_lowPrecision = false;
+        }
+      }
       info.fill = p_fill;
       info.dtcol = (p_pivot ? 1 : 0);
 
@@ -234,10 +286,234 @@ protected:
       ierr = ISDestroy(&perm); CHKERRXX(ierr);
       ierr = ISDestroy(&iperm); CHKERRXX(ierr);
 
+      p_factorNonzeros = p_nonzeros(*A);
+
     } catch (const PETSC_EXCEPTION_TYPE& e) {
       throw PETScException(ierr, e);
     }
     p_factored = true;
+    p_refactor = false;
+  }
+
+  /// Redo the numeric factorization, reusing the ordering and symbolic factorization
+  void p_numericFactor(void) const
+  {
+    PetscErrorCode ierr(0);
+    bool same(true);
+
+    try {
+      Mat *A(PETScMatrix(*LinearMatrixSolverImplementation<T, I>::p_A));
+      if (p_nonzeros(*A) != p_factorNonzeros) {
+        same = false;
+      } else {
+        MatFactorInfo  info;
+        ierr = MatFactorInfoInitialize(&info); CHKERRXX(ierr);
+        info.fill = p_fill;
+        info.dtcol = (p_pivot ? 1 : 0);
+        ierr = MatLUFactorNumeric(p_Fmat, *A, &info); CHKERRXX(ierr);
+      }
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+
+    if (!same) {
+      // the nonzero pattern changed, so the symbolic factorization
+      // cannot be used; start over
+      try {
+        ierr = MatDestroy(&p_Fmat); CHKERRXX(ierr);
+      } catch (const PETSC_EXCEPTION_TYPE& e) {
+        throw PETScException(ierr, e);
+      }
+      p_factored = false;
+      p_factor();
+    }
+    p_refactor = false;
+  }
+
+  /// Iteratively refine a solution computed with a reduced precision factorization
+  /**
+   * Residuals are computed with the full precision coefficient
+   * matrix and corrections with the factorization in ::p_Fmat.
+   *
+   * @param B RHS matrix
+   * @param X on input, initial solution; on output, refined solution
+   *
+   * @return true if refinement converged, false if it stalled
+   */
+  bool p_refine(const Mat& B, Mat& X) const
+  {
+    PetscErrorCode ierr(0);
+    bool converged(false);
+    PetscReal bnorm, rnorm, last(0.0);
+    Mat R, D;
+    int me(this->processor_rank());
+
+    p_refineIterations = 0;
+    try {
+      Mat *A(PETScMatrix(*LinearMatrixSolverImplementation<T, I>::p_A));
+      ierr = MatNorm(B, NORM_FROBENIUS, &bnorm); CHKERRXX(ierr);
+      if (bnorm == 0.0) return true;
+      ierr = MatDuplicate(X, MAT_DO_NOT_COPY_VALUES, &D); CHKERRXX(ierr);
+      ierr = MatMatMult(*A, X, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &R); CHKERRXX(ierr);
+      for (;;) {
+        // R = B - A*X
+        ierr = MatAYPX(R, -1.0, B, SAME_NONZERO_PATTERN); CHKERRXX(ierr);
+        ierr = MatNorm(R, NORM_FROBENIUS, &rnorm); CHKERRXX(ierr);
+        rnorm /= bnorm;
+        if (rnorm <= p_refineTolerance) {
+          converged = true;
+          break;
+        }
+        // give up if the residual is not at least halved
+        if (p_refineIterations >= p_refineMaxIterations ||
+            (p_refineIterations > 0 && rnorm > 0.5*last)) {
+          break;
+        }
+        last = rnorm;
+        ierr = MatMatSolve(p_Fmat, R, D); CHKERRXX(ierr);
+        ierr = MatAXPY(X, 1.0, D, SAME_NONZERO_PATTERN); CHKERRXX(ierr);
+        ierr = MatMatMult(*A, X, MAT_REUSE_MATRIX, PETSC_DEFAULT, &R); CHKERRXX(ierr);
+        p_refineIterations++;
+      }
+      ierr = MatDestroy(&R); CHKERRXX(ierr);
+      ierr = MatDestroy(&D); CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+
+    if (me == 0) {
+      std::string msg = 
+        boost::str(boost::format("%d: %s iterative refinement %s after %d iterations, "
+                                 "relative residual: %g") %
+                   me % this->configurationKey() % 
+                   (converged ? "converged" : "stalled") % 
+                   p_refineIterations % rnorm);
+      std::cerr << msg << std::endl;
+    }
+    return converged;
+  }
+
+  /// Get selected entries of the inverse (specialized)
+  /**
+   * If the factorization is done by MUMPS in full precision, its
+   * selected inversion is used, so only the requested entries are
+   * computed. Otherwise, this falls back to the generic
+   * implementation.
+   */
+  MatrixType *p_inverseEntries(const std::vector<I>& rows, 
+                               const std::vector<I>& cols) const
+  {
+#if defined(PETSC_HAVE_MUMPS) && PETSC_VERSION_GE(3,10,0)
+    PetscErrorCode ierr(0);
+    static const int esize(PetscElementSize<T>::value);
+    int nrsel(rows.size()), ncsel(cols.size());
+    int me(this->processor_rank());
+    MatrixType *result(NULL);
+
+    try {
+      if (!p_factored) {
+        p_factor();
+      } else if (p_refactor) {
+        p_numericFactor();
+      }
+
+      MatSolverPackage pkg;
+      PetscBool ismumps;
+      ierr = MatFactorGetSolverPackage(p_Fmat, &pkg); CHKERRXX(ierr);
+      ierr = PetscStrcmp(pkg, MATSOLVERMUMPS, &ismumps); CHKERRXX(ierr);
+      if (!ismumps || p_lowPrecision) {
+        // the reduced precision factorization needs refinement
+        return LinearMatrixSolverImplementation<T, I>::p_inverseEntries(rows, cols);
+      }
+
+      // The requested entries are given as the nonzero pattern of
+      // the transpose of the inverse, on process 0 only. Each entry
+      // is an esize x esize block in the library matrix
+      PetscInt N;
+      Mat spRHST;
+      ierr = MatGetSize(p_Fmat, &N, NULL); CHKERRXX(ierr);
+      if (me == 0) {
+        ierr = MatCreateSeqAIJ(PETSC_COMM_SELF, N, N, 
+                               nrsel*esize, NULL, &spRHST); CHKERRXX(ierr);
+        std::vector<PetscScalar> zero(nrsel*esize, 0.0);
+        std::vector<PetscInt> ridx(nrsel*esize);
+        for (int k = 0; k < nrsel; ++k) {
+          for (int ii = 0; ii < esize; ++ii) {
+            ridx[k*esize+ii] = rows[k]*esize + ii;
+          }
+        }
+        for (int l = 0; l < ncsel; ++l) {
+          for (int jj = 0; jj < esize; ++jj) {
+            PetscInt c(cols[l]*esize + jj);
+            ierr = MatSetValues(spRHST, 1, &c, nrsel*esize, &ridx[0], 
+                                &zero[0], INSERT_VALUES); CHKERRXX(ierr);
+          }
+        }
+      } else {
+        ierr = MatCreateSeqAIJ(PETSC_COMM_SELF, 0, 0, 0, NULL, &spRHST); CHKERRXX(ierr);
+      }
+      ierr = MatAssemblyBegin(spRHST, MAT_FINAL_ASSEMBLY); CHKERRXX(ierr);
+      ierr = MatAssemblyEnd(spRHST, MAT_FINAL_ASSEMBLY); CHKERRXX(ierr);
+
+      ierr = MatMumpsGetInverseTranspose(p_Fmat, spRHST); CHKERRXX(ierr);
+
+      result = new MatrixType(this->communicator(), 
+                              this->p_localShare(nrsel), 
+                              this->p_localShare(ncsel), Dense);
+      if (me == 0) {
+        PetscScalar px[esize*esize];
+        PetscInt iidx[esize], jidx[esize];
+        for (int k = 0; k < nrsel; ++k) {
+          for (int l = 0; l < ncsel; ++l) {
+            // (spRHST)^T is the block of the inverse
+            for (int ii = 0; ii < esize; ++ii) {
+              iidx[ii] = rows[k]*esize + ii;
+              jidx[ii] = cols[l]*esize + ii;
+            }
+            PetscScalar pxt[esize*esize];
+            ierr = MatGetValues(spRHST, esize, &jidx[0], esize, &iidx[0], 
+                                &pxt[0]); CHKERRXX(ierr);
+            for (int ii = 0; ii < esize; ++ii) {
+              for (int jj = 0; jj < esize; ++jj) {
+                px[ii*esize+jj] = pxt[jj*esize+ii];
+              }
+            }
+            T x;
+            MatrixValueTransferFromLibrary<PetscScalar, T> trans(1, &px[0], &x);
+            trans.go();
+            result->setElement(k, l, x);
+          }
+        }
+      }
+      result->ready();
+      ierr = MatDestroy(&spRHST); CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    return result;
+#else
+    return LinearMatrixSolverImplementation<T, I>::p_inverseEntries(rows, cols);
+#endif
+  }
+
+  /// Get the global number of nonzeros in a matrix
+  PetscLogDouble p_nonzeros(const Mat& A) const
+  {
+    PetscErrorCode ierr(0);
+    MatInfo info;
+    try {
+      ierr = MatGetInfo(A, MAT_GLOBAL_SUM, &info); CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    return info.nz_used;
+  }
+
+  /// Replace the coefficient Matrix (specialized)
+  void p_updateMatrix(const MatrixType& A)
+  {
+    LinearMatrixSolverImplementation<T, I>::p_updateMatrix(A);
+    if (p_factored) p_refactor = true;
   }
 
   /// Solve w/ the specified RHS Matrix (specialized)
@@ -252,6 +528,8 @@ protected:
     try {
       if (!p_factored) {
         p_factor();
+      } else if (p_refactor) {
+        p_numericFactor();
       }
       ierr = MatDuplicate(*Bmat, MAT_DO_NOT_COPY_VALUES, &X); CHKERRXX(ierr);
       ierr = MatMatSolve(p_Fmat, *Bmat, X); CHKERRXX(ierr);
@@ -259,6 +537,21 @@ protected:
       throw PETScException(ierr, e);
     }
 
+    if (p_lowPrecision && !p_refine(*Bmat, X)) {
+      // refinement stalled: the matrix is too poorly conditioned for
+      // the reduced precision factorization, so factor in full
+      // precision from now on
+      try {
+        ierr = MatDestroy(&p_Fmat); CHKERRXX(ierr);
+        p_factored = false;
+        p_lowPrecision = false;
+        p_factor();
+        ierr = MatMatSolve(p_Fmat, *Bmat, X); CHKERRXX(ierr);
+      } catch (const PETSC_EXCEPTION_TYPE& e) {
+        throw PETScException(ierr, e);
+      }
+    }
+
     PETScMatrixImplementation<T, I> *ximpl = 
       new PETScMatrixImplementation<T, I>(X, true);
     MatrixT<T, I> *result = new MatrixT<T, I>(ximpl);
@@ -20,6 +20,7 @@
 #ifndef _petsc_linear_solver_implementation_hpp_
 #define _petsc_linear_solver_implementation_hpp_
 
+#include <cfloat>
 #include <boost/format.hpp>
 
 #include <petscksp.h>
@@ -28,6 +29,7 @@
 #include "petsc_configurable.hpp"
 #include "petsc/petsc_matrix_extractor.hpp"
 #include "petsc/petsc_vector_extractor.hpp"
+#include "petsc/petsc_misc.hpp"
 
 namespace gridpack {
 namespace math {
@@ -50,7 +52,10 @@ public:
   PETScLinearSolverImplementation(MatrixType& A)
     : LinearSolverImplementation<T, I>(A),
       PETScConfigurable(this->communicator()),
-      p_matrixSet(false)
+      p_matrixSet(false), p_Amat(NULL),
+      p_mixedPrecision(false), p_factorPrecision(FLT_EPSILON),
+      p_refineTolerance(1.0e-12), p_refineMaxIterations(10),
+      p_lowPrecision(false), p_refineIterations(0)
   {
   }
 
@@ -78,6 +83,27 @@ protected:
   /// For constant matrices, has the coefficient matrix been set
   mutable bool p_matrixSet;
 
+  /// The coefficient matrix last given to the KSP
+  mutable Mat *p_Amat;
+
+  /// Use a reduced precision factorization with iterative refinement
+  bool p_mixedPrecision;
+
+  /// Precision of the reduced precision factorization
+  double p_factorPrecision;
+
+  /// Relative residual norm at which iterative refinement stops
+  double p_refineTolerance;
+
+  /// Maximum number of refinement iterations before falling back
+  int p_refineMaxIterations;
+
+  /// Is the preconditioner a reduced precision factorization?
+  mutable bool p_lowPrecision;
+
+  /// Number of refinement iterations used in the last solve
+  mutable int p_refineIterations;
+
   /// Do what is necessary to build this instance
   void p_build(const std::string& option_prefix)
   {
@@ -123,7 +149,12 @@ protected:
         ierr = KSPSetOperators(p_KSP, *Amat, *Amat); CHKERRXX(ierr);
 #endif
         p_matrixSet = true;
+        // the factor keeps its reduced precision settings when the
+        // same operator is refactored, so only set them up for a new
+        // operator
+        if (p_lowPrecision && Amat != p_Amat) p_setLowPrecision();
       }
+      p_Amat = Amat;
 
       this->p_resolveImpl(b, x);
           
@@ -144,6 +175,20 @@ protected:
       Vec *xvec(PETScVector(x));
 
       ierr = KSPSolve(p_KSP, *bvec, *xvec); CHKERRXX(ierr);
+      if (p_lowPrecision && p_Amat != NULL && !p_refine(*bvec, *xvec)) {
+        // refinement stalled, so redo the factorization, and all
+        // later ones, in full precision
+        p_lowPrecision = false;
+        PC pc;
+        ierr = KSPGetPC(p_KSP, &pc); CHKERRXX(ierr);
+        ierr = PCReset(pc); CHKERRXX(ierr);
+#if PETSC_VERSION_LT(3,5,0)
+        ierr = KSPSetOperators(p_KSP, *p_Amat, *p_Amat, SAME_NONZERO_PATTERN); CHKERRXX(ierr);
+#else
+        ierr = KSPSetOperators(p_KSP, *p_Amat, *p_Amat); CHKERRXX(ierr);
+#endif
+        ierr = KSPSolve(p_KSP, *bvec, *xvec); CHKERRXX(ierr);
+      }
       int its;
       KSPConvergedReason reason;
       PetscReal rnorm;
@@ -170,10 +215,118 @@ protected:
   }    
   
 
+  /// Make the preconditioner factorization use reduced precision
+  /**
+   * This only works if the preconditioner is a direct factorization
+   * with a solver package that supports it (see
+   * lowPrecisionFactor()). Otherwise, mixed precision is turned off.
+   */
+  void p_setLowPrecision(void) const
+  {
+    PetscErrorCode ierr(0);
+    try {
+      PC pc;
+      PCType pctype;
+      PetscBool islu, ischol, available(PETSC_FALSE);
+      ierr = KSPGetPC(p_KSP, &pc); CHKERRXX(ierr);
+      ierr = PCGetType(pc, &pctype); CHKERRXX(ierr);
+      ierr = PetscStrcmp(pctype, PCLU, &islu); CHKERRXX(ierr);
+      ierr = PetscStrcmp(pctype, PCCHOLESKY, &ischol); CHKERRXX(ierr);
+      if (islu || ischol) {
+        Mat F;
+        ierr = PCFactorSetUpMatSolverPackage(pc); CHKERRXX(ierr);
+        ierr = PCFactorGetMatrix(pc, &F); CHKERRXX(ierr);
+        ierr = lowPrecisionFactor(F, p_factorPrecision, &available); CHKERRXX(ierr);
+      }
+      if (!available) {
+        if (this->processor_rank() == 0) {
+          std::cerr << this->configurationKey() 
+                    << ": reduced precision factorization requires "
+                    << "-pc_type lu and -pc_factor_mat_solver_package mumps, "
+                    << "using full precision" << std::endl;
+        }
+        p_lowPrecision = false;
+      }
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+  }
+
+  /// Iteratively refine a solution computed with a reduced precision factorization
+  /**
+   * Residuals are computed with the full precision coefficient
+   * matrix and corrections with the KSP. 
+   *
+   * @param b RHS vector
+   * @param x on input, initial solution; on output, refined solution
+   *
+   * @return true if refinement converged, false if it stalled
+   */
+  bool p_refine(const Vec& b, Vec& x) const
+  {
+    PetscErrorCode ierr(0);
+    bool converged(false);
+    PetscReal bnorm, rnorm, last(0.0);
+    Vec r, d;
+    int me(this->processor_rank());
+
+    p_refineIterations = 0;
+    try {
+      ierr = VecNorm(b, NORM_2, &bnorm); CHKERRXX(ierr);
+      if (bnorm == 0.0) return true;
+      ierr = VecDuplicate(x, &r); CHKERRXX(ierr);
+      ierr = VecDuplicate(x, &d); CHKERRXX(ierr);
+      for (;;) {
+        // r = b - A*x
+        ierr = MatMult(*p_Amat, x, r); CHKERRXX(ierr);
+        ierr = VecAYPX(r, -1.0, b); CHKERRXX(ierr);
+        ierr = VecNorm(r, NORM_2, &rnorm); CHKERRXX(ierr);
+        rnorm /= bnorm;
+        if (rnorm <= p_refineTolerance) {
+          converged = true;
+          break;
+        }
+        // give up if the residual is not at least halved
+        if (p_refineIterations >= p_refineMaxIterations ||
+            (p_refineIterations > 0 && rnorm > 0.5*last)) {
+          break;
+        }
+        last = rnorm;
+        ierr = VecSet(d, 0.0); CHKERRXX(ierr);
+        ierr = KSPSolve(p_KSP, r, d); CHKERRXX(ierr);
+        ierr = VecAXPY(x, 1.0, d); CHKERRXX(ierr);
+        p_refineIterations++;
+      }
+      ierr = VecDestroy(&r); CHKERRXX(ierr);
+      ierr = VecDestroy(&d); CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+
+    if (me == 0) {
+      std::string msg = 
+        boost::str(boost::format("%d: %s iterative refinement %s after %d iterations, "
+                                 "relative residual: %g") %
+                   me % this->configurationKey() %
+                   (converged ? "converged" : "stalled") % 
+                   p_refineIterations % rnorm);
+      std::cerr << msg << std::endl;
+    }
+    return converged;
+  }
+
   /// Specialized way to configure from property tree
   void p_configure(utility::Configuration::CursorPtr props)
   {
     LinearSolverImplementation<T, I>::p_configure(props);
+    if (props) {
+      p_mixedPrecision = props->get("MixedPrecision", p_mixedPrecision);
+      p_factorPrecision = props->get("FactorPrecision", p_factorPrecision);
+      p_refineTolerance = props->get("RefinementTolerance", p_refineTolerance);
+      p_refineMaxIterations = 
+        props->get("RefinementMaxIterations", p_refineMaxIterations);
+    }
+    p_lowPrecision = p_mixedPrecision;
     this->build(props);
   }
 
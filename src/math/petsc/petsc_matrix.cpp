@@ -54,6 +54,12 @@ MatrixT<T, I>::MatrixT(const parallel::Communicator& comm,
     p_matrix_impl.reset(new PETScMatrixImplementation<T, I>(comm,
                                                             local_rows, cols, true));
     break;
+  case BlockSparse:
+    // without a block size, the only block is a single element
+    p_matrix_impl.reset(new PETScMatrixImplementation<T, I>(comm,
+                                                            local_rows, cols, 
+                                                            1, 0, false));
+    break;
   default:
     BOOST_ASSERT(false);
   }
@@ -164,6 +170,44 @@ MatrixT<RealType>::createDense(const parallel::Communicator& comm,
                                const int& local_cols);
 
 
+// -------------------------------------------------------------
+// Matrix::createBlockSparse
+// -------------------------------------------------------------
+template <typename T, typename I>
+MatrixT<T, I> *
+MatrixT<T, I>::createBlockSparse(const parallel::Communicator& comm,
+                                 const int& local_rows,
+                                 const int& local_cols,
+                                 const int& block_size,
+                                 const int& max_nz_per_row,
+                                 const bool& symmetric)
+{
+  PETScMatrixImplementation<T, I> *impl = 
+    new PETScMatrixImplementation<T, I>(comm, local_rows, local_cols,
+                                        block_size, max_nz_per_row,
+                                        symmetric);
+  MatrixT<T, I> *result = new MatrixT<T, I>(impl);
+  return result;
+}
+
+template 
+MatrixT<ComplexType> *
+MatrixT<ComplexType>::createBlockSparse(const parallel::Communicator& comm,
+                                        const int& local_rows,
+                                        const int& local_cols,
+                                        const int& block_size,
+                                        const int& max_nz_per_row,
+                                        const bool& symmetric);
+
+template 
+MatrixT<RealType> *
+MatrixT<RealType>::createBlockSparse(const parallel::Communicator& comm,
+                                     const int& local_rows,
+                                     const int& local_cols,
+                                     const int& block_size,
+                                     const int& max_nz_per_row,
+                                     const bool& symmetric);
+
 // -------------------------------------------------------------
 // Matrix::equate
 // -------------------------------------------------------------
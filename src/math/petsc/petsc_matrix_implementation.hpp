@@ -20,6 +20,8 @@
 #ifndef _petsc_matrix_implementation_h_
 #define _petsc_matrix_implementation_h_
 
+#include <cstdio>
+#include <vector>
 #include <petscmat.h>
 #include <boost/scoped_ptr.hpp>
 #include <boost/format.hpp>
@@ -110,6 +112,32 @@ public:
                                          &tmp[0]));
   }
 
+  /// Construct a block sparse matrix with an estimate of (maximum) usage
+  PETScMatrixImplementation(const parallel::Communicator& comm,
+                            const IdxType& local_rows, const IdxType& local_cols,
+                            const IdxType& block_size,
+                            const IdxType& max_nonzero_per_row,
+                            const bool& symmetric)
+    : MatrixImplementation<T, I>(comm),
+      p_mwrap()
+  {
+    if (block_size <= 0 || local_rows%block_size != 0 || 
+        local_cols%block_size != 0) {
+      char buf[256];
+      sprintf(buf, "PETScMatrixImplementation: local size (%d,%d) "
+              "is not a multiple of block size %d\n",
+              static_cast<int>(local_rows), static_cast<int>(local_cols),
+              static_cast<int>(block_size));
+      throw Exception(buf);
+    }
+    p_mwrap.reset(new PetscMatrixWrapper(comm, 
+                                         local_rows*elementSize, 
+                                         local_cols*elementSize,
+                                         block_size*elementSize,
+                                         max_nonzero_per_row*elementSize,
+                                         symmetric));
+  }
+
   /// Make a new instance from an existing PETSc matrix
   PETScMatrixImplementation(Mat& m, const bool& copyMat = true, const bool& destroyMat = false)
     : MatrixImplementation<T, I>(PetscMatrixWrapper::getCommunicator(m)),
@@ -386,6 +414,73 @@ protected:
     }
   }
 
+  /// Set or add to a dense block of elements
+  void p_setBlock(const IdxType& i, const IdxType& j, 
+                  const IdxType& m, const IdxType& n, 
+                  const TheType *x, InsertMode mode)
+  {
+    PetscErrorCode ierr(0);
+    PetscInt nrow(m*elementSize), ncol(n*elementSize);
+    if (nrow <= 0 || ncol <= 0) return;
+    try {
+      Mat *mat = p_mwrap->getMatrix();
+
+      // values come ordered by column, the library wants them by row
+      std::vector<PetscScalar> px(nrow*ncol);
+      PetscScalar tmp[elementSize*elementSize];
+      for (IdxType c = 0; c < n; ++c) {
+        for (IdxType r = 0; r < m; ++r) {
+          TheType v(x[c*m+r]);
+          MatrixValueTransferToLibrary<TheType, PetscScalar> trans(1, &v, &tmp[0]);
+          trans.go();
+          for (int ii = 0; ii < elementSize; ++ii) {
+            for (int jj = 0; jj < elementSize; ++jj) {
+              px[(r*elementSize+ii)*ncol + c*elementSize+jj] = 
+                tmp[ii*elementSize+jj];
+            }
+          }
+        }
+      }
+
+      // use block indexes if the block lines up with the storage blocks
+      PetscInt bs;
+      PetscInt row0(i*elementSize), col0(j*elementSize);
+      ierr = MatGetBlockSize(*mat, &bs); CHKERRXX(ierr);
+      if (bs > 1 && row0%bs == 0 && col0%bs == 0 && 
+          nrow%bs == 0 && ncol%bs == 0) {
+        std::vector<PetscInt> iidx(nrow/bs), jidx(ncol/bs);
+        for (PetscInt k = 0; k < nrow/bs; ++k) iidx[k] = row0/bs + k;
+        for (PetscInt k = 0; k < ncol/bs; ++k) jidx[k] = col0/bs + k;
+        ierr = MatSetValuesBlocked(*mat, nrow/bs, &iidx[0], ncol/bs, &jidx[0], 
+                                   &px[0], mode); CHKERRXX(ierr);
+      } else {
+        std::vector<PetscInt> iidx(nrow), jidx(ncol);
+        for (PetscInt k = 0; k < nrow; ++k) iidx[k] = row0 + k;
+        for (PetscInt k = 0; k < ncol; ++k) jidx[k] = col0 + k;
+        ierr = MatSetValues(*mat, nrow, &iidx[0], ncol, &jidx[0], 
+                            &px[0], mode); CHKERRXX(ierr);
+      }
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+  }
+
+  /// Set a dense block of elements
+  void p_setBlock(const IdxType& i, const IdxType& j, 
+                  const IdxType& m, const IdxType& n, 
+                  const TheType *x)
+  {
+    p_setBlock(i, j, m, n, x, INSERT_VALUES);
+  }
+
+  /// Add to a dense block of elements
+  void p_addBlock(const IdxType& i, const IdxType& j, 
+                  const IdxType& m, const IdxType& n, 
+                  const TheType *x)
+  {
+    p_setBlock(i, j, m, n, x, ADD_VALUES);
+  }
+
   /// Get an individual element
   void p_getElement(const IdxType& i, const IdxType& j, TheType& x) const
   {
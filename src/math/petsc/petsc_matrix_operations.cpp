@@ -492,6 +492,13 @@ MatrixT<T, I>::storageType(void) const
                stype == MATSEQAIJ || 
                stype == MATMPIAIJ) {
       result = Sparse;
+    } else if (stype == MATBAIJ ||
+               stype == MATSEQBAIJ ||
+               stype == MATMPIBAIJ ||
+               stype == MATSBAIJ ||
+               stype == MATSEQSBAIJ ||
+               stype == MATMPISBAIJ) {
+      result = BlockSparse;
     } else {
       std::string msg("Matrix: unexpected PETSc storage type: ");
       msg += "\"";
@@ -540,6 +547,15 @@ storageType(const MatrixT<T, I>& A, const MatrixStorageType& new_type)
         new_mat_type = MATSEQAIJ;
       } 
       break;
+    case (BlockSparse):
+      // the block size of A is kept, which is one unless A is
+      // already blocked or was assembled with a block size
+      if (nproc > 1) {
+        new_mat_type = MATMPIBAIJ;
+      } else {
+        new_mat_type = MATSEQBAIJ;
+      } 
+      break;
     }
   
     const Mat *Amat(PETScMatrix(A));
@@ -90,6 +90,18 @@ PetscMatrixWrapper::PetscMatrixWrapper(const parallel::Communicator& comm,
   p_set_sparse_matrix(nonzeros_by_row);
 }
 
+PetscMatrixWrapper::PetscMatrixWrapper(const parallel::Communicator& comm,
+                                       const PetscInt& local_rows, const PetscInt& local_cols,
+                                       const PetscInt& block_size,
+                                       const PetscInt& max_nonzero_per_row,
+                                       const bool& symmetric)
+  : ImplementationVisitable(),
+    p_matrix(), p_matrixWrapped(false), p_destroyWrapped(true)
+{
+  p_build_matrix(comm, local_rows, local_cols);
+  p_set_block_matrix(block_size, max_nonzero_per_row, symmetric);
+}
+
 PetscMatrixWrapper::PetscMatrixWrapper(Mat& m, const bool& copyMat, const bool& destroyMat)
   : ImplementationVisitable(),
     p_matrix(), p_matrixWrapped(false),
@@ -263,6 +275,63 @@ PetscMatrixWrapper::p_set_sparse_matrix(const PetscInt *nz_by_row)
   }
 }
 
+// -------------------------------------------------------------
+// PetscMatrixWrapper::p_set_block_matrix
+// -------------------------------------------------------------
+void 
+PetscMatrixWrapper::p_set_block_matrix(const PetscInt& block_size, 
+                                       const PetscInt& max_nz_per_row,
+                                       const bool& symmetric)
+{
+  PetscErrorCode ierr(0);
+
+  // preallocation is in blocks, not elements; without an estimate,
+  // let the library decide and allow it to grow
+  PetscInt nz_blocks(PETSC_DEFAULT);
+  if (max_nz_per_row > 0) {
+    nz_blocks = (max_nz_per_row + block_size - 1)/block_size;
+  }
+
+  try {
+    parallel::Communicator comm(getCommunicator(p_matrix));
+    if (comm.size() == 1) {
+      if (symmetric) {
+        ierr = MatSetType(p_matrix, MATSEQSBAIJ); CHKERRXX(ierr);
+        ierr = MatSeqSBAIJSetPreallocation(p_matrix, block_size,
+                                           nz_blocks, PETSC_NULL); CHKERRXX(ierr);
+      } else {
+        ierr = MatSetType(p_matrix, MATSEQBAIJ); CHKERRXX(ierr);
+        ierr = MatSeqBAIJSetPreallocation(p_matrix, block_size,
+                                          nz_blocks, PETSC_NULL); CHKERRXX(ierr);
+      }
+    } else {
+      if (symmetric) {
+        ierr = MatSetType(p_matrix, MATMPISBAIJ); CHKERRXX(ierr);
+        ierr = MatMPISBAIJSetPreallocation(p_matrix, block_size,
+                                           nz_blocks, PETSC_NULL,
+                                           nz_blocks, PETSC_NULL); CHKERRXX(ierr);
+      } else {
+        ierr = MatSetType(p_matrix, MATMPIBAIJ); CHKERRXX(ierr);
+        ierr = MatMPIBAIJSetPreallocation(p_matrix, block_size,
+                                          nz_blocks, PETSC_NULL,
+                                          nz_blocks, PETSC_NULL); CHKERRXX(ierr);
+      }
+    }
+    if (max_nz_per_row <= 0) {
+      ierr = MatSetOption(p_matrix, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE); CHKERRXX(ierr);
+    }
+    if (symmetric) {
+      // callers fill both triangles, as they would for any other
+      // storage, so quietly drop the lower one
+      ierr = MatSetOption(p_matrix, MAT_IGNORE_LOWER_TRIANGULAR, PETSC_TRUE); CHKERRXX(ierr);
+    }
+    ierr = MatSetFromOptions(p_matrix); CHKERRXX(ierr);
+    ierr = MatSetUp(p_matrix); CHKERRXX(ierr);
+  } catch (const PETSC_EXCEPTION_TYPE& e) {
+    throw PETScException(ierr, e);
+  }
+}
+
 // -------------------------------------------------------------
 // PetscMatrixWrapper::localRowRange
 // -------------------------------------------------------------
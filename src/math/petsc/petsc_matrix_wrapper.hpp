@@ -52,6 +52,13 @@ public:
                      const PetscInt& local_rows, const PetscInt& local_cols,
                      const PetscInt *nonzeros_by_row);
 
+  /// Construct a block sparse matrix allocating the same number of nonzeros in all rows
+  PetscMatrixWrapper(const parallel::Communicator& comm,
+                     const PetscInt& local_rows, const PetscInt& local_cols,
+                     const PetscInt& block_size,
+                     const PetscInt& max_nonzero_per_row,
+                     const bool& symmetric);
+
   /// Constructor that wraps an existing Mat instance
   PetscMatrixWrapper(Mat& m, const bool& copymat = true,
                      const bool& destroymat = false);
@@ -143,6 +150,11 @@ protected:
   /// Set up a sparse matrix and preallocate it using known nonzeros for each row
   void p_set_sparse_matrix(const PetscInt *nz_by_row);
 
+  /// Set up a block sparse matrix and preallocate it using the maximum nonzeros per row
+  void p_set_block_matrix(const PetscInt& block_size, 
+                          const PetscInt& max_nz_per_row,
+                          const bool& symmetric);
+
   /// Allow visits by implemetation visitor
   void p_accept(ImplementationVisitor& visitor);
 
@@ -71,3 +71,39 @@ sillyMatScaleComplex(Mat A, const gridpack::ComplexType& px)
 
 
 
+
+/// Make a factor matrix use a reduced precision representation
+/** 
+ * This must be called after MatGetFactor() and before the symbolic
+ * factorization. PETSc is built for a single scalar precision, so the
+ * only way to get a factor that is stored with less precision is
+ * through MUMPS block low-rank (BLR) compression, where @c precision
+ * is the dropping threshold (CNTL(7)). A threshold near single
+ * precision machine epsilon gives a factor with roughly single
+ * precision accuracy and substantially less storage. 
+ * 
+ * @param F factor matrix from MatGetFactor()
+ * @param precision BLR dropping threshold
+ * @param available set to PETSC_FALSE if @c F does not support a
+ * reduced precision factor, in which case @c F is not changed
+ * 
+ * @return 
+ */
+PetscErrorCode
+lowPrecisionFactor(Mat F, const double& precision, PetscBool *available)
+{
+  PetscErrorCode ierr(0);
+  *available = PETSC_FALSE;
+#if defined(PETSC_HAVE_MUMPS)
+  MatSolverPackage pkg;
+  ierr = MatFactorGetSolverPackage(F, &pkg); CHKERRQ(ierr);
+  PetscBool ismumps;
+  ierr = PetscStrcmp(pkg, MATSOLVERMUMPS, &ismumps); CHKERRQ(ierr);
+  if (ismumps) {
+    ierr = MatMumpsSetIcntl(F, 35, 1); CHKERRQ(ierr);
+    ierr = MatMumpsSetCntl(F, 7, precision); CHKERRQ(ierr);
+    *available = PETSC_TRUE;
+  }
+#endif
+  return ierr;
+}
@@ -32,6 +32,9 @@
 /// Scale a complex DENSE matrix
 extern PetscErrorCode sillyMatScaleComplex(Mat A, const gridpack::ComplexType& px);
 
+extern PetscErrorCode lowPrecisionFactor(Mat F, const double& precision, 
+                                         PetscBool *available);
+
 // -------------------------------------------------------------
 // sortPermutation
 // 
@@ -0,0 +1,200 @@
+// -------------------------------------------------------------
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+// -------------------------------------------------------------
+/**
+ * @file   complex_kernels_test.cpp
+ * @date   2026-10-19
+ *
+ * @brief  Compare the batched complex kernels against std::complex
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#include <iostream>
+#include <complex>
+#include <vector>
+
+#include "complex_kernels.hpp"
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+typedef std::complex<double> complex_type;
+
+// Largest batch size tested. All sizes up to this are run so that every
+// combination of full SIMD packs and remainder is covered
+#define MAX_N 37
+
+static const double delta(1.0e-12);
+
+/**
+ * Fill split arrays with reproducible values of moderate size that are
+ * well away from zero. One extra element is allocated so that the arrays
+ * can be indexed even if n is zero
+ */
+static void fill(int n, int seed, std::vector<double> &re,
+    std::vector<double> &im)
+{
+  re.resize(n+1);
+  im.resize(n+1);
+  int i;
+  for (i=0; i<n; i++) {
+    re[i] = 0.5+static_cast<double>((i*7+seed*3)%11)/3.0;
+    im[i] = -1.5+static_cast<double>((i*5+seed*13)%9)/2.0;
+  }
+}
+
+/**
+ * Check split arrays against a vector of std::complex values
+ */
+static bool same(int n, const std::vector<double> &re,
+    const std::vector<double> &im, const std::vector<complex_type> &ref)
+{
+  bool ok = true;
+  int i;
+  for (i=0; i<n; i++) {
+    if (std::abs(complex_type(re[i],im[i])-ref[i]) >
+        delta*(1.0+std::abs(ref[i]))) {
+      std::cout << "Mismatch at " << i << " of " << n << ": "
+        << complex_type(re[i],im[i]) << " expected " << ref[i] << std::endl;
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+BOOST_AUTO_TEST_SUITE(ComplexKernels)
+
+BOOST_AUTO_TEST_CASE(Reciprocal)
+{
+  int n;
+  for (n=0; n<=MAX_N; n++) {
+    std::vector<double> xr, xi, yr(n+1), yi(n+1);
+    fill(n, 1, xr, xi);
+    std::vector<complex_type> ref(n);
+    int i;
+    for (i=0; i<n; i++) ref[i] = 1.0/complex_type(xr[i],xi[i]);
+    gridpack::math::complexReciprocal(n, &xr[0], &xi[0], &yr[0], &yi[0]);
+    BOOST_CHECK(same(n, yr, yi, ref));
+    // in place
+    gridpack::math::complexReciprocal(n, &xr[0], &xi[0], &xr[0], &xi[0]);
+    BOOST_CHECK(same(n, xr, xi, ref));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Multiply)
+{
+  int n;
+  for (n=0; n<=MAX_N; n++) {
+    std::vector<double> ar, ai, br, bi, cr(n+1), ci(n+1);
+    fill(n, 2, ar, ai);
+    fill(n, 3, br, bi);
+    std::vector<complex_type> ref(n), refc(n);
+    int i;
+    for (i=0; i<n; i++) {
+      ref[i] = complex_type(ar[i],ai[i])*complex_type(br[i],bi[i]);
+      refc[i] = complex_type(ar[i],ai[i])*std::conj(complex_type(br[i],bi[i]));
+    }
+    gridpack::math::complexMultiply(n, &ar[0], &ai[0], &br[0], &bi[0],
+        &cr[0], &ci[0]);
+    BOOST_CHECK(same(n, cr, ci, ref));
+    gridpack::math::complexMultiplyConj(n, &ar[0], &ai[0], &br[0], &bi[0],
+        &cr[0], &ci[0]);
+    BOOST_CHECK(same(n, cr, ci, refc));
+    // in place, output overwrites second argument
+    std::vector<double> tr(br), ti(bi);
+    gridpack::math::complexMultiply(n, &ar[0], &ai[0], &tr[0], &ti[0],
+        &tr[0], &ti[0]);
+    BOOST_CHECK(same(n, tr, ti, ref));
+    gridpack::math::complexMultiplyConj(n, &ar[0], &ai[0], &br[0], &bi[0],
+        &br[0], &bi[0]);
+    BOOST_CHECK(same(n, br, bi, refc));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Divide)
+{
+  int n;
+  for (n=0; n<=MAX_N; n++) {
+    std::vector<double> ar, ai, br, bi, cr(n+1), ci(n+1);
+    fill(n, 4, ar, ai);
+    fill(n, 5, br, bi);
+    std::vector<complex_type> ref(n);
+    int i;
+    for (i=0; i<n; i++) {
+      ref[i] = complex_type(ar[i],ai[i])/complex_type(br[i],bi[i]);
+    }
+    gridpack::math::complexDivide(n, &ar[0], &ai[0], &br[0], &bi[0],
+        &cr[0], &ci[0]);
+    BOOST_CHECK(same(n, cr, ci, ref));
+    gridpack::math::complexDivide(n, &ar[0], &ai[0], &br[0], &bi[0],
+        &ar[0], &ai[0]);
+    BOOST_CHECK(same(n, ar, ai, ref));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Scale)
+{
+  int n;
+  for (n=0; n<=MAX_N; n++) {
+    std::vector<double> ar, ai, s, dummy, cr(n+1), ci(n+1);
+    fill(n, 6, ar, ai);
+    fill(n, 7, s, dummy);
+    std::vector<complex_type> ref(n);
+    int i;
+    for (i=0; i<n; i++) ref[i] = s[i]*complex_type(ar[i],ai[i]);
+    gridpack::math::complexScale(n, &s[0], &ar[0], &ai[0], &cr[0], &ci[0]);
+    BOOST_CHECK(same(n, cr, ci, ref));
+    gridpack::math::complexScale(n, &s[0], &ar[0], &ai[0], &ar[0], &ai[0]);
+    BOOST_CHECK(same(n, ar, ai, ref));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Cis)
+{
+  int n;
+  for (n=0; n<=MAX_N; n++) {
+    std::vector<double> theta(n+1), cr(n+1), ci(n+1);
+    std::vector<complex_type> ref(n);
+    int i;
+    for (i=0; i<n; i++) {
+      theta[i] = -3.0+0.17*static_cast<double>(i);
+      ref[i] = std::polar(1.0, theta[i]);
+    }
+    gridpack::math::complexCis(n, &theta[0], &cr[0], &ci[0]);
+    BOOST_CHECK(same(n, cr, ci, ref));
+    // in place, angles overwritten by real part
+    std::vector<double> t(theta);
+    gridpack::math::complexCis(n, &t[0], &t[0], &ci[0]);
+    BOOST_CHECK(same(n, t, ci, ref));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// -------------------------------------------------------------
+// init_function
+// -------------------------------------------------------------
+bool init_function()
+{
+  return true;
+}
+
+// -------------------------------------------------------------
+//  Main Program
+// -------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+  std::cout << "Testing complex kernels with SIMD width "
+    << GRIDPACK_COMPLEX_SIMD_WIDTH << std::endl;
+  int result = ::boost::unit_test::unit_test_main( &init_function, argc, argv );
+  return result;
+}
@@ -17,10 +17,15 @@
 // -------------------------------------------------------------
 
 #include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
 #include <boost/scoped_ptr.hpp>
+#include <boost/mpi/collectives.hpp>
 #include <boost/format.hpp>
 #include "linear_solver.hpp"
 #include "linear_matrix_solver.hpp"
+#include "kron_reduction.hpp"
 
 #include "test_main.cpp"
 
@@ -110,6 +115,68 @@ assemble(const int imax, const int jmax,
 }
 
 
+// -------------------------------------------------------------
+// assembleGraded
+// -------------------------------------------------------------
+/**
+ * Assemble D*L*D, where L is the 1D Laplacian and D is a diagonal
+ * scaling graded over @c decades orders of magnitude, which makes a
+ * badly conditioned system. The RHS is chosen so the solution is all
+ * ones.
+ */
+void
+assembleGraded(const int n, const double decades,
+               gridpack::math::RealMatrix& A, 
+               gridpack::math::RealVector& b)
+{
+  int ilo, ihi;
+  b.localIndexRange(ilo, ihi);
+
+  for (int i = ilo; i < ihi; ++i) {
+    double di(pow(10.0, -decades*static_cast<double>(i)/static_cast<double>(n-1)));
+    double bi(2.0*di*di);
+    A.setElement(i, i, 2.0*di*di);
+    if (i > 0) {
+      double dw(pow(10.0, -decades*static_cast<double>(i-1)/static_cast<double>(n-1)));
+      A.setElement(i, i-1, -di*dw);
+      bi -= di*dw;
+    }
+    if (i < n-1) {
+      double de(pow(10.0, -decades*static_cast<double>(i+1)/static_cast<double>(n-1)));
+      A.setElement(i, i+1, -di*de);
+      bi -= di*de;
+    }
+    b.setElement(i, bi);
+  }
+}
+
+// -------------------------------------------------------------
+// relativeResidual
+// -------------------------------------------------------------
+/// Compute ||b - A*x||/||b||
+double
+relativeResidual(const gridpack::math::RealMatrix& A,
+                 const gridpack::math::RealVector& b,
+                 const gridpack::math::RealVector& x)
+{
+  std::auto_ptr<gridpack::math::RealVector> res(multiply(A, x));
+  res->add(b, -1.0);
+  return res->norm2()/b.norm2();
+}
+
+/// Compute ||B - A*X||/||B|| (Frobenius norm)
+double
+relativeResidual(const gridpack::math::RealMatrix& A,
+                 const gridpack::math::RealMatrix& B,
+                 const gridpack::math::RealMatrix& X)
+{
+  std::auto_ptr<gridpack::math::RealMatrix> R(multiply(A, X));
+  boost::scoped_ptr<gridpack::math::RealMatrix> negB(B.clone());
+  negB->scale(-1.0);
+  R->add(*negB);
+  return R->norm2()/B.norm2();
+}
+
 // -------------------------------------------------------------
 /**
  * This is a simple test of the gridpack::math::LinearSolver.  This
@@ -359,6 +426,405 @@ BOOST_AUTO_TEST_CASE ( VersteegMatrixInverse )
   
 }
 
+// -------------------------------------------------------------
+/// Test LinearMatrixSolver with a changed coefficient matrix
+/**
+ * The Versteeg coefficient matrix is inverted, then scaled and passed
+ * to LinearMatrixSolver::updateMatrix(), which should reuse the
+ * symbolic factorization, and inverted again.
+ * 
+ */
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE ( VersteegMatrixUpdate )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int imax = 3*world.size();
+  static const int jmax = 4*world.size();
+  static const int global_size = imax*jmax;
+  int local_size(global_size/world.size());
+
+  boost::scoped_ptr<gridpack::math::RealMatrix> 
+    A(new gridpack::math::RealMatrix(world, local_size, local_size, 
+                                 gridpack::math::Sparse)),
+    I(new gridpack::math::RealMatrix(world, local_size, local_size, 
+                                 gridpack::math::Dense));
+  I->identity();
+
+  boost::scoped_ptr<gridpack::math::RealVector>
+    b(new gridpack::math::RealVector(world, local_size));
+
+  assemble(imax, jmax, *A, *b);
+  A->ready();
+  b->ready();
+
+  boost::scoped_ptr<gridpack::math::RealLinearMatrixSolver> 
+    solver(new gridpack::math::RealLinearMatrixSolver(*A));
+
+  BOOST_REQUIRE(test_config);
+  solver->configurationKey("LinearMatrixSolver");
+  solver->configure(test_config);
+
+  std::auto_ptr<gridpack::math::RealMatrix> Ainv(solver->solve(*I));
+
+  boost::scoped_ptr<gridpack::math::RealMatrix> A2(A->clone());
+  A2->scale(2.0);
+  solver->updateMatrix(*A2);
+
+  std::auto_ptr<gridpack::math::RealMatrix> A2inv(solver->solve(*I));
+  std::auto_ptr<gridpack::math::RealVector> x(multiply(*A2inv, *b));
+  std::auto_ptr<gridpack::math::RealVector> res(multiply(*A2, *x));
+  res->add(*b, -1.0);
+
+  double l2norm(res->norm2());
+  if (world.rank() == 0) {
+    std::cout << "Updated Residual L2 Norm = " << l2norm << std::endl;
+  }
+  BOOST_CHECK(l2norm < 1.0e-05);
+
+  // the updated inverse should be half the original
+  A2inv->scale(-2.0);
+  A2inv->add(*Ainv);
+  BOOST_CHECK(A2inv->norm2() < 1.0e-05);
+}
+
+// -------------------------------------------------------------
+/// Test selected rows and entries of the inverse
+/**
+ * A few entries of the inverse of the Versteeg coefficient matrix are
+ * computed with LinearMatrixSolver::inverseEntries() and
+ * LinearMatrixSolver::solveRows() and compared to the full inverse.
+ * 
+ */
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE ( VersteegSelectedInverse )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int imax = 3*world.size();
+  static const int jmax = 4*world.size();
+  static const int global_size = imax*jmax;
+  int local_size(global_size/world.size());
+
+  gridpack::math::RealMatrix A(world, local_size, local_size, 
+                               gridpack::math::Sparse);
+  gridpack::math::RealMatrix I(world, local_size, local_size, 
+                               gridpack::math::Dense);
+  gridpack::math::RealVector b(world, local_size);
+  assemble(imax, jmax, A, b);
+  A.ready();
+  b.ready();
+  I.identity();
+
+  gridpack::math::RealLinearMatrixSolver solver(A);
+  BOOST_REQUIRE(test_config);
+  solver.configurationKey("LinearMatrixSolver");
+  solver.configure(test_config);
+
+  std::auto_ptr<gridpack::math::RealMatrix> Ainv(solver.solve(I));
+
+  std::vector<int> rows, cols;
+  rows.push_back(global_size - 1);
+  rows.push_back(0);
+  rows.push_back(global_size/2);
+  cols.push_back(1);
+  cols.push_back(global_size - 2);
+
+  std::auto_ptr<gridpack::math::RealMatrix> 
+    S(solver.inverseEntries(rows, cols));
+  BOOST_CHECK_EQUAL(S->rows(), static_cast<int>(rows.size()));
+  BOOST_CHECK_EQUAL(S->cols(), static_cast<int>(cols.size()));
+
+  // a sparse RHS with the same columns of the identity
+  int ncols(cols.size());
+  int lcols(ncols/world.size() + (world.rank() < ncols%world.size() ? 1 : 0));
+  gridpack::math::RealMatrix E(world, local_size, lcols, gridpack::math::Sparse);
+  int lo, hi;
+  E.localRowRange(lo, hi);
+  for (size_t l = 0; l < cols.size(); ++l) {
+    if (lo <= cols[l] && cols[l] < hi) E.setElement(cols[l], l, 1.0);
+  }
+  E.ready();
+  std::auto_ptr<gridpack::math::RealMatrix> R(solver.solveRows(E, rows));
+
+  int slo, shi;
+  S->localRowRange(slo, shi);
+  for (int k = slo; k < shi; ++k) {
+    for (size_t l = 0; l < cols.size(); ++l) {
+      gridpack::math::RealType s, r;
+      S->getElement(k, l, s);
+      R->getElement(k, l, r);
+      BOOST_CHECK_CLOSE(s, r, 1.0e-04);
+    }
+  }
+
+  // compare with the full inverse on the process that owns each row
+  Ainv->localRowRange(lo, hi);
+  std::vector<gridpack::math::RealType> full(rows.size()*cols.size(), 0.0);
+  for (size_t k = 0; k < rows.size(); ++k) {
+    if (lo <= rows[k] && rows[k] < hi) {
+      for (size_t l = 0; l < cols.size(); ++l) {
+        Ainv->getElement(rows[k], cols[l], full[k*cols.size()+l]);
+      }
+    }
+  }
+  std::vector<gridpack::math::RealType> fullsum(full.size());
+  boost::mpi::all_reduce(world, &full[0], full.size(), &fullsum[0], 
+                         std::plus<gridpack::math::RealType>());
+  for (int k = slo; k < shi; ++k) {
+    for (size_t l = 0; l < cols.size(); ++l) {
+      gridpack::math::RealType s;
+      S->getElement(k, l, s);
+      BOOST_CHECK_CLOSE(s, fullsum[k*cols.size()+l], 1.0e-04);
+    }
+  }
+}
+
+// -------------------------------------------------------------
+/// Test Kron reduction of the Versteeg coefficient matrix
+/**
+ * The Versteeg coefficient matrix is reduced onto one node per
+ * process with all columns solved at once and one column at a time.
+ * 
+ */
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE ( VersteegKronReduction )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int imax = 3*world.size();
+  static const int jmax = 4*world.size();
+  static const int global_size = imax*jmax;
+  int local_size(global_size/world.size());
+  int me(world.rank());
+
+  gridpack::math::RealMatrix A(world, local_size, local_size, 
+                               gridpack::math::Sparse);
+  gridpack::math::RealVector b(world, local_size);
+  assemble(imax, jmax, A, b);
+  A.ready();
+  b.ready();
+
+  // one retained node per process
+  gridpack::math::RealMatrix 
+    Ya(world, 1, 1, gridpack::math::Dense),
+    Yb(world, 1, local_size, gridpack::math::Dense),
+    Yc(world, local_size, 1, gridpack::math::Dense);
+  int lo, hi;
+  b.localIndexRange(lo, hi);
+  Ya.setElement(me, me, 1.0);
+  for (int i = lo; i < hi; ++i) {
+    gridpack::math::RealType bi;
+    b.getElement(i, bi);
+    for (int j = 0; j < world.size(); ++j) {
+      Yc.setElement(i, j, bi*static_cast<double>(j+1));
+    }
+    Yb.setElement(me, i, 1.0);
+  }
+  Ya.ready();
+  Yb.ready();
+  Yc.ready();
+
+  gridpack::math::RealKronReduction kron(Ya, Yb, Yc);
+  gridpack::math::RealKronReduction kron1(Ya, Yb, Yc, 1);
+  BOOST_CHECK_EQUAL(kron1.blocks(), world.size());
+
+  std::auto_ptr<gridpack::math::RealMatrix> R(kron.reduce(A));
+  R->scale(-1.0);
+  std::auto_ptr<gridpack::math::RealMatrix> R1(kron1.reduce(A));
+  R1->add(*R);
+  BOOST_CHECK(R1->norm2() < 1.0e-05);
+
+  // reduce a scaled matrix, reusing the factorization;
+  // 2*R2 - Ya - R should vanish
+  boost::scoped_ptr<gridpack::math::RealMatrix> A2(A.clone());
+  A2->scale(2.0);
+  std::auto_ptr<gridpack::math::RealMatrix> R2(kron1.reduce(*A2));
+  boost::scoped_ptr<gridpack::math::RealMatrix> negYa(Ya.clone());
+  negYa->scale(-1.0);
+  R2->scale(2.0);
+  R2->add(*negYa);
+  R2->add(*R);
+  BOOST_CHECK(R2->norm2() < 1.0e-05);
+}
+
+// -------------------------------------------------------------
+/// Test LinearSolver with a reduced precision factorization
+/**
+ * A badly conditioned system is solved with a full precision LU
+ * factorization and with a reduced precision one plus iterative
+ * refinement. The refined residual should meet the refinement
+ * tolerance or be as good as the full precision one. The operator is
+ * set again for the second solve to check that the reduced precision
+ * setup survives it.
+ * 
+ */
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE ( MixedPrecision )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int local_size = 40;
+  const int global_size = local_size*world.size();
+
+  gridpack::math::RealMatrix A(world, local_size, local_size, 
+                               gridpack::math::Sparse);
+  gridpack::math::RealVector 
+    b(world, local_size), x(world, local_size);
+  assembleGraded(global_size, 4.0, A, b);
+  A.ready();
+  b.ready();
+
+  BOOST_REQUIRE(test_config);
+
+  gridpack::math::RealLinearSolver full(A);
+  full.configurationKey("FullPrecisionSolver");
+  full.configure(test_config);
+  x.fill(0.0);
+  x.ready();
+  full.solve(b, x);
+  double rfull(relativeResidual(A, b, x));
+
+  gridpack::math::RealLinearSolver mixed(A);
+  mixed.configurationKey("MixedPrecisionSolver");
+  mixed.configure(test_config);
+  double tol(test_config->get("MixedPrecisionSolver.RefinementTolerance", 1.0e-12));
+
+  for (int k = 0; k < 2; ++k) {
+    x.fill(0.0);
+    mixed.solve(b, x);
+    double r(relativeResidual(A, b, x));
+    if (world.rank() == 0) {
+      std::cout << "Full precision relative residual = " << rfull << std::endl;
+      std::cout << "Mixed precision relative residual = " << r << std::endl;
+    }
+    BOOST_CHECK(r <= std::max(tol, 10.0*rfull));
+  }
+
+  x.fill(0.0);
+  mixed.resolve(b, x);
+  BOOST_CHECK(relativeResidual(A, b, x) <= std::max(tol, 10.0*rfull));
+}
+
+// -------------------------------------------------------------
+/// Test LinearSolver fallback to a full precision factorization
+/**
+ * Refinement is configured so it always stalls, which makes the
+ * solver refactor in full precision. The result, and that of later
+ * solves, should be as good as a full precision solve.
+ * 
+ */
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE ( MixedPrecisionFallback )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int local_size = 40;
+  const int global_size = local_size*world.size();
+
+  gridpack::math::RealMatrix A(world, local_size, local_size, 
+                               gridpack::math::Sparse);
+  gridpack::math::RealVector 
+    b(world, local_size), x(world, local_size);
+  assembleGraded(global_size, 4.0, A, b);
+  A.ready();
+  b.ready();
+
+  BOOST_REQUIRE(test_config);
+
+  gridpack::math::RealLinearSolver full(A);
+  full.configurationKey("FullPrecisionSolver");
+  full.configure(test_config);
+  x.fill(0.0);
+  x.ready();
+  full.solve(b, x);
+  double rfull(relativeResidual(A, b, x));
+  double bound(10.0*rfull + 1.0e-14);
+
+  gridpack::math::RealLinearSolver mixed(A);
+  mixed.configurationKey("MixedPrecisionFallback");
+  mixed.configure(test_config);
+
+  x.fill(0.0);
+  mixed.solve(b, x);
+  BOOST_CHECK(relativeResidual(A, b, x) <= bound);
+
+  x.fill(0.0);
+  mixed.resolve(b, x);
+  BOOST_CHECK(relativeResidual(A, b, x) <= bound);
+
+  x.fill(0.0);
+  mixed.solve(b, x);
+  BOOST_CHECK(relativeResidual(A, b, x) <= bound);
+}
+
+// -------------------------------------------------------------
+/// Test LinearMatrixSolver with a reduced precision factorization
+/**
+ * The badly conditioned system used in MixedPrecision is solved for
+ * two RHS columns in full precision, in reduced precision with
+ * refinement, and with refinement that always stalls so the solver
+ * has to refactor in full precision.
+ * 
+ */
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE ( MixedPrecisionMatrix )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int local_size = 40;
+  const int global_size = local_size*world.size();
+
+  gridpack::math::RealMatrix A(world, local_size, local_size, 
+                               gridpack::math::Sparse);
+  gridpack::math::RealVector b(world, local_size);
+  assembleGraded(global_size, 4.0, A, b);
+  A.ready();
+  b.ready();
+
+  // RHS columns: b and all ones
+  static const int ncols = 2;
+  int lcols(ncols/world.size() + (world.rank() < ncols%world.size() ? 1 : 0));
+  gridpack::math::RealMatrix B(world, local_size, lcols, gridpack::math::Dense);
+  int lo, hi;
+  b.localIndexRange(lo, hi);
+  for (int i = lo; i < hi; ++i) {
+    gridpack::math::RealType bi;
+    b.getElement(i, bi);
+    B.setElement(i, 0, bi);
+    B.setElement(i, 1, 1.0);
+  }
+  B.ready();
+
+  BOOST_REQUIRE(test_config);
+
+  gridpack::math::RealLinearMatrixSolver full(A);
+  full.configurationKey("FullPrecisionMatrixSolver");
+  full.configure(test_config);
+  std::auto_ptr<gridpack::math::RealMatrix> X(full.solve(B));
+  double rfull(relativeResidual(A, B, *X));
+
+  gridpack::math::RealLinearMatrixSolver mixed(A);
+  mixed.configurationKey("MixedPrecisionMatrixSolver");
+  mixed.configure(test_config);
+  double tol(test_config->get("MixedPrecisionMatrixSolver.RefinementTolerance", 1.0e-12));
+  X.reset(mixed.solve(B));
+  double r(relativeResidual(A, B, *X));
+  if (world.rank() == 0) {
+    std::cout << "Full precision relative residual = " << rfull << std::endl;
+    std::cout << "Mixed precision relative residual = " << r << std::endl;
+  }
+  BOOST_CHECK(r <= std::max(tol, 10.0*rfull));
+
+  gridpack::math::RealLinearMatrixSolver fallback(A);
+  fallback.configurationKey("MixedPrecisionMatrixFallback");
+  fallback.configure(test_config);
+  for (int k = 0; k < 2; ++k) {
+    X.reset(fallback.solve(B));
+    BOOST_CHECK(relativeResidual(A, B, *X) <= 10.0*rfull + 1.0e-14);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -356,6 +356,54 @@ BOOST_AUTO_TEST_CASE( accumulate )
   }
 }
 
+BOOST_AUTO_TEST_CASE( set_block )
+{
+  gridpack::parallel::Communicator world;
+  static const int bsize(2);
+  static const int nblocks(3);
+  int lsize(bsize*nblocks);
+
+  boost::scoped_ptr<TestMatrixType> 
+    A(TestMatrixType::createBlockSparse(world, lsize, lsize, bsize, 2*bsize));
+  BOOST_CHECK_EQUAL(A->storageType(), gridpack::math::BlockSparse);
+
+  int lo, hi;
+  A->localRowRange(lo, hi);
+
+  // blocks are column-major, element (r,c) is at x[c*bsize+r]. Set the
+  // blocks, assemble, then add the same blocks again: insert and add
+  // cannot be mixed without an assembly in between
+  TestType x[bsize*bsize];
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int i = lo; i < hi; i += bsize) {
+      for (int r = 0; r < bsize; ++r) {
+        for (int c = 0; c < bsize; ++c) {
+          x[c*bsize+r] = TEST_VALUE(static_cast<double>(i+r), 
+                                    static_cast<double>(c));
+        }
+      }
+      if (pass == 0) {
+        A->setBlock(i, i, bsize, bsize, x);
+      } else {
+        A->addBlock(i, i, bsize, bsize, x);
+      }
+    }
+    A->ready();
+  }
+
+  for (int i = lo; i < hi; i += bsize) {
+    for (int r = 0; r < bsize; ++r) {
+      for (int c = 0; c < bsize; ++c) {
+        TestType y;
+        A->getElement(i+r, i+c, y);
+        TestType z(TEST_VALUE(2.0*static_cast<double>(i+r), 
+                              2.0*static_cast<double>(c)));
+        TEST_VALUE_CLOSE(z, y, delta);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( local_clone )
 {
   gridpack::parallel::Communicator world;
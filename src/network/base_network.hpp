@@ -22,7 +22,15 @@
 #include <iomanip>
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <sstream>
+#include <climits>
+#include <cstring>
+#include <cstdio>
+#include <mpi.h>
 #include <boost/smart_ptr/shared_ptr.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
 #include <boost/serialization/singleton.hpp>
 #include <boost/serialization/extended_type_info.hpp>
 #include <boost/serialization/shared_ptr.hpp>
@@ -35,6 +43,7 @@
 #include "gridpack/partition/graph_partitioner.hpp"
 #include "gridpack/parallel/shuffler.hpp"
 #include "gridpack/parallel/ga_shuffler.hpp"
+#include "gridpack/network/component_arena.hpp"
 #include "gridpack/timer/coarse_timer.hpp"
 #include "gridpack/utilities/exception.hpp"
 
@@ -59,7 +68,8 @@ BusData(void)
     p_branchNeighbors(),
     p_bus(new _bus),
     p_data(new gridpack::component::DataCollection),
-    p_refFlag(false)
+    p_refFlag(false),
+    p_weight(1)
 {
 }
 
@@ -71,7 +81,8 @@ BusData(const BusData& old)
     p_branchNeighbors(old.p_branchNeighbors),
     p_bus(old.p_bus),
     p_data(old.p_data),
-    p_refFlag(old.p_refFlag)
+    p_refFlag(old.p_refFlag),
+    p_weight(old.p_weight)
 {}
 
 /**
@@ -94,6 +105,7 @@ BusData<_bus> & operator=(const BusData<_bus> & rhs)
   p_bus = rhs.p_bus;
   p_data = rhs.p_data;
   p_refFlag = rhs.p_refFlag;
+  p_weight = rhs.p_weight;
   return *this;
 }
 
@@ -106,6 +118,7 @@ BusData<_bus> & operator=(const BusData<_bus> & rhs)
  * p_bus: pointer to bus object
  * p_data: pointer to data collection object
  * p_refFlag: true if this bus is the reference bus
+ * p_weight: estimated computational cost of bus, used by partitioner
  */
   bool                                                   p_activeBus;
   int                                                    p_originalBusIndex;
@@ -114,6 +127,7 @@ BusData<_bus> & operator=(const BusData<_bus> & rhs)
   boost::shared_ptr<_bus>                                p_bus;
   boost::shared_ptr<component::DataCollection>           p_data;
   bool                                                   p_refFlag;
+  int                                                    p_weight;
 
 private: 
 
@@ -128,7 +142,8 @@ private:
       & p_branchNeighbors
       & *p_bus
       & *p_data
-      & p_refFlag;
+      & p_refFlag
+      & p_weight;
   }
 
 };
@@ -154,7 +169,8 @@ BranchData(void)
     p_localBusIndex1(-1),
     p_localBusIndex2(-1),
     p_branch(new _branch),
-    p_data(new gridpack::component::DataCollection)
+    p_data(new gridpack::component::DataCollection),
+    p_weight(2)
 {
 }
 
@@ -169,7 +185,8 @@ BranchData(const BranchData& old)
     p_localBusIndex1(old.p_localBusIndex1),
     p_localBusIndex2(old.p_localBusIndex2),
     p_branch(old.p_branch),
-    p_data(old.p_data)
+    p_data(old.p_data),
+    p_weight(old.p_weight)
 {}
 
 /**
@@ -195,6 +212,7 @@ BranchData<_branch> & operator=(const BranchData<_branch> & rhs)
   p_localBusIndex2 = rhs.p_localBusIndex2;
   p_branch = rhs.p_branch;
   p_data = rhs.p_data;
+  p_weight = rhs.p_weight;
   return *this;
 }
 
@@ -212,6 +230,9 @@ BranchData<_branch> & operator=(const BranchData<_branch> & rhs)
  * p_localBusIndex2: local index of bus at "to" end of branch
  * p_branch: pointer to branch object
  * p_data: pointer to data collection object
+ * p_weight: estimated communication cost of branch, used by partitioner.
+ *      The default of 2 matches the edge weight ParMETIS has always been
+ *      given, relative to a default bus weight of 1
  */
   bool                                                   p_activeBranch;
   int                                                    p_globalBranchIndex;
@@ -223,6 +244,7 @@ BranchData<_branch> & operator=(const BranchData<_branch> & rhs)
   int                                                    p_localBusIndex2;
   boost::shared_ptr<_branch>                             p_branch;
   boost::shared_ptr<component::DataCollection>           p_data;
+  int                                                    p_weight;
 
 private: 
 
@@ -240,7 +262,8 @@ private:
       & p_localBusIndex1
       & p_localBusIndex2
       & *p_branch
-      & *p_data;
+      & *p_data
+      & p_weight;
   }
 
 };
@@ -307,6 +330,8 @@ explicit BaseNetwork(const parallel::Communicator& comm)
   p_external_branch = false;
   p_allocatedBus = false;
   p_allocatedBranch = false;
+  p_arenaAllocation = false;
+  p_localReordering = false;
 }
 
 /**
@@ -675,6 +700,45 @@ bool setActiveBranch(int idx, bool flag)
   }
 }
 
+/**
+ * Set the partitioning weight of the bus. The weight should be
+ * proportional to the computational cost of the bus (including any
+ * devices attached to it) and is used by partition and repartition to
+ * balance work across processes
+ * @param idx local index of bus
+ * @param weight weight of bus (must be at least 1)
+ * @return false if no bus exists for idx
+ */
+bool setBusWeight(int idx, int weight)
+{
+  if (idx < 0 || idx >= p_buses.size()) {
+    return false;
+  } else {
+    if (weight < 1) weight = 1;
+    p_buses[idx].p_weight = weight;
+    return true;
+  }
+}
+
+/**
+ * Set the partitioning weight of the branch. The weight should be
+ * proportional to the cost of communicating across the branch if its
+ * endpoints are on different processes. The default weight is 2
+ * @param idx local index of branch
+ * @param weight weight of branch (must be at least 1)
+ * @return false if no branch exists for idx
+ */
+bool setBranchWeight(int idx, int weight)
+{
+  if (idx < 0 || idx >= p_branches.size()) {
+    return false;
+  } else {
+    if (weight < 1) weight = 1;
+    p_branches[idx].p_weight = weight;
+    return true;
+  }
+}
+
 /**
  * Clear the list of neighbors for the bus at idx
  * @param idx local index of bus
@@ -708,6 +772,71 @@ bool addBranchNeighbor(int idx, int br_idx)
 
 // Bus and Branch accessors
 
+/**
+ * Get partitioning weight of the bus
+ * @param idx local index of bus
+ * @return weight of bus
+ */
+int getBusWeight(int idx)
+{
+  if (idx >= 0 && idx < p_buses.size()) {
+    return p_buses[idx].p_weight;
+  } else {
+    char buf[256];
+    sprintf(buf,"BaseNetwork::getBusWeight: illegal index: %d size: %d\n",
+           idx, static_cast<int>(p_buses.size()));
+    printf("%s",buf);
+    throw gridpack::Exception(buf);
+  }
+  return 0;
+}
+
+/**
+ * Get partitioning weight of the branch
+ * @param idx local index of branch
+ * @return weight of branch
+ */
+int getBranchWeight(int idx)
+{
+  if (idx >= 0 && idx < p_branches.size()) {
+    return p_branches[idx].p_weight;
+  } else {
+    char buf[256];
+    sprintf(buf,"BaseNetwork::getBranchWeight: illegal index: %d size: %d\n",
+           idx, static_cast<int>(p_branches.size()));
+    printf("%s",buf);
+    throw gridpack::Exception(buf);
+  }
+  return 0;
+}
+
+/**
+ * Compute the load imbalance of the current distribution, based on the
+ * bus weights of locally owned buses. This is a collective operation.
+ * @return ratio of the maximum to the average total bus weight on a
+ *         process. A perfectly balanced network returns 1
+ */
+double loadImbalance(void)
+{
+  int nproc = this->processor_size();
+  int me = this->processor_rank();
+  std::vector<int> load(nproc, 0);
+  int i;
+  int nbus = p_buses.size();
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus) load[me] += p_buses[i].p_weight;
+  }
+  communicator().sum(&load[0], nproc);
+  double total = 0.0;
+  int lmax = 0;
+  for (i=0; i<nproc; i++) {
+    total += static_cast<double>(load[i]);
+    if (load[i] > lmax) lmax = load[i];
+  }
+  if (total <= 0.0) return 1.0;
+  return static_cast<double>(lmax)*static_cast<double>(nproc)/total;
+}
+
 /**
  * Get status of the bus (local or ghosted)
  * @param idx local index of bus
@@ -988,6 +1117,370 @@ void assemble(void)
  * Partition the network over the available processes
  */
 void partition(void)
+{
+  p_partition(false, 0.0);
+}
+
+/**
+ * Choose how bus and branch objects are stored after the network is
+ * partitioned. If arena allocation is on, partition and repartition copy
+ * all buses into a single contiguous block and all branches into another,
+ * in local index order with ghost components last, so that loops over
+ * components walk through memory sequentially. Otherwise each component
+ * stays in its own heap allocation. Components must be copy constructible
+ * to use arena allocation. The default is off.
+ * @param flag true if components should be allocated in arenas
+ */
+void setArenaAllocation(bool flag)
+{
+  p_arenaAllocation = flag;
+}
+
+/**
+ * Check whether components are allocated in arenas after partitioning
+ * @return true if arena allocation is on
+ */
+bool getArenaAllocation(void) const
+{
+  return p_arenaAllocation;
+}
+
+/**
+ * Choose whether local buses and branches are reordered after the network
+ * is partitioned. If reordering is on, active buses are numbered using
+ * reverse Cuthill-McKee on the graph of local active buses, ghost buses
+ * follow the active buses they are attached to and branches are sorted
+ * by the new indices of their end buses. Matrices and vectors built by
+ * the mappers then have a smaller bandwidth and loops over components
+ * visit neighboring buses close together. The default is off.
+ * @param flag true if local components should be reordered
+ */
+void setLocalReordering(bool flag)
+{
+  p_localReordering = flag;
+}
+
+/**
+ * Check whether local components are reordered after partitioning
+ * @return true if local reordering is on
+ */
+bool getLocalReordering(void) const
+{
+  return p_localReordering;
+}
+
+/**
+ * Repartition a network that has already been partitioned. ParMETIS
+ * adaptive repartitioning is used, starting from the current
+ * distribution, so only buses and branches whose owner changes are
+ * moved between processes. Ghost buses and branches are rebuilt and
+ * exchange buffers that were allocated by the network are reallocated
+ * and reinitialized. Exchange buffers supplied by the components (via
+ * allocXCBusPointers/allocXCBranchPointers) must be set up again by
+ * the application, typically by calling the factory setExchange method,
+ * followed by initBusUpdate and initBranchUpdate.
+ * @param itr ratio of inter-process communication time to data
+ *        redistribution time. Larger values favor partition quality over
+ *        keeping buses and branches where they are
+ * @return total number of buses that changed owner
+ */
+int repartition(double itr = 1000.0)
+{
+  // Remember exchange buffer configuration so it can be restored
+  int busXCSize = 0;
+  if (p_allocatedBus && !p_external_bus) busXCSize = p_busXCBufSize;
+  int branchXCSize = 0;
+  if (p_allocatedBranch && !p_external_branch) branchXCSize = p_branchXCBufSize;
+  bool busUpdate = p_busGASet;
+  bool branchUpdate = p_branchGASet;
+  bool mapSet = (p_busMap.size() > 0 || p_branchMap.size() > 0);
+
+  // Remove ghosts and exchange buffers. Only active buses and branches
+  // remain, so each process is the current owner of everything it holds
+  clean();
+
+  // Connections between components are rebuilt after redistribution
+  int i;
+  int nbus = p_buses.size();
+  for (i=0; i<nbus; i++) {
+    p_buses[i].p_bus->clearBranches();
+    p_buses[i].p_bus->clearBuses();
+  }
+
+  int moved = p_partition(true, itr);
+  communicator().sum(&moved, 1);
+
+  // Reference bus flag travels with the bus, so find its new location
+  p_refBus = -1;
+  nbus = p_buses.size();
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus && p_buses[i].p_refFlag) {
+      p_refBus = i;
+      break;
+    }
+  }
+
+  if (busXCSize > 0) {
+    allocXCBus(busXCSize);
+    if (busUpdate) initBusUpdate();
+  }
+  if (branchXCSize > 0) {
+    allocXCBranch(branchXCSize);
+    if (branchUpdate) initBranchUpdate();
+  }
+  if (mapSet) setMap();
+  return moved;
+}
+
+/**
+ * Write the partitioned network to a binary snapshot file. The snapshot
+ * contains the data collection objects, original and global indices,
+ * weights, reference bus flag and active (owner) flags of all buses and
+ * branches on each process, including ghosts, so the network can be
+ * restored with loadSnapshot without parsing and partitioning. All
+ * processes write their part of the file in a single collective call.
+ * This is collective.
+ * @param filename name of snapshot file
+ * @param saveState if true, the state of the bus and branch components is
+ *        also saved. Otherwise components must be initialized from the data
+ *        collection objects (e.g. by calling the factory load method) after
+ *        the snapshot is loaded
+ * @param source description of the input the network was created from
+ *        (e.g. file name, size and modification time and any options
+ *        applied while parsing). It is stored in the snapshot and checked
+ *        by loadSnapshot
+ */
+void saveSnapshot(const std::string &filename, bool saveState = false,
+    const std::string &source = std::string())
+{
+  MPI_Comm comm = static_cast<MPI_Comm>(communicator());
+  int me = communicator().rank();
+  int nprocs = communicator().size();
+
+  // Serialize local buses and branches
+  std::ostringstream oss;
+  {
+    boost::archive::binary_oarchive oa(oss);
+    p_saveSnapshot(oa, saveState);
+  }
+  std::string blob = oss.str();
+  long long size = blob.size();
+  std::vector<long long> sizes(nprocs,0);
+  MPI_Allgather(&size,1,MPI_LONG_LONG,&sizes[0],1,MPI_LONG_LONG,comm);
+  long long offset = sizeof(SnapshotHeader)+source.size()
+    +nprocs*sizeof(long long);
+  int i;
+  for (i=0; i<me; i++) offset += sizes[i];
+
+  MPI_File fh;
+  int ierr = MPI_File_open(comm, const_cast<char*>(filename.c_str()),
+      MPI_MODE_WRONLY|MPI_MODE_CREATE, MPI_INFO_NULL, &fh);
+  if (ierr != MPI_SUCCESS) {
+    char buf[256];
+    sprintf(buf,"BaseNetwork::saveSnapshot: unable to open file %s\n",
+        filename.c_str());
+    throw gridpack::Exception(buf);
+  }
+  MPI_File_set_size(fh, 0);
+  if (me == 0) {
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    strncpy(header.magic, "GPNETSNP", sizeof(header.magic));
+    header.version = p_snapshotVersion;
+    header.nprocs = nprocs;
+    header.state = (saveState ? 1 : 0);
+    header.sourceSize = source.size();
+    MPI_File_write_at(fh, 0, &header, sizeof(header), MPI_BYTE,
+        MPI_STATUS_IGNORE);
+    if (header.sourceSize > 0) {
+      MPI_File_write_at(fh, sizeof(header), const_cast<char*>(source.data()),
+          header.sourceSize, MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+    MPI_File_write_at(fh, sizeof(header)+header.sourceSize, &sizes[0],
+        nprocs*sizeof(long long), MPI_BYTE, MPI_STATUS_IGNORE);
+  }
+  p_checkSnapshotSize(size);
+  ierr = MPI_File_write_at_all(fh, offset, const_cast<char*>(blob.data()),
+      static_cast<int>(size), MPI_BYTE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+  if (ierr != MPI_SUCCESS) {
+    char buf[256];
+    sprintf(buf,"BaseNetwork::saveSnapshot: error writing file %s\n",
+        filename.c_str());
+    throw gridpack::Exception(buf);
+  }
+}
+
+/**
+ * Restore a network from a snapshot written by saveSnapshot. The network
+ * must be empty. If the snapshot was written with the same number of
+ * processes, each process reads back its own buses and branches and no
+ * partitioning is done. Otherwise, the active buses and branches are
+ * divided between the processes in the order in which they were written
+ * and the network is repartitioned adaptively, starting from this
+ * distribution. Exchange buffers are not part of the snapshot and must be
+ * set up by the application in the usual way. This is collective.
+ * @param filename name of snapshot file
+ * @param source description of the input the network should be created
+ *        from. If it is not empty, it must match the description passed to
+ *        saveSnapshot, otherwise the snapshot is out of date and is not
+ *        loaded
+ * @return false if the file could not be opened or is out of date. The
+ *         network is still empty in this case
+ */
+bool loadSnapshot(const std::string &filename,
+    const std::string &source = std::string())
+{
+  MPI_Comm comm = static_cast<MPI_Comm>(communicator());
+  int me = communicator().rank();
+  int nprocs = communicator().size();
+  if (p_buses.size() > 0 || p_branches.size() > 0) {
+    throw gridpack::Exception(
+        "BaseNetwork::loadSnapshot: network already contains buses or branches");
+  }
+  MPI_File fh;
+  int ierr = MPI_File_open(comm, const_cast<char*>(filename.c_str()),
+      MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+  if (ierr != MPI_SUCCESS) return false;
+
+  SnapshotHeader header;
+  MPI_File_read_at(fh, 0, &header, sizeof(header), MPI_BYTE,
+      MPI_STATUS_IGNORE);
+  if (strncmp(header.magic, "GPNETSNP", sizeof(header.magic)) ||
+      header.version != p_snapshotVersion || header.nprocs <= 0 ||
+      header.sourceSize < 0) {
+    MPI_File_close(&fh);
+    char buf[256];
+    sprintf(buf,"BaseNetwork::loadSnapshot: %s is not a network snapshot"
+        " of version %d\n",filename.c_str(),p_snapshotVersion);
+    throw gridpack::Exception(buf);
+  }
+
+  // Only use the snapshot if it was created from the same input. All
+  // processes must agree, so that they either all load the snapshot or
+  // all create the network again
+  int stale = 0;
+  if (!source.empty()) {
+    std::string stored(header.sourceSize,' ');
+    if (header.sourceSize > 0) {
+      MPI_File_read_at(fh, sizeof(header), &stored[0], header.sourceSize,
+          MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+    if (stored != source) stale = 1;
+  }
+  MPI_Allreduce(MPI_IN_PLACE,&stale,1,MPI_INT,MPI_MAX,comm);
+  if (stale) {
+    MPI_File_close(&fh);
+    return false;
+  }
+
+  int nfile = header.nprocs;
+  std::vector<long long> sizes(nfile);
+  MPI_File_read_at(fh, sizeof(header)+header.sourceSize, &sizes[0],
+      nfile*sizeof(long long), MPI_BYTE, MPI_STATUS_IGNORE);
+  std::vector<long long> offsets(nfile);
+  offsets[0] = sizeof(header)+header.sourceSize+nfile*sizeof(long long);
+  int i;
+  for (i=1; i<nfile; i++) offsets[i] = offsets[i-1]+sizes[i-1];
+
+  // With the same number of processes, read back the local network.
+  // Otherwise read whole blocks written by other processes and keep only
+  // the buses and branches that were active
+  bool same = (nfile == nprocs);
+  std::vector<char> blob;
+  for (i=me; i<nfile; i+=nprocs) {
+    p_checkSnapshotSize(sizes[i]);
+    blob.resize(sizes[i]);
+    if (sizes[i] > 0) {
+      MPI_File_read_at(fh, offsets[i], &blob[0], static_cast<int>(sizes[i]),
+          MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+    std::istringstream iss(std::string(blob.begin(),blob.end()));
+    boost::archive::binary_iarchive ia(iss);
+    p_loadSnapshot(ia, !same);
+    if (same) break;
+  }
+  MPI_File_close(&fh);
+
+  if (same) {
+    if (p_arenaAllocation) p_allocateArenas();
+    p_connectComponents();
+  } else {
+    p_partition(true, 1000.0);
+  }
+  p_setRefBus();
+  return true;
+}
+
+/**
+ * Copy a partitioned network from one group of processes to other groups
+ * of the same size, without parsing or partitioning it again. The peers
+ * communicator connects the processes that have the same rank in the
+ * communicators of each group, so each process receives the buses and
+ * branches (including ghosts) of its counterpart in the source group. On
+ * process root of peers the network must be partitioned, on the other
+ * processes it must be empty. Exchange buffers are not copied and must be
+ * set up by the application in the usual way. This is collective on peers.
+ * @param peers communicator connecting processes with the same rank in
+ *        each group
+ * @param root rank in peers of the process that holds the network
+ */
+void replicate(const parallel::Communicator &peers, int root)
+{
+  MPI_Comm comm = static_cast<MPI_Comm>(peers);
+  int me = peers.rank();
+  if (me != root && (p_buses.size() > 0 || p_branches.size() > 0)) {
+    throw gridpack::Exception(
+        "BaseNetwork::replicate: network already contains buses or branches");
+  }
+  int nmin = communicator().size();
+  int nmax = nmin;
+  peers.min(&nmin,1);
+  peers.max(&nmax,1);
+  if (nmin != nmax) {
+    char buf[256];
+    sprintf(buf,"BaseNetwork::replicate: groups have different sizes"
+        " min: %d max: %d\n",nmin,nmax);
+    throw gridpack::Exception(buf);
+  }
+
+  std::string blob;
+  if (me == root) {
+    std::ostringstream oss;
+    {
+      boost::archive::binary_oarchive oa(oss);
+      p_saveSnapshot(oa, false);
+    }
+    blob = oss.str();
+  }
+  long long size = blob.size();
+  MPI_Bcast(&size,1,MPI_LONG_LONG,root,comm);
+  p_checkSnapshotSize(size);
+  if (me != root) blob.resize(size);
+  if (size > 0) {
+    MPI_Bcast(&blob[0],static_cast<int>(size),MPI_BYTE,root,comm);
+  }
+  if (me != root) {
+    std::istringstream iss(blob);
+    boost::archive::binary_iarchive ia(iss);
+    p_loadSnapshot(ia, false);
+    if (p_arenaAllocation) p_allocateArenas();
+    p_connectComponents();
+    p_setRefBus();
+  }
+}
+
+private:
+
+/**
+ * Partition (or repartition) the network and distribute buses and
+ * branches to their new owners
+ * @param adaptive if true, start from the current distribution
+ * @param itr ratio of communication time to redistribution time (only
+ *        used if adaptive is true)
+ * @return number of local buses sent to other processes
+ */
+int p_partition(bool adaptive, double itr)
 {
   gridpack::utility::CoarseTimer *timer;
   timer = NULL;
@@ -1012,15 +1505,21 @@ void partition(void)
 
   for (BusIterator bus = p_buses.begin(); 
       bus != p_buses.end(); ++bus) {
-    partitioner.add_node(bus->p_globalBusIndex,bus->p_originalBusIndex);
+    partitioner.add_node(bus->p_globalBusIndex,bus->p_originalBusIndex,
+        bus->p_weight);
   }
   for (BranchIterator branch = p_branches.begin(); 
       branch != p_branches.end(); ++branch) {
     partitioner.add_edge(branch->p_globalBranchIndex, 
         branch->p_originalBusIndex1,
-        branch->p_originalBusIndex2);
+        branch->p_originalBusIndex2,
+        branch->p_weight);
+  }
+  if (adaptive) {
+    partitioner.repartition(itr);
+  } else {
+    partitioner.partition();
   }
-  partitioner.partition();
   // Recover global indices for branch ends from partitioner
   int nbranch = p_branches.size();
   int idx;
@@ -1090,6 +1589,10 @@ void partition(void)
 
   if (timer != NULL) timer->start(t_bus_dist);
   partitioner.node_destinations(dest);
+  int moved(0);
+  for (size_t i = 0; i < dest.size(); ++i) {
+    if (static_cast<int>(dest[i]) != me) moved++;
+  }
   bus_shuffler(p_buses, dest);
   if (timer != NULL) timer->stop(t_bus_dist);
 
@@ -1122,60 +1625,15 @@ void partition(void)
   ghostbranches.clear();
   if (timer != NULL) timer->stop(t_branch_dist);
 
+  // Optionally reorder buses and branches for locality, then move
+  // them into contiguous storage before the connections between them
+  // are set up. Ghosts are last in either case
+  if (p_localReordering) p_reorderComponents();
+  if (p_arenaAllocation) p_allocateArenas();
+
   // At this point, each process should have a self-contained
   // network, update local and global indexes, etc.
-
-  // make an index of global bus index to local index and update
-  // the branch local bus indexes
-  int active_buses(0), active_branches(0);
-  {
-    std::map<int, int> busindexes;
-    int lidx(0);
-    for (BusIterator b = p_buses.begin(); b != p_buses.end(); ++b, ++lidx) {
-      clearBranchNeighbors(lidx);
-      busindexes[b->p_globalBusIndex] = lidx;
-      if (b->p_activeBus) active_buses += 1;
-    }
-
-    // go through the branches and set the local bus indexes and pointers
-    lidx = 0;
-    for (BranchIterator b = p_branches.begin(); b != p_branches.end(); ++b, ++lidx) {
-      int gbus, lbus1, lbus2;
-      BusPtr bus1, bus2;
-
-      // set local indexes
-
-      gbus = b->p_globalBusIndex1;
-      lbus1 = busindexes[gbus];
-      bus1 = p_buses[lbus1].p_bus;
-
-      gbus = b->p_globalBusIndex2;
-      lbus2 = busindexes[gbus];
-      bus2 = p_buses[lbus2].p_bus;
-
-      b->p_localBusIndex1 = lbus1;
-      addBranchNeighbor(lbus1, lidx);
-
-      b->p_localBusIndex2 = lbus2;
-      addBranchNeighbor(lbus2, lidx);
-
-      // set component pointers
-
-      b->p_branch->setBus1(bus1);
-      b->p_branch->setBus2(bus2);
-
-      gbus = b->p_globalBusIndex1;
-      bus1->addBranch(b->p_branch);
-      bus1->addBus(bus2);
-      setGlobalBusIndex1(lidx,gbus); 
-      gbus = b->p_globalBusIndex2;
-      bus2->addBranch(b->p_branch);
-      bus2->addBus(bus1);
-      setGlobalBusIndex2(lidx,gbus); 
-
-      if (b->p_activeBranch) active_branches += 1;
-    }
-  }
+  p_connectComponents();
 
   std::cout << me << ": "
     << "I have " 
@@ -1184,8 +1642,11 @@ void partition(void)
     << std::endl;
 
   if (timer != NULL) timer->stop(t_total);
+  return moved;
 }
 
+public:
+
 
 
 /**
@@ -1338,6 +1799,7 @@ template <class _new_bus, class _new_branch> void clone(
     new_network->setGlobalBusIndex(i,idx);
     *(new_network->getBusData(i)) = *(getBusData(i));
     new_network->setActiveBus(i,getActiveBus(i));
+    new_network->setBusWeight(i,getBusWeight(i));
     // set neighbor indices
     std::vector<int> nghbrs;
     nghbrs = getConnectedBranches(i);
@@ -1358,6 +1820,7 @@ template <class _new_bus, class _new_branch> void clone(
     new_network->setGlobalBranchIndex(i,idx);
     *(new_network->getBranchData(i)) = *(getBranchData(i));
     new_network->setActiveBranch(i,getActiveBranch(i));
+    new_network->setBranchWeight(i,getBranchWeight(i));
     // set bus indices at either end of branch
     getBranchEndpoints(i,&idx,&jdx);
     new_network->setLocalBusIndex1(i,idx);
@@ -2433,6 +2896,320 @@ std::vector<int> getLocalBranchIndices(int idx1, int idx2) {
 }
 
 
+private:
+
+/**
+ * Permute buses and branches on this process. Active buses are numbered
+ * with reverse Cuthill-McKee, starting each connected piece at a bus of
+ * lowest degree, and ghost buses are placed after all active buses in
+ * the order of their lowest numbered active neighbor. Active branches are
+ * sorted by the new indices of their end buses and are followed by ghost
+ * branches sorted the same way. Local indices in branches and bus
+ * neighbor lists are not updated, they are set up after this call
+ */
+void p_reorderComponents(void)
+{
+  int i, j, k;
+  int nbus = p_buses.size();
+  int nbranch = p_branches.size();
+  if (nbus == 0) return;
+
+  // Find the current position of the buses at either end of each branch
+  std::map<int, int> busindexes;
+  for (i=0; i<nbus; i++) {
+    busindexes[p_buses[i].p_globalBusIndex] = i;
+  }
+  std::vector<int> end1(nbranch), end2(nbranch);
+  for (i=0; i<nbranch; i++) {
+    end1[i] = busindexes[p_branches[i].p_globalBusIndex1];
+    end2[i] = busindexes[p_branches[i].p_globalBusIndex2];
+  }
+
+  // Build bus adjacency lists in compressed form. Only branches between
+  // two active buses count towards the degree used to order active buses
+  std::vector<int> offset(nbus+1,0);
+  std::vector<int> degree(nbus,0);
+  for (i=0; i<nbranch; i++) {
+    offset[end1[i]+1]++;
+    offset[end2[i]+1]++;
+    if (p_buses[end1[i]].p_activeBus && p_buses[end2[i]].p_activeBus) {
+      degree[end1[i]]++;
+      degree[end2[i]]++;
+    }
+  }
+  for (i=0; i<nbus; i++) offset[i+1] += offset[i];
+  std::vector<int> adjacent(offset[nbus]);
+  std::vector<int> fill(offset.begin(),offset.end()-1);
+  for (i=0; i<nbranch; i++) {
+    adjacent[fill[end1[i]]++] = end2[i];
+    adjacent[fill[end2[i]]++] = end1[i];
+  }
+
+  // Candidate starting buses in order of increasing degree
+  std::vector<std::pair<int,int> > start;
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus) {
+      start.push_back(std::pair<int,int>(degree[i],i));
+    }
+  }
+  std::sort(start.begin(),start.end());
+
+  // Cuthill-McKee ordering of active buses, one connected piece at a time
+  std::vector<int> order;
+  order.reserve(nbus);
+  std::vector<char> visited(nbus,0);
+  std::vector<std::pair<int,int> > next;
+  int nstart = start.size();
+  for (k=0; k<nstart; k++) {
+    int root = start[k].second;
+    if (visited[root]) continue;
+    visited[root] = 1;
+    size_t head = order.size();
+    order.push_back(root);
+    while (head < order.size()) {
+      int bus = order[head++];
+      next.clear();
+      for (j=offset[bus]; j<offset[bus+1]; j++) {
+        int nghbr = adjacent[j];
+        if (!visited[nghbr] && p_buses[nghbr].p_activeBus) {
+          visited[nghbr] = 1;
+          next.push_back(std::pair<int,int>(degree[nghbr],nghbr));
+        }
+      }
+      std::sort(next.begin(),next.end());
+      for (j=0; j<static_cast<int>(next.size()); j++) {
+        order.push_back(next[j].second);
+      }
+    }
+  }
+  std::reverse(order.begin(),order.end());
+  int nactive = order.size();
+
+  // Ghost buses follow their lowest numbered active neighbor
+  std::vector<int> newidx(nbus,-1);
+  for (i=0; i<nactive; i++) newidx[order[i]] = i;
+  std::vector<std::pair<int,int> > ghosts;
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus) continue;
+    int key = nactive;
+    for (j=offset[i]; j<offset[i+1]; j++) {
+      int nghbr = newidx[adjacent[j]];
+      if (nghbr >= 0 && nghbr < key) key = nghbr;
+    }
+    ghosts.push_back(std::pair<int,int>(key,i));
+  }
+  std::sort(ghosts.begin(),ghosts.end());
+  for (i=0; i<static_cast<int>(ghosts.size()); i++) {
+    newidx[ghosts[i].second] = nactive+i;
+    order.push_back(ghosts[i].second);
+  }
+
+  // Sort branches by activity and then by the new indices of their ends
+  std::vector<std::pair<std::pair<int,int>,std::pair<int,int> > > keys(nbranch);
+  for (i=0; i<nbranch; i++) {
+    int lo = std::min(newidx[end1[i]],newidx[end2[i]]);
+    int hi = std::max(newidx[end1[i]],newidx[end2[i]]);
+    keys[i].first.first = (p_branches[i].p_activeBranch ? 0 : 1);
+    keys[i].first.second = lo;
+    keys[i].second.first = hi;
+    keys[i].second.second = i;
+  }
+  std::sort(keys.begin(),keys.end());
+
+  BusDataVector buses;
+  buses.reserve(nbus);
+  for (i=0; i<nbus; i++) buses.push_back(p_buses[order[i]]);
+  p_buses.swap(buses);
+  BranchDataVector branches;
+  branches.reserve(nbranch);
+  for (i=0; i<nbranch; i++) {
+    branches.push_back(p_branches[keys[i].second.second]);
+  }
+  p_branches.swap(branches);
+}
+
+/**
+ * Set up local indices of branch ends, bus neighbor lists and the pointers
+ * between bus and branch components for the buses and branches currently
+ * held by this process
+ */
+void p_connectComponents(void)
+{
+  // make an index of global bus index to local index and update
+  // the branch local bus indexes
+  std::map<int, int> busindexes;
+  int lidx(0);
+  for (BusIterator b = p_buses.begin(); b != p_buses.end(); ++b, ++lidx) {
+    clearBranchNeighbors(lidx);
+    busindexes[b->p_globalBusIndex] = lidx;
+  }
+
+  // go through the branches and set the local bus indexes and pointers
+  lidx = 0;
+  for (BranchIterator b = p_branches.begin(); b != p_branches.end(); ++b, ++lidx) {
+    int gbus, lbus1, lbus2;
+    BusPtr bus1, bus2;
+
+    // set local indexes
+
+    gbus = b->p_globalBusIndex1;
+    lbus1 = busindexes[gbus];
+    bus1 = p_buses[lbus1].p_bus;
+
+    gbus = b->p_globalBusIndex2;
+    lbus2 = busindexes[gbus];
+    bus2 = p_buses[lbus2].p_bus;
+
+    b->p_localBusIndex1 = lbus1;
+    addBranchNeighbor(lbus1, lidx);
+
+    b->p_localBusIndex2 = lbus2;
+    addBranchNeighbor(lbus2, lidx);
+
+    // set component pointers
+
+    b->p_branch->setBus1(bus1);
+    b->p_branch->setBus2(bus2);
+
+    gbus = b->p_globalBusIndex1;
+    bus1->addBranch(b->p_branch);
+    bus1->addBus(bus2);
+    setGlobalBusIndex1(lidx,gbus); 
+    gbus = b->p_globalBusIndex2;
+    bus2->addBranch(b->p_branch);
+    bus2->addBus(bus1);
+    setGlobalBusIndex2(lidx,gbus); 
+  }
+}
+
+/**
+ * Serialize local buses and branches for a snapshot. Connections between
+ * components and local indices are not saved, they are rebuilt when the
+ * snapshot is loaded
+ * @param ar output archive
+ * @param saveState if true, serialize bus and branch components
+ */
+template <class Archive> void p_saveSnapshot(Archive &ar, bool saveState)
+{
+  int i;
+  int nbus = p_buses.size();
+  ar & saveState & nbus;
+  for (i=0; i<nbus; i++) {
+    BusData<BusType> &bus = p_buses[i];
+    ar & bus.p_activeBus
+      & bus.p_originalBusIndex
+      & bus.p_globalBusIndex
+      & bus.p_refFlag
+      & bus.p_weight
+      & *bus.p_data;
+    if (saveState) ar & *bus.p_bus;
+  }
+  int nbranch = p_branches.size();
+  ar & nbranch;
+  for (i=0; i<nbranch; i++) {
+    BranchData<BranchType> &branch = p_branches[i];
+    ar & branch.p_activeBranch
+      & branch.p_globalBranchIndex
+      & branch.p_originalBusIndex1
+      & branch.p_originalBusIndex2
+      & branch.p_globalBusIndex1
+      & branch.p_globalBusIndex2
+      & branch.p_weight
+      & *branch.p_data;
+    if (saveState) ar & *branch.p_branch;
+  }
+}
+
+/**
+ * Append buses and branches from a snapshot to the local network
+ * @param ar input archive
+ * @param activeOnly if true, ghost buses and branches are discarded
+ */
+template <class Archive> void p_loadSnapshot(Archive &ar, bool activeOnly)
+{
+  int i, nbus, nbranch;
+  bool saveState;
+  ar & saveState & nbus;
+  for (i=0; i<nbus; i++) {
+    BusData<BusType> bus;
+    ar & bus.p_activeBus
+      & bus.p_originalBusIndex
+      & bus.p_globalBusIndex
+      & bus.p_refFlag
+      & bus.p_weight
+      & *bus.p_data;
+    if (saveState) ar & *bus.p_bus;
+    if (!activeOnly || bus.p_activeBus) p_buses.push_back(bus);
+  }
+  ar & nbranch;
+  for (i=0; i<nbranch; i++) {
+    BranchData<BranchType> branch;
+    ar & branch.p_activeBranch
+      & branch.p_globalBranchIndex
+      & branch.p_originalBusIndex1
+      & branch.p_originalBusIndex2
+      & branch.p_globalBusIndex1
+      & branch.p_globalBusIndex2
+      & branch.p_weight
+      & *branch.p_data;
+    if (saveState) ar & *branch.p_branch;
+    if (!activeOnly || branch.p_activeBranch) p_branches.push_back(branch);
+  }
+}
+
+/**
+ * Find the local index of the reference bus after buses have been loaded
+ * from a snapshot
+ */
+void p_setRefBus(void)
+{
+  p_refBus = -1;
+  int i;
+  int nbus = p_buses.size();
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus && p_buses[i].p_refFlag) {
+      p_refBus = i;
+      break;
+    }
+  }
+}
+
+/**
+ * Check that a block of the snapshot file can be moved in a single MPI call
+ * @param size number of bytes in block
+ */
+void p_checkSnapshotSize(long long size)
+{
+  if (size > static_cast<long long>(INT_MAX)) {
+    char buf[256];
+    sprintf(buf,"BaseNetwork: snapshot block of %lld bytes exceeds MPI"
+        " count limit\n",size);
+    throw gridpack::Exception(buf);
+  }
+}
+
+/**
+ * Copy all buses and branches into contiguous arenas, in their current
+ * order, and point the bus and branch data at the copies. Connections
+ * between components are not copied and must be set up afterwards
+ */
+void p_allocateArenas(void)
+{
+  int i;
+  int nbus = p_buses.size();
+  typename BusArena::ArenaPtr busArena(new BusArena(nbus));
+  for (i=0; i<nbus; i++) {
+    BusType *bus = busArena->add(*(p_buses[i].p_bus));
+    p_buses[i].p_bus = BusArena::share(busArena, bus);
+  }
+  int nbranch = p_branches.size();
+  typename BranchArena::ArenaPtr branchArena(new BranchArena(nbranch));
+  for (i=0; i<nbranch; i++) {
+    BranchType *branch = branchArena->add(*(p_branches[i].p_branch));
+    p_branches[i].p_branch = BranchArena::share(branchArena, branch);
+  }
+}
+
 protected:
 
 /**
@@ -2453,6 +3230,8 @@ private:
   typedef boost::shared_ptr< BranchData<BranchType> > BranchDataPtr;
   typedef std::vector< BranchData<BranchType> > BranchDataVector;
   typedef typename BranchDataVector::iterator BranchIterator;
+  typedef ComponentArena<BusType> BusArena;
+  typedef ComponentArena<BranchType> BranchArena;
 
   /**
    * Vector of bus data and objects
@@ -2522,6 +3301,34 @@ private:
    */
   std::multimap<int,int> p_busMap;
   std::multimap<std::pair<int,int>,int> p_branchMap;
+
+  /**
+   * Allocate buses and branches in contiguous arenas after partitioning
+   */
+  bool p_arenaAllocation;
+
+  /**
+   * Reorder local buses and branches after partitioning
+   */
+  bool p_localReordering;
+
+  /**
+   * Fixed size header at the beginning of a snapshot file. The header is
+   * followed by the description of the source of the network, the size of
+   * the block written by each process and then by the blocks themselves
+   */
+  struct SnapshotHeader {
+    char magic[8];
+    int version;
+    int nprocs;
+    int state;
+    int sourceSize;
+  };
+
+  /**
+   * Current snapshot format
+   */
+  static const int p_snapshotVersion = 2;
 };
 }  //namespace network
 }  //namespace gridpack
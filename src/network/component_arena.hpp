@@ -0,0 +1,151 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   component_arena.hpp
+ * @date   2026-10-19
+ *
+ * @brief
+ * Contiguous storage for network components. All buses (or all branches)
+ * on a process are placed in a single block of memory in local index order
+ * so that loops over components in the mappers and factories walk through
+ * memory sequentially.
+ */
+// -------------------------------------------------------------
+
+#ifndef _component_arena_hpp_
+#define _component_arena_hpp_
+
+#include <new>
+#include <cstdio>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include "gridpack/utilities/exception.hpp"
+
+namespace gridpack {
+namespace network {
+
+// -------------------------------------------------------------
+//  class ComponentArena
+// -------------------------------------------------------------
+/**
+ * Fixed size block of components of a single type. Components are copy
+ * constructed into the block with add() and are destroyed, in reverse
+ * order, when the arena is destroyed. Pointers returned by add() share
+ * ownership of the whole arena (see share()), so the block is released
+ * only after the last component in it is no longer referenced. Components
+ * must be copy constructible and must not own resources that are released
+ * by their destructor through raw pointers.
+ */
+template <class _component>
+class ComponentArena {
+public:
+
+  typedef boost::shared_ptr<ComponentArena<_component> > ArenaPtr;
+  typedef boost::shared_ptr<_component> ComponentPtr;
+
+  /**
+   * Constructor
+   * @param capacity number of components that can be stored in the arena
+   */
+  explicit ComponentArena(int capacity)
+    : p_data(NULL), p_capacity(capacity), p_size(0)
+  {
+    if (p_capacity < 0) {
+      char buf[256];
+      sprintf(buf,"ComponentArena: illegal capacity %d\n",p_capacity);
+      throw gridpack::Exception(buf);
+    }
+    if (p_capacity > 0) {
+      p_data = static_cast<_component*>(
+          ::operator new(static_cast<size_t>(p_capacity)*sizeof(_component)));
+    }
+  }
+
+  /**
+   * Destructor
+   */
+  ~ComponentArena(void)
+  {
+    while (p_size > 0) {
+      p_size--;
+      p_data[p_size].~_component();
+    }
+    if (p_data) ::operator delete(p_data);
+  }
+
+  /**
+   * Copy a component into the next free slot of the arena
+   * @param component component that is copied
+   * @return pointer to new component
+   */
+  _component* add(const _component &component)
+  {
+    if (p_size >= p_capacity) {
+      char buf[256];
+      sprintf(buf,"ComponentArena: capacity %d exceeded\n",p_capacity);
+      throw gridpack::Exception(buf);
+    }
+    _component *ptr = new (p_data+p_size) _component(component);
+    p_size++;
+    return ptr;
+  }
+
+  /**
+   * Create a shared pointer to a component in the arena. The pointer keeps
+   * the entire arena alive
+   * @param arena pointer to arena that holds component
+   * @param ptr component stored in arena
+   * @return shared pointer to component
+   */
+  static ComponentPtr share(const ArenaPtr &arena, _component *ptr)
+  {
+    return ComponentPtr(arena, ptr);
+  }
+
+  /**
+   * Number of components in arena
+   */
+  int size(void) const
+  {
+    return p_size;
+  }
+
+  /**
+   * Maximum number of components that can be held in arena
+   */
+  int capacity(void) const
+  {
+    return p_capacity;
+  }
+
+  /**
+   * Pointer to the first component in the arena
+   */
+  _component* data(void) const
+  {
+    return p_data;
+  }
+
+private:
+
+  // Arenas are referenced through shared pointers and are never copied
+  ComponentArena(const ComponentArena&);
+  ComponentArena& operator=(const ComponentArena&);
+
+  // uninitialized storage for p_capacity components
+  _component *p_data;
+
+  // number of components that can be stored
+  int p_capacity;
+
+  // number of components that have been constructed
+  int p_size;
+};
+
+} // network
+} // gridpack
+#endif
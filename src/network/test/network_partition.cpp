@@ -14,6 +14,9 @@
  */
 
 #include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
 #include <ga++.h>
 #include <boost/mpi/environment.hpp>
 #include <boost/mpi/communicator.hpp>
@@ -230,6 +233,212 @@ public:
 
 
 
+typedef gridpack::network::BaseNetwork<BogusBus, BogusBranch> BogusBaseNetwork;
+
+/**
+ * Check that two networks have the same buses and branches in the same
+ * local order, with the same indices, ghost status and neighbors, and that
+ * the components of the second network are connected to each other
+ */
+static bool sameLocalNetwork(BogusBaseNetwork &net1, BogusBaseNetwork &net2)
+{
+  if (net1.numBuses() != net2.numBuses() ||
+      net1.numBranches() != net2.numBranches()) return false;
+  bool ok = true;
+  for (int b = 0; b < net1.numBuses(); ++b) {
+    if (net1.getActiveBus(b) != net2.getActiveBus(b) ||
+        net1.getOriginalBusIndex(b) != net2.getOriginalBusIndex(b) ||
+        net1.getGlobalBusIndex(b) != net2.getGlobalBusIndex(b) ||
+        net1.getConnectedBranches(b) != net2.getConnectedBranches(b) ||
+        net1.getConnectedBuses(b) != net2.getConnectedBuses(b)) ok = false;
+  }
+  for (int b = 0; b < net1.numBranches(); ++b) {
+    int bus1, bus2, bus3, bus4;
+    net1.getBranchEndpoints(b, &bus1, &bus2);
+    net2.getBranchEndpoints(b, &bus3, &bus4);
+    if (bus1 != bus3 || bus2 != bus4) ok = false;
+    net1.getOriginalBranchEndpoints(b, &bus1, &bus2);
+    net2.getOriginalBranchEndpoints(b, &bus3, &bus4);
+    if (bus1 != bus3 || bus2 != bus4) ok = false;
+    if (net1.getActiveBranch(b) != net2.getActiveBranch(b) ||
+        net1.getGlobalBranchIndex(b) != net2.getGlobalBranchIndex(b)) {
+      ok = false;
+    }
+    net2.getBranchEndpoints(b, &bus1, &bus2);
+    if (net2.getBranch(b)->getBus1().get() != net2.getBus(bus1).get() ||
+        net2.getBranch(b)->getBus2().get() != net2.getBus(bus2).get()) {
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+/**
+ * Check that a distributed network is the lattice created by
+ * BogusLatticeNetwork: every lattice branch is active on exactly one
+ * process, both ends of every local branch are local buses and every
+ * active bus is connected to its lattice neighbors. This is collective
+ */
+static bool latticeConnected(BogusBaseNetwork &net, int rows, int cols)
+{
+  bool ok = true;
+  int nbus = rows*cols;
+  // branch (a,a+cols) has key 2*a and branch (a,a+1) has key 2*a+1
+  std::vector<int> count(2*nbus, 0);
+  for (int b = 0; b < net.numBranches(); ++b) {
+    int bus1, bus2, orig1, orig2;
+    net.getBranchEndpoints(b, &bus1, &bus2);
+    if (bus1 < 0 || bus1 >= net.numBuses() ||
+        bus2 < 0 || bus2 >= net.numBuses()) {
+      ok = false;
+      continue;
+    }
+    net.getOriginalBranchEndpoints(b, &orig1, &orig2);
+    if (net.getOriginalBusIndex(bus1) != orig1 ||
+        net.getOriginalBusIndex(bus2) != orig2) ok = false;
+    if (net.getBranch(b)->getBus1().get() != net.getBus(bus1).get() ||
+        net.getBranch(b)->getBus2().get() != net.getBus(bus2).get()) {
+      ok = false;
+    }
+    int lo = std::min(orig1, orig2), hi = std::max(orig1, orig2);
+    if (lo < 0 || hi >= nbus || (hi-lo != cols && hi-lo != 1)) {
+      ok = false;
+    } else if (net.getActiveBranch(b)) {
+      count[2*lo + (hi-lo == cols ? 0 : 1)]++;
+    }
+  }
+  net.communicator().sum(&count[0], 2*nbus);
+  for (int a = 0; a < nbus; ++a) {
+    int down = (a/cols < rows-1 ? 1 : 0);
+    int right = (a%cols < cols-1 ? 1 : 0);
+    if (count[2*a] != down || count[2*a+1] != right) ok = false;
+  }
+  for (int b = 0; b < net.numBuses(); ++b) {
+    if (!net.getActiveBus(b)) continue;
+    int a = net.getOriginalBusIndex(b);
+    std::vector<int> expected, found;
+    if (a/cols > 0) expected.push_back(a-cols);
+    if (a%cols > 0) expected.push_back(a-1);
+    if (a%cols < cols-1) expected.push_back(a+1);
+    if (a/cols < rows-1) expected.push_back(a+cols);
+    std::vector<int> buses = net.getConnectedBuses(b);
+    for (size_t i = 0; i < buses.size(); ++i) {
+      found.push_back(net.getOriginalBusIndex(buses[i]));
+    }
+    std::sort(found.begin(), found.end());
+    if (found != expected) ok = false;
+  }
+  return ok;
+}
+
+/**
+ * Find the process that owns each bus, by original index. Returns false
+ * if any of the nbus buses is not owned by exactly one process. This is
+ * collective
+ */
+static bool busOwners(BogusBaseNetwork &net, int nbus,
+    std::vector<int> &owner)
+{
+  int me = net.communicator().rank();
+  std::vector<int> count(nbus, 0);
+  owner.assign(nbus, 0);
+  bool ok = true;
+  for (int b = 0; b < net.numBuses(); ++b) {
+    if (!net.getActiveBus(b)) continue;
+    int a = net.getOriginalBusIndex(b);
+    if (a < 0 || a >= nbus) {
+      ok = false;
+      continue;
+    }
+    count[a]++;
+    owner[a] += me;
+  }
+  net.communicator().sum(&count[0], nbus);
+  net.communicator().sum(&owner[0], nbus);
+  for (int a = 0; a < nbus; ++a) {
+    if (count[a] != 1) ok = false;
+  }
+  return ok;
+}
+
+/**
+ * Check that the ghost buses on this process are owned by some other
+ * process and are neighbors of a local bus, and that every branch
+ * touches at least one local bus
+ */
+static bool ghostsPlaced(BogusBaseNetwork &net, const std::vector<int> &owner)
+{
+  int me = net.communicator().rank();
+  bool ok = true;
+  for (int b = 0; b < net.numBuses(); ++b) {
+    int a = net.getOriginalBusIndex(b);
+    if (a < 0 || a >= static_cast<int>(owner.size())) {
+      ok = false;
+      continue;
+    }
+    if (net.getActiveBus(b)) {
+      if (owner[a] != me) ok = false;
+      continue;
+    }
+    if (owner[a] == me) ok = false;
+    std::vector<int> buses = net.getConnectedBuses(b);
+    bool local = false;
+    for (size_t i = 0; i < buses.size(); ++i) {
+      if (net.getActiveBus(buses[i])) local = true;
+    }
+    if (!local) ok = false;
+  }
+  for (int b = 0; b < net.numBranches(); ++b) {
+    int bus1, bus2;
+    net.getBranchEndpoints(b, &bus1, &bus2);
+    if (!net.getActiveBus(bus1) && !net.getActiveBus(bus2)) ok = false;
+  }
+  return ok;
+}
+
+/**
+ * Check that a network holds the same local buses and branches, in the
+ * same order and with the same indices, ghost status and neighbors, on
+ * every process of peers. This is collective on peers
+ */
+static bool samePeerNetwork(BogusBaseNetwork &net,
+    const gridpack::parallel::Communicator &peers)
+{
+  std::vector<int> sig;
+  sig.push_back(net.numBuses());
+  sig.push_back(net.numBranches());
+  for (int b = 0; b < net.numBuses(); ++b) {
+    sig.push_back(net.getActiveBus(b) ? 1 : 0);
+    sig.push_back(net.getOriginalBusIndex(b));
+    sig.push_back(net.getGlobalBusIndex(b));
+    std::vector<int> branches = net.getConnectedBranches(b);
+    std::vector<int> buses = net.getConnectedBuses(b);
+    sig.push_back(branches.size());
+    sig.insert(sig.end(), branches.begin(), branches.end());
+    sig.push_back(buses.size());
+    sig.insert(sig.end(), buses.begin(), buses.end());
+  }
+  for (int b = 0; b < net.numBranches(); ++b) {
+    int bus1, bus2, orig1, orig2;
+    net.getBranchEndpoints(b, &bus1, &bus2);
+    net.getOriginalBranchEndpoints(b, &orig1, &orig2);
+    sig.push_back(net.getActiveBranch(b) ? 1 : 0);
+    sig.push_back(net.getGlobalBranchIndex(b));
+    sig.push_back(bus1);
+    sig.push_back(bus2);
+    sig.push_back(orig1);
+    sig.push_back(orig2);
+  }
+  int nmin = sig.size(), nmax = sig.size();
+  peers.min(&nmin, 1);
+  peers.max(&nmax, 1);
+  if (nmin != nmax) return false;
+  std::vector<int> smin(sig), smax(sig);
+  peers.min(&smin[0], nmin);
+  peers.max(&smax[0], nmax);
+  return smin == sig && smax == sig;
+}
+
 BOOST_AUTO_TEST_SUITE ( NetworkTest ) 
 
 BOOST_AUTO_TEST_CASE ( bus_data_serialization )
@@ -246,6 +455,7 @@ BOOST_AUTO_TEST_CASE ( bus_data_serialization )
     bus1.p_globalBusIndex = an_int_value;
     bus1.p_branchNeighbors.push_back(an_int_value);
     bus1.p_refFlag = true;
+    bus1.p_weight = an_int_value;
     bus1.p_bus->setReferenceBus(true);
 
     boost::shared_ptr<gridpack::component::DataCollection> 
@@ -260,6 +470,7 @@ BOOST_AUTO_TEST_CASE ( bus_data_serialization )
   BOOST_CHECK_EQUAL(bus1.p_globalBusIndex, an_int_value);
   BOOST_CHECK_EQUAL(bus1.p_branchNeighbors.back(), an_int_value);
   BOOST_CHECK(bus1.p_refFlag);
+  BOOST_CHECK_EQUAL(bus1.p_weight, an_int_value);
   BOOST_CHECK(bus1.p_data);
   BOOST_CHECK(bus1.p_bus->getReferenceBus());
 
@@ -426,6 +637,351 @@ BOOST_AUTO_TEST_CASE ( lattice_partition )
   net.writeGraph("lattice-after.dot");
 }
 
+BOOST_AUTO_TEST_CASE ( lattice_repartition )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(5), cols(5);
+  int nbus(rows*cols);
+  BogusLatticeNetwork net(world, rows, cols);
+
+  net.partition();
+
+  int allbuses(net.totalBuses());
+  int allbranches(net.totalBranches());
+  BOOST_CHECK_EQUAL(allbuses, nbus);
+  std::vector<int> before, after;
+  BOOST_CHECK(busOwners(net, nbus, before));
+
+  // the network is already balanced, so repartitioning should not
+  // lose or duplicate anything, and the buses that moved are the ones
+  // whose owner changed
+  int moved(net.repartition());
+  BOOST_CHECK(moved >= 0);
+  BOOST_CHECK(moved <= allbuses);
+  BOOST_CHECK_EQUAL(net.totalBuses(), allbuses);
+  BOOST_CHECK_EQUAL(net.totalBranches(), allbranches);
+  BOOST_CHECK(busOwners(net, nbus, after));
+  int changed(0);
+  for (int a = 0; a < nbus; ++a) {
+    if (before[a] != after[a]) changed++;
+  }
+  BOOST_CHECK_EQUAL(moved, changed);
+  BOOST_CHECK(ghostsPlaced(net, after));
+  BOOST_CHECK(latticeConnected(net, rows, cols));
+
+  // make the first row of buses much more expensive, so buses have to
+  // move to restore the balance
+  for (int b = 0; b < net.numBuses(); ++b) {
+    if (net.getOriginalBusIndex(b) < cols) net.setBusWeight(b, 10);
+  }
+  before = after;
+  moved = net.repartition();
+  BOOST_CHECK_EQUAL(net.totalBuses(), allbuses);
+  BOOST_CHECK_EQUAL(net.totalBranches(), allbranches);
+  BOOST_CHECK(busOwners(net, nbus, after));
+  changed = 0;
+  for (int a = 0; a < nbus; ++a) {
+    if (before[a] != after[a]) changed++;
+  }
+  BOOST_CHECK_EQUAL(moved, changed);
+  if (world.size() == 1) BOOST_CHECK_EQUAL(moved, 0);
+  BOOST_CHECK(ghostsPlaced(net, after));
+  BOOST_CHECK(latticeConnected(net, rows, cols));
+
+  // weights travel with the buses that moved
+  for (int b = 0; b < net.numBuses(); ++b) {
+    if (!net.getActiveBus(b)) continue;
+    int weight(net.getOriginalBusIndex(b) < cols ? 10 : 1);
+    BOOST_CHECK_EQUAL(net.getBusWeight(b), weight);
+  }
+
+  net.writeGraph("lattice-repartition.dot");
+}
+
+BOOST_AUTO_TEST_CASE ( lattice_weighted_partition )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(5), cols(5);
+  BogusLatticeNetwork net(world, rows, cols);
+
+  // make the first row of buses much more expensive than the rest
+  for (int b = 0; b < net.numBuses(); ++b) {
+    if (net.getOriginalBusIndex(b) < cols) {
+      BOOST_CHECK(net.setBusWeight(b, 10));
+    }
+  }
+  BOOST_CHECK(!net.setBusWeight(net.numBuses(), 10));
+
+  // give the branches along the first row a weight that depends on
+  // where they are
+  for (int b = 0; b < net.numBranches(); ++b) {
+    int bus1, bus2;
+    net.getOriginalBranchEndpoints(b, &bus1, &bus2);
+    if (bus1 < cols && bus2 < cols) {
+      BOOST_CHECK(net.setBranchWeight(b, 3+std::min(bus1, bus2)));
+    }
+  }
+
+  net.partition();
+
+  BOOST_CHECK_EQUAL(net.totalBuses(), rows*cols);
+
+  // weights travel with the buses
+  for (int b = 0; b < net.numBuses(); ++b) {
+    if (net.getOriginalBusIndex(b) < cols) {
+      BOOST_CHECK_EQUAL(net.getBusWeight(b), 10);
+    } else {
+      BOOST_CHECK_EQUAL(net.getBusWeight(b), 1);
+    }
+  }
+  // so do the branch weights, and the other branches keep the default
+  // edge weight
+  for (int b = 0; b < net.numBranches(); ++b) {
+    int bus1, bus2;
+    net.getOriginalBranchEndpoints(b, &bus1, &bus2);
+    if (bus1 < cols && bus2 < cols) {
+      BOOST_CHECK_EQUAL(net.getBranchWeight(b), 3+std::min(bus1, bus2));
+    } else {
+      BOOST_CHECK_EQUAL(net.getBranchWeight(b), 2);
+    }
+  }
+
+  // the weighted load is the sum of the bus weights that each process
+  // owns
+  std::vector<int> load(world.size(), 0);
+  for (int b = 0; b < net.numBuses(); ++b) {
+    if (net.getActiveBus(b)) load[world.rank()] += net.getBusWeight(b);
+  }
+  world.sum(&load[0], world.size());
+  int total(0), lmax(0);
+  for (int p = 0; p < world.size(); ++p) {
+    total += load[p];
+    lmax = std::max(lmax, load[p]);
+  }
+  BOOST_CHECK_EQUAL(total, 10*cols + (rows-1)*cols);
+
+  double imbalance(net.loadImbalance());
+  BOOST_CHECK(imbalance >= 1.0);
+  BOOST_CHECK_CLOSE(imbalance, static_cast<double>(lmax*world.size())/
+                    static_cast<double>(total), 1.0e-8);
+  if (world.size() == 1) {
+    BOOST_CHECK_CLOSE(imbalance, 1.0, 1.0e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE ( lattice_arena_partition )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(5), cols(5);
+  BogusLatticeNetwork net(world, rows, cols);
+
+  net.setArenaAllocation(true);
+  BOOST_CHECK(net.getArenaAllocation());
+  net.partition();
+  BOOST_CHECK_EQUAL(net.totalBuses(), rows*cols);
+
+  // buses and branches are contiguous and in local index order, with
+  // ghosts last
+  int nbus(net.numBuses()), nbranch(net.numBranches());
+  for (int b = 1; b < nbus; ++b) {
+    BOOST_CHECK(net.getBus(b).get() == net.getBus(b-1).get() + 1);
+    if (net.getActiveBus(b)) {
+      BOOST_CHECK(net.getActiveBus(b-1));
+    }
+  }
+  for (int b = 1; b < nbranch; ++b) {
+    BOOST_CHECK(net.getBranch(b).get() == net.getBranch(b-1).get() + 1);
+  }
+
+  // connections refer to the components in the arena
+  for (int b = 0; b < nbranch; ++b) {
+    int bus1, bus2;
+    net.getBranchEndpoints(b, &bus1, &bus2);
+    BOOST_CHECK(net.getBranch(b)->getBus1().get() == net.getBus(bus1).get());
+    BOOST_CHECK(net.getBranch(b)->getBus2().get() == net.getBus(bus2).get());
+  }
+
+  // components are moved to new arenas when the network is repartitioned
+  net.repartition();
+  BOOST_CHECK_EQUAL(net.totalBuses(), rows*cols);
+  nbus = net.numBuses();
+  for (int b = 1; b < nbus; ++b) {
+    BOOST_CHECK(net.getBus(b).get() == net.getBus(b-1).get() + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE ( lattice_snapshot )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(5), cols(5);
+  BogusLatticeNetwork net(world, rows, cols);
+  net.partition();
+  net.saveSnapshot("lattice.snp", false, "lattice 5x5");
+
+  // with the same number of processes, every process gets back exactly
+  // its own buses and branches, including ghosts
+  BogusBaseNetwork copy(world);
+  BOOST_CHECK(copy.loadSnapshot("lattice.snp", "lattice 5x5"));
+  BOOST_CHECK(sameLocalNetwork(net, copy));
+  BOOST_CHECK(latticeConnected(copy, rows, cols));
+
+  // snapshots made from a different source are not used
+  BogusBaseNetwork stale(world);
+  BOOST_CHECK(!stale.loadSnapshot("lattice.snp", "lattice 6x6"));
+  BOOST_CHECK_EQUAL(stale.numBuses(), 0);
+  BOOST_CHECK_EQUAL(stale.numBranches(), 0);
+  BOOST_CHECK(stale.loadSnapshot("lattice.snp"));
+  BOOST_CHECK(sameLocalNetwork(net, stale));
+  BogusBaseNetwork missing(world);
+  BOOST_CHECK(!missing.loadSnapshot("no-such-lattice.snp"));
+}
+
+BOOST_AUTO_TEST_CASE ( lattice_snapshot_resize )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(5), cols(5);
+  int nbranch(2*rows*cols - rows - cols);
+
+  // write a snapshot on the first half of the processes and read it on
+  // all of them. On a single process both halves are the same and the
+  // snapshot is read back without partitioning
+  int half((world.size()+1)/2);
+  int color(world.rank() < half ? 0 : 1);
+  gridpack::parallel::Communicator group = world.split(color);
+  if (color == 0) {
+    BogusLatticeNetwork net(group, rows, cols);
+    net.partition();
+    net.saveSnapshot("lattice-half.snp");
+  }
+  world.barrier();
+  BogusBaseNetwork all(world);
+  BOOST_CHECK(all.loadSnapshot("lattice-half.snp"));
+  BOOST_CHECK_EQUAL(all.totalBuses(), rows*cols);
+  BOOST_CHECK_EQUAL(all.totalBranches(), nbranch);
+  BOOST_CHECK(latticeConnected(all, rows, cols));
+
+  // and back from all processes to the first half
+  all.saveSnapshot("lattice-all.snp");
+  world.barrier();
+  if (color == 0) {
+    BogusBaseNetwork net(group);
+    BOOST_CHECK(net.loadSnapshot("lattice-all.snp"));
+    BOOST_CHECK_EQUAL(net.totalBuses(), rows*cols);
+    BOOST_CHECK_EQUAL(net.totalBranches(), nbranch);
+    BOOST_CHECK(latticeConnected(net, rows, cols));
+  }
+}
+
+BOOST_AUTO_TEST_CASE ( lattice_replicate )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(5), cols(5);
+  int nbranch(2*rows*cols - rows - cols);
+  int me(world.rank());
+
+  // split the processes into two groups of the same size. If the number of
+  // processes is odd, the last process sits this part out. Only the first
+  // group partitions the lattice and it is copied to the second group
+  int half(world.size()/2);
+  gridpack::parallel::Communicator active =
+    world.split(me < 2*half ? 0 : 1);
+  if (half > 0 && me < 2*half) {
+    int color(me < half ? 0 : 1);
+    gridpack::parallel::Communicator group = active.split(color);
+    boost::shared_ptr<BogusBaseNetwork> net;
+    if (color == 0) {
+      net.reset(new BogusLatticeNetwork(group, rows, cols));
+      net->partition();
+    } else {
+      net.reset(new BogusBaseNetwork(group));
+    }
+    gridpack::parallel::Communicator peers = active.split(group.rank());
+    int root(color == 0 ? peers.rank() : -1);
+    peers.max(&root, 1);
+    net->replicate(peers, root);
+
+    // each replica has exactly the local and ghost buses and branches of
+    // its counterpart in the first group
+    BOOST_CHECK(samePeerNetwork(*net, peers));
+    BOOST_CHECK_EQUAL(net->totalBuses(), rows*cols);
+    BOOST_CHECK_EQUAL(net->totalBranches(), nbranch);
+    BOOST_CHECK(latticeConnected(*net, rows, cols));
+  }
+  world.barrier();
+
+  // groups of different sizes cannot be matched process by process. The
+  // first process forms a group by itself and is paired with the first
+  // process of the group holding all the others
+  if (world.size() > 2) {
+    int color(me == 0 ? 0 : 1);
+    gridpack::parallel::Communicator group = world.split(color);
+    gridpack::parallel::Communicator peers =
+      world.split(group.rank() == 0 ? 0 : me);
+    boost::shared_ptr<BogusBaseNetwork> net;
+    if (color == 0) {
+      net.reset(new BogusLatticeNetwork(group, rows, cols));
+    } else {
+      net.reset(new BogusBaseNetwork(group));
+    }
+    if (peers.size() > 1) {
+      BOOST_CHECK_THROW(net->replicate(peers, 0), gridpack::Exception);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE ( chain_local_reordering )
+{
+  gridpack::parallel::Communicator world;
+  static const int local_size(20);
+  int global_buses(local_size*world.size());
+  gridpack::network::BaseNetwork<BogusBus, BogusBranch> net(world);
+
+  // a linear network with buses added in scrambled order, so the local
+  // order after partitioning has no relation to the connections
+  if (world.rank() == 0) {
+    std::vector<int> busidx(global_buses);
+    for (int i = 0; i < global_buses; ++i) busidx[i] = i;
+    for (int i = global_buses-1; i > 0; --i) {
+      std::swap(busidx[i], busidx[(7*i+3)%(i+1)]);
+    }
+    for (int b = 0; b < global_buses; ++b) {
+      net.addBus(busidx[b]);
+      net.setGlobalBusIndex(b, busidx[b]);
+    }
+    for (int b = 0; b < global_buses-1; ++b) {
+      net.addBranch(b, b+1);
+      net.setGlobalBranchIndex(b, b);
+      net.setGlobalBusIndex1(b, b);
+      net.setGlobalBusIndex2(b, b+1);
+    }
+  }
+
+  net.setLocalReordering(true);
+  BOOST_CHECK(net.getLocalReordering());
+  net.partition();
+  BOOST_CHECK_EQUAL(net.totalBuses(), global_buses);
+  BOOST_CHECK_EQUAL(net.totalBranches(), global_buses-1);
+
+  // ghosts are last
+  int nbus(net.numBuses()), nbranch(net.numBranches());
+  for (int b = 1; b < nbus; ++b) {
+    if (net.getActiveBus(b)) {
+      BOOST_CHECK(net.getActiveBus(b-1));
+    }
+  }
+
+  // active pieces of the chain are numbered consecutively, so the local
+  // bandwidth is one
+  for (int b = 0; b < nbranch; ++b) {
+    int bus1, bus2;
+    net.getBranchEndpoints(b, &bus1, &bus2);
+    BOOST_CHECK(net.getBranch(b)->getBus1().get() == net.getBus(bus1).get());
+    BOOST_CHECK(net.getBranch(b)->getBus2().get() == net.getBus(bus2).get());
+    if (net.getActiveBus(bus1) && net.getActiveBus(bus2)) {
+      BOOST_CHECK_EQUAL(std::abs(bus1-bus2), 1);
+    }
+  }
+}
 
 BOOST_AUTO_TEST_SUITE_END( )
 
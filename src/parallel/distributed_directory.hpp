@@ -0,0 +1,319 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   distributed_directory.hpp
+ * @date   2026-10-19
+ *
+ * @brief
+ * A distributed directory that stores key-value pairs on the process that
+ * owns the key, together with the sparse all-to-all exchange used to move
+ * data to and from the owners. Ownership of a key is determined by
+ * consistent hashing, so any process can compute the owner of any key
+ * without communication. All operations that move data are collective.
+ */
+// -------------------------------------------------------------
+
+#ifndef _distributed_directory_hpp_
+#define _distributed_directory_hpp_
+
+#include <vector>
+#include <utility>
+#include <climits>
+#include <cstring>
+#include <cstdio>
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
+#include "gridpack/parallel/communicator.hpp"
+#include "gridpack/utilities/exception.hpp"
+
+namespace gridpack {
+namespace parallel {
+
+/**
+ * Exchange blocks of bytes between all processes in a single round. The
+ * send buffer contains the data for each destination process in rank
+ * order. Sizes are exchanged with MPI_Alltoall and the data with
+ * MPI_Alltoallv, so only processes that actually exchange data move
+ * anything.
+ * @param comm communicator over which data is exchanged
+ * @param sendbuf data for all destinations, ordered by destination rank
+ * @param sendbytes number of bytes going to each process
+ * @param recvbuf data received from all sources, ordered by source rank
+ * @param recvbytes number of bytes received from each process
+ */
+inline void exchangeBytes(const Communicator &comm,
+    const std::vector<char> &sendbuf, const std::vector<int> &sendbytes,
+    std::vector<char> &recvbuf, std::vector<int> &recvbytes)
+{
+  int nprocs = comm.size();
+  MPI_Comm mpicomm = static_cast<MPI_Comm>(comm);
+  recvbytes.assign(nprocs, 0);
+  int ierr = MPI_Alltoall(const_cast<int*>(&sendbytes[0]), 1, MPI_INT,
+      &recvbytes[0], 1, MPI_INT, mpicomm);
+  if (ierr != MPI_SUCCESS) {
+    throw gridpack::Exception("exchangeBytes: MPI_Alltoall failed");
+  }
+  std::vector<int> sdispls(nprocs, 0);
+  std::vector<int> rdispls(nprocs, 0);
+  size_t stotal = 0;
+  size_t rtotal = 0;
+  int p;
+  for (p=0; p<nprocs; p++) {
+    sdispls[p] = static_cast<int>(stotal);
+    rdispls[p] = static_cast<int>(rtotal);
+    stotal += sendbytes[p];
+    rtotal += recvbytes[p];
+    if (stotal > static_cast<size_t>(INT_MAX) ||
+        rtotal > static_cast<size_t>(INT_MAX)) {
+      throw gridpack::Exception("exchangeBytes: buffer exceeds MPI count limit");
+    }
+  }
+  recvbuf.resize(rtotal);
+  char dummy = 0;
+  ierr = MPI_Alltoallv(
+      (stotal > 0 ? const_cast<char*>(&sendbuf[0]) : &dummy),
+      const_cast<int*>(&sendbytes[0]), &sdispls[0], MPI_BYTE,
+      (rtotal > 0 ? &recvbuf[0] : &dummy),
+      &recvbytes[0], &rdispls[0], MPI_BYTE, mpicomm);
+  if (ierr != MPI_SUCCESS) {
+    throw gridpack::Exception("exchangeBytes: MPI_Alltoallv failed");
+  }
+}
+
+/**
+ * Send a list of fixed-size records to their destination processes in a
+ * single round. Records must be trivially copyable (plain structs, pairs
+ * of integers, etc.).
+ * @param comm communicator over which records are exchanged
+ * @param records records on this process
+ * @param dest destination process for each record
+ * @param recv records received by this process, ordered by source rank
+ * @param recvcount number of records received from each process
+ */
+template <typename Record>
+void exchangeRecords(const Communicator &comm,
+    const std::vector<Record> &records, const std::vector<int> &dest,
+    std::vector<Record> &recv, std::vector<int> &recvcount)
+{
+  int nprocs = comm.size();
+  int nrec = records.size();
+  if (static_cast<int>(dest.size()) != nrec) {
+    throw gridpack::Exception(
+        "exchangeRecords: records and destinations have different lengths");
+  }
+  // Bin records by destination with a counting sort
+  std::vector<int> sendcount(nprocs, 0);
+  int i;
+  for (i=0; i<nrec; i++) {
+    if (dest[i] < 0 || dest[i] >= nprocs) {
+      char buf[256];
+      sprintf(buf,"exchangeRecords: illegal destination %d\n",dest[i]);
+      throw gridpack::Exception(buf);
+    }
+    sendcount[dest[i]]++;
+  }
+  std::vector<int> offset(nprocs, 0);
+  for (i=1; i<nprocs; i++) {
+    offset[i] = offset[i-1] + sendcount[i-1];
+  }
+  const int rsize = sizeof(Record);
+  std::vector<char> sendbuf(static_cast<size_t>(nrec)*rsize);
+  for (i=0; i<nrec; i++) {
+    memcpy(&sendbuf[static_cast<size_t>(offset[dest[i]])*rsize],
+        &records[i], rsize);
+    offset[dest[i]]++;
+  }
+  std::vector<int> sendbytes(nprocs);
+  for (i=0; i<nprocs; i++) {
+    sendbytes[i] = sendcount[i]*rsize;
+  }
+  std::vector<char> recvbuf;
+  std::vector<int> recvbytes;
+  exchangeBytes(comm, sendbuf, sendbytes, recvbuf, recvbytes);
+  recvcount.resize(nprocs);
+  for (i=0; i<nprocs; i++) {
+    recvcount[i] = recvbytes[i]/rsize;
+  }
+  int nrecv = recvbuf.size()/rsize;
+  recv.resize(nrecv);
+  if (nrecv > 0) memcpy(static_cast<void*>(&recv[0]), &recvbuf[0],
+      recvbuf.size());
+}
+
+// -------------------------------------------------------------
+//  class DistributedDirectory
+// -------------------------------------------------------------
+/**
+ * Directory of key-value pairs distributed over all processes in a
+ * communicator. Each key is stored on the process returned by owner(),
+ * which is computed with jump consistent hashing so that keys are spread
+ * evenly and no lookup table is needed to find them. Keys may map to
+ * more than one value. Key and Value must be trivially copyable and Key
+ * must be hashable with boost::hash.
+ */
+template <typename Key, typename Value>
+class DistributedDirectory {
+public:
+
+  typedef std::pair<Key, Value> KeyValue;
+
+  /**
+   * Constructor
+   * @param comm communicator over which directory is distributed
+   */
+  DistributedDirectory(const Communicator &comm)
+    : p_comm(comm)
+  { }
+
+  /**
+   * Destructor
+   */
+  ~DistributedDirectory(void)
+  { }
+
+  /**
+   * Process that owns a key
+   * @param key key value
+   * @return rank of process that stores entries for key
+   */
+  int owner(const Key &key) const
+  {
+    return owner(key, p_comm.size());
+  }
+
+  /**
+   * Process that would own a key in a directory spread over nprocs
+   * processes. The result is the same on every process and, when nprocs
+   * is increased by one, a key either keeps its owner or moves to the new
+   * process
+   * @param key key value
+   * @param nprocs number of processes
+   * @return rank of process that stores entries for key
+   */
+  static int owner(const Key &key, int nprocs)
+  {
+    boost::hash<Key> hasher;
+    unsigned long long h = static_cast<unsigned long long>(hasher(key));
+    // Scramble bits so that consecutive integer keys are well separated
+    h += 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    h = h ^ (h >> 31);
+    // Jump consistent hash
+    long long b = -1, j = 0;
+    while (j < nprocs) {
+      b = j;
+      h = h * 2862933555777941757ULL + 1;
+      j = static_cast<long long>(static_cast<double>(b + 1) *
+          (static_cast<double>(1LL << 31) /
+           static_cast<double>((h >> 33) + 1)));
+    }
+    return static_cast<int>(b);
+  }
+
+  /**
+   * Remove all entries held by this process
+   */
+  void clear(void)
+  {
+    p_map.clear();
+  }
+
+  /**
+   * Add key-value pairs to the directory. This is collective.
+   * @param pairs key-value pairs contributed by this process
+   */
+  void insert(const std::vector<KeyValue> &pairs)
+  {
+    int i;
+    int npairs = pairs.size();
+    std::vector<int> dest(npairs);
+    for (i=0; i<npairs; i++) {
+      dest[i] = owner(pairs[i].first);
+    }
+    std::vector<KeyValue> recv;
+    std::vector<int> recvcount;
+    exchangeRecords(p_comm, pairs, dest, recv, recvcount);
+    int nrecv = recv.size();
+    for (i=0; i<nrecv; i++) {
+      p_map.insert(recv[i]);
+    }
+  }
+
+  /**
+   * Find values corresponding to a list of keys. This is collective. Keys
+   * that are not in the directory are dropped and keys that map to more
+   * than one value are repeated, once for each value.
+   * @param keys on input, the keys to look up. On output, the keys for
+   *        which a value was found
+   * @param values on output, the values corresponding to keys
+   */
+  void lookup(std::vector<Key> &keys, std::vector<Value> &values)
+  {
+    int i, j, p;
+    int nprocs = p_comm.size();
+    int nkeys = keys.size();
+    std::vector<int> dest(nkeys);
+    for (i=0; i<nkeys; i++) {
+      dest[i] = owner(keys[i]);
+    }
+    std::vector<Key> request;
+    std::vector<int> reqcount;
+    exchangeRecords(p_comm, keys, dest, request, reqcount);
+
+    // Answer requests. Requests arrive ordered by source rank, so the
+    // source of each request can be recovered from the counts
+    std::vector<KeyValue> reply;
+    std::vector<int> rdest;
+    typename MapType::const_iterator it;
+    j = 0;
+    for (p=0; p<nprocs; p++) {
+      for (i=0; i<reqcount[p]; i++) {
+        std::pair<typename MapType::const_iterator,
+          typename MapType::const_iterator> range
+            = p_map.equal_range(request[j]);
+        for (it = range.first; it != range.second; it++) {
+          reply.push_back(*it);
+          rdest.push_back(p);
+        }
+        j++;
+      }
+    }
+    std::vector<KeyValue> answer;
+    std::vector<int> anscount;
+    exchangeRecords(p_comm, reply, rdest, answer, anscount);
+    int nans = answer.size();
+    keys.resize(nans);
+    values.resize(nans);
+    for (i=0; i<nans; i++) {
+      keys[i] = answer[i].first;
+      values[i] = answer[i].second;
+    }
+  }
+
+  /**
+   * Number of entries stored on this process
+   */
+  int localSize(void) const
+  {
+    return p_map.size();
+  }
+
+private:
+
+  typedef boost::unordered_multimap<Key, Value, boost::hash<Key> > MapType;
+
+  Communicator p_comm;
+
+  MapType p_map;
+};
+
+} // namespace parallel
+} // namespace gridpack
+
+#endif
@@ -22,9 +22,9 @@
 #ifndef _hash_map_hpp_
 #define _hash_map_hpp_
 
-#include <map>
 #include <vector>
 #include "gridpack/parallel/communicator.hpp"
+#include "gridpack/parallel/distributed_directory.hpp"
 
 namespace gridpack {
 namespace hash_map {
@@ -65,27 +65,11 @@ public:
 
 private:
 
-  // hash function for indices. Maps the value of key into the interval
-  // [0,p_nprocs-1] where p_nprocs is the total number of processors
-  // @param key input value of key
-  // @return number between 0 and p_nprocs-1
-  int hashValue(int key);
-
-  // hash function for index pairs. Maps the value of key into the interval
-  // [0,p_nprocs-1] where p_nprocs is the total number of processors
-  // @param key input value of key
-  // @return number between 0 and nprocs-1
-  int pairHashValue(std::pair<int,int> key);
-
-  int p_nprocs;
-  int p_me;
-  int p_GAgrp;
-
-  MPI_Comm p_comm;
-
-  std::multimap<int, int> p_umap;
+  // key-value pairs are stored on the process that owns the key, as
+  // determined by consistent hashing
+  parallel::DistributedDirectory<int, int> p_umap;
   
-  std::multimap<std::pair<int,int>, int> p_pmap;
+  parallel::DistributedDirectory<std::pair<int,int>, int> p_pmap;
 };
 
 
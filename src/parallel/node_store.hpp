@@ -0,0 +1,308 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   node_store.hpp
+ * @date   2026-10-19
+ *
+ * @brief
+ * This is a utility that stores a collection of read-only vectors once per
+ * shared-memory node. All processes on a node read the same copy of the
+ * data directly out of an MPI-3 shared memory window, instead of each
+ * process keeping its own replicated copy.
+ */
+
+// -------------------------------------------------------------
+
+#ifndef _node_store_hpp_
+#define _node_store_hpp_
+
+#include <vector>
+#include <climits>
+#include <cstring>
+#include <cstdio>
+#include <mpi.h>
+#include "gridpack/utilities/exception.hpp"
+#include "gridpack/parallel/communicator.hpp"
+
+namespace gridpack {
+namespace parallel {
+
+// -------------------------------------------------------------
+//  class NodeStore
+// -------------------------------------------------------------
+/**
+ * The interface is the same as GlobalStore. Vectors are added with
+ * addVector on any process and upload is then called on all processes in
+ * the communicator. After upload, every vector is available on every
+ * process, but only one copy exists on each node. The data type must be
+ * a plain data type that can be copied with memcpy, and the data may not
+ * be modified after upload.
+ */
+template <typename _data_type >
+class NodeStore {
+private:
+  gridpack::parallel::Communicator p_comm;
+public:
+
+  /**
+   * Default constructor
+   * @param comm communicator over which NodeStore object runs.
+   *             Data is accessible from any process on the communicator
+   */
+  NodeStore(const gridpack::parallel::Communicator &comm)
+    : p_comm(comm)
+  {
+    p_me = comm.rank();
+    p_nprocs = comm.size();
+    p_numVecs = 0;
+    p_ndata = 0;
+    p_base = NULL;
+    p_uploaded = false;
+    p_nodeComm = MPI_COMM_NULL;
+    p_leaderComm = MPI_COMM_NULL;
+  }
+
+  /**
+   * Default destructor
+   */
+  ~NodeStore(void)
+  {
+    if (p_uploaded) {
+      MPI_Win_free(&p_win);
+    }
+    if (p_leaderComm != MPI_COMM_NULL) MPI_Comm_free(&p_leaderComm);
+    if (p_nodeComm != MPI_COMM_NULL) MPI_Comm_free(&p_nodeComm);
+  }
+
+  /**
+   * Add vector to NodeStore
+   * @param idx index of data in NodeStore
+   * @param vec standard vector containing data
+   */
+  void addVector(const int idx, const std::vector<_data_type> &vec)
+  {
+    if (p_uploaded) {
+      char buf[256];
+      sprintf(buf,"NodeStore::addVector called after upload on process %d\n",
+          p_me);
+      throw gridpack::Exception(buf);
+    }
+    p_index.push_back(idx);
+    p_data.push_back(vec);
+  }
+
+  /**
+   * Copy data that is held locally into the shared memory segment on each
+   * node. This must be called on all processes in the communicator
+   */
+  void upload()
+  {
+    // Find out maximum index and assume that this represents the total number
+    // of vectors added to NodeStore object. Indices without data have
+    // zero length
+    int max_idx = -1;
+    int i;
+    for (i=0; i<static_cast<int>(p_index.size()); i++) {
+      if (p_index[i] < 0) {
+        char buf[256];
+        sprintf(buf,"Index %d less than zero in NodeStore::upload on process %d\n",
+            p_index[i],p_me);
+        throw gridpack::Exception(buf);
+      }
+      if (p_index[i] > max_idx) max_idx = p_index[i];
+    }
+    p_comm.max(&max_idx,1);
+    p_numVecs = max_idx+1;
+
+    // Check to see if any indices have been used more than once and find
+    // the length of each vector
+    std::vector<int> count(p_numVecs+1,0);
+    std::vector<int> len(p_numVecs+1,0);
+    for (i=0; i<static_cast<int>(p_index.size()); i++) {
+      count[p_index[i]] += 1;
+      len[p_index[i]] = static_cast<int>(p_data[i].size());
+    }
+    if (p_numVecs > 0) {
+      p_comm.sum(&count[0],p_numVecs);
+      p_comm.sum(&len[0],p_numVecs);
+    }
+    for (i=0; i<p_numVecs; i++) {
+      if (count[i] > 1) {
+        char buf[256];
+        sprintf(buf,"Multiple vectors for index %d NodeStore::upload on process %d\n",
+            i,p_me);
+        throw gridpack::Exception(buf);
+      }
+    }
+    p_offset.resize(p_numVecs+1);
+    p_offset[0] = 0;
+    for (i=0; i<p_numVecs; i++) {
+      p_offset[i+1] = p_offset[i]+static_cast<MPI_Aint>(len[i]);
+    }
+    p_ndata = p_offset[p_numVecs];
+
+    // Create a communicator for the processes on each node and one for the
+    // lowest ranked process on each node
+    MPI_Comm comm = static_cast<MPI_Comm>(p_comm);
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, p_me, MPI_INFO_NULL,
+        &p_nodeComm);
+    int node_me;
+    MPI_Comm_rank(p_nodeComm, &node_me);
+    MPI_Comm_split(comm, (node_me == 0 ? 0 : MPI_UNDEFINED), p_me,
+        &p_leaderComm);
+
+    // Allocate the shared segment on the lowest ranked process on the node.
+    // The other processes allocate nothing and get a pointer to that segment
+    int dsize = static_cast<int>(sizeof(_data_type));
+    MPI_Aint nbytes = (node_me == 0 ? p_ndata*dsize : 0);
+    void *ptr;
+    int ierr = MPI_Win_allocate_shared(nbytes, dsize, MPI_INFO_NULL,
+        p_nodeComm, &ptr, &p_win);
+    if (ierr != MPI_SUCCESS) {
+      char buf[256];
+      sprintf(buf,"NodeStore::upload unable to allocate %ld bytes of"
+          " shared memory on process %d\n",static_cast<long>(nbytes),p_me);
+      throw gridpack::Exception(buf);
+    }
+    p_uploaded = true;
+    MPI_Aint qsize;
+    int qdisp;
+    MPI_Win_shared_query(p_win, 0, &qsize, &qdisp, &ptr);
+    p_base = static_cast<_data_type*>(ptr);
+
+    // Each process copies its own vectors into the segment on its node. The
+    // segments start out as zero so that a bitwise OR across nodes
+    // combines the contributions from all processes
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, p_win);
+    if (node_me == 0 && p_ndata > 0) {
+      memset(static_cast<void*>(p_base), 0, p_ndata*dsize);
+    }
+    nodeSync();
+    for (i=0; i<static_cast<int>(p_index.size()); i++) {
+      if (p_data[i].size() == 0) continue;
+      memcpy(static_cast<void*>(p_base+p_offset[p_index[i]]),
+          &(p_data[i])[0], p_data[i].size()*sizeof(_data_type));
+    }
+    nodeSync();
+    if (p_leaderComm != MPI_COMM_NULL) {
+      char *cbuf = reinterpret_cast<char*>(p_base);
+      MPI_Aint remaining = p_ndata*dsize;
+      while (remaining > 0) {
+        int chunk = (remaining > INT_MAX ? INT_MAX : static_cast<int>(remaining));
+        MPI_Allreduce(MPI_IN_PLACE, cbuf, chunk, MPI_BYTE, MPI_BOR,
+            p_leaderComm);
+        cbuf += chunk;
+        remaining -= chunk;
+      }
+    }
+    nodeSync();
+    MPI_Win_unlock_all(p_win);
+
+    p_data.clear();
+    p_index.clear();
+  }
+
+  /**
+   * Number of vectors in NodeStore
+   * @return number of vectors
+   */
+  int numVectors(void) const
+  {
+    return p_numVecs;
+  }
+
+  /**
+   * Get length of vector corresponding to index idx
+   * @param idx index of stored vector
+   * @return number of elements in vector
+   */
+  int getSize(const int idx) const
+  {
+    checkIndex(idx,"getSize");
+    return static_cast<int>(p_offset[idx+1]-p_offset[idx]);
+  }
+
+  /**
+   * Get a pointer to vector corresponding to index idx. The pointer refers
+   * directly to the shared memory segment on the node and remains valid
+   * until the NodeStore is destroyed
+   * @param idx index of stored vector
+   * @return pointer to first element of vector
+   */
+  const _data_type* getData(const int idx) const
+  {
+    checkIndex(idx,"getData");
+    return p_base+p_offset[idx];
+  }
+
+  /**
+   * Get copy of vector corresponding to index idx from NodeStore
+   * @param idx index of stored vector
+   * @param vec vector of returned values
+   */
+  void getVector(const int idx, std::vector<_data_type> &vec) const
+  {
+    checkIndex(idx,"getVector");
+    vec.assign(p_base+p_offset[idx],p_base+p_offset[idx+1]);
+  }
+
+private:
+
+  /**
+   * Make sure that index is in range and data has been uploaded
+   * @param idx index of stored vector
+   * @param name name of calling function
+   */
+  void checkIndex(const int idx, const char *name) const
+  {
+    if (!p_uploaded || idx < 0 || idx >= p_numVecs) {
+      char buf[256];
+      sprintf(buf,"Requested vector index %d in NodeStore::%s out of range"
+          " on process %d\n",idx,name,p_me);
+      throw gridpack::Exception(buf);
+    }
+  }
+
+  /**
+   * Make writes to the shared segment visible to all processes on the node
+   */
+  void nodeSync(void)
+  {
+    MPI_Win_sync(p_win);
+    MPI_Barrier(p_nodeComm);
+    MPI_Win_sync(p_win);
+  }
+
+  int p_me;
+
+  int p_nprocs;
+
+  int p_numVecs;
+
+  MPI_Aint p_ndata;
+
+  bool p_uploaded;
+
+  std::vector<int> p_index;
+
+  std::vector<std::vector<_data_type> > p_data;
+
+  std::vector<MPI_Aint> p_offset;
+
+  MPI_Comm p_nodeComm;
+
+  MPI_Comm p_leaderComm;
+
+  MPI_Win p_win;
+
+  _data_type *p_base;
+};
+
+} // namespace parallel
+} // namespace gridpack
+#endif
@@ -13,7 +13,9 @@
  * @brief  
  * This is a wrapper for a random number generator. The current implementation
  * relies on the standard random number generator in C++ and all the caveats
- * that apply to default random number generators should be noted.
+ * that apply to default random number generators should be noted. A
+ * counter-based generator that is independent of the processor count is
+ * also provided.
  * 
  */
 
@@ -114,5 +116,205 @@ double Random::Random::grand(void)
   return 0.0;
 }
 
+// -------------------------------------------------------------
+//  class CounterRandom
+// -------------------------------------------------------------
+
+// Philox4x32 multipliers and Weyl sequence constants
+static const boost::uint32_t PHILOX_M0 = 0xD2511F53;
+static const boost::uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const boost::uint32_t PHILOX_W0 = 0x9E3779B9;
+static const boost::uint32_t PHILOX_W1 = 0xBB67AE85;
+
+// Scale factor for converting 53 random bits to a double in [0,1)
+static const double TWO_M53 = 1.0/9007199254740992.0;
+
+static const double TWO_PI = 6.283185307179586476925286766559;
+
+/**
+ * Constructor
+ * @param seed random number generator initialization
+ */
+CounterRandom::CounterRandom(int seed)
+{
+  this->seed(seed);
+}
+
+/**
+ * Default destructor
+ */
+CounterRandom::~CounterRandom(void)
+{
+}
+
+/**
+ * Reinitialize generator with a new seed. The stream is set back to
+ * (0,0,0)
+ * @param seed random number generator initialization
+ */
+void CounterRandom::seed(int seed)
+{
+  p_seed = static_cast<boost::uint32_t>(seed);
+  setStream(0,0,0);
+}
+
+/**
+ * Select a stream and go to its beginning
+ * @param id1 first stream identifier
+ * @param id2 second stream identifier
+ * @param id3 third stream identifier
+ */
+void CounterRandom::setStream(int id1, int id2, int id3)
+{
+  p_key[0] = p_seed;
+  p_key[1] = static_cast<boost::uint32_t>(id1);
+  p_id[0] = static_cast<boost::uint32_t>(id2);
+  p_id[1] = static_cast<boost::uint32_t>(id3);
+  p_pos = 0;
+}
+
+/**
+ * Set position in current stream
+ * @param pos index of next value to be returned
+ */
+void CounterRandom::setPosition(boost::uint64_t pos)
+{
+  p_pos = pos;
+}
+
+/**
+ * Apply the Philox4x32-10 bijection to a counter
+ * @param ctr 128 bit counter, overwritten with the result
+ * @param key 64 bit key
+ */
+void CounterRandom::philox(boost::uint32_t ctr[4],
+    const boost::uint32_t key[2])
+{
+  boost::uint32_t k0 = key[0];
+  boost::uint32_t k1 = key[1];
+  int i;
+  for (i=0; i<10; i++) {
+    boost::uint64_t p0 = static_cast<boost::uint64_t>(PHILOX_M0)*ctr[0];
+    boost::uint64_t p1 = static_cast<boost::uint64_t>(PHILOX_M1)*ctr[2];
+    boost::uint32_t hi0 = static_cast<boost::uint32_t>(p0>>32);
+    boost::uint32_t lo0 = static_cast<boost::uint32_t>(p0);
+    boost::uint32_t hi1 = static_cast<boost::uint32_t>(p1>>32);
+    boost::uint32_t lo1 = static_cast<boost::uint32_t>(p1);
+    ctr[0] = hi1^ctr[1]^k0;
+    ctr[1] = lo1;
+    ctr[2] = hi0^ctr[3]^k1;
+    ctr[3] = lo0;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+}
+
+/**
+ * Evaluate two uniform numbers for a block of the current stream
+ * @param block block index
+ * @param u1 first value in [0,1)
+ * @param u2 second value in [0,1)
+ */
+inline void CounterRandom::p_block(boost::uint64_t block, double &u1,
+    double &u2)
+{
+  boost::uint32_t ctr[4];
+  ctr[0] = static_cast<boost::uint32_t>(block);
+  ctr[1] = static_cast<boost::uint32_t>(block>>32);
+  ctr[2] = p_id[0];
+  ctr[3] = p_id[1];
+  philox(ctr, p_key);
+  u1 = (static_cast<double>(ctr[0]>>5)*67108864.0
+      + static_cast<double>(ctr[1]>>6))*TWO_M53;
+  u2 = (static_cast<double>(ctr[2]>>5)*67108864.0
+      + static_cast<double>(ctr[3]>>6))*TWO_M53;
+}
+
+/**
+ * Return a double precision random number in the range [0,1)
+ */
+double CounterRandom::drand(void)
+{
+  double u1, u2;
+  p_block(p_pos>>1, u1, u2);
+  double ret = (p_pos&1) ? u2 : u1;
+  p_pos++;
+  return ret;
+}
+
+/**
+ * Return a double precision random number from a gaussian distribution with
+ * unit variance
+ */
+double CounterRandom::grand(void)
+{
+  double u1, u2;
+  p_block(p_pos>>1, u1, u2);
+  double r = sqrt(-2.0*log(1.0-u1));
+  double ret = (p_pos&1) ? r*sin(TWO_PI*u2) : r*cos(TWO_PI*u2);
+  p_pos++;
+  return ret;
+}
+
+/**
+ * Fill an array with uniform random numbers in the range [0,1)
+ * @param x array of values
+ * @param n number of values
+ */
+void CounterRandom::fillUniform(double *x, int n)
+{
+  if (n <= 0) return;
+  boost::uint64_t first = p_pos>>1;
+  int nblock = static_cast<int>(((p_pos+n-1)>>1) - first) + 1;
+  p_u1.resize(nblock);
+  p_u2.resize(nblock);
+  int i;
+  for (i=0; i<nblock; i++) {
+    p_block(first+i, p_u1[i], p_u2[i]);
+  }
+  int off = static_cast<int>(p_pos&1);
+  for (i=0; i<n; i++) {
+    int j = i+off;
+    x[i] = (j&1) ? p_u2[j>>1] : p_u1[j>>1];
+  }
+  p_pos += n;
+}
+
+/**
+ * Fill an array with random numbers from a gaussian distribution with unit
+ * variance
+ * @param x array of values
+ * @param n number of values
+ */
+void CounterRandom::fillGaussian(double *x, int n)
+{
+  if (n <= 0) return;
+  boost::uint64_t first = p_pos>>1;
+  int nblock = static_cast<int>(((p_pos+n-1)>>1) - first) + 1;
+  p_u1.resize(nblock);
+  p_u2.resize(nblock);
+  int i;
+  for (i=0; i<nblock; i++) {
+    p_block(first+i, p_u1[i], p_u2[i]);
+  }
+  // Box-Muller transform. Each block produces a pair of values, stored
+  // back in p_u1 and p_u2. There are no branches in this loop so it can
+  // be vectorized
+  double *u1 = &p_u1[0];
+  double *u2 = &p_u2[0];
+  for (i=0; i<nblock; i++) {
+    double r = sqrt(-2.0*log(1.0-u1[i]));
+    double theta = TWO_PI*u2[i];
+    u1[i] = r*cos(theta);
+    u2[i] = r*sin(theta);
+  }
+  int off = static_cast<int>(p_pos&1);
+  for (i=0; i<n; i++) {
+    int j = i+off;
+    x[i] = (j&1) ? u2[j>>1] : u1[j>>1];
+  }
+  p_pos += n;
+}
+
 }  // random
 }  // gridpack
@@ -14,6 +14,11 @@
  * This is a wrapper for a random number generator. The current implementation
  * relies on the standard random number generator in C++ and all the caveats
  * that apply to default random number generators should be noted.
+ *
+ * A counter-based generator (Philox4x32-10) is also provided. Its output
+ * depends only on a seed, a set of stream identifiers and the position in
+ * the stream, so results do not depend on how work is divided between
+ * processors.
  * 
  */
 
@@ -23,6 +28,8 @@
 #define _random_hpp_
 
 #include <cstdlib>
+#include <vector>
+#include <boost/cstdint.hpp>
 #include <boost/random/linear_congruential.hpp>
 #include <boost/random/uniform_int.hpp>
 #include <boost/random/mersenne_twister.hpp>
@@ -38,7 +45,7 @@ namespace gridpack {
 namespace random {
 
 // -------------------------------------------------------------
-//  class GlobalIndexHashMap
+//  class Random
 // -------------------------------------------------------------
 class Random {
 public:
@@ -88,6 +95,109 @@ private:
 };
 
 
+// -------------------------------------------------------------
+//  class CounterRandom
+// -------------------------------------------------------------
+/**
+ * Counter-based random number generator using the Philox4x32-10 bijection.
+ * Each stream is identified by a seed and up to three integer ids (for
+ * example, the original index of a bus, the generator on the bus and the
+ * quantity being sampled). The n'th value in a stream is a pure function of
+ * these values and n, so any processor can reproduce any value without
+ * sharing state. Uniform and Gaussian values are derived from the same
+ * counter, so element n of a stream has the same position whether it is
+ * drawn as a uniform or a Gaussian value.
+ */
+class CounterRandom {
+public:
+
+  /**
+   * Constructor
+   * @param seed random number generator initialization. Unlike Random, the
+   *        seed is not modified by the processor rank
+   */
+  CounterRandom(int seed = 42);
+
+  /**
+   * Default destructor
+   */
+  ~CounterRandom(void);
+
+  /**
+   * Reinitialize generator with a new seed. The stream is set back to
+   * (0,0,0)
+   * @param seed random number generator initialization
+   */
+  void seed(int seed);
+
+  /**
+   * Select a stream and go to its beginning
+   * @param id1 first stream identifier (e.g. original bus index)
+   * @param id2 second stream identifier (e.g. generator index)
+   * @param id3 third stream identifier (e.g. sampled quantity)
+   */
+  void setStream(int id1, int id2 = 0, int id3 = 0);
+
+  /**
+   * Set position in current stream
+   * @param pos index of next value to be returned
+   */
+  void setPosition(boost::uint64_t pos);
+
+  /**
+   * Return a double precision random number in the range [0,1)
+   */
+  double drand(void);
+
+  /**
+   * Return a double precision random number from a gaussian distribution with
+   * unit variance
+   */
+  double grand(void);
+
+  /**
+   * Fill an array with uniform random numbers in the range [0,1), starting
+   * from the current position in the stream
+   * @param x array of values
+   * @param n number of values
+   */
+  void fillUniform(double *x, int n);
+
+  /**
+   * Fill an array with random numbers from a gaussian distribution with unit
+   * variance, starting from the current position in the stream. Values are
+   * generated with the Box-Muller transform in blocks so that the loops
+   * over the array can be vectorized
+   * @param x array of values
+   * @param n number of values
+   */
+  void fillGaussian(double *x, int n);
+
+  /**
+   * Apply the Philox4x32-10 bijection to a counter
+   * @param ctr 128 bit counter, overwritten with the result
+   * @param key 64 bit key
+   */
+  static void philox(boost::uint32_t ctr[4], const boost::uint32_t key[2]);
+
+private:
+
+  /**
+   * Evaluate two uniform numbers for a block of the current stream
+   * @param block block index
+   * @param u1 first value in [0,1)
+   * @param u2 second value in [0,1)
+   */
+  void p_block(boost::uint64_t block, double &u1, double &u2);
+
+  boost::uint32_t p_seed;
+  boost::uint32_t p_key[2];
+  boost::uint32_t p_id[2];
+  boost::uint64_t p_pos;
+  std::vector<double> p_u1;
+  std::vector<double> p_u2;
+};
+
 } // namespace random
 } // namespace gridpack
 
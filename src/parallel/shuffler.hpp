@@ -27,11 +27,13 @@
 #include <iostream>
 #include <vector>
 #include <utility>
+#include <climits>
 #include <boost/mpi.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/utility.hpp>
 
 #include "gridpack/parallel/distributed.hpp"
+#include "gridpack/utilities/exception.hpp"
 
 #ifndef _shuffler_hpp_
 #define _shuffler_hpp_
@@ -50,7 +52,7 @@ namespace parallel {
  * thing.  After execution, each process will contain a vector of the
  * things assigned to it.
  *
- * This uses blocking send/receive.  
+ * This uses a single all-to-all exchange of serialized buffers.
  *
  * The things redistributed must be copy constructable and serializable.  
  * 
@@ -76,6 +78,15 @@ public:
   ~Shuffler(void) {}
   
   /// Redistribute and get the Things assigned to the local process
+  /**
+   * Things destined for each process are serialized into a single
+   * contiguous send buffer. Buffer sizes are exchanged with one
+   * MPI_Alltoall and the buffers themselves are moved with one
+   * MPI_Alltoallv, so the cost depends on the amount of data moved and
+   * not on the number of processes. Things that stay on the local
+   * process are not serialized. On return, local things come first,
+   * followed by things received from other processes in rank order.
+   */
   void operator()(ThingVector& locthings, const IndexVector& destproc)
   {
     BOOST_ASSERT(locthings.size() == destproc.size());
@@ -84,90 +95,100 @@ public:
 
     if (comm.size() <= 1) return;
 
-    size_t nthings(0);
-    all_reduce(comm, locthings.size(), nthings, std::plus<size_t>());
-    if (nthings <= 0) return;
+    int me = comm.rank();
+    int nprocs = comm.size();
 
     // save the original list of local things 
 
     ThingVector tvect(locthings); 
     locthings.clear();
 
-    // Work on each processors list of things separately
-
-    std::vector<ThingVector> tosend(comm.size());
-
     // all processes go through the destinations and makes a vector to
     // send to each of the other processes
 
+    std::vector<ThingVector> tosend(nprocs);
+
     size_t locidx(0);
 
     for (typename IndexVector::const_iterator dest = destproc.begin(); 
          dest != destproc.end(); ++dest) {
-      if (*dest == comm.rank()) {
+      if (*dest == me) {
         locthings.push_back(tvect[locidx]);
       } else {
         tosend[*dest].push_back(tvect[locidx]);
       }
       locidx += 1;
     }
-
-#if 0
-    for (int src = 0; src < comm.size(); ++src) {
-      ThingVector tmp;
-      if (comm.rank() == src) {
-        scatter(comm, tosend, tmp, src);
-      } else {
-        scatter(comm, tmp, src);
+    tvect.clear();
+
+    // Serialize the things for each destination into one contiguous
+    // buffer. Nothing is written for destinations that get nothing
+
+    std::vector<int> sendsizes(nprocs, 0);
+    std::vector<int> senddispls(nprocs, 0);
+    boost::mpi::packed_oarchive::buffer_type sendbuf;
+    for (int p = 0; p < nprocs; ++p) {
+      senddispls[p] = sendbuf.size();
+      if (tosend[p].empty()) continue;
+      boost::mpi::packed_oarchive::buffer_type pbuf;
+      {
+        boost::mpi::packed_oarchive oa(comm, pbuf);
+        oa << tosend[p];
       }
-      std::copy(tmp.begin(), tmp.end(), std::back_inserter(locthings));
+      sendbuf.insert(sendbuf.end(), pbuf.begin(), pbuf.end());
+      sendsizes[p] = pbuf.size();
+      ThingVector().swap(tosend[p]);
     }
-  }
-#else
-    int me = comm.rank();
-    int nprocs = comm.size();
-    for (int src = 0; src < nprocs; ++src) {
-      // Don't send messages of zero size. Exchange sizes with all processors
-      // first
-      //printf("p[%d] Got to 1\n",me);
-      std::vector<int> srcsizes(nprocs);
-      std::vector<int> tsizes(nprocs);
-      for (int i = 0; i<nprocs; i++) {
-        if (src == me) {
-          srcsizes[i] = tosend[i].size();
-        } else {
-          srcsizes[i] = 0;
-        }
-      }
-      int ierr;
-      ierr = MPI_Allreduce(&srcsizes[0],&tsizes[0],nprocs,MPI_INT,MPI_SUM,
-                           static_cast<MPI_Comm>(comm));
-      if (ierr != 0) {
-        // FIXME: throw
-      }
-      //create receive buffer
-     // printf("p[%d] Got to 2\n",me);
+
+    // Exchange buffer sizes with all processes
+
+    std::vector<int> recvsizes(nprocs, 0);
+    int ierr;
+    ierr = MPI_Alltoall(&sendsizes[0], 1, MPI_INT,
+                        &recvsizes[0], 1, MPI_INT,
+                        static_cast<MPI_Comm>(comm));
+    if (ierr != MPI_SUCCESS) {
+      throw gridpack::Exception("Shuffler: MPI_Alltoall failed");
+    }
+
+    std::vector<int> recvdispls(nprocs, 0);
+    size_t recvtotal(0);
+    for (int p = 0; p < nprocs; ++p) {
+      recvdispls[p] = recvtotal;
+      recvtotal += recvsizes[p];
+    }
+    if (sendbuf.size() > static_cast<size_t>(INT_MAX) ||
+        recvtotal > static_cast<size_t>(INT_MAX)) {
+      throw gridpack::Exception("Shuffler: buffer exceeds MPI count limit");
+    }
+
+    // Move all of the serialized things in a single exchange
+
+    boost::mpi::packed_iarchive::buffer_type recvbuf(recvtotal);
+    char dummy(0);
+    ierr = MPI_Alltoallv((sendbuf.empty() ? &dummy : &sendbuf[0]),
+                         &sendsizes[0], &senddispls[0], MPI_PACKED,
+                         (recvbuf.empty() ? &dummy : &recvbuf[0]),
+                         &recvsizes[0], &recvdispls[0], MPI_PACKED,
+                         static_cast<MPI_Comm>(comm));
+    if (ierr != MPI_SUCCESS) {
+      throw gridpack::Exception("Shuffler: MPI_Alltoallv failed");
+    }
+    boost::mpi::packed_oarchive::buffer_type().swap(sendbuf);
+
+    // Unpack things in source rank order
+
+    for (int p = 0; p < nprocs; ++p) {
+      if (recvsizes[p] <= 0) continue;
+      boost::mpi::packed_iarchive::buffer_type
+        pbuf(recvbuf.begin() + recvdispls[p],
+             recvbuf.begin() + recvdispls[p] + recvsizes[p]);
+      boost::mpi::packed_iarchive ia(comm, pbuf);
       ThingVector tmp;
-      if (me == src) {
-        for (int i=0; i<nprocs; i++) {
-          if (i == me) {
-            //printf("p[%d] Got to 2\n",me);
-            tmp = tosend[i];
-          } else {
-            //printf("p[%d] Got to 3 size: %d send to: %d\n",me,tsizes[i],i);
-            if (tsizes[i] > 0) 
-              static_cast<boost::mpi::communicator>(comm).send(i,src,tosend[i]);
-          }
-        }
-      } else {
-            //printf("p[%d] Got to 4 size: %d recieve from: %d\n",me,tsizes[me],src);
-        if (tsizes[me] > 0) 
-          static_cast<boost::mpi::communicator>(comm).recv(src,src,tmp);
-      }
+      ia >> tmp;
       std::copy(tmp.begin(), tmp.end(), std::back_inserter(locthings));
     }
   }
-#endif
 
 };
 
@@ -0,0 +1,267 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/collectives.hpp>
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+#include "mpi.h"
+#include "gridpack/parallel/parallel.hpp"
+#include "gridpack/parallel/distributed_directory.hpp"
+
+#define NKEYS 1000
+
+typedef gridpack::parallel::DistributedDirectory<int, int> Directory;
+
+/**
+ * Number of values stored for key in the directory built by fillDirectory
+ */
+int numValues(int key)
+{
+  return key%3 + 1;
+}
+
+/**
+ * Value number v of key
+ */
+int keyValue(int key, int v)
+{
+  return 10*key + v;
+}
+
+/**
+ * Add keys 0..NKEYS-1 to the directory. Each key is contributed by a
+ * single process and has between 1 and 3 values. Only even ranked
+ * processes contribute anything, so odd ranked processes have nothing
+ * to send
+ */
+void fillDirectory(const gridpack::parallel::Communicator &comm,
+    Directory &dir)
+{
+  int me = comm.rank();
+  int nprocs = comm.size();
+  int nsend = (nprocs+1)/2;
+  std::vector<Directory::KeyValue> pairs;
+  int key, v;
+  if (me%2 == 0) {
+    for (key=me/2; key<NKEYS; key += nsend) {
+      for (v=0; v<numValues(key); v++) {
+        pairs.push_back(std::make_pair(key, keyValue(key,v)));
+      }
+    }
+  }
+  dir.insert(pairs);
+}
+
+/**
+ * Check that the result of a lookup contains exactly the values for the
+ * requested keys that exist in the directory
+ * @param request keys passed to lookup
+ * @param keys keys returned by lookup
+ * @param values values returned by lookup
+ * @return true if result is correct
+ */
+bool checkLookup(const std::vector<int> &request,
+    const std::vector<int> &keys, const std::vector<int> &values)
+{
+  if (keys.size() != values.size()) return false;
+  std::vector<std::pair<int,int> > expect, found;
+  size_t i;
+  int v;
+  for (i=0; i<request.size(); i++) {
+    if (request[i] < 0 || request[i] >= NKEYS) continue;
+    for (v=0; v<numValues(request[i]); v++) {
+      expect.push_back(std::make_pair(request[i], keyValue(request[i],v)));
+    }
+  }
+  for (i=0; i<keys.size(); i++) {
+    found.push_back(std::make_pair(keys[i], values[i]));
+  }
+  std::sort(expect.begin(), expect.end());
+  std::sort(found.begin(), found.end());
+  return expect == found;
+}
+
+BOOST_AUTO_TEST_SUITE ( TestDistributedDirectory )
+
+BOOST_AUTO_TEST_CASE( ExchangeRecords )
+{
+  gridpack::parallel::Communicator world;
+  int me = world.rank();
+  int nprocs = world.size();
+
+  // Process me sends (me+p)%3 records to process p, so some pairs of
+  // processes exchange nothing
+  std::vector<std::pair<int,int> > records;
+  std::vector<int> dest;
+  int p, i;
+  for (p=nprocs-1; p>=0; p--) {
+    for (i=0; i<(me+p)%3; i++) {
+      records.push_back(std::make_pair(me, i));
+      dest.push_back(p);
+    }
+  }
+  std::vector<std::pair<int,int> > recv;
+  std::vector<int> recvcount;
+  gridpack::parallel::exchangeRecords(world, records, dest, recv, recvcount);
+
+  // Records arrive ordered by source rank and in the order they were sent
+  bool ok = (static_cast<int>(recvcount.size()) == nprocs);
+  int n = 0;
+  for (p=0; p<nprocs && ok; p++) {
+    if (recvcount[p] != (p+me)%3) ok = false;
+    for (i=0; i<recvcount[p] && ok; i++) {
+      if (n >= static_cast<int>(recv.size()) ||
+          recv[n].first != p || recv[n].second != i) ok = false;
+      n++;
+    }
+  }
+  if (n != static_cast<int>(recv.size())) ok = false;
+  BOOST_CHECK(ok);
+
+  // Illegal destinations are caught before any communication
+  dest.assign(records.size(), nprocs);
+  if (records.size() > 0) {
+    BOOST_CHECK_THROW(gridpack::parallel::exchangeRecords(world, records,
+          dest, recv, recvcount), gridpack::Exception);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( Owner )
+{
+  gridpack::parallel::Communicator world;
+  int me = world.rank();
+  int nprocs = world.size();
+  int key, k;
+
+  // Owners are in range and consistent hashing only moves keys to the
+  // new process when the number of processes grows
+  bool ok = true;
+  int maxk = 2*nprocs+8;
+  std::vector<int> count(maxk, 0);
+  for (key=0; key<NKEYS; key++) {
+    int last = Directory::owner(key, 1);
+    if (last != 0) ok = false;
+    for (k=2; k<=maxk; k++) {
+      int own = Directory::owner(key, k);
+      if (own < 0 || own >= k) ok = false;
+      if (own != last && own != k-1) ok = false;
+      last = own;
+    }
+    count[Directory::owner(key, nprocs)]++;
+  }
+  BOOST_CHECK(ok);
+
+  // Every process computes the same owners
+  std::vector<int> cmin(count), cmax(count);
+  world.min(&cmin[0], maxk);
+  world.max(&cmax[0], maxk);
+  BOOST_CHECK(cmin == cmax);
+
+  // A directory on a communicator of size k uses the same owners. Each
+  // process is in one of the two halves of the split
+  for (k=1; k<=nprocs; k++) {
+    gridpack::parallel::Communicator sub = world.split(me < k ? 0 : 1);
+    Directory dir(sub);
+    int size = sub.size();
+    bool sok = true;
+    for (key=0; key<NKEYS; key++) {
+      if (dir.owner(key) != Directory::owner(key, size)) sok = false;
+    }
+    BOOST_CHECK(sok);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( Lookup )
+{
+  gridpack::parallel::Communicator world;
+  int me = world.rank();
+  int nprocs = world.size();
+  Directory dir(world);
+  fillDirectory(world, dir);
+
+  // All values are stored somewhere
+  int total = dir.localSize();
+  world.sum(&total, 1);
+  int expected = 0;
+  int key;
+  for (key=0; key<NKEYS; key++) expected += numValues(key);
+  BOOST_CHECK_EQUAL(total, expected);
+
+  // Request a strided set of keys, a repeated key and keys that are not
+  // in the directory
+  std::vector<int> request;
+  for (key=me; key<NKEYS; key += nprocs) request.push_back(key);
+  request.push_back(me%NKEYS);
+  request.push_back(NKEYS+me);
+  request.push_back(-1-me);
+  std::vector<int> keys(request), values;
+  dir.lookup(keys, values);
+  BOOST_CHECK(checkLookup(request, keys, values));
+}
+
+BOOST_AUTO_TEST_CASE( ZeroSends )
+{
+  gridpack::parallel::Communicator world;
+  int me = world.rank();
+  Directory dir(world);
+  fillDirectory(world, dir);
+
+  // Only process 0 asks for anything
+  std::vector<int> request;
+  if (me == 0) {
+    request.push_back(NKEYS-1);
+    request.push_back(NKEYS);
+    request.push_back(0);
+  }
+  std::vector<int> keys(request), values;
+  dir.lookup(keys, values);
+  BOOST_CHECK(checkLookup(request, keys, values));
+
+  // Nobody asks for anything, or only for missing keys
+  request.clear();
+  keys.clear();
+  dir.lookup(keys, values);
+  BOOST_CHECK(keys.empty() && values.empty());
+  request.push_back(NKEYS+me);
+  keys = request;
+  dir.lookup(keys, values);
+  BOOST_CHECK(keys.empty() && values.empty());
+
+  // Clearing leaves nothing to find
+  dir.clear();
+  BOOST_CHECK_EQUAL(dir.localSize(), 0);
+  keys.assign(1, 0);
+  dir.lookup(keys, values);
+  BOOST_CHECK(keys.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END( )
+
+bool init_function(void)
+{
+  return true;
+}
+
+int main (int argc, char **argv) {
+
+  gridpack::parallel::Environment env(argc, argv);
+  gridpack::parallel::Communicator world;
+
+  int me = world.rank();
+  if (me == 0) {
+    printf("Testing distributed directory on %d processors\n",world.size());
+  }
+
+  int result = ::boost::unit_test::unit_test_main( &init_function, argc, argv );
+  return result;
+}
@@ -0,0 +1,130 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   node_store_test.cpp
+ * @date   2026-10-19
+ *
+ * @brief  A simple test of the GridPACK node store module
+ *
+ *
+ */
+
+// -------------------------------------------------------------
+// -------------------------------------------------------------
+// Battelle Memorial Institute
+// Pacific Northwest Laboratory
+// -------------------------------------------------------------
+
+#include <iostream>
+#include "gridpack/parallel/parallel.hpp"
+#include "gridpack/parallel/node_store.hpp"
+
+#define MAX_VEC  1000
+
+#define VEC_LEN  100
+
+// -------------------------------------------------------------
+//  Main Program
+// -------------------------------------------------------------
+
+typedef struct {int ival;
+                double dval;
+} data_type;
+
+int
+main(int argc, char **argv)
+{
+  gridpack::parallel::Environment env(argc, argv);
+  int ret = 0;
+  // Create an artificial scope so that all objects call their destructors
+  // before the environment is finalized
+  if (1) {
+    gridpack::parallel::Communicator world;
+    int me = world.rank();
+    int nproc = world.size();
+    if (me == 0) {
+      printf("Testing NodeStore on %d processors\n\n",nproc);
+    }
+    int lo = me*MAX_VEC/nproc;
+    int hi = (me+1)*MAX_VEC/nproc-1;
+    int i, j;
+    gridpack::parallel::NodeStore<data_type> bank(world);
+    // Store vectors in node store object. Vectors have different lengths
+    // on each process
+    for (i=lo; i<=hi; i++) {
+      std::vector<data_type> vec;
+      for (j=0; j<VEC_LEN+me; j++) {
+        data_type item;
+        item.ival = j+me;
+        item.dval = static_cast<double>(j+me+1);
+        vec.push_back(item);
+      }
+      bank.addVector(i,vec);
+    }
+    // Upload vectors to shared memory on each node
+    bank.upload();
+
+    // Check values of all vectors on every process. Only the first
+    // mistake on each process is reported
+    int chk = 1;
+    if (bank.numVectors() != MAX_VEC) {
+      printf("p[%d] Expected %d vectors, found %d\n",me,MAX_VEC,
+          bank.numVectors());
+      chk = 0;
+    }
+    int p;
+    for (p=0; p<nproc; p++) {
+      lo = p*MAX_VEC/nproc;
+      hi = (p+1)*MAX_VEC/nproc-1;
+      for (i=lo; i<=hi; i++) {
+        if (bank.getSize(i) != VEC_LEN+p) {
+          if (chk == 1) {
+            printf("p[%d] Vector %d has length %d expected %d\n",me,i,
+                bank.getSize(i),VEC_LEN+p);
+          }
+          chk = 0;
+          continue;
+        }
+        const data_type *ptr = bank.getData(i);
+        std::vector<data_type> vec;
+        bank.getVector(i, vec);
+        if (static_cast<int>(vec.size()) != VEC_LEN+p) {
+          if (chk == 1) {
+            printf("p[%d] Copy of vector %d has length %d expected %d\n",
+                me,i,static_cast<int>(vec.size()),VEC_LEN+p);
+          }
+          chk = 0;
+          continue;
+        }
+        // Both the pointer into shared memory and the copy must hold the
+        // stored values
+        for (j=0; j<VEC_LEN+p; j++) {
+          int ival = j+p;
+          double dval = static_cast<double>(j+p+1);
+          if (ptr[j].ival == ival && ptr[j].dval == dval &&
+              vec[j].ival == ival && vec[j].dval == dval) continue;
+          if (chk == 1) {
+            printf("p[%d] Mistake found at (vec[%d])[%d]. Expected ival: %d"
+                " dval: %f Pointer ival: %d dval: %f Copy ival: %d"
+                " dval: %f\n",me,i,j,ival,dval,ptr[j].ival,ptr[j].dval,
+                vec[j].ival,vec[j].dval);
+          }
+          chk = 0;
+        }
+      }
+    }
+    world.sync();
+    world.sum(&chk,1);
+    if (chk == nproc && me == 0) {
+      printf("Vectors OK\n");
+    } else if (chk < nproc && me == 0) {
+      printf("Error found in vectors\n");
+    }
+    if (chk < nproc) ret = 1;
+  }
+  return ret;
+}
@@ -21,6 +21,7 @@
 // -------------------------------------------------------------
 
 #include <iostream>
+#include <vector>
 #include <ga.h>
 #include "gridpack/parallel/parallel.hpp"
 #include "gridpack/parallel/random.hpp"
@@ -102,6 +103,31 @@ main(int argc, char **argv)
             gaussian[i]);
       }
     }
+
+    // Check counter-based generator against known answers for
+    // Philox4x32-10 and check that bulk and scalar draws agree
+    boost::uint32_t ctr[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    boost::uint32_t key[2] = {0xa4093822, 0x299f31d0};
+    gridpack::random::CounterRandom::philox(ctr, key);
+    bool ok = (ctr[0] == 0xd16cfe09 && ctr[1] == 0x94fdcceb &&
+        ctr[2] == 0x5001e420 && ctr[3] == 0x24126ea1);
+    gridpack::random::CounterRandom crandom(iseed);
+    std::vector<double> bulk(MAX_BINS+1);
+    crandom.setStream(GA_Nodeid(), 1, 2);
+    crandom.fillGaussian(&bulk[0], MAX_BINS+1);
+    crandom.setStream(GA_Nodeid(), 1, 2);
+    for (i=0; i<MAX_BINS+1; i++) {
+      if (crandom.grand() != bulk[i]) ok = false;
+    }
+    int iok = ok ? 0 : 1;
+    GA_Igop(&iok,1,"+");
+    if (GA_Nodeid() == 0) {
+      if (iok == 0) {
+        printf("\nCounter-based generator passed\n");
+      } else {
+        printf("\nCounter-based generator failed on %d processors\n",iok);
+      }
+    }
   }
   return 0;
 }
@@ -181,6 +181,35 @@ BOOST_AUTO_TEST_CASE( multi_tester_shuffle )
     
 }
 
+BOOST_AUTO_TEST_CASE( all_to_all_shuffle )
+{
+  gridpack::parallel::Communicator comm;
+  boost::mpi::communicator world(static_cast<MPI_Comm>(comm),
+      boost::mpi::comm_duplicate);
+  const int local_size(3*world.size());
+  std::vector<Tester> things;
+  std::vector<int> dest;
+
+  // every process sends some things to every process, including itself
+  things.reserve(local_size);
+  dest.reserve(local_size);
+  for (int i = 0; i < local_size; ++i) {
+    things.push_back(Tester(world.rank()*local_size + i));
+    dest.push_back((i + world.rank()) % world.size());
+  }
+
+  gridpack::parallel::Shuffler<Tester> shuffle(world);
+  shuffle(things, dest);
+
+  BOOST_CHECK_EQUAL(things.size(), static_cast<size_t>(local_size));
+  for (size_t i = 0; i < things.size(); ++i) {
+    int src(things[i].index/local_size);
+    int j(things[i].index % local_size);
+    BOOST_CHECK_EQUAL((j + src) % world.size(), world.rank());
+    BOOST_CHECK_EQUAL(things[i].label, Tester(things[i].index).label);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END( )
 
 BOOST_AUTO_TEST_SUITE( gaShufflerTest )
@@ -31,6 +31,7 @@
 #include "gridpack/network/base_network.hpp"
 #include "gridpack/parser/base_parser.hpp"
 #include "gridpack/parser/hash_distr.hpp"
+#include "gridpack/parser/dyr_records.hpp"
 #include "gridpack/factory/base_factory.hpp"
 #include "parser_classes/gencls.hpp"
 #include "parser_classes/gensal.hpp"
@@ -756,7 +757,7 @@ class BasePTIParser : public BaseParser<_network>
       //      p_timer->start(t_ds);
       int me(p_network->communicator().rank());
 
-      std::vector<gen_params> gen_data;
+      std::vector<std::vector<char> > gen_data;
       std::vector<bus_relay_params> bus_relay_data;
       std::vector<branch_relay_params> branch_relay_data;
       std::vector<load_params> load_data;
@@ -771,15 +772,17 @@ class BasePTIParser : public BaseParser<_network>
             &branch_relay_data, &load_data);
         input.close();
       }
+      // Generator models are moved as compact records that only contain the
+      // parameters used by each model
       int nsize = gen_data.size();
       std::vector<int> buses;
       int i;
       for (i=0; i<nsize; i++) {
-        buses.push_back(gen_data[i].bus_id);
+        buses.push_back(DyrModelTable::header(&gen_data[i][0]).bus_id);
       }
-      gridpack::hash_distr::HashDistribution<_network,gen_params,gen_params>
+      gridpack::hash_distr::HashDistribution<_network,char,char>
         distr(p_network);
-      distr.distributeBusValues(buses,gen_data);
+      distr.distributeBusRecords(buses,gen_data);
       // Now match data with corresponding data collection objects
       gridpack::component::DataCollection *data;
       nsize = buses.size();
@@ -787,6 +790,7 @@ class BasePTIParser : public BaseParser<_network>
         int l_idx = buses[i];
         data = dynamic_cast<gridpack::component::DataCollection*>
           (p_network->getBusData(l_idx).get());
+        DyrRecordHeader header = DyrModelTable::header(&gen_data[i][0]);
 
         // Find out how many generators are already on bus
         int ngen = 0;
@@ -795,7 +799,7 @@ class BasePTIParser : public BaseParser<_network>
         int g_id = -1;
         if (ngen > 0) {
           // Clean up 2 character tag for generator ID
-          std::string tag = gen_data[i].gen_id;
+          std::string tag = header.gen_id;
           int j;
           for (j=0; j<ngen; j++) {
             std::string t_id;
@@ -809,35 +813,7 @@ class BasePTIParser : public BaseParser<_network>
 
         // Check to see parameters can be assigned to a generator
         if (g_id > -1) {
-          if (!strcmp(gen_data[i].model,"GENCLS")) {
-            GenclsParser<gen_params> parser;
-            parser.extract(gen_data[i], data, g_id);
-          } else if (!strcmp(gen_data[i].model,"GENSAL")) {
-            GensalParser<gen_params> parser;
-            parser.extract(gen_data[i], data, g_id);
-          } else if (!strcmp(gen_data[i].model,"GENROU")) {
-            GenrouParser<gen_params> parser;
-            parser.extract(gen_data[i], data, g_id);
-          } else if (!strcmp(gen_data[i].model,"WSIEG1")) {
-            Wsieg1Parser<gen_params> parser;
-            parser.extract(gen_data[i], data, g_id);
-          } else if (!strcmp(gen_data[i].model,"EXDC1") ||
-              !strcmp(gen_data[i].model,"EXDC2")) {
-            Exdc1Parser<gen_params> parser;
-            parser.extract(gen_data[i], data, g_id);
-          } else if (!strcmp(gen_data[i].model,"ESST1A")) {
-            Esst1aParser<gen_params> parser;
-            parser.extract(gen_data[i], data, g_id);
-          } else if (!strcmp(gen_data[i].model,"ESST4B")) {
-            Esst4bParser<gen_params> parser;
-            parser.extract(gen_data[i], data, g_id);
-          } else if (!strcmp(gen_data[i].model,"GGOV1")) {
-            Ggov1Parser<gen_params> parser;
-            parser.extract(gen_data[i], data, g_id);
-          } else if (!strcmp(gen_data[i].model,"WSHYGP")) {
-            WshygpParser<gen_params> parser;
-            parser.extract(gen_data[i], data, g_id);
-          }
+          DyrModelTable::extract(&gen_data[i][0], data, g_id);
         }
       }
       // Add parameters for a bus relay
@@ -1121,14 +1097,7 @@ class BasePTIParser : public BaseParser<_network>
 
     // Utility function to check if device is on a generator
     bool onGenerator(std::string &device) {
-      bool ret = false;
-      if (device == "GENCLS" || device == "GENSAL" || device == "GENROU" ||
-          device == "WSIEG1" || device == "EXDC1" || device == "EXDC2" ||
-          device == "ESST1A" || device == "ESST4B" || device == "GGOV1" ||
-          device == "WSHYGP") {
-        ret = true;
-      }
-      return ret;
+      return (DyrModelTable::modelType(device) >= 0);
     }
 
     // Utility function to check if device is on a bus
@@ -1260,34 +1229,8 @@ class BasePTIParser : public BaseParser<_network>
           bool bval;
 
           if (g_id > -1) {
-            if (sval == "GENCLS") {
-              GenclsParser<gen_params> parser;
-              parser.parse(split_line, data, g_id);
-            } else if (sval == "GENSAL") {
-              GensalParser<gen_params> parser;
-              parser.parse(split_line, data, g_id);
-            } else if (sval == "GENROU") {
-              GenrouParser<gen_params> parser;
-              parser.parse(split_line, data, g_id);
-            } else if (sval == "WSIEG1") {
-              Wsieg1Parser<gen_params> parser;
-              parser.parse(split_line, data, g_id);
-            } else if (sval == "EXDC1" || sval == "EXDC2") {
-              Exdc1Parser<gen_params> parser;
-              parser.parse(split_line, data, g_id);
-            } else if (sval == "ESST1A") {
-              Esst1aParser<gen_params> parser;
-              parser.parse(split_line, data, g_id);
-            } else if (sval == "ESST4A") {
-              Esst4bParser<gen_params> parser;
-              parser.parse(split_line, data, g_id);
-            } else if (sval == "GGOV1") {
-              Ggov1Parser<gen_params> parser;
-              parser.parse(split_line, data, g_id);
-            } else if (sval == "WSHYGP") {
-              WshygpParser<gen_params> parser;
-              parser.parse(split_line, data, g_id);
-            }
+            DyrModelTable::parse(DyrModelTable::modelType(sval),
+                split_line, data, g_id);
           }
         } else if (onBus(sval)) {
           int l_idx, o_idx;
@@ -1389,7 +1332,8 @@ class BasePTIParser : public BaseParser<_network>
     }
 
     // Parse file to construct lists of structs representing different devices.
-    void find_ds_vector(std::ifstream & input, std::vector<gen_params> *gen_vector,
+    void find_ds_vector(std::ifstream & input,
+        std::vector<std::vector<char> > *gen_vector,
         std::vector<bus_relay_params> *bus_relay_vector,
         std::vector<branch_relay_params> *branch_relay_vector,
         std::vector<load_params> *load_vector)
@@ -1419,53 +1363,11 @@ class BasePTIParser : public BaseParser<_network>
         util.toUpper(sval);
 
         if (onGenerator(sval)) {
-          gen_params data;
-
-          // GENERATOR_BUSNUMBER               "I"                   integer
-          int o_idx;
-          o_idx = atoi(split_line[0].c_str());
-          data.bus_id = o_idx;
-
-          // Clean up 2 character tag for generator ID
+          // Store only the parameters that are used by the model
           std::string tag = util.clean2Char(split_line[2]);
-          strcpy(data.gen_id, tag.c_str());
-
-          double rval;
-          int ival;
-
-
-          // GENERATOR_MODEL              "MODEL"                  integer
-          strcpy(data.model, sval.c_str());
-
-          if (sval == "GENCLS") {
-            GenclsParser<gen_params> parser;
-            parser.store(split_line,data);
-          } else if (sval == "GENSAL") {
-            GensalParser<gen_params> parser;
-            parser.store(split_line,data);
-          } else if (sval == "GENROU") {
-            GenrouParser<gen_params> parser;
-            parser.store(split_line,data);
-          } else if (sval == "WSIEG1") {
-            Wsieg1Parser<gen_params> parser;
-            parser.store(split_line,data);
-          } else if (sval == "EXDC1" || sval == "EXDC2") {
-            Exdc1Parser<gen_params> parser;
-            parser.store(split_line,data);
-          } else if (sval == "ESST1A") {
-            Esst1aParser<gen_params> parser;
-            parser.store(split_line,data);
-          } else if (sval == "ESST4B") {
-            Esst4bParser<gen_params> parser;
-            parser.store(split_line,data);
-          } else if (sval == "GGOV1") {
-            Ggov1Parser<gen_params> parser;
-            parser.store(split_line,data);
-          } else if (sval == "WSHYGP") {
-            WshygpParser<gen_params> parser;
-            parser.store(split_line,data);
-          }
-          gen_vector->push_back(data);
+          gen_vector->push_back(std::vector<char>());
+          DyrModelTable::pack(DyrModelTable::modelType(sval), split_line,
+              tag, gen_vector->back());
         } else if (onBus(sval)) {
 
           // RELAY_BUSNUMBER               "I"                   integer
@@ -0,0 +1,263 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   dyr_records.hpp
+ * @date   2026-10-19
+ *
+ * @brief
+ * Compact records for generator models read from .dyr files. Each record
+ * consists of a small header (bus, model type, generator ID and parameter
+ * count) followed by the numerical parameters of the model, so records
+ * only take up as much space as the model actually needs. Models are
+ * looked up in a single table that connects the model name to the parser
+ * class that stores its parameters in a DataCollection object.
+ */
+// -------------------------------------------------------------
+
+#ifndef _dyr_records_hpp_
+#define _dyr_records_hpp_
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include "gridpack/component/data_collection.hpp"
+#include "gridpack/utilities/exception.hpp"
+#include "parser_classes/gencls.hpp"
+#include "parser_classes/gensal.hpp"
+#include "parser_classes/genrou.hpp"
+#include "parser_classes/wsieg1.hpp"
+#include "parser_classes/exdc1.hpp"
+#include "parser_classes/esst1a.hpp"
+#include "parser_classes/esst4b.hpp"
+#include "parser_classes/ggov1.hpp"
+#include "parser_classes/wshygp.hpp"
+
+namespace gridpack {
+namespace parser {
+
+/**
+ * Header of a compact generator model record. The header is followed by
+ * nparam doubles, which are the fields of the .dyr record after the
+ * generator ID
+ */
+struct DyrRecordHeader {
+  int bus_id;     // original index of bus that owns device
+  int model;      // index of model in DyrModelTable
+  char gen_id[4]; // generator ID
+  int nparam;     // number of parameters that follow header
+};
+
+// -------------------------------------------------------------
+//  class DyrModelTable
+// -------------------------------------------------------------
+/**
+ * Table of generator models that can appear in a .dyr file. Models are
+ * identified by their position in the table
+ */
+class DyrModelTable {
+public:
+
+  /**
+   * Function that parses the fields of a .dyr record and stores the
+   * results in a data collection object
+   */
+  typedef void (*ParseFunction)(std::vector<std::string> &split_line,
+      gridpack::component::DataCollection *data, int g_id);
+
+  /**
+   * Number of models in table
+   */
+  static int numModels(void)
+  {
+    int n = 0;
+    while (entries()[n].name != NULL) n++;
+    return n;
+  }
+
+  /**
+   * Find model type corresponding to a model name
+   * @param name model name (upper case)
+   * @return model type or -1 if model is not a generator model
+   */
+  static int modelType(const std::string &name)
+  {
+    const Entry *table = entries();
+    int i = 0;
+    while (table[i].name != NULL) {
+      if (name == table[i].name) return i;
+      i++;
+    }
+    return -1;
+  }
+
+  /**
+   * Name of model
+   * @param model model type
+   * @return model name
+   */
+  static const char* modelName(int model)
+  {
+    checkModel(model);
+    return entries()[model].name;
+  }
+
+  /**
+   * Parse the fields of a .dyr record and store the result in a data
+   * collection object
+   * @param model model type
+   * @param split_line fields of .dyr record
+   * @param data data collection object
+   * @param g_id index of generator on bus
+   */
+  static void parse(int model, std::vector<std::string> &split_line,
+      gridpack::component::DataCollection *data, int g_id)
+  {
+    checkModel(model);
+    entries()[model].parse(split_line, data, g_id);
+  }
+
+  /**
+   * Convert the fields of a .dyr record to a compact record and append it
+   * to a buffer
+   * @param model model type
+   * @param split_line fields of .dyr record
+   * @param gen_id cleaned up generator ID
+   * @param buf buffer that the record is appended to
+   */
+  static void pack(int model, const std::vector<std::string> &split_line,
+      const std::string &gen_id, std::vector<char> &buf)
+  {
+    checkModel(model);
+    DyrRecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.bus_id = atoi(split_line[0].c_str());
+    header.model = model;
+    strncpy(header.gen_id, gen_id.c_str(), sizeof(header.gen_id)-1);
+    int nstr = split_line.size();
+    header.nparam = (nstr > 3 ? nstr-3 : 0);
+    size_t offset = buf.size();
+    buf.resize(offset+sizeof(header)+header.nparam*sizeof(double));
+    memcpy(&buf[offset], &header, sizeof(header));
+    offset += sizeof(header);
+    int i;
+    for (i=0; i<header.nparam; i++) {
+      double rval = atof(split_line[i+3].c_str());
+      memcpy(&buf[offset], &rval, sizeof(double));
+      offset += sizeof(double);
+    }
+  }
+
+  /**
+   * Read the header of a compact record
+   * @param record pointer to beginning of record
+   * @return header
+   */
+  static DyrRecordHeader header(const char *record)
+  {
+    DyrRecordHeader ret;
+    memcpy(&ret, record, sizeof(ret));
+    return ret;
+  }
+
+  /**
+   * Size of a compact record
+   * @param record pointer to beginning of record
+   * @return number of bytes in record
+   */
+  static size_t recordSize(const char *record)
+  {
+    DyrRecordHeader hdr = header(record);
+    return sizeof(DyrRecordHeader)+hdr.nparam*sizeof(double);
+  }
+
+  /**
+   * Store the contents of a compact record in a data collection object.
+   * The record is expanded back into a list of fields and parsed in the
+   * same way as the original .dyr record
+   * @param record pointer to beginning of record
+   * @param data data collection object
+   * @param g_id index of generator on bus
+   */
+  static void extract(const char *record,
+      gridpack::component::DataCollection *data, int g_id)
+  {
+    DyrRecordHeader hdr = header(record);
+    checkModel(hdr.model);
+    std::vector<std::string> split_line(hdr.nparam+3);
+    char buf[32];
+    sprintf(buf,"%d",hdr.bus_id);
+    split_line[0] = buf;
+    split_line[1] = entries()[hdr.model].name;
+    split_line[2] = hdr.gen_id;
+    const char *ptr = record+sizeof(DyrRecordHeader);
+    int i;
+    for (i=0; i<hdr.nparam; i++) {
+      double rval;
+      memcpy(&rval, ptr, sizeof(double));
+      ptr += sizeof(double);
+      // 17 significant digits reproduce the value exactly
+      sprintf(buf,"%.17g",rval);
+      split_line[i+3] = buf;
+    }
+    parse(hdr.model, split_line, data, g_id);
+  }
+
+private:
+
+  struct Entry {
+    const char *name;
+    ParseFunction parse;
+  };
+
+  /**
+   * Parse a record with one of the model parser classes. The parse methods
+   * do not depend on the template argument
+   */
+  template <class _parser>
+  static void parseModel(std::vector<std::string> &split_line,
+      gridpack::component::DataCollection *data, int g_id)
+  {
+    _parser parser;
+    parser.parse(split_line, data, g_id);
+  }
+
+  /**
+   * Model table, terminated by an entry with a NULL name
+   */
+  static const Entry* entries(void)
+  {
+    static const Entry table[] = {
+      {"GENCLS", &parseModel<GenclsParser<DyrRecordHeader> >},
+      {"GENSAL", &parseModel<GensalParser<DyrRecordHeader> >},
+      {"GENROU", &parseModel<GenrouParser<DyrRecordHeader> >},
+      {"WSIEG1", &parseModel<Wsieg1Parser<DyrRecordHeader> >},
+      {"EXDC1", &parseModel<Exdc1Parser<DyrRecordHeader> >},
+      {"EXDC2", &parseModel<Exdc1Parser<DyrRecordHeader> >},
+      {"ESST1A", &parseModel<Esst1aParser<DyrRecordHeader> >},
+      {"ESST4B", &parseModel<Esst4bParser<DyrRecordHeader> >},
+      {"GGOV1", &parseModel<Ggov1Parser<DyrRecordHeader> >},
+      {"WSHYGP", &parseModel<WshygpParser<DyrRecordHeader> >},
+      {NULL, NULL}
+    };
+    return table;
+  }
+
+  static void checkModel(int model)
+  {
+    if (model < 0 || model >= numModels()) {
+      char buf[256];
+      sprintf(buf,"DyrModelTable: unknown model type %d\n",model);
+      throw gridpack::Exception(buf);
+    }
+  }
+};
+
+} // parser
+} // gridpack
+#endif
@@ -13,7 +13,10 @@
  * @brief  
  * This is a utility that is designed to move a set of data for a collection of
  * buses and/or branches based on the process that owns the buses or branches.
- * Ownership is based on the original index of the bus or branch
+ * Ownership is based on the original index of the bus or branch. Each
+ * distribute call looks up the processes holding the destination buses or
+ * branches in a distributed directory and moves the data in a single
+ * sparse all-to-all exchange
  * 
  */
 
@@ -22,13 +25,19 @@
 #ifndef _hash_distr_hpp_
 #define _hash_distr_hpp_
 
-#define SYSTOLIC
-
-//#define HASH_WITH_MPI
+// Define SYSTOLIC to move data by having every process scan a global array
+// holding all values. Otherwise, data is routed directly to the processes
+// that hold the corresponding buses and branches using the distributed
+// directory in GlobalIndexHashMap
+//#define SYSTOLIC
 
+#include <set>
+#include <map>
+#include <cstring>
 #include <ga.h>
 #include <boost/unordered_map.hpp>
 #include "gridpack/parallel/index_hash.hpp"
+#include "gridpack/parallel/distributed_directory.hpp"
 #include "gridpack/utilities/exception.hpp"
 
 namespace gridpack {
@@ -43,14 +52,16 @@ template <typename _network,
  class HashDistribution {
 private:
 
-  typedef struct{int idx;
-           _bus_data_type data;
-  } bus_data_pair;
+  struct bus_data_pair {
+    int idx;
+    _bus_data_type data;
+  };
 
-  typedef struct{int idx1;
-            int idx2;
-           _branch_data_type data;
-  } branch_data_pair;
+  struct branch_data_pair {
+    int idx1;
+    int idx2;
+    _branch_data_type data;
+  };
 
 public:
   typedef _network NetworkType;
@@ -230,279 +241,80 @@ public:
     }
     GA_Destroy(g_vals);
 #else
-    int nprocs = p_network->communicator().size();
     int me = p_network->communicator().rank();
-    // Get global indices corresponding to keys
-    int i,j;
-    // Create a list of unique keys
+    int ksize = keys.size();
+    int vsize = values.size();
+    if (vsize != ksize) {
+      char buf[256];
+      sprintf(buf,"p[%d] HashDistribution::distributeBusValues ERROR: length"
+          " of keys and values arrays don't match ksize: %d vsize: %d\n",
+          me,ksize,vsize);
+      printf("%s",buf);
+      throw gridpack::Exception(buf);
+    }
+    // Find the processors that hold each bus. Each unique key is only
+    // looked up once
+    int i;
     std::vector<int> base_keys;
     std::set<int> key_check;
-    std::set<int>::iterator itc;
-    for (i=0; i<keys.size(); i++) {
-      itc = key_check.find(keys[i]);
-      if (itc == key_check.end()) {
-        key_check.insert(keys[i]);
-        base_keys.push_back(keys[i]);
-      }
+    for (i=0; i<ksize; i++) {
+      if (key_check.insert(keys[i]).second) base_keys.push_back(keys[i]);
     }
     std::vector<int> procLoc;
-    // Get processor that owns global index
     p_indexHashMap->getValues(base_keys,procLoc);
-    // We now know how many processors each unique key maps to. Use this
-    // information to create a complete a  new values list, a new keys list, and
-    // a processor location list
     std::multimap<int,int> keyMap;
     for (i=0; i<base_keys.size(); i++) {
       keyMap.insert(std::pair<int,int>(base_keys[i],procLoc[i]));
     }
-    std::vector<_bus_data_type> newValues;
-    std::vector<int> newKeys;
-    std::vector<int> destProcs;
-    j = 0;
     std::multimap<int,int>::iterator itk;
-    for (i=0; i<values.size(); i++) {
-      itk = keyMap.find(keys[i]);
-      if (itk != keyMap.end()) {
-        while (itk != keyMap.upper_bound(keys[i])) {
-          newValues.push_back(values[i]);
-          newKeys.push_back(keys[i]);
-          destProcs.push_back(itk->second);
-          itk++;
-        }
-      }
-    }
 
-    // sort keys into linked list based on which processors they are going to
-    int nsize = newKeys.size();
-    int ltop[nprocs];
-    int ldest[nsize];
-    int destNum[nprocs];
-    for (i=0; i<nprocs; i++) {
-      ltop[i] = -1;
-      destNum[i] = 0;
-    }
-    for (i=0; i<nsize; i++) {
-      ldest[i] = -1;
-    }
-    int iproc;
-    for (i=0; i<nsize; i++) {
-      iproc = destProcs[i];
-      destNum[iproc]++;
-      ldest[i] = ltop[iproc]; 
-      ltop[iproc] = i;
-    }
-#ifdef HASH_WITH_MPI
-    // Use all-to-all call to determine number of unique keys coming from each
+    // Create a map between original and local indices of buses on this
     // processor
-    int srcNum[nprocs];
-    int ierr;
-    int one = 1;
-    MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
-    ierr = MPI_Alltoall(destNum,one,MPI_INT,srcNum,one,MPI_INT,comm);
-
-    // Each process now knows how much data it will receive. Pack data data into
-    // an appropriate sized buffer and send it to processors using a all-to-all
-    // vector call
-    bus_data_pair *sendBuf;
-    sendBuf = new bus_data_pair[newValues.size()];
-    // Fill sendBuf with data from newValues and newKeys
-    int icnt=0;
-    for (i=0; i<nprocs; i++) {
-      j = ltop[i];
-      if (j>=0) {
-        while(j >= 0) {
-          sendBuf[icnt].idx = newKeys[j];
-          sendBuf[icnt].data = newValues[j];
-          j = ldest[j];
-          icnt++;
-        }
-      }
-    }
-
-    // Evaluate offsets for data being sent and received and then correct all
-    // sizes by the number of bytes in bus_data_pair structure
-    int elemsize =  sizeof(bus_data_pair);
-    int destOffset[nprocs];
-    int srcOffset[nprocs];
-    destOffset[0] = 0;
-    srcOffset[0] = 0;
-    for (i=1; i<nprocs; i++) {
-      destOffset[i] = destOffset[i-1] + destNum[i-1];
-      srcOffset[i] = srcOffset[i-1] + srcNum[i-1];
-    }
-    int nvalues = 0;
-    for (i=0; i<nprocs; i++) {
-      nvalues += srcNum[i];
-      destOffset[i] = elemsize*destOffset[i];
-      destNum[i] = elemsize*destNum[i];
-      srcOffset[i] = elemsize*srcOffset[i];
-      srcNum[i] = elemsize*srcNum[i];
-    }
-
-    // Allocate buffer to receive data from other processors
-    bus_data_pair *recvBuf;
-    recvBuf = new bus_data_pair[nvalues];
-    
-    // Transmit data and clean up buffers that are no longer needed
-    ierr = MPI_Alltoallv(sendBuf, destNum, destOffset, MPI_BYTE, recvBuf,
-        srcNum, srcOffset, MPI_BYTE, comm);
-    delete [] sendBuf;
-
-    // Data is now available on processor that can use it. Pack it into final
-    // data structures. Start by creating a map between global and local bus
-    // indices on this processors
-    keys.clear();
-    values.clear();
     int nbus = p_network->numBuses();
     std::multimap<int,int> idxMap;
-    std::pair<int,int> idxPair;
-    // Create map between global index and local index for locally held buses
     for (i=0; i<nbus; i++) {
-      idxPair = std::pair<int,int>(p_network->getOriginalBusIndex(i),i);
-      idxMap.insert(idxPair);
+      idxMap.insert(std::pair<int,int>(p_network->getOriginalBusIndex(i),i));
     }
-    // Get data from recvBuf and pack keys and values arrays
-    // with local indices and data
     std::multimap<int,int>::iterator it;
-    for (i=0; i<nvalues; i++) {
-      it = idxMap.find(recvBuf[i].idx);
-      if (it != idxMap.end()) {
-        while (it != idxMap.upper_bound(recvBuf[i].idx)) {
-          keys.push_back(it->second);
-          values.push_back(recvBuf[i].data);
-          it++;
-        }
-      } else {
-        printf("p[%d] Unresolved original bus index: %d\n",me,
-            recvBuf[i].idx);
-      }
-    }
 
-    delete [] recvBuf;
-#else
-    // Find total number of values going to each processor
-    // and get offsets on each processor for each set  of values
-    int g_numValues = GA_Create_handle();
-    int dims;
-    dims = nprocs;
-    int one = 1;
-    int blocks;
-    blocks = 1;
-    GA_Set_data(g_numValues,one,&dims,C_INT);
-    GA_Set_chunk(g_numValues, &blocks);
-    GA_Set_pgroup(g_numValues, p_GAgrp);
-    GA_Allocate(g_numValues);
-    GA_Zero(g_numValues);
-    int r_offset[nprocs];
-    for (j=0; j<nprocs; j++) {
-      i = (j+me)%nprocs;
-      if (destNum[i] > 0) {
-        r_offset[i] = NGA_Read_inc(g_numValues,&i,destNum[i]);
-      } else {
-        r_offset[i] = 0;
-      }
-    }
-    GA_Pgroup_sync(p_GAgrp);
-    // Copy values from global array to local array
-    int numValues[nprocs];
-    int lo, hi;
-    lo = 0;
-    hi = nprocs-1;
-    if (me == 0) {
-      if (lo<=hi) NGA_Get(g_numValues,&lo,&hi,numValues,&one);
-    } else {
-      for (i=0; i<nprocs; i++) {
-        numValues[i] = 0;
+    // Create one record for every processor that holds the bus
+    std::vector<bus_data_pair> sendBuf;
+    std::vector<int> destProcs;
+    bus_data_pair item;
+    for (i=0; i<ksize; i++) {
+      for (itk = keyMap.lower_bound(keys[i]);
+          itk != keyMap.upper_bound(keys[i]); itk++) {
+        item.idx = keys[i];
+        item.data = values[i];
+        sendBuf.push_back(item);
+        destProcs.push_back(itk->second);
       }
     }
-    char plus[2];
-    strcpy(plus,"+");
-    GA_Pgroup_igop(p_GAgrp,numValues,nprocs,plus);
-    GA_Destroy(g_numValues);
-
-    // Create a global array that can hold all values. Partition the array so
-    // that each processor has enough local memory to hold all values coming to
-    // it
-    int dtype = NGA_Register_type(sizeof(bus_data_pair));
-    // total number of values on all processors
-    int totalVals = 0;
-    for (i=0; i<nprocs; i++) {
-      r_offset[i] += totalVals;
-      totalVals += numValues[i];
-    }
-    if (totalVals == 0) {
-      NGA_Deregister_type(dtype);
-      return;
-    }
-    int g_data = GA_Create_handle();
-    dims = totalVals;
-    GA_Set_data(g_data, one, &dims, dtype);
-    GA_Set_pgroup(g_data,p_GAgrp);
-    int mapc[nprocs];
-    mapc[0] = 0;
-    for (i=1; i<nprocs; i++) {
-      mapc[i] = mapc[i-1] + numValues[i-1];
-    }
-    blocks = nprocs;
-    GA_Set_irreg_distr(g_data,mapc,&blocks);
-    GA_Allocate(g_data);
 
-    // Repack values and send them to the processor with the corresponding buses
-    bus_data_pair *bus_data;
-    int ncnt;
-    for (i=0; i<nprocs; i++) {
-      j = ltop[i];
-      ncnt = 0;
-      if (j >= 0) {
-        bus_data = new bus_data_pair[destNum[i]];
-        while (j >= 0) {
-          bus_data[ncnt].idx = newKeys[j];
-          bus_data[ncnt].data = newValues[j];
-          j = ldest[j];
-          ncnt++;
-        }
-        lo = r_offset[i];
-        hi = lo + destNum[i] - 1;
-        if (lo<=hi) NGA_Put(g_data,&lo,&hi,bus_data,&one);
-        delete [] bus_data;
-      }
-    }
+    // Move all data to the processors that need it in a single exchange
+    std::vector<bus_data_pair> recvBuf;
+    std::vector<int> recvNum;
+    gridpack::parallel::exchangeRecords(p_network->communicator(),
+        sendBuf, destProcs, recvBuf, recvNum);
+    sendBuf.clear();
 
-    GA_Pgroup_sync(p_GAgrp);
-    // Data is now on processor. Unpack it and put it in arrays for export
+    // Pack keys and values arrays with local indices and data
     keys.clear();
     values.clear();
-    int nbus = p_network->numBuses();
-    std::multimap<int,int> idxMap;
-    std::pair<int,int> idxPair;
-    // Create map between global index and local index for locally held buses
-    for (i=0; i<nbus; i++) {
-      idxPair = std::pair<int,int>(p_network->getOriginalBusIndex(i),i);
-      idxMap.insert(idxPair);
-    }
-    // Get data from global array and pack keys and values arrays
-    // with local indices and data
-    int ndata = numValues[me];
-    lo = mapc[me];
-    hi = lo + ndata - 1;
-    if (lo<=hi) NGA_Access(g_data,&lo,&hi,&bus_data,&one);
-    std::multimap<int,int>::iterator it;
-    for (i=0; i<ndata; i++) {
-      it = idxMap.find(bus_data[i].idx);
+    int nvalues = recvBuf.size();
+    for (i=0; i<nvalues; i++) {
+      it = idxMap.find(recvBuf[i].idx);
       if (it != idxMap.end()) {
-        while (it != idxMap.upper_bound(bus_data[i].idx)) {
+        while (it != idxMap.upper_bound(recvBuf[i].idx)) {
           keys.push_back(it->second);
-          values.push_back(bus_data[i].data);
+          values.push_back(recvBuf[i].data);
           it++;
         }
       } else {
         printf("p[%d] Unresolved original bus index: %d\n",me,
-            bus_data[i].idx);
+            recvBuf[i].idx);
       }
     }
-    if (lo<=hi) NGA_Release(g_data,&lo,&hi);
-    GA_Destroy(g_data);
-#endif
 #endif
   }
 
@@ -652,322 +464,239 @@ public:
 #else
     int nprocs = p_network->communicator().size();
     int me = p_network->communicator().rank();
-    // Get global indices corresponding to keys
-    int i,j;
-    // Create a list of unique keys
+    int ksize = keys.size();
+    int vsize = values.size();
+    if (vsize != ksize) {
+      char buf[256];
+      sprintf(buf,"p[%d] HashDistribution::distributeBusValues ERROR: length"
+          " of keys and values arrays don't match ksize: %d vsize: %d\n",
+          me,ksize,vsize);
+      printf("%s",buf);
+      throw gridpack::Exception(buf);
+    }
+    // Find the processors that hold each bus. Each unique key is only
+    // looked up once
+    int i;
     std::vector<int> base_keys;
     std::set<int> key_check;
-    std::set<int>::iterator itc;
-    for (i=0; i<keys.size(); i++) {
-      itc = key_check.find(keys[i]);
-      if (itc == key_check.end()) {
-        key_check.insert(keys[i]);
-        base_keys.push_back(keys[i]);
-      }
+    for (i=0; i<ksize; i++) {
+      if (key_check.insert(keys[i]).second) base_keys.push_back(keys[i]);
     }
     std::vector<int> procLoc;
-    // Get processor that owns global index
     p_indexHashMap->getValues(base_keys,procLoc);
-    // We now know how many processors each unique key maps to. Use this
-    // information to create a complete a  new values list, a new keys list, and
-    // a processor location list
     std::multimap<int,int> keyMap;
     for (i=0; i<base_keys.size(); i++) {
       keyMap.insert(std::pair<int,int>(base_keys[i],procLoc[i]));
     }
-    std::vector<_bus_data_type*> newValues;
-    std::vector<int> newKeys;
-    std::vector<int> destProcs;
     std::multimap<int,int>::iterator itk;
-    _bus_data_type *dptr;
-    for (i=0; i<values.size(); i++) {
-      itk = keyMap.find(keys[i]);
-      if (itk != keyMap.end()) {
-        while (itk != keyMap.upper_bound(keys[i])) {
-          dptr = new _bus_data_type[nvals];
-          for (j=0; j<nvals; j++) {
-            dptr[j] = (values[i])[j];
-          }
-          newValues.push_back(dptr);
-          newKeys.push_back(keys[i]);
-          destProcs.push_back(itk->second);
-          itk++;
-        }
-      }
-    }
 
-    // sort keys into linked list based on which processors they are going to
-    int nsize = newKeys.size();
-    int ltop[nprocs];
-    int ldest[nsize];
-    int destNum[nprocs];
-    for (i=0; i<nprocs; i++) {
-      ltop[i] = -1;
-      destNum[i] = 0;
-    }
-    for (i=0; i<nsize; i++) {
-      ldest[i] = -1;
-    }
-    int iproc;
-    for (i=0; i<nsize; i++) {
-      iproc = destProcs[i];
-      destNum[iproc]++;
-      ldest[i] = ltop[iproc]; 
-      ltop[iproc] = i;
-    }
-#ifdef HASH_WITH_MPI
-    // Use all-to-all call to determine number of unique keys coming from each
+    // Create a map between original and local indices of buses on this
     // processor
-    int srcNum[nprocs];
-    int ierr;
-    int k;
-    int one = 1;
-    MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
-    ierr = MPI_Alltoall(destNum,one,MPI_INT,srcNum,one,MPI_INT,comm);
+    int nbus = p_network->numBuses();
+    std::multimap<int,int> idxMap;
+    for (i=0; i<nbus; i++) {
+      idxMap.insert(std::pair<int,int>(p_network->getOriginalBusIndex(i),i));
+    }
+    std::multimap<int,int>::iterator it;
 
-    // Each process now knows how much data it will receive. Pack data data into
-    // an appropriate sized buffer and send it to processors using a all-to-all
-    // vector call
-    char *sendBuf;
-    sendBuf = new char[newValues.size()
-      * (sizeof(_bus_data_type)*nvals+sizeof(int))];
-    // Fill sendBuf with data from newValues and newKeys
-    char *ptr = sendBuf;
-    for (i=0; i<nprocs; i++) {
-      j = ltop[i];
-      if (j>=0) {
-        while(j >= 0) {
-          ((int*)ptr)[0] = newKeys[j];
-          ptr += sizeof(int);
-          dptr = (_bus_data_type*)ptr;
-          for (k=0; k<nvals; k++) {
-            dptr[k] = (newValues[j])[k];
-          }
-          j = ldest[j];
-          ptr += nvals*sizeof(_bus_data_type);
-        }
+    // Pack one record for every processor that holds the bus. Each record
+    // consists of the original bus index followed by nvals values
+    int elemsize = sizeof(int) + nvals*sizeof(_bus_data_type);
+    std::vector<int> destNum(nprocs,0);
+    for (i=0; i<ksize; i++) {
+      for (itk = keyMap.lower_bound(keys[i]);
+          itk != keyMap.upper_bound(keys[i]); itk++) {
+        destNum[itk->second] += elemsize;
       }
     }
-
-    // Evaluate offsets for data being sent and received and then correct all
-    // sizes by the number of bytes in bus_data_pair structure
-    int elemsize =  nvals*sizeof(_bus_data_type)+sizeof(int);
-    int destOffset[nprocs];
-    int srcOffset[nprocs];
-    destOffset[0] = 0;
-    srcOffset[0] = 0;
+    std::vector<int> destOffset(nprocs,0);
     for (i=1; i<nprocs; i++) {
       destOffset[i] = destOffset[i-1] + destNum[i-1];
-      srcOffset[i] = srcOffset[i-1] + srcNum[i-1];
     }
-    int nvalues = 0;
-    for (i=0; i<nprocs; i++) {
-      nvalues += srcNum[i];
-      destOffset[i] = elemsize*destOffset[i];
-      destNum[i] = elemsize*destNum[i];
-      srcOffset[i] = elemsize*srcOffset[i];
-      srcNum[i] = elemsize*srcNum[i];
+    std::vector<char> sendBuf(destOffset[nprocs-1]+destNum[nprocs-1]);
+    for (i=0; i<ksize; i++) {
+      for (itk = keyMap.lower_bound(keys[i]);
+          itk != keyMap.upper_bound(keys[i]); itk++) {
+        char *ptr = &sendBuf[destOffset[itk->second]];
+        memcpy(ptr, &keys[i], sizeof(int));
+        memcpy(ptr+sizeof(int), values[i], nvals*sizeof(_bus_data_type));
+        destOffset[itk->second] += elemsize;
+      }
     }
 
-    // Allocate buffer to receive data from other processors
-    char *recvBuf;
-    recvBuf = new char[nvalues*(sizeof(_bus_data_type)*nvals+sizeof(int))];
-    
-    // Transmit data and clean up buffers that are no longer needed
-    ierr = MPI_Alltoallv(sendBuf, destNum, destOffset, MPI_BYTE, recvBuf,
-        srcNum, srcOffset, MPI_BYTE, comm);
-    delete [] sendBuf;
+    // Move all data to the processors that need it in a single exchange
+    std::vector<char> recvBuf;
+    std::vector<int> srcNum;
+    gridpack::parallel::exchangeBytes(p_network->communicator(),
+        sendBuf, destNum, recvBuf, srcNum);
+    sendBuf.clear();
 
-    // Data is now available on processor that can use it. Pack it into final
-    // data structures. Start by creating a map between global and local bus
-    // indices on this processors
+    // Pack keys and values arrays with local indices and data
     keys.clear();
-    int vsize = values.size();
     for (i=0; i<vsize; i++) {
       delete [] values[i];
     }
     values.clear();
-    int nbus = p_network->numBuses();
-    std::multimap<int,int> idxMap;
-    std::pair<int,int> idxPair;
-    // Create map between global index and local index for locally held buses
-    for (i=0; i<nbus; i++) {
-      idxPair = std::pair<int,int>(p_network->getOriginalBusIndex(i),i);
-      idxMap.insert(idxPair);
-    }
-    // Get data from recvBuf and pack keys and values arrays
-    // with local indices and data
-    std::multimap<int,int>::iterator it;
-    _bus_data_type *rptr;
+    int nvalues = recvBuf.size()/elemsize;
     int idx;
-    ptr = recvBuf;
     for (i=0; i<nvalues; i++) {
-      idx = ((int*)ptr)[0];
-      ptr += sizeof(int);
+      const char *ptr = &recvBuf[static_cast<size_t>(i)*elemsize];
+      memcpy(&idx, ptr, sizeof(int));
       it = idxMap.find(idx);
-      rptr = (_bus_data_type*)ptr;
-      ptr += nvals*sizeof(_bus_data_type);
       if (it != idxMap.end()) {
         while (it != idxMap.upper_bound(idx)) {
-          dptr = new _bus_data_type[nvals];
-          for (j=0; j<nvals; j++) {
-            dptr[j] = rptr[j];
-          }
+          _bus_data_type *data = new _bus_data_type[nvals];
+          memcpy(data, ptr+sizeof(int), nvals*sizeof(_bus_data_type));
           keys.push_back(it->second);
-          values.push_back(dptr);
+          values.push_back(data);
           it++;
         }
       } else {
-        printf("p[%d] Unresolved original bus index: %d\n",me,
-            idx);
+        printf("p[%d] Unresolved original bus index: %d\n",me,idx);
       }
     }
+#endif
+  }
 
-    delete [] recvBuf;
+  // Send variable length records corresponding to keys to the processors
+  // that own them. On completion, keys contain the local indices of the buses
+  // receiving data and values contains the records
+  // @param keys on input, a list of integer keys corresponding to the original
+  // bus indices of the buses that receive the data, on output, a list of local
+  // bus indices
+  // @param values on input, a list of records corresponding to the list of
+  // keys. Records may have different lengths. On output, the received records
+  void distributeBusRecords(std::vector<int> &keys,
+      std::vector<std::vector<_bus_data_type> > &values)
+  {
+    int me = p_network->communicator().rank();
+    int ksize = keys.size();
+    int vsize = values.size();
+    if (vsize != ksize) {
+      char buf[256];
+      sprintf(buf,"p[%d] HashDistribution::distributeBusRecords ERROR: length"
+          " of keys and values arrays don't match ksize: %d vsize: %d\n",
+          me,ksize,vsize);
+      printf("%s",buf);
+      throw gridpack::Exception(buf);
+    }
+    int i;
+#ifdef SYSTOLIC
+    // Pad records to a common length, with the record length stored in
+    // front, and use the fixed length distribution
+    int lsize = (sizeof(int)+sizeof(_bus_data_type)-1)/sizeof(_bus_data_type);
+    int maxlen = 0;
+    for (i=0; i<ksize; i++) {
+      if (static_cast<int>(values[i].size()) > maxlen)
+        maxlen = values[i].size();
+    }
+    char cmax[4];
+    strcpy(cmax,"max");
+    GA_Pgroup_igop(p_GAgrp,&maxlen,1,cmax);
+    int nvals = lsize+maxlen;
+    std::vector<_bus_data_type*> padded(ksize);
+    for (i=0; i<ksize; i++) {
+      int len = values[i].size();
+      padded[i] = new _bus_data_type[nvals];
+      memcpy(padded[i], &len, sizeof(int));
+      if (len > 0) memcpy(padded[i]+lsize, &values[i][0],
+          len*sizeof(_bus_data_type));
+    }
+    distributeBusValues(keys, padded, nvals);
+    int nvalues = padded.size();
+    values.resize(nvalues);
+    for (i=0; i<nvalues; i++) {
+      int len;
+      memcpy(&len, padded[i], sizeof(int));
+      values[i].assign(padded[i]+lsize, padded[i]+lsize+len);
+      delete [] padded[i];
+    }
 #else
-    // Find total number of values going to each processor
-    // and get offsets on each processor for each set  of values
-    int g_numValues = GA_Create_handle();
-    int dims;
-    dims = nprocs;
-    int one = 1;
-    int blocks;
-    blocks = 1;
-    GA_Set_data(g_numValues,one,&dims,C_INT);
-    GA_Set_chunk(g_numValues, &blocks);
-    GA_Set_pgroup(g_numValues, p_GAgrp);
-    GA_Allocate(g_numValues);
-    GA_Zero(g_numValues);
-    int r_offset[nprocs];
-    for (j=0; j<nprocs; j++) {
-      i = (j+me)%nprocs;
-      if (destNum[i] > 0) {
-        r_offset[i] = NGA_Read_inc(g_numValues,&i,destNum[i]);
-      } else {
-        r_offset[i] = 0;
-      }
+    int nprocs = p_network->communicator().size();
+    // Find the processors that hold each bus. Each unique key is only
+    // looked up once
+    std::vector<int> base_keys;
+    std::set<int> key_check;
+    for (i=0; i<ksize; i++) {
+      if (key_check.insert(keys[i]).second) base_keys.push_back(keys[i]);
     }
-    GA_Pgroup_sync(p_GAgrp);
-    // Copy values from global array to local array
-    int numValues[nprocs];
-    int lo, hi;
-    lo = 0;
-    hi = nprocs-1;
-    if (me == 0) {
-      if (lo<=hi) NGA_Get(g_numValues,&lo,&hi,numValues,&one);
-    } else {
-      for (i=0; i<nprocs; i++) {
-        numValues[i] = 0;
-      }
+    std::vector<int> procLoc;
+    p_indexHashMap->getValues(base_keys,procLoc);
+    std::multimap<int,int> keyMap;
+    for (i=0; i<base_keys.size(); i++) {
+      keyMap.insert(std::pair<int,int>(base_keys[i],procLoc[i]));
     }
-    char plus[2];
-    strcpy(plus,"+");
-    GA_Pgroup_igop(p_GAgrp,numValues,nprocs,plus);
-    GA_Destroy(g_numValues);
+    std::multimap<int,int>::iterator itk;
 
-    // Create a global array that can hold all values. Partition the array so
-    // that each processor has enough local memory to hold all values coming to
-    // it
-    int dataSize = nvals*sizeof(_bus_data_type)+sizeof(int);
-    int dtype = NGA_Register_type(dataSize);
-    // total number of values on all processors
-    int totalVals = 0;
-    for (i=0; i<nprocs; i++) {
-      r_offset[i] += totalVals;
-      totalVals += numValues[i];
+    // Create a map between original and local indices of buses on this
+    // processor
+    int nbus = p_network->numBuses();
+    std::multimap<int,int> idxMap;
+    for (i=0; i<nbus; i++) {
+      idxMap.insert(std::pair<int,int>(p_network->getOriginalBusIndex(i),i));
     }
-    if (totalVals == 0) {
-      NGA_Deregister_type(dtype);
-      return;
+    std::multimap<int,int>::iterator it;
+
+    // Pack one record for every processor that holds the bus. Each record
+    // consists of the original bus index and the record length followed by
+    // the record itself
+    const int hsize = 2*sizeof(int);
+    std::vector<int> destNum(nprocs,0);
+    for (i=0; i<ksize; i++) {
+      int nbytes = hsize + values[i].size()*sizeof(_bus_data_type);
+      for (itk = keyMap.lower_bound(keys[i]);
+          itk != keyMap.upper_bound(keys[i]); itk++) {
+        destNum[itk->second] += nbytes;
+      }
     }
-    int g_data = GA_Create_handle();
-    dims = totalVals;
-    GA_Set_data(g_data, one, &dims, dtype);
-    GA_Set_pgroup(g_data,p_GAgrp);
-    int mapc[nprocs];
-    mapc[0] = 0;
+    std::vector<int> destOffset(nprocs,0);
     for (i=1; i<nprocs; i++) {
-      mapc[i] = mapc[i-1] + numValues[i-1];
+      destOffset[i] = destOffset[i-1] + destNum[i-1];
     }
-    blocks = nprocs;
-    GA_Set_irreg_distr(g_data,mapc,&blocks);
-    GA_Allocate(g_data);
-
-    // Repack values and send them to the processor with the corresponding buses
-    char *bus_data, *ptr;
-    int k;
-    for (i=0; i<nprocs; i++) {
-      j = ltop[i];
-      if (j >= 0) {
-        bus_data = new char[dataSize*destNum[i]];
-        ptr = bus_data;
-        while (j >= 0) {
-          ((int*)ptr)[0] = newKeys[j];
-          ptr += sizeof(int);
-          dptr = (_bus_data_type*)ptr;
-          for (k=0; k<nvals; k++) {
-             dptr[k] = (newValues[j])[k];
-          }
-          ptr += nvals*sizeof(_bus_data_type);
-          j = ldest[j];
-        }
-        lo = r_offset[i];
-        hi = lo + destNum[i] - 1;
-        if (lo<=hi) NGA_Put(g_data,&lo,&hi,bus_data,&one);
-        delete [] bus_data;
+    std::vector<char> sendBuf(destOffset[nprocs-1]+destNum[nprocs-1]);
+    for (i=0; i<ksize; i++) {
+      int len = values[i].size();
+      int nbytes = len*sizeof(_bus_data_type);
+      for (itk = keyMap.lower_bound(keys[i]);
+          itk != keyMap.upper_bound(keys[i]); itk++) {
+        char *ptr = &sendBuf[destOffset[itk->second]];
+        memcpy(ptr, &keys[i], sizeof(int));
+        memcpy(ptr+sizeof(int), &len, sizeof(int));
+        if (len > 0) memcpy(ptr+hsize, &values[i][0], nbytes);
+        destOffset[itk->second] += hsize+nbytes;
       }
     }
 
-    GA_Pgroup_sync(p_GAgrp);
-    // Data is now on processor. Unpack it and put it in arrays for export
+    // Move all data to the processors that need it in a single exchange
+    std::vector<char> recvBuf;
+    std::vector<int> srcNum;
+    gridpack::parallel::exchangeBytes(p_network->communicator(),
+        sendBuf, destNum, recvBuf, srcNum);
+    sendBuf.clear();
+
+    // Unpack records into keys and values arrays
     keys.clear();
-    int vsize = values.size();
-    for (i=0; i<vsize; i++) {
-      delete [] values[i];
-    }
     values.clear();
-    int nbus = p_network->numBuses();
-    std::multimap<int,int> idxMap;
-    std::pair<int,int> idxPair;
-    // Create map between global index and local index for locally held buses
-    for (i=0; i<nbus; i++) {
-      idxPair = std::pair<int,int>(p_network->getOriginalBusIndex(i),i);
-      idxMap.insert(idxPair);
-    }
-    // Get data from global array and pack keys and values arrays
-    // with local indices and data
-    int ndata = numValues[me];
-    lo = mapc[me];
-    hi = lo + ndata - 1;
-    if (lo<=hi) NGA_Access(g_data,&lo,&hi,&bus_data,&one);
-    std::multimap<int,int>::iterator it;
-    int idx;
-    ptr = bus_data;
-    _bus_data_type *rptr;
-    for (i=0; i<ndata; i++) {
-      idx = ((int*)ptr)[0];
-      ptr += sizeof(int);
+    size_t pos = 0;
+    while (pos < recvBuf.size()) {
+      int idx, len;
+      memcpy(&idx, &recvBuf[pos], sizeof(int));
+      memcpy(&len, &recvBuf[pos+sizeof(int)], sizeof(int));
+      const char *data = &recvBuf[pos+hsize];
+      pos += hsize + len*sizeof(_bus_data_type);
       it = idxMap.find(idx);
-      rptr = (_bus_data_type*)ptr;
-      ptr += nvals*sizeof(_bus_data_type);
       if (it != idxMap.end()) {
         while (it != idxMap.upper_bound(idx)) {
           keys.push_back(it->second);
-          dptr = new _bus_data_type[nvals];
-          for (j=0; j<nvals; j++) {
-            dptr[j] = rptr[j];
-          }
-          values.push_back(dptr);
+          values.push_back(std::vector<_bus_data_type>(len));
+          if (len > 0) memcpy(&values.back()[0], data,
+              len*sizeof(_bus_data_type));
           it++;
         }
       } else {
-        printf("p[%d] Unresolved original bus index: %d\n",me,
-            idx);
+        printf("p[%d] Unresolved original bus index: %d\n",me,idx);
       }
     }
-    if (lo<=hi) NGA_Release(g_data,&lo,&hi);
-    GA_Destroy(g_data);
-#endif
 #endif
   }
 
@@ -1103,291 +832,86 @@ public:
     }
     GA_Destroy(g_vals);
 #else
-    int nprocs = p_network->communicator().size();
     int me = p_network->communicator().rank();
-    // Get global indices corresponding to keys
-    int i,j;
-    // Create a list of unique keys
+    int ksize = keys.size();
+    int vsize = values.size();
+    if (vsize != ksize) {
+      char buf[256];
+      sprintf(buf,"p[%d] HashDistribution::distributeBranchValues ERROR: length"
+          " of keys and values arrays don't match ksize: %d vsize: %d\n",
+          me,ksize,vsize);
+      printf("%s",buf);
+      throw gridpack::Exception(buf);
+    }
+    // Find the processors that hold each branch. Each unique key is only
+    // looked up once
+    int i;
     std::vector<std::pair<int,int> > base_keys;
     std::set<std::pair<int,int> > key_check;
-    std::set<std::pair<int,int> >::iterator itc;
-    for (i=0; i<keys.size(); i++) {
-      itc = key_check.find(keys[i]);
-      if (itc == key_check.end()) {
-        key_check.insert(keys[i]);
-        base_keys.push_back(keys[i]);
-      }
+    for (i=0; i<ksize; i++) {
+      if (key_check.insert(keys[i]).second) base_keys.push_back(keys[i]);
     }
     std::vector<int> procLoc;
-    // Get processor that owns global index
     p_indexHashMap->getValues(base_keys,procLoc);
-    // We now know how many processors each unique key maps to. Use this
-    // information to create a complete a  new values list, a new keys list, and
-    // a processor location list
     std::multimap<std::pair<int,int>,int> keyMap;
     for (i=0; i<base_keys.size(); i++) {
       keyMap.insert(std::pair<std::pair<int,int>,int>(base_keys[i],procLoc[i]));
     }
-    std::vector<_branch_data_type> newValues;
-    std::vector<std::pair<int,int> > newKeys;
-    std::vector<int> destProcs;
-    j = 0;
     std::multimap<std::pair<int,int>,int>::iterator itk;
-    for (i=0; i<values.size(); i++) {
-      itk = keyMap.find(keys[i]);
-      if (itk != keyMap.end()) {
-        while (itk != keyMap.upper_bound(keys[i])) {
-          newValues.push_back(values[i]);
-          newKeys.push_back(keys[i]);
-          destProcs.push_back(itk->second);
-          itk++;
-        }
-      }
-    }
 
-    // sort keys into linked list based on which processors they are going to
-    int nsize = newKeys.size();
-    int ltop[nprocs];
-    int ldest[nsize];
-    int destNum[nprocs];
-    for (i=0; i<nprocs; i++) {
-      ltop[i] = -1;
-      destNum[i] = 0;
-    }
-    for (i=0; i<nsize; i++) {
-      ldest[i] = -1;
-    }
-    int iproc;
-    for (i=0; i<nsize; i++) {
-      iproc = destProcs[i];
-      destNum[iproc]++;
-      ldest[i] = ltop[iproc]; 
-      ltop[iproc] = i;
-    }
-#ifdef HASH_WITH_MPI
-    // Use all-to-all call to determine number of unique keys coming from each
-    // processor
-    int srcNum[nprocs];
-    int ierr;
-    int one = 1;
-    MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
-    ierr = MPI_Alltoall(destNum,one,MPI_INT,srcNum,one,MPI_INT,comm);
-
-    // Each process now knows how much data it will receive. Pack data data into
-    // an appropriate sized buffer and send it to processors using a all-to-all
-    // vector call
-    branch_data_pair *sendBuf;
-    sendBuf = new branch_data_pair[newValues.size()];
-    // Fill sendBuf with data from newValues and newKeys
-    int icnt = 0;
-    for (i=0; i<nprocs; i++) {
-      j = ltop[i];
-      if (j>=0) {
-        while(j >= 0) {
-          sendBuf[icnt].idx1 = newKeys[j].first;
-          sendBuf[icnt].idx2 = newKeys[j].second;
-          sendBuf[icnt].data = newValues[j];
-          j = ldest[j];
-          icnt++;
-        }
-      }
-    }
-
-    // Evaluate offsets for data being sent and received and then correct all
-    // sizes by the number of bytes in branch_data_pair structure
-    int elemsize =  sizeof(branch_data_pair);
-    int destOffset[nprocs];
-    int srcOffset[nprocs];
-    destOffset[0] = 0;
-    srcOffset[0] = 0;
-    for (i=1; i<nprocs; i++) {
-      destOffset[i] = destOffset[i-1] + destNum[i-1];
-      srcOffset[i] = srcOffset[i-1] + srcNum[i-1];
-    }
-    int nvalues = 0;
-    for (i=0; i<nprocs; i++) {
-      nvalues += srcNum[i];
-      destOffset[i] = elemsize*destOffset[i];
-      destNum[i] = elemsize*destNum[i];
-      srcOffset[i] = elemsize*srcOffset[i];
-      srcNum[i] = elemsize*srcNum[i];
-    }
-
-    // Allocate buffer to receive data from other processors
-    branch_data_pair *recvBuf;
-    recvBuf = new branch_data_pair[nvalues];
-    
-    // Transmit data and clean up buffers that are no longer needed
-    ierr = MPI_Alltoallv(sendBuf, destNum, destOffset, MPI_BYTE, recvBuf,
-        srcNum, srcOffset, MPI_BYTE, comm);
-    delete [] sendBuf;
-
-    // Data is now available on processor that can use it. Pack it into final
-    // data structures. Start by creating a map between global and local branch
-    // indices on this processor
-    values.clear();
-    branch_ids.clear();
+    // Create a map between original endpoint indices and local indices of
+    // branches on this processor
     int nbranch = p_network->numBranches();
     std::multimap<std::pair<int,int>,int> idxMap;
-    std::pair<std::pair<int,int>,int> idxPair;
-    // Create map between global index and local index for locally held buses
     int idx1, idx2;
     std::pair<int,int> key;
     for (i=0; i<nbranch; i++) {
       p_network->getOriginalBranchEndpoints(i,&idx1,&idx2);
       key = std::pair<int,int>(idx1,idx2);
-      idxPair = std::pair<std::pair<int,int>,int>(key,i);
-      idxMap.insert(idxPair);
+      idxMap.insert(std::pair<std::pair<int,int>,int>(key,i));
     }
-    // Get data from recvBuf and pack keys and values arrays
-    // with local indices and data
     std::multimap<std::pair<int,int>,int>::iterator it;
-    for (i=0; i<nvalues; i++) {
-      key = std::pair<int,int>(recvBuf[i].idx1,recvBuf[i].idx2);
-      it = idxMap.find(key);
-      if (it != idxMap.end()) {
-        while (it != idxMap.upper_bound(key)) {
-          branch_ids.push_back(it->second);
-          values.push_back(recvBuf[i].data);
-          it++;
-        }
-      } else {
-        printf("p[%d] Unresolved original branch index: < %d, %d>\n",me,
-            recvBuf[i].idx1,recvBuf[i].idx2);
-      }
-    }
 
-    delete [] recvBuf;
-#else
-    // Find total number of values going to each processor
-    // and get offsets on each processor for each set  of values
-    int g_numValues = GA_Create_handle();
-    int dims;
-    dims = nprocs;
-    int one = 1;
-    int blocks;
-    blocks = 1;
-    GA_Set_data(g_numValues,one,&dims,C_INT);
-    GA_Set_chunk(g_numValues, &blocks);
-    GA_Set_pgroup(g_numValues, p_GAgrp);
-    GA_Allocate(g_numValues);
-    GA_Zero(g_numValues);
-    int r_offset[nprocs];
-    for (j=0; j<nprocs; j++) {
-      i = (j+me)%nprocs;
-      if (destNum[i] > 0) {
-        r_offset[i] = NGA_Read_inc(g_numValues,&i,destNum[i]);
-      } else {
-        r_offset[i] = 0;
-      }
-    }
-    GA_Pgroup_sync(p_GAgrp);
-    // Copy values from global array to local array
-    int numValues[nprocs];
-    int lo, hi;
-    lo = 0;
-    hi = nprocs-1;
-    if (me == 0) {
-      if (lo<=hi) NGA_Get(g_numValues,&lo,&hi,numValues,&one);
-    } else {
-      for (i=0; i<nprocs; i++) {
-        numValues[i] = 0;
+    // Create one record for every processor that holds the branch
+    std::vector<branch_data_pair> sendBuf;
+    std::vector<int> destProcs;
+    branch_data_pair item;
+    for (i=0; i<ksize; i++) {
+      for (itk = keyMap.lower_bound(keys[i]);
+          itk != keyMap.upper_bound(keys[i]); itk++) {
+        item.idx1 = keys[i].first;
+        item.idx2 = keys[i].second;
+        item.data = values[i];
+        sendBuf.push_back(item);
+        destProcs.push_back(itk->second);
       }
     }
-    char plus[2];
-    strcpy(plus,"+");
-    GA_Pgroup_igop(p_GAgrp,numValues,nprocs,plus);
-    GA_Destroy(g_numValues);
-
-    // Create a global array that can hold all values. Partition the array so
-    // that each processor has enough local memory to hold all values coming to
-    // it
-    int dtype = NGA_Register_type(sizeof(branch_data_pair));
-    // total number of values on all processors
-    int totalVals = 0;
-    for (i=0; i<nprocs; i++) {
-      r_offset[i] += totalVals;
-      totalVals += numValues[i];
-    }
-    if (totalVals == 0) {
-      NGA_Deregister_type(dtype);
-      return;
-    }
-    int g_data = GA_Create_handle();
-    dims = totalVals;
-    GA_Set_data(g_data, one, &dims, dtype);
-    GA_Set_pgroup(g_data,p_GAgrp);
-    int mapc[nprocs];
-    mapc[0] = 0;
-    for (i=1; i<nprocs; i++) {
-      mapc[i] = mapc[i-1] + numValues[i-1];
-    }
-    blocks = nprocs;
-    GA_Set_irreg_distr(g_data,mapc,&blocks);
-    GA_Allocate(g_data);
 
-    // Repack values and send them to the processor with the corresponding
-    // branches
-    branch_data_pair *branch_data;
-    int ncnt;
-    for (i=0; i<nprocs; i++) {
-      j = ltop[i];
-      ncnt = 0;
-      if (j >= 0) {
-        branch_data = new branch_data_pair[destNum[i]];
-        while (j >= 0) {
-          branch_data[ncnt].idx1 = newKeys[j].first;
-          branch_data[ncnt].idx2 = newKeys[j].second;
-          branch_data[ncnt].data = newValues[j];
-          j = ldest[j];
-          ncnt++;
-        }
-        lo = r_offset[i];
-        hi = lo + destNum[i] - 1;
-        if (lo<=hi) NGA_Put(g_data,&lo,&hi,branch_data,&one);
-        delete [] branch_data;
-      }
-    }
+    // Move all data to the processors that need it in a single exchange
+    std::vector<branch_data_pair> recvBuf;
+    std::vector<int> recvNum;
+    gridpack::parallel::exchangeRecords(p_network->communicator(),
+        sendBuf, destProcs, recvBuf, recvNum);
+    sendBuf.clear();
 
-    GA_Pgroup_sync(p_GAgrp);
-    // Data is now on processor. Unpack it and put it in arrays for export
-    keys.clear();
+    // Pack branch_ids and values arrays with local indices and data
     values.clear();
-    int nbranch = p_network->numBranches();
-    std::multimap<std::pair<int,int>,int> idxMap;
-    std::pair<std::pair<int,int>,int> idxPair;
-    // Create map between global index and local index for locally held branches
-    int idx1, idx2;
-    for (i=0; i<nbranch; i++) {
-      p_network->getOriginalBranchEndpoints(i,&idx1,&idx2);
-      idxPair = std::pair<std::pair<int,int>,int>(std::pair<int,int>(idx1,idx2),i);
-      idxMap.insert(idxPair);
-    }
-    // Get data from global array and pack keys and values arrays
-    // with local indices and data
-    int ndata = numValues[me];
-    lo = mapc[me];
-    hi = lo + ndata - 1;
-    if (lo<=hi) NGA_Access(g_data,&lo,&hi,&branch_data,&one);
-    std::multimap<std::pair<int,int>,int>::iterator it;
-    std::pair<int,int> key;
-    for (i=0; i<ndata; i++) {
-      key = std::pair<int,int>(branch_data[i].idx1,branch_data[i].idx2);
+    branch_ids.clear();
+    int nvalues = recvBuf.size();
+    for (i=0; i<nvalues; i++) {
+      key = std::pair<int,int>(recvBuf[i].idx1,recvBuf[i].idx2);
       it = idxMap.find(key);
       if (it != idxMap.end()) {
         while (it != idxMap.upper_bound(key)) {
           branch_ids.push_back(it->second);
-          values.push_back(branch_data[i].data);
+          values.push_back(recvBuf[i].data);
           it++;
         }
       } else {
         printf("p[%d] Unresolved original branch index: < %d, %d >\n",me,
-            branch_data[i].idx1,branch_data[i].idx2);
+            recvBuf[i].idx1,recvBuf[i].idx2);
       }
     }
-    if (lo<=hi) NGA_Release(g_data,&lo,&hi);
-    GA_Destroy(g_data);
-#endif
 #endif
   }
 
@@ -1541,330 +1065,106 @@ public:
 #else
     int nprocs = p_network->communicator().size();
     int me = p_network->communicator().rank();
-    // Get global indices corresponding to keys
-    int i,j;
-    // Create a list of unique keys
+    int ksize = keys.size();
+    int vsize = values.size();
+    if (vsize != ksize) {
+      char buf[256];
+      sprintf(buf,"p[%d] HashDistribution::distributeBranchValues ERROR: length"
+          " of keys and values arrays don't match ksize: %d vsize: %d\n",
+          me,ksize,vsize);
+      printf("%s",buf);
+      throw gridpack::Exception(buf);
+    }
+    // Find the processors that hold each branch. Each unique key is only
+    // looked up once
+    int i;
     std::vector<std::pair<int,int> > base_keys;
     std::set<std::pair<int,int> > key_check;
-    std::set<std::pair<int,int> >::iterator itc;
-    for (i=0; i<keys.size(); i++) {
-      itc = key_check.find(keys[i]);
-      if (itc == key_check.end()) {
-        key_check.insert(keys[i]);
-        base_keys.push_back(keys[i]);
-      }
+    for (i=0; i<ksize; i++) {
+      if (key_check.insert(keys[i]).second) base_keys.push_back(keys[i]);
     }
     std::vector<int> procLoc;
-    // Get processor that owns global index
     p_indexHashMap->getValues(base_keys,procLoc);
-    // We now know how many processors each unique key maps to. Use this
-    // information to create a complete a  new values list, a new keys list, and
-    // a processor location list
     std::multimap<std::pair<int,int>,int> keyMap;
     for (i=0; i<base_keys.size(); i++) {
       keyMap.insert(std::pair<std::pair<int,int>,int>(base_keys[i],procLoc[i]));
     }
-    std::vector<_branch_data_type*> newValues;
-    std::vector<std::pair<int,int> > newKeys;
-    std::vector<int> destProcs;
     std::multimap<std::pair<int,int>,int>::iterator itk;
-    _branch_data_type *dptr;
-    for (i=0; i<values.size(); i++) {
-      itk = keyMap.find(keys[i]);
-      if (itk != keyMap.end()) {
-        while (itk != keyMap.upper_bound(keys[i])) {
-          dptr = new _branch_data_type[nvals];
-          for (j=0; j<nvals; j++) {
-            dptr[j] = (values[i])[j];
-          }
-          newValues.push_back(values[i]);
-          newKeys.push_back(keys[i]);
-          destProcs.push_back(itk->second);
-          itk++;
-        }
-      }
-    }
-
-    // sort keys into linked list based on which processors they are going to
-    int nsize = newKeys.size();
-    int ltop[nprocs];
-    int ldest[nsize];
-    int destNum[nprocs];
-    for (i=0; i<nprocs; i++) {
-      ltop[i] = -1;
-      destNum[i] = 0;
-    }
-    for (i=0; i<nsize; i++) {
-      ldest[i] = -1;
-    }
-    int iproc;
-    for (i=0; i<nsize; i++) {
-      iproc = destProcs[i];
-      destNum[iproc]++;
-      ldest[i] = ltop[iproc]; 
-      ltop[iproc] = i;
-    }
-#ifdef HASH_WITH_MPI
-    // Use all-to-all call to determine number of unique keys coming from each
-    // processor
-    int srcNum[nprocs];
-    int ierr;
-    int one = 1;
-    MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
-    ierr = MPI_Alltoall(destNum,one,MPI_INT,srcNum,one,MPI_INT,comm);
 
-    // Each process now knows how much data it will receive. Pack data data into
-    // an appropriate sized buffer and send it to processors using a all-to-all
-    // vector call
-    char *sendBuf;
-    sendBuf = new char[newValues.size()
-      * (sizeof(_branch_data_type)*nvals+2*sizeof(int))];
-    // Fill sendBuf with data from newValues and newKeys
-    char *ptr = sendBuf;
-    int k;
-    for (i=0; i<nprocs; i++) {
-      j = ltop[i];
-      if (j>=0) {
-        while(j >= 0) {
-          ((int*)ptr)[0] = newKeys[j].first;
-          ((int*)ptr)[1] = newKeys[j].second;
-          ptr += 2*sizeof(int);
-          dptr = (_branch_data_type*)ptr;
-          for (k=0; k<nvals; k++) {
-            dptr[k] = (newValues[j])[k];
-          }
-          j = ldest[j];
-          ptr += nvals*sizeof(_branch_data_type);
-        }
-      }
-    }
-
-    // Evaluate offsets for data being sent and received and then correct all
-    // sizes by the number of bytes in branch_data_pair structure
-    int elemsize =  nvals*sizeof(_branch_data_type)+2*sizeof(int);
-    int destOffset[nprocs];
-    int srcOffset[nprocs];
-    destOffset[0] = 0;
-    srcOffset[0] = 0;
-    for (i=1; i<nprocs; i++) {
-      destOffset[i] = destOffset[i-1] + destNum[i-1];
-      srcOffset[i] = srcOffset[i-1] + srcNum[i-1];
-    }
-    int nvalues = 0;
-    for (i=0; i<nprocs; i++) {
-      nvalues += srcNum[i];
-      destOffset[i] = elemsize*destOffset[i];
-      destNum[i] = elemsize*destNum[i];
-      srcOffset[i] = elemsize*srcOffset[i];
-      srcNum[i] = elemsize*srcNum[i];
-    }
-
-    // Allocate buffer to receive data from other processors
-    char *recvBuf;
-    recvBuf = new char[nvalues*(sizeof(_branch_data_type)*nvals+2*sizeof(int))];
-    
-    // Transmit data and clean up buffers that are no longer needed
-    ierr = MPI_Alltoallv(sendBuf, destNum, destOffset, MPI_BYTE, recvBuf,
-        srcNum, srcOffset, MPI_BYTE, comm);
-    delete [] sendBuf;
-
-    // Data is now available on processor that can use it. Pack it into final
-    // data structures. Start by creating a map between global and local branch
-    // indices on this processor
-    int vsize = values.size();
-    for (i=0; i<vsize; i++) {
-      delete [] values[i];
-    }
-    values.clear();
-    branch_ids.clear();
+    // Create a map between original endpoint indices and local indices of
+    // branches on this processor
     int nbranch = p_network->numBranches();
     std::multimap<std::pair<int,int>,int> idxMap;
-    std::pair<std::pair<int,int>,int> idxPair;
-    // Create map between global index and local index for locally held buses
     int idx1, idx2;
     std::pair<int,int> key;
     for (i=0; i<nbranch; i++) {
       p_network->getOriginalBranchEndpoints(i,&idx1,&idx2);
       key = std::pair<int,int>(idx1,idx2);
-      idxPair = std::pair<std::pair<int,int>,int>(key,i);
-      idxMap.insert(idxPair);
+      idxMap.insert(std::pair<std::pair<int,int>,int>(key,i));
     }
-    // Get data from recvBuf and pack keys and values arrays
-    // with local indices and data
     std::multimap<std::pair<int,int>,int>::iterator it;
-    _branch_data_type *rptr;
-    ptr = recvBuf;
-    for (i=0; i<nvalues; i++) {
-      key = std::pair<int,int>(((int*)ptr)[0], ((int*)ptr)[1]);
-      ptr += 2*sizeof(int);
-      it = idxMap.find(key);
-      rptr = (_branch_data_type*)ptr;
-      ptr += nvals*sizeof(_branch_data_type);
-      if (it != idxMap.end()) {
-        while (it != idxMap.upper_bound(key)) {
-          dptr = new _branch_data_type[nvals];
-          for (j=0; j<nvals; j++) {
-            dptr[j] = rptr[j];
-          }
-          branch_ids.push_back(it->second);
-          values.push_back(dptr);
-          it++;
-        }
-      } else {
-        printf("p[%d] Unresolved original branch index: < %d, %d>\n",me,
-            key.first,key.second);
-      }
-    }
 
-    delete [] recvBuf;
-#else
-    // Find total number of values going to each processor
-    // and get offsets on each processor for each set  of values
-    int g_numValues = GA_Create_handle();
-    int dims;
-    dims = nprocs;
-    int one = 1;
-    int blocks;
-    blocks = 1;
-    GA_Set_data(g_numValues,one,&dims,C_INT);
-    GA_Set_chunk(g_numValues, &blocks);
-    GA_Set_pgroup(g_numValues, p_GAgrp);
-    GA_Allocate(g_numValues);
-    GA_Zero(g_numValues);
-    int r_offset[nprocs];
-    for (j=0; j<nprocs; j++) {
-      i = (j+me)%nprocs;
-      if (destNum[i] > 0) {
-        r_offset[i] = NGA_Read_inc(g_numValues,&i,destNum[i]);
-      } else {
-        r_offset[i] = 0;
-      }
-    }
-    GA_Pgroup_sync(p_GAgrp);
-    // Copy values from global array to local array
-    int numValues[nprocs];
-    int lo, hi;
-    lo = 0;
-    hi = nprocs-1;
-    if (me == 0) {
-      if (lo<=hi) NGA_Get(g_numValues,&lo,&hi,numValues,&one);
-    } else {
-      for (i=0; i<nprocs; i++) {
-        numValues[i] = 0;
+    // Pack one record for every processor that holds the branch. Each
+    // record consists of the original indices of the branch endpoints
+    // followed by nvals values
+    int elemsize = 2*sizeof(int) + nvals*sizeof(_branch_data_type);
+    std::vector<int> destNum(nprocs,0);
+    for (i=0; i<ksize; i++) {
+      for (itk = keyMap.lower_bound(keys[i]);
+          itk != keyMap.upper_bound(keys[i]); itk++) {
+        destNum[itk->second] += elemsize;
       }
     }
-    char plus[2];
-    strcpy(plus,"+");
-    GA_Pgroup_igop(p_GAgrp,numValues,nprocs,plus);
-    GA_Destroy(g_numValues);
-
-    // Create a global array that can hold all values. Partition the array so
-    // that each processor has enough local memory to hold all values coming to
-    // it
-    int dataSize = nvals*sizeof(_branch_data_type)+2*sizeof(int);
-    int dtype = NGA_Register_type(dataSize);
-    // total number of values on all processors
-    int totalVals = 0;
-    for (i=0; i<nprocs; i++) {
-      r_offset[i] += totalVals;
-      totalVals += numValues[i];
-    }
-    if (totalVals == 0) {
-      NGA_Deregister_type(dtype);
-      return;
-    }
-    int g_data = GA_Create_handle();
-    dims = totalVals;
-    GA_Set_data(g_data, one, &dims, dtype);
-    GA_Set_pgroup(g_data,p_GAgrp);
-    int mapc[nprocs];
-    mapc[0] = 0;
+    std::vector<int> destOffset(nprocs,0);
     for (i=1; i<nprocs; i++) {
-      mapc[i] = mapc[i-1] + numValues[i-1];
+      destOffset[i] = destOffset[i-1] + destNum[i-1];
     }
-    blocks = nprocs;
-    GA_Set_irreg_distr(g_data,mapc,&blocks);
-    GA_Allocate(g_data);
-
-    // Repack values and send them to the processor with the corresponding
-    // branches
-    char *branch_data, *ptr;
-    int k;
-    for (i=0; i<nprocs; i++) {
-      j = ltop[i];
-      if (j >= 0) {
-        branch_data = new char[dataSize*destNum[i]];
-        ptr = branch_data;
-        while (j >= 0) {
-          ((int*)ptr)[0] = newKeys[j].first;
-          ((int*)ptr)[1] = newKeys[j].second;
-          ptr += 2*sizeof(int);
-          dptr = (_branch_data_type*)ptr;
-          for (k=0; k<nvals; k++) {
-            dptr[k] = (newValues[j])[k];
-          }
-          ptr += nvals*sizeof(_branch_data_type);
-          j = ldest[j];
-        }
-        lo = r_offset[i];
-        hi = lo + destNum[i] - 1;
-        if (lo<=hi) NGA_Put(g_data,&lo,&hi,branch_data,&one);
-        delete [] branch_data;
+    std::vector<char> sendBuf(destOffset[nprocs-1]+destNum[nprocs-1]);
+    for (i=0; i<ksize; i++) {
+      for (itk = keyMap.lower_bound(keys[i]);
+          itk != keyMap.upper_bound(keys[i]); itk++) {
+        char *ptr = &sendBuf[destOffset[itk->second]];
+        memcpy(ptr, &keys[i].first, sizeof(int));
+        memcpy(ptr+sizeof(int), &keys[i].second, sizeof(int));
+        memcpy(ptr+2*sizeof(int), values[i],
+            nvals*sizeof(_branch_data_type));
+        destOffset[itk->second] += elemsize;
       }
     }
 
-    GA_Pgroup_sync(p_GAgrp);
-    // Data is now on processor. Unpack it and put it in arrays for export
-    keys.clear();
-    int vsize = values.size();
+    // Move all data to the processors that need it in a single exchange
+    std::vector<char> recvBuf;
+    std::vector<int> srcNum;
+    gridpack::parallel::exchangeBytes(p_network->communicator(),
+        sendBuf, destNum, recvBuf, srcNum);
+    sendBuf.clear();
+
+    // Pack branch_ids and values arrays with local indices and data
+    branch_ids.clear();
     for (i=0; i<vsize; i++) {
       delete [] values[i];
     }
     values.clear();
-    int nbranch = p_network->numBranches();
-    std::multimap<std::pair<int,int>,int> idxMap;
-    std::pair<std::pair<int,int>,int> idxPair;
-    // Create map between global index and local index for locally held branches
-    int idx1, idx2;
-    for (i=0; i<nbranch; i++) {
-      p_network->getOriginalBranchEndpoints(i,&idx1,&idx2);
-      idxPair = std::pair<std::pair<int,int>,int>(std::pair<int,int>(idx1,idx2),i);
-      idxMap.insert(idxPair);
-    }
-    // Get data from global array and pack keys and values arrays
-    // with local indices and data
-    int ndata = numValues[me];
-    lo = mapc[me];
-    hi = lo + ndata - 1;
-    if (lo<=hi) NGA_Access(g_data,&lo,&hi,&branch_data,&one);
-    std::multimap<std::pair<int,int>,int>::iterator it;
-    std::pair<int,int> key;
-    ptr = branch_data;
-    _branch_data_type *rptr;
-    for (i=0; i<ndata; i++) {
-      key = std::pair<int,int>(((int*)ptr)[0], ((int*)ptr)[1]);
-      ptr += 2*sizeof(int);
+    int nvalues = recvBuf.size()/elemsize;
+    for (i=0; i<nvalues; i++) {
+      const char *ptr = &recvBuf[static_cast<size_t>(i)*elemsize];
+      memcpy(&idx1, ptr, sizeof(int));
+      memcpy(&idx2, ptr+sizeof(int), sizeof(int));
+      key = std::pair<int,int>(idx1,idx2);
       it = idxMap.find(key);
-      rptr = (_branch_data_type*)ptr;
-      ptr += nvals*sizeof(_branch_data_type);
       if (it != idxMap.end()) {
         while (it != idxMap.upper_bound(key)) {
+          _branch_data_type *data = new _branch_data_type[nvals];
+          memcpy(data, ptr+2*sizeof(int), nvals*sizeof(_branch_data_type));
           branch_ids.push_back(it->second);
-          dptr = new _branch_data_type[nvals];
-          for (j=0; j<nvals; j++) {
-            dptr[j] = rptr[j];
-          }
-          values.push_back(dptr);
+          values.push_back(data);
           it++;
         }
       } else {
         printf("p[%d] Unresolved original branch index: < %d, %d >\n",me,
-            key.first,key.second);
+            idx1,idx2);
       }
     }
-    if (lo<=hi) NGA_Release(g_data,&lo,&hi);
-    GA_Destroy(g_data);
-#endif
 #endif
   }
 
@@ -0,0 +1,861 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   synthetic_network.hpp
+ * @date   2026-10-19
+ *
+ * @brief
+ * Generator for synthetic power grid networks that can be used for
+ * scaling studies. Every property of a bus (load, generators, dynamic
+ * models and the branches to higher numbered buses) is computed from a
+ * hash of the random seed and the bus number, so the network is the same
+ * no matter how many processes generate it or in what order buses are
+ * visited. Networks can be written to PSS/E version 23 .raw and .dyr
+ * files or created directly on a distributed network with
+ * SyntheticParser, without going through files.
+ */
+// -------------------------------------------------------------
+
+#ifndef _synthetic_network_hpp_
+#define _synthetic_network_hpp_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <mpi.h>
+#include "gridpack/component/data_collection.hpp"
+#include "gridpack/parser/dictionary.hpp"
+#include "gridpack/parser/base_parser.hpp"
+#include "gridpack/parser/dyr_records.hpp"
+#include "gridpack/utilities/exception.hpp"
+#include "gridpack/utilities/string_utils.hpp"
+
+namespace gridpack {
+namespace parser {
+
+/**
+ * Parameters of a synthetic network
+ */
+struct SyntheticNetworkParams {
+  // total number of buses
+  int numBuses;
+  // number of areas. Areas are contiguous blocks of bus numbers
+  int numAreas;
+  // average number of branches connected to a bus
+  double averageDegree;
+  // maximum number of branches added by a single bus, in addition to the
+  // branch to the next bus
+  int maxExtraBranches;
+  // average distance in bus numbers spanned by local branches
+  double localSpan;
+  // fraction of branches that connect arbitrary buses within an area
+  double longBranchFraction;
+  // number of tie lines between neighboring areas
+  int tiesPerArea;
+  // fraction of buses with generators
+  double generatorFraction;
+  // maximum number of generating units on a bus
+  int maxUnitsPerBus;
+  // average load on each bus (MW)
+  double meanLoad;
+  // fraction of generators with GENCLS and GENSAL models. All other
+  // generators use GENROU
+  double genclsFraction;
+  double gensalFraction;
+  // fraction of detailed (GENSAL, GENROU) generators with an ESST1A
+  // exciter and a WSIEG1 governor
+  double exciterFraction;
+  double governorFraction;
+  // random seed
+  unsigned int seed;
+
+  /**
+   * Default parameters
+   */
+  SyntheticNetworkParams(void)
+    : numBuses(1000), numAreas(1), averageDegree(2.8),
+      maxExtraBranches(8), localSpan(10.0), longBranchFraction(0.05),
+      tiesPerArea(4), generatorFraction(0.2), maxUnitsPerBus(2),
+      meanLoad(10.0), genclsFraction(1.0), gensalFraction(0.0),
+      exciterFraction(0.0), governorFraction(0.0), seed(12345)
+  { }
+};
+
+// -------------------------------------------------------------
+//  class SyntheticNetwork
+// -------------------------------------------------------------
+/**
+ * Synthetic network described by a SyntheticNetworkParams struct. Buses
+ * are numbered from 1 to numBuses. Bus 1 is the swing bus. Each bus is
+ * connected to the next bus in its area and adds a geometrically
+ * distributed number of extra branches to higher numbered buses in the
+ * same area, mostly to nearby buses and occasionally to arbitrary ones.
+ * Neighboring areas are connected by tie lines. Generation is scaled so
+ * that it matches the total load.
+ */
+class SyntheticNetwork {
+public:
+
+  /**
+   * Data for a bus, as it would appear in a .raw file
+   */
+  struct BusRecord {
+    int id;
+    int type;
+    int area;
+    double pl;
+    double ql;
+  };
+
+  /**
+   * Data for a generating unit
+   */
+  struct GeneratorRecord {
+    int bus;
+    std::string id;
+    double pg;
+    double qmax;
+    double qmin;
+    double vs;
+    double mbase;
+    double zx;
+    double pmax;
+  };
+
+  /**
+   * Data for a single circuit of a branch
+   */
+  struct BranchRecord {
+    int from;
+    int to;
+    std::string ckt;
+    double r;
+    double x;
+    double b;
+  };
+
+  /**
+   * Constructor
+   * @param params network parameters
+   */
+  SyntheticNetwork(const SyntheticNetworkParams &params)
+    : p_params(params), p_genScale(1.0)
+  {
+    checkParams();
+    setupTies();
+    // Scale generation to total load. This is a single pass over all
+    // buses and gives the same result on all processes
+    double load = 0.0;
+    double capacity = 0.0;
+    int id, k;
+    for (id=1; id<=p_params.numBuses; id++) {
+      load += busLoad(id);
+      int nunit = numUnits(id);
+      for (k=0; k<nunit; k++) capacity += unitCapacity(id,k);
+    }
+    if (capacity > 0.0) p_genScale = load/capacity;
+  }
+
+  /**
+   * Destructor
+   */
+  ~SyntheticNetwork(void)
+  { }
+
+  /**
+   * Network parameters
+   */
+  const SyntheticNetworkParams& params(void) const
+  {
+    return p_params;
+  }
+
+  /**
+   * Number of buses in network
+   */
+  int numBuses(void) const
+  {
+    return p_params.numBuses;
+  }
+
+  /**
+   * Area that a bus belongs to
+   * @param id bus ID (1 <= id <= numBuses())
+   * @return area index (0 <= area < numAreas)
+   */
+  int area(int id) const
+  {
+    return static_cast<int>((static_cast<long long>(id-1)
+          *p_params.numAreas)/p_params.numBuses);
+  }
+
+  /**
+   * Get data for a bus
+   * @param id bus ID
+   * @return bus record
+   */
+  BusRecord bus(int id) const
+  {
+    BusRecord ret;
+    ret.id = id;
+    ret.type = (id == 1 ? 3 : (numUnits(id) > 0 ? 2 : 1));
+    ret.area = area(id)+1;
+    ret.pl = busLoad(id);
+    ret.ql = 0.3*ret.pl;
+    return ret;
+  }
+
+  /**
+   * Get the generating units on a bus
+   * @param id bus ID
+   * @param gens list of generating units
+   */
+  void generators(int id, std::vector<GeneratorRecord> &gens) const
+  {
+    gens.clear();
+    int nunit = numUnits(id);
+    int k;
+    for (k=0; k<nunit; k++) {
+      GeneratorRecord gen;
+      char buf[8];
+      sprintf(buf,"%d",k+1);
+      gen.bus = id;
+      gen.id = buf;
+      gen.pg = p_genScale*unitCapacity(id,k);
+      gen.mbase = ceil(1.25*gen.pg);
+      gen.pmax = gen.mbase;
+      gen.qmax = 0.6*gen.mbase;
+      gen.qmin = -0.3*gen.mbase;
+      gen.vs = 1.0+0.04*uniform(id,STREAM_UNIT+k,1);
+      gen.zx = 0.25;
+      gens.push_back(gen);
+    }
+  }
+
+  /**
+   * Get the branches from a bus to higher numbered buses. Parallel
+   * circuits between the same two buses are listed one after another
+   * @param id bus ID
+   * @param branches list of branch circuits
+   */
+  void branches(int id, std::vector<BranchRecord> &branches) const
+  {
+    branches.clear();
+    std::vector<int> to;
+    int a = area(id);
+    int last = areaStart(a+1)-1;
+    if (id < last) {
+      to.push_back(id+1);
+      // Number of extra branches is geometrically distributed
+      double mean = 0.5*p_params.averageDegree - 1.0;
+      int nextra = 0;
+      if (mean > 0.0) {
+        double p = mean/(1.0+mean);
+        nextra = static_cast<int>(log(1.0-uniform(id,STREAM_DEGREE,0))
+            /log(p));
+        if (nextra > p_params.maxExtraBranches) {
+          nextra = p_params.maxExtraBranches;
+        }
+      }
+      int k;
+      for (k=0; k<nextra; k++) {
+        int j;
+        if (uniform(id,STREAM_LONG,k) < p_params.longBranchFraction) {
+          j = id+1+static_cast<int>(uniform(id,STREAM_TARGET,k)
+              *static_cast<double>(last-id));
+        } else {
+          double q = p_params.localSpan/(1.0+p_params.localSpan);
+          j = id+1+static_cast<int>(log(1.0-uniform(id,STREAM_TARGET,k))
+              /log(q));
+        }
+        if (j > last) j = last;
+        to.push_back(j);
+      }
+    }
+    // Tie lines that start at this bus
+    std::vector<std::pair<int,int> >::const_iterator it
+      = std::lower_bound(p_ties.begin(),p_ties.end(),
+          std::pair<int,int>(id,0));
+    while (it != p_ties.end() && it->first == id) {
+      to.push_back(it->second);
+      it++;
+    }
+    std::sort(to.begin(),to.end());
+    int i;
+    int nckt = 0;
+    for (i=0; i<static_cast<int>(to.size()); i++) {
+      if (i > 0 && to[i] == to[i-1]) {
+        nckt++;
+      } else {
+        nckt = 1;
+      }
+      BranchRecord branch;
+      char buf[8];
+      sprintf(buf,"%d",nckt);
+      branch.from = id;
+      branch.to = to[i];
+      branch.ckt = buf;
+      // Branches that cross areas or span many buses are longer
+      double length = 1.0;
+      if (area(to[i]) != a || to[i]-id > 4*p_params.localSpan) length = 3.0;
+      branch.r = length*(0.002+0.008*uniform(id,STREAM_BRANCH,3*i));
+      branch.x = branch.r*(6.0+6.0*uniform(id,STREAM_BRANCH,3*i+1));
+      branch.b = length*0.04*uniform(id,STREAM_BRANCH,3*i+2);
+      branches.push_back(branch);
+    }
+  }
+
+  /**
+   * Get the .dyr records of the generating units on a bus. Each record is
+   * the list of fields of a line in a .dyr file, without the terminating
+   * '/'
+   * @param id bus ID
+   * @param records list of records
+   */
+  void dyrRecords(int id,
+      std::vector<std::vector<std::string> > &records) const
+  {
+    records.clear();
+    int nunit = numUnits(id);
+    int k;
+    for (k=0; k<nunit; k++) {
+      double u = uniform(id,STREAM_MODEL,k);
+      std::vector<std::string> fields;
+      if (u < p_params.genclsFraction) {
+        startRecord(id,k,"GENCLS",fields);
+        double h = 3.0+3.0*uniform(id,STREAM_MODEL,k+64);
+        addFields(fields,2,h,2.0);
+        records.push_back(fields);
+        continue;
+      }
+      if (u < p_params.genclsFraction+p_params.gensalFraction) {
+        startRecord(id,k,"GENSAL",fields);
+        double gensal[12] = {6.0,0.035,0.035,4.0,0.0,1.4,1.0,0.21,0.18,
+          0.12,0.17,0.55};
+        addFields(fields,12,gensal);
+      } else {
+        startRecord(id,k,"GENROU",fields);
+        double genrou[14] = {7.0,0.03,0.75,0.05,4.0,0.0,1.8,1.7,0.3,0.55,
+          0.25,0.2,0.1,0.3};
+        addFields(fields,14,genrou);
+      }
+      records.push_back(fields);
+      if (uniform(id,STREAM_MODEL,k+128) < p_params.exciterFraction) {
+        startRecord(id,k,"ESST1A",fields);
+        double esst1a[20] = {1.0,1.0,0.0,999.0,-999.0,0.51,2.01,0.0,0.0,
+          178.9,0.029,999.0,-999.0,4.48,-1.79,0.11,0.0,1.0,0.0,2.8};
+        addFields(fields,20,esst1a);
+        records.push_back(fields);
+      }
+      if (uniform(id,STREAM_MODEL,k+192) < p_params.governorFraction) {
+        startRecord(id,k,"WSIEG1",fields);
+        double wsieg1[36];
+        int i;
+        for (i=0; i<36; i++) wsieg1[i] = 0.0;
+        wsieg1[2] = 25.0;
+        wsieg1[4] = 3.3;
+        wsieg1[5] = 0.3;
+        wsieg1[6] = 0.25;
+        wsieg1[7] = -3.3;
+        wsieg1[8] = 1.01;
+        wsieg1[10] = 0.08612;
+        wsieg1[11] = 1.0;
+        addFields(fields,36,wsieg1);
+        records.push_back(fields);
+      }
+    }
+  }
+
+  /**
+   * Write network to a PSS/E version 23 .raw file. Records are generated
+   * and written one bus at a time, so memory use does not depend on the
+   * size of the network
+   * @param filename name of file
+   */
+  void writeRaw(const std::string &filename) const
+  {
+    FILE *fp = openFile(filename);
+    int nbus = numBuses();
+    int id, i;
+    fprintf(fp,"0  100.000\n");
+    fprintf(fp,"SYNTHETIC NETWORK, %d BUSES, %d AREAS, SEED %u\n",nbus,
+        p_params.numAreas,p_params.seed);
+    fprintf(fp,"\n");
+    for (id=1; id<=nbus; id++) {
+      BusRecord rec = bus(id);
+      fprintf(fp,"%9d,%4d,%10.3f,%10.3f,%10.3f,%10.3f,%4d,%8.5f,%10.4f,"
+          "'BUS-%-8d',%9.4f,%4d\n",id,rec.type,rec.pl,rec.ql,0.0,0.0,
+          rec.area,1.0,0.0,id,100.0,rec.area);
+    }
+    fprintf(fp,"0 / END OF BUS DATA, BEGIN GENERATOR DATA\n");
+    std::vector<GeneratorRecord> gens;
+    for (id=1; id<=nbus; id++) {
+      generators(id,gens);
+      for (i=0; i<static_cast<int>(gens.size()); i++) {
+        const GeneratorRecord &gen = gens[i];
+        fprintf(fp,"%9d,'%-2s',%10.3f,%10.3f,%10.3f,%10.3f,%8.5f,     0,"
+            "%10.3f,%10.5f,%10.5f,   0.00000,   0.00000,   1.00000,1,"
+            "  100.0,%10.3f,%10.3f\n",gen.bus,gen.id.c_str(),gen.pg,0.0,
+            gen.qmax,gen.qmin,gen.vs,gen.mbase,0.0,gen.zx,gen.pmax,0.0);
+      }
+    }
+    fprintf(fp,"0 / END OF GENERATOR DATA, BEGIN BRANCH DATA\n");
+    std::vector<BranchRecord> brs;
+    for (id=1; id<=nbus; id++) {
+      branches(id,brs);
+      for (i=0; i<static_cast<int>(brs.size()); i++) {
+        const BranchRecord &br = brs[i];
+        fprintf(fp,"%9d,%9d,'%-2s',%10.5f,%10.5f,%10.5f,   0.00,   0.00,"
+            "   0.00,0.00000,000.000, 0.00000, 0.00000, 0.00000, 0.00000,"
+            " 1\n",br.from,br.to,br.ckt.c_str(),br.r,br.x,br.b);
+      }
+    }
+    fprintf(fp,"0 / END OF BRANCH DATA, BEGIN TRANSFORMER ADJUSTMENT DATA\n");
+    fprintf(fp,"0 / END OF TRANSFORMER ADJUSTMENT DATA, BEGIN AREA DATA\n");
+    fprintf(fp,"0 / END OF AREA DATA, BEGIN TWO-TERMINAL DC DATA\n");
+    fprintf(fp,"0 / END OF TWO-TERMINAL DC DATA, BEGIN SWITCHED SHUNT DATA\n");
+    fprintf(fp,"0 / END OF SWITCHED SHUNT DATA\n");
+    fclose(fp);
+  }
+
+  /**
+   * Write the dynamic models of all generators to a .dyr file
+   * @param filename name of file
+   */
+  void writeDyr(const std::string &filename) const
+  {
+    FILE *fp = openFile(filename);
+    std::vector<std::vector<std::string> > records;
+    int id, i, j;
+    for (id=1; id<=numBuses(); id++) {
+      dyrRecords(id,records);
+      for (i=0; i<static_cast<int>(records.size()); i++) {
+        const std::vector<std::string> &fields = records[i];
+        for (j=0; j<static_cast<int>(fields.size()); j++) {
+          fprintf(fp,"%s%s",(j>0?", ":""),fields[j].c_str());
+        }
+        fprintf(fp," /\n");
+      }
+    }
+    fclose(fp);
+  }
+
+  /**
+   * Write network files on process 0 of a communicator. The other
+   * processes wait until the files are complete
+   * @param comm communicator
+   * @param rawFile name of .raw file
+   * @param dyrFile name of .dyr file. No file is written if it is empty
+   */
+  void write(MPI_Comm comm, const std::string &rawFile,
+      const std::string &dyrFile) const
+  {
+    int me;
+    MPI_Comm_rank(comm,&me);
+    if (me == 0) {
+      writeRaw(rawFile);
+      if (!dyrFile.empty()) writeDyr(dyrFile);
+    }
+    MPI_Barrier(comm);
+  }
+
+private:
+
+  // Independent random streams for different properties of a bus
+  enum {STREAM_LOAD = 1, STREAM_GEN = 2, STREAM_UNIT = 3,
+    STREAM_DEGREE = 64, STREAM_LONG = 65, STREAM_TARGET = 66,
+    STREAM_BRANCH = 67, STREAM_TIE = 68, STREAM_MODEL = 69};
+
+  /**
+   * Check that parameters are consistent
+   */
+  void checkParams(void) const
+  {
+    const SyntheticNetworkParams &p = p_params;
+    bool ok = (p.numBuses >= 2 && p.numAreas >= 1 &&
+        p.numBuses >= 2*p.numAreas && p.averageDegree >= 0.0 &&
+        p.maxExtraBranches >= 0 && p.localSpan > 0.0 &&
+        p.longBranchFraction >= 0.0 && p.longBranchFraction <= 1.0 &&
+        p.tiesPerArea >= 1 && p.generatorFraction > 0.0 &&
+        p.generatorFraction <= 1.0 && p.maxUnitsPerBus >= 1 &&
+        p.meanLoad >= 0.0 && p.genclsFraction >= 0.0 &&
+        p.gensalFraction >= 0.0 &&
+        p.genclsFraction+p.gensalFraction <= 1.0 &&
+        p.exciterFraction >= 0.0 && p.governorFraction >= 0.0);
+    if (!ok) {
+      char buf[256];
+      sprintf(buf,"SyntheticNetwork: inconsistent parameters buses: %d"
+          " areas: %d degree: %f generator fraction: %f\n",p.numBuses,
+          p.numAreas,p.averageDegree,p.generatorFraction);
+      throw gridpack::Exception(buf);
+    }
+  }
+
+  /**
+   * First bus in an area
+   * @param a area index (0 <= a <= numAreas)
+   * @return ID of first bus in area, numBuses()+1 if a = numAreas
+   */
+  int areaStart(int a) const
+  {
+    long long n = p_params.numBuses;
+    long long na = p_params.numAreas;
+    return static_cast<int>((a*n+na-1)/na)+1;
+  }
+
+  /**
+   * Create the tie lines between neighboring areas, sorted by the bus
+   * they start from
+   */
+  void setupTies(void)
+  {
+    int a, t;
+    for (a=1; a<p_params.numAreas; a++) {
+      int lo0 = areaStart(a-1);
+      int lo1 = areaStart(a);
+      int hi1 = areaStart(a+1);
+      for (t=0; t<p_params.tiesPerArea; t++) {
+        int from = lo0+static_cast<int>(uniform(a,STREAM_TIE,2*t)
+            *static_cast<double>(lo1-lo0));
+        int to = lo1+static_cast<int>(uniform(a,STREAM_TIE,2*t+1)
+            *static_cast<double>(hi1-lo1));
+        p_ties.push_back(std::pair<int,int>(from,to));
+      }
+    }
+    std::sort(p_ties.begin(),p_ties.end());
+  }
+
+  /**
+   * Load on a bus
+   */
+  double busLoad(int id) const
+  {
+    return p_params.meanLoad*(0.5+uniform(id,STREAM_LOAD,0));
+  }
+
+  /**
+   * Number of generating units on a bus
+   */
+  int numUnits(int id) const
+  {
+    if (id != 1 && uniform(id,STREAM_GEN,0) >= p_params.generatorFraction) {
+      return 0;
+    }
+    return 1+static_cast<int>(uniform(id,STREAM_GEN,1)
+        *static_cast<double>(p_params.maxUnitsPerBus));
+  }
+
+  /**
+   * Relative capacity of a generating unit
+   */
+  double unitCapacity(int id, int k) const
+  {
+    return 0.5+uniform(id,STREAM_UNIT+k,0);
+  }
+
+  /**
+   * Uniformly distributed random number in [0,1) that only depends on
+   * the seed, the bus, the stream and the index within the stream
+   */
+  double uniform(int id, int stream, int k) const
+  {
+    unsigned long long h = static_cast<unsigned long long>(p_params.seed);
+    h = mix(h ^ static_cast<unsigned long long>(id));
+    h = mix(h ^ (static_cast<unsigned long long>(stream) << 32
+          ^ static_cast<unsigned long long>(k)));
+    return static_cast<double>(h >> 11)*(1.0/9007199254740992.0);
+  }
+
+  /**
+   * SplitMix64 finalizer
+   */
+  static unsigned long long mix(unsigned long long h)
+  {
+    h += 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+  }
+
+  /**
+   * Start a .dyr record with bus, model and generator ID
+   */
+  static void startRecord(int id, int k, const char *model,
+      std::vector<std::string> &fields)
+  {
+    char buf[32];
+    fields.clear();
+    sprintf(buf,"%d",id);
+    fields.push_back(buf);
+    sprintf(buf,"'%s'",model);
+    fields.push_back(buf);
+    sprintf(buf,"'%d '",k+1);
+    fields.push_back(buf);
+  }
+
+  /**
+   * Append numerical parameters to a .dyr record
+   */
+  static void addFields(std::vector<std::string> &fields, int n,
+      const double *values)
+  {
+    char buf[32];
+    int i;
+    for (i=0; i<n; i++) {
+      sprintf(buf,"%g",values[i]);
+      fields.push_back(buf);
+    }
+  }
+
+  static void addFields(std::vector<std::string> &fields, int n,
+      double v1, double v2)
+  {
+    double values[2] = {v1,v2};
+    addFields(fields,n,values);
+  }
+
+  /**
+   * Open a file for writing
+   */
+  static FILE* openFile(const std::string &filename)
+  {
+    FILE *fp = fopen(filename.c_str(),"w");
+    if (fp == NULL) {
+      char buf[256];
+      sprintf(buf,"SyntheticNetwork: unable to open file %s\n",
+          filename.c_str());
+      throw gridpack::Exception(buf);
+    }
+    return fp;
+  }
+
+  SyntheticNetworkParams p_params;
+
+  // factor that converts unit capacities to generation in MW
+  double p_genScale;
+
+  // tie lines between areas (from bus, to bus), sorted by from bus
+  std::vector<std::pair<int,int> > p_ties;
+};
+
+// -------------------------------------------------------------
+//  class SyntheticParser
+// -------------------------------------------------------------
+/**
+ * Create a synthetic network directly on a distributed network object.
+ * Each process generates a contiguous block of buses, together with the
+ * branches that start on those buses, and the network is then partitioned
+ * in the usual way. The data collection objects contain the same fields
+ * as they would if the network were read from the .raw file written by
+ * SyntheticNetwork::writeRaw.
+ */
+template <class _network>
+class SyntheticParser : public BaseParser<_network>
+{
+public:
+
+  /**
+   * Constructor
+   * @param network network that the synthetic network is created on. This
+   *        should not contain any buses or branches
+   * @param synthetic synthetic network description
+   */
+  SyntheticParser(boost::shared_ptr<_network> network,
+      const SyntheticNetwork &synthetic)
+    : p_synthetic(synthetic)
+  {
+    this->setNetwork(network);
+  }
+
+  /**
+   * Destructor
+   */
+  virtual ~SyntheticParser()
+  { }
+
+  /**
+   * Generate the buses and branches that belong to this process and add
+   * them to the network. The network still needs to be partitioned
+   */
+  void parse(void)
+  {
+    int me = this->p_network->communicator().rank();
+    int nprocs = this->p_network->communicator().size();
+    int nbus = p_synthetic.numBuses();
+    int lo = static_cast<int>((static_cast<long long>(me)*nbus)/nprocs)+1;
+    int hi = static_cast<int>((static_cast<long long>(me+1)*nbus)/nprocs);
+    std::vector<boost::shared_ptr<component::DataCollection> > busData;
+    std::vector<boost::shared_ptr<component::DataCollection> > branchData;
+    std::vector<SyntheticNetwork::GeneratorRecord> gens;
+    std::vector<SyntheticNetwork::BranchRecord> brs;
+    int id, i;
+    for (id=lo; id<=hi; id++) {
+      boost::shared_ptr<component::DataCollection>
+        data(new component::DataCollection);
+      setBusData(p_synthetic.bus(id),data.get());
+      p_synthetic.generators(id,gens);
+      for (i=0; i<static_cast<int>(gens.size()); i++) {
+        setGeneratorData(gens[i],i,data.get());
+      }
+      if (!gens.empty()) {
+        data->addValue(GENERATOR_NUMBER,static_cast<int>(gens.size()));
+      }
+      busData.push_back(data);
+
+      p_synthetic.branches(id,brs);
+      int nelems = 0;
+      boost::shared_ptr<component::DataCollection> branch;
+      for (i=0; i<static_cast<int>(brs.size()); i++) {
+        if (i == 0 || brs[i].to != brs[i-1].to) {
+          branch.reset(new component::DataCollection);
+          branch->addValue(BRANCH_INDEX,
+              static_cast<int>(branchData.size()));
+          branch->addValue(BRANCH_FROMBUS,brs[i].from);
+          branch->addValue(BRANCH_TOBUS,brs[i].to);
+          branch->addValue(BRANCH_NUM_ELEMENTS,0);
+          branchData.push_back(branch);
+          nelems = 0;
+        }
+        setBranchData(brs[i],nelems,branch.get());
+        nelems++;
+        branch->setValue(BRANCH_NUM_ELEMENTS,nelems);
+      }
+    }
+    this->setCaseID(0);
+    this->setCaseSBase(100.0);
+    this->createNetwork(busData,branchData);
+  }
+
+  /**
+   * Add the dynamic models of the generators to all buses on this
+   * process. This should be called after the network has been partitioned
+   * and gives the same result as reading the .dyr file written by
+   * SyntheticNetwork::writeDyr
+   */
+  void addDynamicModels(void)
+  {
+    gridpack::utility::StringUtils util;
+    std::vector<std::vector<std::string> > records;
+    int nbus = this->p_network->numBuses();
+    int i, j;
+    for (i=0; i<nbus; i++) {
+      p_synthetic.dyrRecords(this->p_network->getOriginalBusIndex(i),records);
+      gridpack::component::DataCollection *data
+        = this->p_network->getBusData(i).get();
+      for (j=0; j<static_cast<int>(records.size()); j++) {
+        std::vector<std::string> &fields = records[j];
+        // Generator k on a bus has ID k+1, so the index can be read off
+        // the tag directly
+        std::string tag = util.clean2Char(fields[2]);
+        int g_id = atoi(tag.c_str())-1;
+        std::string model = util.trimQuotes(fields[1]);
+        DyrModelTable::parse(DyrModelTable::modelType(model),fields,data,
+            g_id);
+      }
+    }
+  }
+
+private:
+
+  /**
+   * Copy bus record into data collection, using the same fields as the
+   * PTI23 parser
+   */
+  static void setBusData(const SyntheticNetwork::BusRecord &rec,
+      component::DataCollection *data)
+  {
+    char name[32];
+    sprintf(name,"'BUS-%-8d'",rec.id);
+    data->addValue(BUS_NUMBER,rec.id);
+    data->addValue(BUS_NAME,name);
+    data->addValue(BUS_BASEKV,100.0);
+    data->addValue(BUS_TYPE,rec.type);
+    data->addValue(BUS_SHUNT_GL,0.0);
+    data->addValue(BUS_SHUNT_GL,0.0,0);
+    data->addValue(BUS_SHUNT_BL,0.0);
+    data->addValue(BUS_SHUNT_BL,0.0,0);
+    data->addValue(SHUNT_NUMBER,1);
+    data->addValue(SHUNT_BUSNUMBER,rec.id);
+    data->addValue(BUS_ZONE,rec.area);
+    data->addValue(BUS_AREA,rec.area);
+    data->addValue(BUS_VOLTAGE_MAG,1.0);
+    data->addValue(BUS_VOLTAGE_ANG,0.0);
+    data->addValue(BUS_OWNER,rec.area);
+    data->addValue(LOAD_PL,rec.pl);
+    data->addValue(LOAD_PL,rec.pl,0);
+    data->addValue(LOAD_ID," 1",0);
+    data->addValue(LOAD_QL,rec.ql);
+    data->addValue(LOAD_QL,rec.ql,0);
+    data->addValue(LOAD_NUMBER,1);
+    data->addValue(LOAD_STATUS,1,0);
+    data->addValue(LOAD_BUSNUMBER,rec.id);
+  }
+
+  /**
+   * Copy generator record into data collection
+   */
+  static void setGeneratorData(const SyntheticNetwork::GeneratorRecord &gen,
+      int g, component::DataCollection *data)
+  {
+    gridpack::utility::StringUtils util;
+    std::string tag = gen.id;
+    tag = util.clean2Char(tag);
+    data->addValue(GENERATOR_BUSNUMBER,gen.bus,g);
+    data->addValue(GENERATOR_ID,tag.c_str(),g);
+    data->addValue(GENERATOR_PG,gen.pg,g);
+    data->addValue(GENERATOR_QG,0.0,g);
+    data->addValue(GENERATOR_QMAX,gen.qmax,g);
+    data->addValue(GENERATOR_QMIN,gen.qmin,g);
+    data->addValue(GENERATOR_VS,gen.vs,g);
+    data->addValue(GENERATOR_IREG,0,g);
+    data->addValue(GENERATOR_MBASE,gen.mbase,g);
+    data->addValue(GENERATOR_ZSOURCE,gridpack::ComplexType(0.0,gen.zx),g);
+    data->addValue(GENERATOR_XTRAN,gridpack::ComplexType(0.0,0.0),g);
+    data->addValue(GENERATOR_RT,0.0,g);
+    data->addValue(GENERATOR_XT,0.0,g);
+    data->addValue(GENERATOR_GTAP,1.0,g);
+    data->addValue(GENERATOR_STAT,1,g);
+    data->addValue(GENERATOR_RMPCT,100.0,g);
+    data->addValue(GENERATOR_PMAX,gen.pmax,g);
+    data->addValue(GENERATOR_PMIN,0.0,g);
+  }
+
+  /**
+   * Copy a branch circuit into data collection
+   */
+  static void setBranchData(const SyntheticNetwork::BranchRecord &br,
+      int n, component::DataCollection *data)
+  {
+    gridpack::utility::StringUtils util;
+    std::string tag = br.ckt;
+    tag = util.clean2Char(tag);
+    data->addValue(BRANCH_SWITCHED,false,n);
+    data->addValue(BRANCH_CKT,tag.c_str(),n);
+    data->addValue(BRANCH_R,br.r,n);
+    data->addValue(BRANCH_X,br.x,n);
+    data->addValue(BRANCH_B,br.b,n);
+    data->addValue(BRANCH_RATING_A,0.0,n);
+    data->addValue(BRANCH_RATING_B,0.0,n);
+    data->addValue(BRANCH_RATING_C,0.0,n);
+    data->addValue(BRANCH_TAP,0.0,n);
+    data->addValue(BRANCH_SHIFT,0.0,n);
+    data->addValue(BRANCH_SHUNT_ADMTTNC_G1,0.0,n);
+    data->addValue(BRANCH_SHUNT_ADMTTNC_B1,0.0,n);
+    data->addValue(BRANCH_SHUNT_ADMTTNC_G2,0.0,n);
+    data->addValue(BRANCH_SHUNT_ADMTTNC_B2,0.0,n);
+    data->addValue(BRANCH_STATUS,1,n);
+  }
+
+  const SyntheticNetwork &p_synthetic;
+};
+
+} // parser
+} // gridpack
+#endif
@@ -0,0 +1,236 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   dyr_records_test.cpp
+ * @date   2026-10-19
+ *
+ * @brief  Check that generator models sent as compact records end up in
+ *         the data collection objects exactly as if they had been parsed
+ *         directly from the .dyr file
+ */
+// -------------------------------------------------------------
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/archive/text_oarchive.hpp>
+
+#include "gridpack/utilities/string_utils.hpp"
+#include "gridpack/parser/dictionary.hpp"
+#include "gridpack/parser/dyr_records.hpp"
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+using gridpack::parser::DyrModelTable;
+using gridpack::parser::DyrRecordHeader;
+
+/**
+ * Number of fields in a complete record for each model, including the
+ * bus, model name and generator ID. WSIEG1 has the most parameters
+ */
+static const struct {
+  const char *name;
+  int nfield;
+} models[] = {
+  {"GENCLS", 6},
+  {"GENSAL", 15},
+  {"GENROU", 17},
+  {"WSIEG1", 39},
+  {"EXDC1", 19},
+  {"EXDC2", 19},
+  {"ESST1A", 23},
+  {"ESST4B", 20},
+  {"GGOV1", 38},
+  {"WSHYGP", 33},
+  {NULL, 0}
+};
+
+/**
+ * Create a .dyr record with nfield fields. Parameters have more digits
+ * than a double can hold and some are written in exponential notation
+ * @param bus bus ID
+ * @param name model name
+ * @param id generator ID, including quotes
+ * @param nfield total number of fields
+ * @return record, terminated by a slash
+ */
+static std::string dyrRecord(int bus, const char *name, const char *id,
+    int nfield)
+{
+  char buf[128];
+  sprintf(buf,"  %d, '%s', %s",bus,name,id);
+  std::string record = buf;
+  int i;
+  for (i=3; i<nfield; i++) {
+    double rval = static_cast<double>((i*37)%23)/7.0-1.0;
+    if (i%5 == 0) {
+      sprintf(buf,", %.6E",rval);
+    } else {
+      sprintf(buf,", %.20f",rval);
+    }
+    record.append(buf);
+  }
+  record.append(" /");
+  return record;
+}
+
+/**
+ * Split a record the same way as BasePTIParser does when it reads a .dyr
+ * file
+ */
+static std::vector<std::string> splitRecord(const std::string &line)
+{
+  std::string record = line;
+  int idx = record.find('/');
+  if (idx != std::string::npos) record.erase(idx,record.length()-idx);
+  std::vector<std::string> split_line;
+  boost::split(split_line, record, boost::algorithm::is_any_of(","),
+      boost::token_compress_on);
+  return split_line;
+}
+
+/**
+ * Model type of a split record
+ */
+static int recordModel(std::vector<std::string> &split_line)
+{
+  gridpack::utility::StringUtils util;
+  std::string sval = util.trimQuotes(split_line[1]);
+  util.toUpper(sval);
+  return DyrModelTable::modelType(sval);
+}
+
+/**
+ * Serialized contents of a data collection. Two collections filled by the
+ * same sequence of calls give the same string if and only if they hold the
+ * same values
+ */
+static std::string contents(gridpack::component::DataCollection &data)
+{
+  std::ostringstream os;
+  {
+    boost::archive::text_oarchive oa(os);
+    oa << data;
+  }
+  return os.str();
+}
+
+BOOST_AUTO_TEST_SUITE(DyrRecords)
+
+BOOST_AUTO_TEST_CASE(ModelTable)
+{
+  // The test covers every model in the table
+  int n = 0;
+  while (models[n].name != NULL) {
+    BOOST_CHECK_EQUAL(DyrModelTable::modelType(models[n].name), n);
+    BOOST_CHECK_EQUAL(std::string(DyrModelTable::modelName(n)),
+        std::string(models[n].name));
+    n++;
+  }
+  BOOST_CHECK_EQUAL(DyrModelTable::numModels(), n);
+  BOOST_CHECK_EQUAL(DyrModelTable::modelType("IEEL"), -1);
+  BOOST_CHECK_THROW(DyrModelTable::modelName(n), gridpack::Exception);
+  BOOST_CHECK_THROW(DyrModelTable::modelName(-1), gridpack::Exception);
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  // One complete record for each model family, with generator IDs that
+  // contain spaces, followed by a truncated record and a record with a
+  // lower case model name
+  std::vector<std::string> records;
+  int i;
+  for (i=0; models[i].name != NULL; i++) {
+    records.push_back(dyrRecord(100+i, models[i].name,
+          (i%2 == 0 ? "' 1'" : "'G1 '"), models[i].nfield));
+  }
+  records.push_back(dyrRecord(7, "GENROU", "\"2\"", 9));
+  records.push_back(dyrRecord(8, "gencls", "3", 6));
+
+  // Pack all records into a single buffer, as find_ds_vector does
+  std::vector<char> buf;
+  std::vector<std::string> tags;
+  gridpack::utility::StringUtils util;
+  int nrec = records.size();
+  for (i=0; i<nrec; i++) {
+    std::vector<std::string> split_line = splitRecord(records[i]);
+    int model = recordModel(split_line);
+    BOOST_REQUIRE(model >= 0);
+    tags.push_back(util.clean2Char(split_line[2]));
+    DyrModelTable::pack(model, split_line, tags[i], buf);
+  }
+
+  // Walk through the buffer and compare each record with the result of
+  // parsing the original record directly. Each model is stored on two
+  // generators so that the generator index is checked as well
+  size_t offset = 0;
+  for (i=0; i<nrec; i++) {
+    BOOST_REQUIRE(offset < buf.size());
+    std::vector<std::string> split_line = splitRecord(records[i]);
+    int model = recordModel(split_line);
+    const char *record = &buf[offset];
+    DyrRecordHeader hdr = DyrModelTable::header(record);
+    BOOST_CHECK_EQUAL(hdr.bus_id, atoi(split_line[0].c_str()));
+    BOOST_CHECK_EQUAL(hdr.model, model);
+    BOOST_CHECK_EQUAL(std::string(hdr.gen_id), tags[i]);
+    BOOST_CHECK_EQUAL(hdr.nparam, static_cast<int>(split_line.size())-3);
+    BOOST_CHECK_EQUAL(DyrModelTable::recordSize(record),
+        sizeof(DyrRecordHeader)+hdr.nparam*sizeof(double));
+
+    gridpack::component::DataCollection serial, packed;
+    int g_id;
+    for (g_id=0; g_id<2; g_id++) {
+      DyrModelTable::parse(model, split_line, &serial, g_id);
+      DyrModelTable::extract(record, &packed, g_id);
+    }
+    std::string sdata = contents(serial);
+    std::string pdata = contents(packed);
+    if (sdata != pdata) {
+      std::cout << "Record " << records[i] << " does not survive packing"
+        << std::endl;
+      serial.dump();
+      packed.dump();
+    }
+    BOOST_CHECK(sdata == pdata);
+    offset += DyrModelTable::recordSize(record);
+  }
+  BOOST_CHECK_EQUAL(offset, buf.size());
+
+  // Records with an unknown model are rejected
+  DyrRecordHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.model = DyrModelTable::numModels();
+  gridpack::component::DataCollection data;
+  BOOST_CHECK_THROW(DyrModelTable::extract(reinterpret_cast<char*>(&hdr),
+        &data, 0), gridpack::Exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+bool init_function()
+{
+  return true;
+}
+
+// -------------------------------------------------------------
+//  Main Program
+// -------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+  int result = ::boost::unit_test::unit_test_main( &init_function, argc, argv );
+  return result;
+}
@@ -0,0 +1,385 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdio>
+
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/collectives.hpp>
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+#include "mpi.h"
+#include <macdecls.h>
+#include "gridpack/network/base_network.hpp"
+#include "gridpack/parser/synthetic_network.hpp"
+#include "gridpack/parser/PTI23_parser.hpp"
+
+#define NUM_BUSES 2000
+#define NUM_AREAS 4
+
+class TestBus
+  : public gridpack::component::BaseBusComponent {
+  public:
+
+  TestBus(void) {
+  }
+
+  ~TestBus(void) {
+  }
+};
+
+BOOST_CLASS_EXPORT(TestBus)
+
+class TestBranch
+  : public gridpack::component::BaseBranchComponent {
+  public:
+
+  TestBranch(void) {
+  }
+
+  ~TestBranch(void) {
+  }
+};
+
+BOOST_CLASS_EXPORT(TestBranch)
+
+typedef gridpack::network::BaseNetwork<TestBus, TestBranch> TestNetwork;
+
+/**
+ * Find root of bus in union-find structure
+ */
+int findRoot(std::vector<int> &parent, int id)
+{
+  while (parent[id] != id) {
+    parent[id] = parent[parent[id]];
+    id = parent[id];
+  }
+  return id;
+}
+
+gridpack::parser::SyntheticNetworkParams testParams(void)
+{
+  gridpack::parser::SyntheticNetworkParams params;
+  params.numBuses = NUM_BUSES;
+  params.numAreas = NUM_AREAS;
+  params.genclsFraction = 0.4;
+  params.gensalFraction = 0.3;
+  params.exciterFraction = 0.5;
+  params.governorFraction = 0.5;
+  return params;
+}
+
+BOOST_AUTO_TEST_SUITE(SyntheticNetworkTest)
+
+BOOST_AUTO_TEST_CASE(Topology)
+{
+  gridpack::parser::SyntheticNetwork synth(testParams());
+  std::vector<int> parent(NUM_BUSES+1);
+  int id;
+  for (id=0; id<=NUM_BUSES; id++) parent[id] = id;
+
+  // Every branch goes to a higher numbered bus and all buses are
+  // connected
+  std::vector<gridpack::parser::SyntheticNetwork::BranchRecord> branches;
+  std::vector<gridpack::parser::SyntheticNetwork::GeneratorRecord> gens;
+  bool ok = true;
+  double load = 0.0;
+  double gen = 0.0;
+  size_t i;
+  for (id=1; id<=NUM_BUSES; id++) {
+    synth.branches(id,branches);
+    for (i=0; i<branches.size(); i++) {
+      if (branches[i].from != id || branches[i].to <= id ||
+          branches[i].to > NUM_BUSES) ok = false;
+      parent[findRoot(parent,id)] = findRoot(parent,branches[i].to);
+    }
+    load += synth.bus(id).pl;
+    synth.generators(id,gens);
+    for (i=0; i<gens.size(); i++) gen += gens[i].pg;
+  }
+  BOOST_CHECK(ok);
+  int root = findRoot(parent,1);
+  int ndisc = 0;
+  for (id=2; id<=NUM_BUSES; id++) {
+    if (findRoot(parent,id) != root) ndisc++;
+  }
+  BOOST_CHECK_EQUAL(ndisc, 0);
+
+  // Generation is scaled to match load
+  BOOST_CHECK_CLOSE(load, gen, 1.0e-6);
+}
+
+BOOST_AUTO_TEST_CASE(Determinism)
+{
+  gridpack::parser::SyntheticNetwork synth1(testParams());
+  gridpack::parser::SyntheticNetwork synth2(testParams());
+  typedef gridpack::parser::SyntheticNetwork::BranchRecord BranchRecord;
+  typedef gridpack::parser::SyntheticNetwork::GeneratorRecord GenRecord;
+  std::vector<std::vector<BranchRecord> > b1(NUM_BUSES+1), b2(NUM_BUSES+1);
+  std::vector<std::vector<GenRecord> > g1(NUM_BUSES+1), g2(NUM_BUSES+1);
+  std::vector<std::vector<std::vector<std::string> > > d1(NUM_BUSES+1),
+    d2(NUM_BUSES+1);
+  int id;
+  size_t i;
+  // Visit buses in opposite orders. The second generator also asks for
+  // the records of each bus in a different order
+  for (id=NUM_BUSES; id>=1; id--) {
+    synth1.branches(id,b1[id]);
+    synth1.generators(id,g1[id]);
+    synth1.dyrRecords(id,d1[id]);
+  }
+  for (id=1; id<=NUM_BUSES; id++) {
+    synth2.dyrRecords(id,d2[id]);
+    synth2.generators(id,g2[id]);
+    synth2.branches(id,b2[id]);
+  }
+  bool ok = true;
+  for (id=1; id<=NUM_BUSES; id++) {
+    if (b1[id].size() != b2[id].size() || g1[id].size() != g2[id].size()) {
+      ok = false;
+      continue;
+    }
+    for (i=0; i<b1[id].size(); i++) {
+      const BranchRecord &r1 = b1[id][i];
+      const BranchRecord &r2 = b2[id][i];
+      if (r1.from != r2.from || r1.to != r2.to || r1.ckt != r2.ckt ||
+          r1.r != r2.r || r1.x != r2.x || r1.b != r2.b) ok = false;
+    }
+    for (i=0; i<g1[id].size(); i++) {
+      if (g1[id][i].id != g2[id][i].id || g1[id][i].pg != g2[id][i].pg ||
+          g1[id][i].vs != g2[id][i].vs) ok = false;
+    }
+    if (d1[id] != d2[id]) ok = false;
+  }
+  BOOST_CHECK(ok);
+}
+
+// Fields that are compared between networks, for each bus
+enum {B_COUNT, B_TYPE, B_AREA, B_PL, B_QL, B_VM, B_NGEN, B_PG, B_QMAX,
+  B_VS, B_MBASE, B_MODEL, B_H, B_MISSING, NUM_BUS_FIELDS};
+
+// Fields that are compared between networks, summed over the branches
+// that start at a bus
+enum {L_COUNT, L_NELEM, L_TO, L_R, L_X, L_B, L_MISSING, NUM_BRANCH_FIELDS};
+
+/**
+ * Collect the data of all active buses and branches in a network into
+ * tables indexed by bus ID. Every bus and branch is active on exactly
+ * one process, so summing the tables over all processes gives tables that
+ * do not depend on how the network is distributed
+ */
+void networkTables(TestNetwork &network, std::vector<double> &busTable,
+    std::vector<double> &branchTable)
+{
+  busTable.assign((NUM_BUSES+1)*NUM_BUS_FIELDS,0.0);
+  branchTable.assign((NUM_BUSES+1)*NUM_BRANCH_FIELDS,0.0);
+  int nbus = network.numBuses();
+  int i, g;
+  for (i=0; i<nbus; i++) {
+    if (!network.getActiveBus(i)) continue;
+    gridpack::component::DataCollection *data = network.getBusData(i).get();
+    double *row = &busTable[network.getOriginalBusIndex(i)*NUM_BUS_FIELDS];
+    int ival;
+    double rval;
+    int missing = 0;
+    row[B_COUNT] += 1.0;
+    if (data->getValue(BUS_TYPE,&ival)) row[B_TYPE] = ival; else missing++;
+    if (data->getValue(BUS_AREA,&ival)) row[B_AREA] = ival; else missing++;
+    if (data->getValue(LOAD_PL,&rval,0)) row[B_PL] = rval; else missing++;
+    if (data->getValue(LOAD_QL,&rval,0)) row[B_QL] = rval; else missing++;
+    if (data->getValue(BUS_VOLTAGE_MAG,&rval)) row[B_VM] = rval;
+    else missing++;
+    int ngen = 0;
+    data->getValue(GENERATOR_NUMBER,&ngen);
+    row[B_NGEN] = ngen;
+    for (g=0; g<ngen; g++) {
+      std::string model;
+      if (data->getValue(GENERATOR_PG,&rval,g)) row[B_PG] += rval;
+      else missing++;
+      if (data->getValue(GENERATOR_QMAX,&rval,g)) row[B_QMAX] += rval;
+      else missing++;
+      if (data->getValue(GENERATOR_VS,&rval,g)) row[B_VS] += rval;
+      else missing++;
+      if (data->getValue(GENERATOR_MBASE,&rval,g)) row[B_MBASE] += rval;
+      else missing++;
+      if (data->getValue(GENERATOR_MODEL,&model,g)) {
+        row[B_MODEL] += gridpack::parser::DyrModelTable::modelType(model)+1;
+      } else {
+        missing++;
+      }
+      if (data->getValue(GENERATOR_INERTIA_CONSTANT_H,&rval,g)) {
+        row[B_H] += rval;
+      } else {
+        missing++;
+      }
+    }
+    row[B_MISSING] = missing;
+  }
+  int nbranch = network.numBranches();
+  for (i=0; i<nbranch; i++) {
+    if (!network.getActiveBranch(i)) continue;
+    gridpack::component::DataCollection *data =
+      network.getBranchData(i).get();
+    int from, to, nelem;
+    int missing = 0;
+    if (!data->getValue(BRANCH_FROMBUS,&from)) from = 0;
+    if (!data->getValue(BRANCH_TOBUS,&to)) missing++;
+    if (!data->getValue(BRANCH_NUM_ELEMENTS,&nelem)) missing++;
+    double *row = &branchTable[from*NUM_BRANCH_FIELDS];
+    row[L_COUNT] += 1.0;
+    row[L_NELEM] += nelem;
+    row[L_TO] += to;
+    int e;
+    for (e=0; e<nelem; e++) {
+      double rval;
+      if (data->getValue(BRANCH_R,&rval,e)) row[L_R] += rval; else missing++;
+      if (data->getValue(BRANCH_X,&rval,e)) row[L_X] += rval; else missing++;
+      if (data->getValue(BRANCH_B,&rval,e)) row[L_B] += rval; else missing++;
+    }
+    row[L_MISSING] += missing;
+  }
+}
+
+/**
+ * Compare two tables field by field
+ * @param nfield number of fields per bus
+ * @param tol tolerance for each field
+ * @return false if any field differs by more than its tolerance. The
+ * first difference is printed
+ */
+bool sameTable(const std::vector<double> &t1, const std::vector<double> &t2,
+    int nfield, const double *tol, const char *name)
+{
+  size_t i;
+  for (i=0; i<t1.size(); i++) {
+    if (fabs(t1[i]-t2[i]) > tol[i%nfield]) {
+      printf("%s table differs for bus %d field %d: %f %f\n",name,
+          static_cast<int>(i/nfield),static_cast<int>(i%nfield),t1[i],t2[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+BOOST_AUTO_TEST_CASE(RawFile)
+{
+  gridpack::parallel::Communicator world;
+  gridpack::parser::SyntheticNetwork synth(testParams());
+
+  // Network generated in place on all processes
+  boost::shared_ptr<TestNetwork> network1(new TestNetwork(world));
+  gridpack::parser::SyntheticParser<TestNetwork> parser1(network1, synth);
+  parser1.parse();
+  network1->partition();
+  parser1.addDynamicModels();
+
+  // The same network read back from the files written by the generator
+  synth.write(world, "synthetic.raw", "synthetic.dyr");
+  boost::shared_ptr<TestNetwork> network2(new TestNetwork(world));
+  gridpack::parser::PTI23_parser<TestNetwork> parser2(network2);
+  parser2.parse("synthetic.raw");
+  network2->partition();
+  parser2.externalParse("synthetic.dyr");
+
+  std::vector<double> bus1, branch1, bus2, branch2;
+  networkTables(*network1, bus1, branch1);
+  networkTables(*network2, bus2, branch2);
+  world.sum(&bus1[0], bus1.size());
+  world.sum(&branch1[0], branch1.size());
+  world.sum(&bus2[0], bus2.size());
+  world.sum(&branch2[0], branch2.size());
+
+  // Every bus and branch exists exactly once in each network
+  int id;
+  bool ok = true;
+  for (id=1; id<=NUM_BUSES; id++) {
+    if (bus1[id*NUM_BUS_FIELDS+B_COUNT] != 1.0) ok = false;
+  }
+  BOOST_CHECK(ok);
+  int nbranch1 = network1->totalBranches();
+  int nbranch2 = network2->totalBranches();
+  BOOST_CHECK_EQUAL(nbranch1, nbranch2);
+
+  // The .raw file has 3 decimals for powers and 5 for voltages and
+  // impedances, so values summed over a few generators or branch circuits
+  // agree to within a few units in the last written digit. Everything
+  // else, including the dynamic models, must agree exactly
+  double busTol[NUM_BUS_FIELDS] = {0.0, 0.0, 0.0, 1.0e-3, 1.0e-3, 1.0e-5,
+    0.0, 1.0e-2, 1.0e-2, 1.0e-4, 0.0, 0.0, 0.0, 0.0};
+  double branchTol[NUM_BRANCH_FIELDS] = {0.0, 0.0, 0.0, 1.0e-4, 1.0e-4,
+    1.0e-4, 0.0};
+  BOOST_CHECK(sameTable(bus1, bus2, NUM_BUS_FIELDS, busTol, "Bus"));
+  BOOST_CHECK(sameTable(branch1, branch2, NUM_BRANCH_FIELDS, branchTol,
+        "Branch"));
+}
+
+BOOST_AUTO_TEST_CASE(DistributedParse)
+{
+  gridpack::parallel::Communicator world;
+  gridpack::parser::SyntheticNetwork synth(testParams());
+  boost::shared_ptr<TestNetwork> network(new TestNetwork(world));
+  gridpack::parser::SyntheticParser<TestNetwork> parser(network, synth);
+  parser.parse();
+  parser.addDynamicModels();
+
+  // Count buses and generators on this process and compare against
+  // the generator
+  int nbus = network->numBuses();
+  int ngen = 0;
+  int nref = 0;
+  bool ok = true;
+  int i;
+  std::vector<gridpack::parser::SyntheticNetwork::GeneratorRecord> gens;
+  for (i=0; i<nbus; i++) {
+    boost::shared_ptr<gridpack::component::DataCollection> data =
+      network->getBusData(i);
+    int id, ng;
+    data->getValue(BUS_NUMBER,&id);
+    if (!data->getValue(GENERATOR_NUMBER,&ng)) ng = 0;
+    synth.generators(id,gens);
+    if (ng != static_cast<int>(gens.size())) ok = false;
+    int g;
+    for (g=0; g<ng; g++) {
+      std::string model;
+      if (!data->getValue(GENERATOR_MODEL,&model,g)) ok = false;
+    }
+    ngen += ng;
+    nref += static_cast<int>(gens.size());
+  }
+  BOOST_CHECK(ok);
+  int ntot = nbus;
+  world.sum(&ntot,1);
+  BOOST_CHECK_EQUAL(ntot, NUM_BUSES);
+  world.sum(&ngen,1);
+  world.sum(&nref,1);
+  BOOST_CHECK_EQUAL(ngen, nref);
+}
+
+BOOST_AUTO_TEST_SUITE_END( )
+
+bool init_function(void)
+{
+  return true;
+}
+
+int main (int argc, char **argv) {
+
+  gridpack::parallel::Environment env(argc, argv);
+  gridpack::parallel::Communicator world;
+
+  int me = world.rank();
+  if (me == 0) {
+    printf("Testing synthetic network generator\n");
+    printf("\nTest Network has %d buses in %d areas\n",NUM_BUSES,NUM_AREAS);
+  }
+
+  int result = ::boost::unit_test::unit_test_main( &init_function, argc, argv );
+  return result;
+}
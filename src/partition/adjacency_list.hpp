@@ -78,21 +78,25 @@ public:
   ~AdjacencyList(void);
 
   /// Add the global index and original index of a local node
-  void add_node(const Index& global_index, const Index& original_index)
+  void add_node(const Index& global_index, const Index& original_index,
+                const int& weight = 1)
   {
     p_global_nodes.push_back(global_index);
     p_original_nodes.push_back(original_index);
+    p_node_weights.push_back(weight);
   }
   
   /// Add the global index of a local edge and what it connects using the
   /// original indices for the buses at either end of the node
   void add_edge(const Index& edge_index, 
                 Index node_index_1,
-                Index node_index_2)
+                Index node_index_2,
+                const int& weight = 2)
   {
     p_Edge tmp;
     tmp.index = edge_index;
     tmp.original_conn = std::make_pair(node_index_1, node_index_2);
+    tmp.weight = weight;
     p_edges.push_back(tmp);
   }
 
@@ -121,6 +125,12 @@ public:
   /// Get the global edge index given a local index
   Index edge_index(const int& local_index) const;
 
+  /// Get the weight of a local node
+  int node_weight(const int& local_index) const;
+
+  /// Get the weight of a local edge
+  int edge_weight(const int& local_index) const;
+
   /// Get an edges connected global node indexes 
   void edge(const int& local_index, Index& node1, Index& node2) const;
 
@@ -134,6 +144,11 @@ public:
   /// Get the number of neighbors of the specified (local) node
   size_t node_neighbors(const int& local_index) const;
 
+  /// Get the weights of the edges connecting the specified (local)
+  /// node to its neighbors, in the same order as node_neighbors()
+  void node_neighbor_weights(const int& local_index,
+                             std::vector<int>& weights) const;
+
 protected:
 
   typedef std::pair<Index, Index> p_NodeConnect;
@@ -144,7 +159,9 @@ protected:
     p_NodeConnect original_conn;
     p_NodeConnect global_conn;
     p_Connected found;
-    p_Edge() : index(0), original_conn(), global_conn(), found(false, false) {}
+    int weight;
+    p_Edge() : index(0), original_conn(), global_conn(), found(false, false),
+               weight(2) {}
   };
   typedef std::vector<p_Edge> p_EdgeVector;
 
@@ -155,12 +172,18 @@ protected:
 
   /// The list of original indices for local nodes
   IndexVector p_original_nodes;
+
+  /// The list of weights for local nodes
+  std::vector<int> p_node_weights;
   
   /// The list of local edges
   p_EdgeVector p_edges;
 
   /// The resulting adjacency for local nodes
   p_Adjacency p_adjacency;
+
+  /// Edge weights corresponding to ::p_adjacency
+  std::vector< std::vector<int> > p_adjacency_weights;
   
 
 };
@@ -50,18 +50,20 @@ public:
   ~GraphPartitioner(void);
 
   /// Add the global index of a local node and the original index of local node
-  void add_node(const Index& global_index, const Index& original_index)
+  void add_node(const Index& global_index, const Index& original_index,
+                const int& weight = 1)
   {
-    p_impl->add_node(global_index, original_index);
+    p_impl->add_node(global_index, original_index, weight);
   }
   
   /// Add the global index of a local edge and what it connects using the original
   /// indices of the buses at either end of the node 
   void add_edge(const Index& edge_index, 
                 const Index& node_index_1,
-                const Index& node_index_2)
+                const Index& node_index_2,
+                const int& weight = 2)
   {
-    p_impl->add_edge(edge_index, node_index_1, node_index_2);
+    p_impl->add_edge(edge_index, node_index_1, node_index_2, weight);
   }
 
   /// Get the global indices of the buses at either end of a branch
@@ -100,6 +102,12 @@ public:
     p_impl->partition();
   }
 
+  /// Repartition the graph, starting from the current node distribution
+  void repartition(const double& itr)
+  {
+    p_impl->repartition(itr);
+  }
+
   /// Get the node destinations
   void node_destinations(IndexVector& dest) const
   {
@@ -46,7 +46,8 @@ GraphPartitionerImplementation::GraphPartitionerImplementation(const parallel::C
   : parallel::Distributed(comm), utility::Uncopyable(),
     p_adjacency_list(comm), 
     p_node_destinations(),
-    p_edge_destinations()
+    p_edge_destinations(),
+    p_adaptive(false), p_itr(1000.0)
 {
   // empty
 }
@@ -57,7 +58,8 @@ GraphPartitionerImplementation::GraphPartitionerImplementation(const parallel::C
   : parallel::Distributed(comm), utility::Uncopyable(),
     p_adjacency_list(comm, local_nodes, local_edges), 
     p_node_destinations(local_nodes),
-    p_edge_destinations(local_edges)
+    p_edge_destinations(local_edges),
+    p_adaptive(false), p_itr(1000.0)
 {
   // empty
 }
@@ -112,6 +114,27 @@ GraphPartitionerImplementation::ghost_edge_destinations(GraphPartitionerImplemen
             std::back_inserter(dest));
 }
 
+// -------------------------------------------------------------
+// GraphPartitionerImplementation::repartition
+// -------------------------------------------------------------
+/** 
+ * Nodes are assumed to be on the process that currently owns them.
+ * Partitioning starts from this distribution and tries to move as
+ * few nodes as possible.
+ * 
+ * @param itr ratio of inter-process communication time to data
+ * redistribution time. Large values favor a low edge cut; small
+ * values favor leaving nodes where they are.
+ */
+void
+GraphPartitionerImplementation::repartition(const double& itr)
+{
+  p_adaptive = true;
+  p_itr = itr;
+  this->partition();
+  p_adaptive = false;
+}
+
 // -------------------------------------------------------------
 // GraphPartitionerImplementation::partition
 // -------------------------------------------------------------
@@ -171,7 +194,11 @@ GraphPartitionerImplementation::partition(void)
 
   if (timer != NULL) timer->start(t_part);
 
-  this->p_partition();          // fills p_node_destinations
+  if (p_adaptive) {
+    this->p_repartition();      // fills p_node_destinations
+  } else {
+    this->p_partition();        // fills p_node_destinations
+  }
 
   if (timer != NULL) timer->stop(t_part);
 
@@ -281,6 +308,7 @@ GraphPartitionerImplementation::partition(void)
   node_src.reset();
 
 
+  p_ghost_edge_destinations.clear();
   p_ghost_edge_destinations.reserve(locedges);
   std::copy(e2dest.begin(), e2dest.end(), 
             std::back_inserter(p_ghost_edge_destinations));
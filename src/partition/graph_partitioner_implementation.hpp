@@ -54,18 +54,20 @@ public:
   virtual ~GraphPartitionerImplementation(void);
 
   /// Add the global index and original index of a local node
-  void add_node(const Index& global_index, const Index& original_index)
+  void add_node(const Index& global_index, const Index& original_index,
+                const int& weight = 1)
   {
-    p_adjacency_list.add_node(global_index, original_index);
+    p_adjacency_list.add_node(global_index, original_index, weight);
   }
   
   /// Add the global index of a local edge and what it connects using the
   /// original indices of buses at either end
   void add_edge(const Index& edge_index, 
                 const Index& node_index_1,
-                const Index& node_index_2)
+                const Index& node_index_2,
+                const int& weight = 2)
   {
-    p_adjacency_list.add_edge(edge_index, node_index_1, node_index_2);
+    p_adjacency_list.add_edge(edge_index, node_index_1, node_index_2, weight);
   }
 
   /// Get the global indices of the buses at either end of a branch
@@ -101,6 +103,9 @@ public:
   /// Partition the graph
   void partition(void);
 
+  /// Repartition the graph, starting from the current node distribution
+  void repartition(const double& itr);
+
   /// Get the node destinations
   void node_destinations(IndexVector& dest) const;
 
@@ -130,9 +135,25 @@ protected:
   /// A list of processors where local edges should go
   IndexVector p_ghost_edge_destinations;
 
+  /// Use adaptive repartitioning instead of partitioning from scratch
+  bool p_adaptive;
+
+  /// Ratio of inter-process communication time to redistribution time
+  double p_itr;
+
   /// Partition the graph (specialized)
   virtual void p_partition(void) = 0;
 
+  /// Repartition the graph (specialized), starting from current owners
+  /**
+   * Implementations that do not support adaptive repartitioning just
+   * partition from scratch.
+   */
+  virtual void p_repartition(void)
+  {
+    this->p_partition();
+  }
+
 };
 
 
@@ -19,6 +19,8 @@
 #include <boost/mpi/collectives.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/utility.hpp>
+#include <boost/assert.hpp>
+#include "gridpack/utilities/exception.hpp"
 #include "parmetis/parmetis_graph_partitioner_impl.hpp"
 #include "parmetis/parmetis_graph_wrapper.hpp"
 
@@ -63,6 +65,10 @@ ParMETISGraphPartitionerImpl::~ParMETISGraphPartitionerImpl(void)
  * that indicates the adjacency info for individual nodes (xadj).
  * These are named as in the ParMETIS documentation.
  * 
+ * Node and edge weights supplied to the AdjacencyList (bus and
+ * branch weights from the network) are passed along as vwgt and
+ * adjwgt, so the partition balances the actual work per node.
+ * 
  * (I'm starting to remember why I don't like ParMETIS. Serious
  * problems with ParMETIS:
  * 
@@ -80,10 +86,12 @@ ParMETISGraphPartitionerImpl::p_partition(void)
   std::vector<idx_t> vtxdist;
   std::vector<idx_t> xadj;
   std::vector<idx_t> adjncy;
+  std::vector<idx_t> vwgt;
+  std::vector<idx_t> adjwgt;
 
   ParMETISGraphWrapper wrap(p_adjacency_list);
 
-  wrap.get_csr_local(vtxdist, xadj, adjncy);
+  wrap.get_csr_local(vtxdist, xadj, adjncy, vwgt, adjwgt);
 
   int nnodes(vtxdist[me+1] - vtxdist[me]);
 
@@ -119,8 +127,6 @@ ParMETISGraphPartitionerImpl::p_partition(void)
   idx_t ncon(1);
   idx_t wgtflag(3), numflag(0);
   idx_t nparts(this->processor_size());
-  std::vector<idx_t> vwgt(nnodes, 1);
-  std::vector<idx_t> adjwgt(adjncy.size(), 2);
   std::vector<real_t> tpwgts(nparts*ncon, 1.0/static_cast<real_t>(nparts));
   real_t ubvec(1.05);
   std::vector<idx_t> options(3);
@@ -158,5 +164,79 @@ ParMETISGraphPartitionerImpl::p_partition(void)
 }
 
 
+// -------------------------------------------------------------
+// ParMETISGraphPartitionerImpl::p_repartition
+// -------------------------------------------------------------
+/**
+ * Like ::p_partition(), but the current owner of each node is used
+ * as the starting partition and ParMETIS_V3_AdaptiveRepart() is
+ * called. ParMETIS balances the edge cut against the number of nodes
+ * that have to move, as controlled by ::p_itr.
+ * 
+ */
+void 
+ParMETISGraphPartitionerImpl::p_repartition(void)
+{
+  int me(this->processor_rank());
+  std::vector<idx_t> vtxdist;
+  std::vector<idx_t> xadj;
+  std::vector<idx_t> adjncy;
+  std::vector<idx_t> vwgt;
+  std::vector<idx_t> adjwgt;
+
+  ParMETISGraphWrapper wrap(p_adjacency_list);
+
+  wrap.get_csr_local(vtxdist, xadj, adjncy, vwgt, adjwgt);
+
+  int nnodes(vtxdist[me+1] - vtxdist[me]);
+
+  // the current owners are the starting partition
+
+  std::vector<idx_t> part;
+  wrap.get_owner_local(vtxdist, part);
+  BOOST_ASSERT(part.size() == nnodes);
+
+  int status;
+
+  idx_t ncon(1);
+  idx_t wgtflag(3), numflag(0);
+  idx_t nparts(this->processor_size());
+  std::vector<idx_t> vsize(nnodes, 1);
+  std::vector<real_t> tpwgts(nparts*ncon, 1.0/static_cast<real_t>(nparts));
+  real_t ubvec(1.05);
+  real_t itr(p_itr);
+  std::vector<idx_t> options(4);
+  options[0] = 1;
+  options[1] = 127;
+  options[2] = 14;
+  options[3] = PARMETIS_PSR_UNCOUPLED;
+  MPI_Comm comm(this->communicator());
+
+  idx_t edgecut;
+  status = ParMETIS_V3_AdaptiveRepart(&vtxdist[0], 
+                                      &xadj[0], 
+                                      &adjncy[0],
+                                      &vwgt[0],
+                                      &vsize[0],
+                                      &adjwgt[0],
+                                      &wgtflag,
+                                      &numflag,
+                                      &ncon,
+                                      &nparts,
+                                      &tpwgts[0],
+                                      &ubvec,
+                                      &itr,
+                                      &options[0],
+                                      &edgecut, &part[0],
+                                      &comm);
+  if (status != METIS_OK) {
+    throw Exception("ParMETIS_V3_AdaptiveRepart failed");
+  }
+
+  wrap.set_partition(vtxdist, part);
+  wrap.get_partition(p_node_destinations);
+}
+
+
 } // namespace network
 } // namespace gridpack
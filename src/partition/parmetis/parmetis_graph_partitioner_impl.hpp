@@ -56,6 +56,9 @@ protected:
   /// Partition the graph (specialized)
   void p_partition(void);
 
+  /// Repartition the graph using ParMETIS adaptive repartitioning
+  void p_repartition(void);
+
 };
 
 
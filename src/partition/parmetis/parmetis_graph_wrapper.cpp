@@ -29,7 +29,7 @@ namespace bl = boost::lambda;
 static const int one(1);
 static const int two(2);
 
-static const int num_node_data(3);
+static const int num_node_data(4);
 
 namespace gridpack {
 namespace network {
@@ -48,7 +48,7 @@ ParMETISGraphWrapper::ParMETISGraphWrapper(const AdjacencyList& alist)
     p_global_nodes(0), p_global_edges(0),
     p_node_data(), p_local_node_id(), 
     p_node_lo(-1), p_node_hi(-1), 
-    p_xadj_gbl(), p_adjncy_gbl()
+    p_xadj_gbl(), p_adjncy_gbl(), p_adjwgt_gbl()
 {
   p_initialize();
 }
@@ -112,6 +112,15 @@ ParMETISGraphWrapper::p_initialize_gbl(const int& gblnodes, const int& locnodes,
     hi[1] = p_node_hi; hi[1] = 1;
     p_node_data->put(lo, hi, &ndata[0], ld);
 
+    // put the node weight
+
+    for (int n = 0; n < locnodes; ++n) {
+      ndata[n] = p_adjacency.node_weight(n);
+    }
+    lo[0] = p_node_lo; lo[1] = 3;
+    hi[0] = p_node_hi; hi[1] = 3;
+    p_node_data->put(lo, hi, &ndata[0], ld);
+
   }
 
   communicator().sync();
@@ -167,9 +176,13 @@ ParMETISGraphWrapper::p_initialize_gbl(const int& gblnodes, const int& locnodes,
   p_adjncy_gbl.reset(new GA::GlobalArray(MT_C_INT, one, dims,
                                          "ParMETIS Adjacency List", NULL));
   p_adjncy_gbl->zero();
+  p_adjwgt_gbl.reset(new GA::GlobalArray(MT_C_INT, one, dims,
+                                         "ParMETIS Edge Weights", NULL));
+  p_adjwgt_gbl->zero();
 
   std::vector<AdjacencyList::Index> nbrs;
   std::vector<int> inbrs;
+  std::vector<int> wnbrs;
   for (int p = 0; p < this->processor_size(); ++p) {
     if (p == this->processor_rank()) {
       if (locnodes > 0) {
@@ -185,6 +198,9 @@ ParMETISGraphWrapper::p_initialize_gbl(const int& gblnodes, const int& locnodes,
 	  lo[0] = tmp[0];
 	  hi[0] = tmp[0] + inbrs.size() - 1;
 	  if (hi[0] >= lo[0]) p_adjncy_gbl->put(lo, hi, &inbrs[0], ld);
+	  p_adjacency.node_neighbor_weights(i, wnbrs);
+	  BOOST_ASSERT(wnbrs.size() == inbrs.size());
+	  if (hi[0] >= lo[0]) p_adjwgt_gbl->put(lo, hi, &wnbrs[0], ld);
 
 	  int idx(p_node_lo + i + 1);
 	  tmp[0] += inbrs.size();
@@ -247,6 +263,17 @@ void
 ParMETISGraphWrapper::get_csr_local(std::vector<idx_t>& vtxdist,
                                     std::vector<idx_t>& xadj,
                                     std::vector<idx_t>& adjncy) const
+{
+  std::vector<idx_t> vwgt, adjwgt;
+  get_csr_local(vtxdist, xadj, adjncy, vwgt, adjwgt);
+}
+
+void
+ParMETISGraphWrapper::get_csr_local(std::vector<idx_t>& vtxdist,
+                                    std::vector<idx_t>& xadj,
+                                    std::vector<idx_t>& adjncy,
+                                    std::vector<idx_t>& vwgt,
+                                    std::vector<idx_t>& adjwgt) const
 {
   BOOST_ASSERT(p_node_data);
   BOOST_ASSERT(p_local_node_id);
@@ -300,6 +327,28 @@ ParMETISGraphWrapper::get_csr_local(std::vector<idx_t>& vtxdist,
   std::vector<int> nidx(nidxsize);
   p_adjncy_gbl->get(&lo[0], &hi[0], &nidx[0], &ld[0]);
 
+  {
+    std::vector<int> wtmp(nidxsize);
+    if (nidxsize > 0) p_adjwgt_gbl->get(&lo[0], &hi[0], &wtmp[0], &ld[0]);
+    adjwgt.clear();
+    adjwgt.reserve(wtmp.size());
+    std::copy(wtmp.begin(), wtmp.end(), std::back_inserter(adjwgt));
+  }
+
+  {
+    vwgt.clear();
+    if (localnodes > 0) {
+      int nlo[2], nhi[2], nld[2];
+      nlo[0] = vtxdist[me]; nlo[1] = 3;
+      nhi[0] = vtxdist[me+1]-1; nhi[1] = 3;
+      nld[0] = 1; nld[1] = 1;
+      std::vector<int> wtmp(localnodes);
+      p_node_data->get(nlo, nhi, &wtmp[0], nld);
+      vwgt.reserve(localnodes);
+      std::copy(wtmp.begin(), wtmp.end(), std::back_inserter(vwgt));
+    }
+  }
+
   {  
     std::vector<int*> junkidx(nidx.size());
     std::vector<int>::iterator i(nidx.begin());
@@ -319,6 +368,40 @@ ParMETISGraphWrapper::get_csr_local(std::vector<idx_t>& vtxdist,
   communicator().sync();
 }
 
+// -------------------------------------------------------------
+// ParMETISGraphWrapper::get_owner_local
+// -------------------------------------------------------------
+/** 
+ * The owner is the process that held the node in the AdjacencyList
+ * used to build this instance. This is used as the starting
+ * partition for adaptive repartitioning.
+ * 
+ * @param vtxdist ParMETIS graph node distribution (from ::get_csr_local)
+ * @param owner current owner process of each local ParMETIS graph node
+ */
+void
+ParMETISGraphWrapper::get_owner_local(const std::vector<idx_t>& vtxdist,
+                                      std::vector<idx_t>& owner) const
+{
+  int me(this->processor_rank());
+  int nlocal(vtxdist[me+1] - vtxdist[me]);
+
+  BOOST_ASSERT(p_node_data);
+
+  owner.clear();
+  if (nlocal > 0) {
+    int lo[2], hi[2], ld[2];
+    lo[0] = vtxdist[me]; lo[1] = 1;
+    hi[0] = vtxdist[me+1]-1; hi[1] = 1;
+    ld[0] = 1; ld[1] = 1;
+    std::vector<int> tmp(nlocal);
+    p_node_data->get(lo, hi, &tmp[0], ld);
+    owner.reserve(nlocal);
+    std::copy(tmp.begin(), tmp.end(), std::back_inserter(owner));
+  }
+  communicator().sync();
+}
+
 // -------------------------------------------------------------
 // ParMETISGraphWrapper::set_partition
 // -------------------------------------------------------------
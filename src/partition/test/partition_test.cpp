@@ -18,6 +18,7 @@
 #include <ctime>
 #include <iostream>
 #include <iterator>
+#include <algorithm>
 #include <ga++.h>
 #include <boost/mpi/collectives.hpp>
 #include <boost/serialization/vector.hpp>
@@ -96,6 +97,53 @@ BOOST_AUTO_TEST_CASE( adjacency )
     
 }
 
+/// Check that node and edge weights reach the right nodes
+/**
+ * @test
+ * 
+ * The simple linear graph is built with node n weighted n+1 and edge
+ * e, which connects nodes e and e+1, weighted 10+e. Node n is added on
+ * process n%nproc and edge e on process (e+1)%nproc, so on more than
+ * one process the edge weights have to travel to both nodes.
+ */
+BOOST_AUTO_TEST_CASE( weighted_adjacency )
+{
+  gridpack::parallel::Communicator world;
+  const int me(world.rank()), nproc(world.size());
+  const int global_nodes(4*nproc);
+  
+  using gridpack::network::AdjacencyList;
+
+  AdjacencyList adlist(world);
+  for (int n = me; n < global_nodes; n += nproc) {
+    adlist.add_node(n, n, n+1);
+  }
+  for (int e = (me+nproc-1)%nproc; e < global_nodes-1; e += nproc) {
+    adlist.add_edge(e, e, e+1, 10+e);
+  }
+  adlist.ready();
+
+  for (size_t i = 0; i < adlist.nodes(); ++i) {
+    AdjacencyList::Index node(adlist.node_index(i));
+    BOOST_CHECK_EQUAL(adlist.node_weight(i), static_cast<int>(node)+1);
+
+    AdjacencyList::IndexVector nbr;
+    std::vector<int> wgt;
+    adlist.node_neighbors(i, nbr);
+    adlist.node_neighbor_weights(i, wgt);
+    BOOST_REQUIRE_EQUAL(wgt.size(), nbr.size());
+    for (size_t k = 0; k < nbr.size(); ++k) {
+      int e(static_cast<int>(std::min(node, nbr[k])));
+      BOOST_CHECK_EQUAL(wgt[k], 10+e);
+    }
+  }
+
+  for (size_t i = 0; i < adlist.edges(); ++i) {
+    BOOST_CHECK_EQUAL(adlist.edge_weight(i), 
+                      10+static_cast<int>(adlist.edge_index(i)));
+  }
+}
+
 /// 
 /**
  * @test